@@ -36,6 +36,17 @@ function(define_verilator_environment)
         CACHE PATH "Path to the waveform file" FORCE)
   endif()
 
+  # Coverage instrumentation for every testbench: OFF, user (cover
+  # properties only) or all (line, toggle and user)
+  set(VERILATOR_COVERAGE
+      $ENV{VERILATOR_COVERAGE}
+      CACHE STRING "Verilator coverage: OFF, user or all")
+  if(NOT VERILATOR_COVERAGE)
+    set(VERILATOR_COVERAGE
+        OFF
+        CACHE STRING "Verilator coverage: OFF, user or all" FORCE)
+  endif()
+
   list(APPEND VERI_ARGS -Wall -Wno-fatal -sv --cc)
 
   message(STATUS "Verilog source directory: ${VERILOG_SRC_DIR}")
@@ -43,6 +54,7 @@ function(define_verilator_environment)
   message(STATUS "Verilog test directory: ${VERILOG_TEST_DIR}")
   message(STATUS "Verilog sim directory: ${VERILOG_SIM_DIR}")
   message(STATUS "Waveform file: ${WAVEFORM_FILE}")
+  message(STATUS "Verilator coverage: ${VERILATOR_COVERAGE}")
 
   set(VERI_ARGS
       ${VERI_ARGS}
@@ -118,12 +130,22 @@ function(add_verilated_testbench name top_module cpp_main)
     endif()
   endif()
 
+  set(_verilated_cov_args "")
+  if(VERILATOR_COVERAGE STREQUAL "user")
+    set(_verilated_cov_args --coverage-user)
+  elseif(VERILATOR_COVERAGE STREQUAL "all")
+    set(_verilated_cov_args --coverage)
+  elseif(VERILATOR_COVERAGE)
+    message(FATAL_ERROR "VERILATOR_COVERAGE must be OFF, user or all")
+  endif()
+
   verilate(
     ${MODEL_TARGET}
     SOURCES
     ${TESTBENCH_SOURCES}
     VERILATOR_ARGS
     ${TESTBENCH_VERILATOR_ARGS}
+    ${_verilated_cov_args}
     TOP_MODULE
     ${top_module}
     PREFIX
@@ -131,7 +153,13 @@ function(add_verilated_testbench name top_module cpp_main)
     TRACE_VCD
     TRACE_STRUCTS)
 
-  target_link_libraries(${name} PRIVATE ${MODEL_TARGET} csv2)
+  # Benches may run monitor output on a writer thread (async_writer.hpp)
+  find_package(Threads REQUIRED)
+  target_link_libraries(${name} PRIVATE ${MODEL_TARGET} csv2 Threads::Threads)
+  if(_verilated_cov_args)
+    # VerilatorTb writes coverage.dat (or $COVERAGE_FILE) at exit
+    target_compile_definitions(${name} PRIVATE VM_COVERAGE=1)
+  endif()
 
   # Add run_<target> if it doesn't already exist
   set(RUN_TARGET "run-${name}")
@@ -174,3 +202,17 @@ function(add_verilated_testbench name top_module cpp_main)
     endif()
   endif()
 endfunction()
+
+# pybind11 module over a testbench's Verilated model (SVWDM_PYTHON=ON), for
+# running the bench in process
+function(add_verilated_pymodule name tb_name cpp_src)
+  set(MODEL_TARGET "${tb_name}_model")
+  set_target_properties(${MODEL_TARGET} PROPERTIES POSITION_INDEPENDENT_CODE
+                                                   ON)
+  pybind11_add_module(${name} ${cpp_src})
+  target_include_directories(${name} PRIVATE "${CPP_LIB_DIR}")
+  target_link_libraries(${name} PRIVATE ${MODEL_TARGET} csv2)
+  if(VERILATOR_COVERAGE)
+    target_compile_definitions(${name} PRIVATE VM_COVERAGE=1)
+  endif()
+endfunction()
@@ -0,0 +1,335 @@
+#ifndef AFE_NOISE_HPP
+#define AFE_NOISE_HPP
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Deterministic noise and nonideality sources for the photodetector, ADC and
+// DAC models. Every value is a pure function of (seed, stream, index), so a
+// ring's noise does not depend on how many other rings are simulated or on
+// the order samples are drawn in. Benches drive the results into the
+// i_pd_noise / i_adc_* / i_dac_* wrapper ports, so noise settings change
+// without re-verilating.
+namespace afe_noise {
+
+// ----------------------------------------------------------------------
+// Counter-based RNG
+// ----------------------------------------------------------------------
+// Philox4x32-10 (Salmon et al., SC'11)
+class Philox4x32 {
+public:
+  typedef std::array<uint32_t, 4> ctr_t;
+  typedef std::array<uint32_t, 2> key_t;
+
+  static ctr_t generate(ctr_t ctr, key_t key) {
+    for (int r = 0; r < 10; ++r) {
+      ctr = round(ctr, key);
+      key[0] += 0x9E3779B9u;
+      key[1] += 0xBB67AE85u;
+    }
+    return ctr;
+  }
+
+private:
+  static ctr_t round(const ctr_t &c, const key_t &k) {
+    const uint64_t p0 = uint64_t{0xD2511F53u} * c[0];
+    const uint64_t p1 = uint64_t{0xCD9E8D57u} * c[2];
+    return {static_cast<uint32_t>(p1 >> 32) ^ c[1] ^ k[0],
+            static_cast<uint32_t>(p1),
+            static_cast<uint32_t>(p0 >> 32) ^ c[3] ^ k[1],
+            static_cast<uint32_t>(p0)};
+  }
+};
+
+// Uniform in (0, 1), never exactly 0 so log() is safe
+inline double u01(uint32_t x) { return (x + 0.5) * (1.0 / 4294967296.0); }
+
+// Independent normal stream. The tag separates sources that share a ring
+// (white PD noise, each pink octave, ADC/DAC tables).
+class NoiseStream {
+public:
+  NoiseStream(uint64_t seed = 0, uint32_t stream = 0, uint32_t tag = 0)
+      : key_{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)},
+        stream_(stream), tag_(tag) {}
+
+  // Four normals per counter via Box-Muller
+  std::array<double, 4> normal4(uint64_t block) const {
+    const auto r = Philox4x32::generate(
+        {static_cast<uint32_t>(block), static_cast<uint32_t>(block >> 32),
+         stream_, tag_},
+        key_);
+    constexpr double kTwoPi = 6.283185307179586;
+    const double m0 = std::sqrt(-2.0 * std::log(u01(r[0])));
+    const double m1 = std::sqrt(-2.0 * std::log(u01(r[2])));
+    const double a0 = kTwoPi * u01(r[1]);
+    const double a1 = kTwoPi * u01(r[3]);
+    return {m0 * std::cos(a0), m0 * std::sin(a0), m1 * std::cos(a1),
+            m1 * std::sin(a1)};
+  }
+
+  double normal(uint64_t n) const { return normal4(n >> 2)[n & 3]; }
+
+  // Block generation, one Philox call per four samples
+  void fill_normal(uint64_t first, double *out, size_t count) const {
+    size_t i = 0;
+    while (i < count) {
+      const uint64_t n = first + i;
+      const auto v = normal4(n >> 2);
+      for (uint64_t j = n & 3; j < 4 && i < count; ++j, ++i) {
+        out[i] = v[j];
+      }
+    }
+  }
+
+private:
+  Philox4x32::key_t key_;
+  uint32_t stream_;
+  uint32_t tag_;
+};
+
+enum noise_tag_e : uint32_t {
+  TAG_PD_WHITE = 0x000,
+  TAG_PD_PINK = 0x100, // + octave
+  TAG_ADC_DNL = 0x200,
+  TAG_DAC_DNL = 0x300
+};
+// ----------------------------------------------------------------------
+
+// ----------------------------------------------------------------------
+// Photodetector current noise
+// ----------------------------------------------------------------------
+// Sigmas are in o_real_current units. 1/f noise uses a stateless
+// Voss-McCartney sum: octave k holds one normal for 2^k samples.
+struct PdNoiseConfig {
+  double white_sigma = 0.0;
+  double pink_sigma = 0.0;
+  int pink_octaves = 10;
+};
+
+class PdNoiseModel {
+public:
+  PdNoiseModel() = default;
+  PdNoiseModel(uint64_t seed, uint32_t ring, const PdNoiseConfig &cfg)
+      : cfg_(cfg), white_(seed, ring, TAG_PD_WHITE) {
+    for (int k = 0; k < cfg_.pink_octaves; ++k) {
+      pink_.emplace_back(seed, ring, TAG_PD_PINK + k);
+    }
+  }
+
+  double current(uint64_t n) const {
+    double out = 0.0;
+    if (cfg_.white_sigma != 0.0)
+      out += cfg_.white_sigma * white_.normal(n);
+    if (cfg_.pink_sigma != 0.0 && !pink_.empty()) {
+      double pink = 0.0;
+      for (size_t k = 0; k < pink_.size(); ++k) {
+        pink += pink_[k].normal(n >> k);
+      }
+      out += cfg_.pink_sigma * pink / std::sqrt(double(pink_.size()));
+    }
+    return out;
+  }
+
+  // Same values as current(first + i), but each octave draws one normal per
+  // 2^k samples instead of one per sample
+  void fill(uint64_t first, double *out, size_t count) const {
+    if (cfg_.white_sigma != 0.0) {
+      white_.fill_normal(first, out, count);
+      for (size_t i = 0; i < count; ++i)
+        out[i] *= cfg_.white_sigma;
+    } else {
+      for (size_t i = 0; i < count; ++i)
+        out[i] = 0.0;
+    }
+    if (cfg_.pink_sigma == 0.0 || pink_.empty())
+      return;
+    const double gain = cfg_.pink_sigma / std::sqrt(double(pink_.size()));
+    for (size_t k = 0; k < pink_.size(); ++k) {
+      size_t i = 0;
+      while (i < count) {
+        const uint64_t held = (first + i) >> k;
+        const double v = gain * pink_[k].normal(held);
+        for (; i < count && ((first + i) >> k) == held; ++i) {
+          out[i] += v;
+        }
+      }
+    }
+  }
+
+private:
+  PdNoiseConfig cfg_;
+  NoiseStream white_;
+  std::vector<NoiseStream> pink_;
+};
+
+// Sequential reader for benches: one sample per clock, refilled in blocks
+class PdNoiseReader {
+public:
+  explicit PdNoiseReader(const PdNoiseModel &model, size_t block = 1024)
+      : model_(model), buf_(block), pos_(block) {}
+
+  double next() {
+    if (pos_ == buf_.size()) {
+      model_.fill(index_, buf_.data(), buf_.size());
+      pos_ = 0;
+    }
+    ++index_;
+    return buf_[pos_++];
+  }
+
+  uint64_t index() const { return index_; }
+
+private:
+  PdNoiseModel model_;
+  std::vector<double> buf_;
+  size_t pos_;
+  uint64_t index_ = 0;
+};
+// ----------------------------------------------------------------------
+
+// ----------------------------------------------------------------------
+// Converter nonlinearity tables
+// ----------------------------------------------------------------------
+// Endpoint-fit INL from per-code DNL, in LSB
+template <size_t N>
+std::array<double, N> inl_from_dnl(const std::array<double, N> &dnl) {
+  std::array<double, N> inl{};
+  for (size_t k = 1; k < N; ++k) {
+    inl[k] = inl[k - 1] + dnl[k - 1];
+  }
+  const double slope = inl[N - 1] / double(N - 1);
+  for (size_t k = 0; k < N; ++k) {
+    inl[k] -= slope * double(k);
+  }
+  return inl;
+}
+
+// Random DNL with sigma in LSB, clamped above -1 LSB so codes stay monotonic
+template <size_t N>
+std::array<double, N> random_dnl(const NoiseStream &stream, double sigma) {
+  std::array<double, N> dnl{};
+  stream.fill_normal(0, dnl.data(), N);
+  for (auto &d : dnl) {
+    d *= sigma;
+    if (d < -0.95)
+      d = -0.95;
+  }
+  dnl[N - 1] = 0.0;
+  return dnl;
+}
+
+// Mirrors adc.sv: code = floor(x - inl[floor(x)]) with
+// x = i_ana * (2^W - 1) / FullScaleRange + offset
+template <int WIDTH> class AdcNonideality {
+public:
+  static constexpr int NUM_CODES = 1 << WIDTH;
+  typedef std::array<double, NUM_CODES> table_t;
+
+  AdcNonideality() { inl_.fill(0.0); }
+  AdcNonideality(double offset_lsb, const table_t &inl)
+      : offset_lsb_(offset_lsb), inl_(inl) {}
+
+  static AdcNonideality random(uint64_t seed, uint32_t ring, double dnl_sigma,
+                               double offset_lsb) {
+    NoiseStream stream(seed, ring, TAG_ADC_DNL);
+    return AdcNonideality(offset_lsb,
+                          inl_from_dnl(random_dnl<NUM_CODES>(stream, dnl_sigma)));
+  }
+
+  int convert(double ana, double full_scale) const {
+    const double x = ana * (NUM_CODES - 1) / full_scale + offset_lsb_;
+    const double x_inl = x - inl_[clamp(std::floor(x))];
+    return clamp(std::floor(x_inl));
+  }
+
+  double offset_lsb() const { return offset_lsb_; }
+  double inl(int code) const { return inl_[code]; }
+  const table_t &inl_table() const { return inl_; }
+
+private:
+  static int clamp(double v) {
+    if (v < 0.0)
+      return 0;
+    if (v > double(NUM_CODES - 1))
+      return NUM_CODES - 1;
+    return static_cast<int>(v);
+  }
+
+  double offset_lsb_ = 0.0;
+  table_t inl_;
+};
+
+// Mirrors dac.sv: o_ana = (code + inl[code]) * FullScaleRange / (2^W - 1)
+// Random tables combine a second-order bow (peak bow_lsb mid-scale) with a
+// random DNL walk
+template <int WIDTH> class DacNonideality {
+public:
+  static constexpr int NUM_CODES = 1 << WIDTH;
+  typedef std::array<double, NUM_CODES> table_t;
+
+  DacNonideality() { inl_.fill(0.0); }
+  explicit DacNonideality(const table_t &inl) : inl_(inl) {}
+
+  static DacNonideality random(uint64_t seed, uint32_t ring, double bow_lsb,
+                               double dnl_sigma) {
+    NoiseStream stream(seed, ring, TAG_DAC_DNL);
+    table_t inl = inl_from_dnl(random_dnl<NUM_CODES>(stream, dnl_sigma));
+    for (int k = 0; k < NUM_CODES; ++k) {
+      const double t = double(k) / double(NUM_CODES - 1);
+      inl[k] += 4.0 * bow_lsb * t * (1.0 - t);
+    }
+    return DacNonideality(inl);
+  }
+
+  double convert(int code, double full_scale) const {
+    return (code + inl_[code]) * full_scale / double(NUM_CODES - 1);
+  }
+
+  double inl(int code) const { return inl_[code]; }
+  const table_t &inl_table() const { return inl_; }
+
+private:
+  table_t inl_;
+};
+// ----------------------------------------------------------------------
+
+// Copy a table into an unpacked real port (e.g. dut->i_adc_inl)
+template <typename Port, size_t N>
+void load_table(Port &port, const std::array<double, N> &table) {
+  for (size_t k = 0; k < N; ++k) {
+    port[k] = table[k];
+  }
+}
+
+// ----------------------------------------------------------------------
+// Per-ring bundle
+// ----------------------------------------------------------------------
+struct AfeNoiseConfig {
+  uint64_t seed = 1;
+  PdNoiseConfig pd;
+  double adc_offset_lsb = 0.0;
+  double adc_dnl_sigma = 0.0;
+  double dac_bow_lsb = 0.0;
+  double dac_dnl_sigma = 0.0;
+};
+
+template <int ADC_WIDTH, int DAC_WIDTH> struct AfeNoise {
+  AfeNoise(const AfeNoiseConfig &cfg, uint32_t ring)
+      : pd(PdNoiseModel(cfg.seed, ring, cfg.pd)),
+        adc(AdcNonideality<ADC_WIDTH>::random(cfg.seed, ring, cfg.adc_dnl_sigma,
+                                              cfg.adc_offset_lsb)),
+        dac(DacNonideality<DAC_WIDTH>::random(cfg.seed, ring, cfg.dac_bow_lsb,
+                                              cfg.dac_dnl_sigma)) {}
+
+  PdNoiseReader pd;
+  AdcNonideality<ADC_WIDTH> adc;
+  DacNonideality<DAC_WIDTH> dac;
+};
+// ----------------------------------------------------------------------
+
+} // namespace afe_noise
+
+#endif // AFE_NOISE_HPP
@@ -0,0 +1,139 @@
+#ifndef CTRL_ARB_QOS_HPP
+#define CTRL_ARB_QOS_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace ctrl_arb_qos {
+
+// tuner_phy_pkg::tuner_ctrl_ch_e
+typedef uint8_t ch_t;
+constexpr ch_t CH_NULL = 0;
+constexpr ch_t CH_SEARCH = 1;
+constexpr ch_t CH_LOCK = 2;
+constexpr ch_t CH_CAL = 3;
+constexpr ch_t CH_MON = 4;
+
+// Tune grant of tuner_ctrl_arb_if (select_channel() and the registers it
+// updates), one call per cycle in which the arbiter is ready for a tune.
+// Requests are a mask with bit ch set for tune_val[ch]. All weights zero is
+// fixed priority, lowest channel first; otherwise weighted round-robin,
+// where a channel keeps the grant for up to its weight (min 1) grants in a
+// row. lock_max_wait != 0 forces CH_LOCK once it has waited that many
+// grants to other channels.
+class QosArbiter {
+public:
+  static constexpr int CFG_MAX = 15; // 4-bit weight/wait config and counters
+
+  explicit QosArbiter(int num_client = 2)
+      : num_client_(num_client), weight_(num_client + 1, 0) {
+    if (num_client < 1)
+      throw std::invalid_argument("ctrl_arb_qos: num_client must be >= 1");
+    reset();
+  }
+
+  void reset() {
+    rr_ch_ = CH_SEARCH;
+    rr_cnt_ = 0;
+    lock_wait_ = 0;
+  }
+
+  int num_client() const { return num_client_; }
+
+  void set_weight(ch_t ch, int weight) {
+    weight_.at(ch) = std::clamp(weight, 0, CFG_MAX);
+  }
+  void set_lock_max_wait(int n) { lock_max_wait_ = std::clamp(n, 0, CFG_MAX); }
+
+  bool wrr() const {
+    for (int c = 1; c <= num_client_; ++c)
+      if (weight_[c] != 0)
+        return true;
+    return false;
+  }
+
+  // Grant among req while tune_rdy; returns CH_NULL if nothing requests
+  ch_t grant(uint32_t req) {
+    const ch_t g = select(req);
+    if (g == CH_NULL) {
+      idle(req);
+      return g;
+    }
+    if (g == rr_ch_) {
+      rr_cnt_ = std::min(rr_cnt_ + 1, CFG_MAX);
+    } else {
+      rr_ch_ = g;
+      rr_cnt_ = 1;
+    }
+    if (has_lock() && g != CH_LOCK && requests(req, CH_LOCK))
+      lock_wait_ = std::min(lock_wait_ + 1, CFG_MAX);
+    else
+      lock_wait_ = 0;
+    return g;
+  }
+
+  // A cycle without a grant (tune_rdy low)
+  void idle(uint32_t req) {
+    if (has_lock() && !requests(req, CH_LOCK))
+      lock_wait_ = 0;
+  }
+
+  // Most grants to other channels while CH_LOCK requests before it is
+  // granted, or -1 when fixed priority can starve it
+  int lock_wait_bound() const {
+    if (!has_lock())
+      return -1;
+    int bound = -1;
+    if (wrr()) {
+      bound = 0;
+      for (int c = 1; c <= num_client_; ++c)
+        if (c != CH_LOCK)
+          bound += burst_len(static_cast<ch_t>(c));
+    } else if (CH_LOCK == 1) {
+      bound = 0;
+    }
+    if (lock_max_wait_ != 0)
+      bound = bound < 0 ? lock_max_wait_ : std::min(bound, lock_max_wait_);
+    return bound;
+  }
+
+  int lock_wait() const { return lock_wait_; }
+
+private:
+  bool has_lock() const { return num_client_ >= CH_LOCK; }
+  static bool requests(uint32_t req, ch_t ch) { return (req >> ch) & 1u; }
+  int burst_len(ch_t ch) const { return weight_[ch] == 0 ? 1 : weight_[ch]; }
+
+  ch_t select(uint32_t req) const {
+    if (has_lock() && requests(req, CH_LOCK) && lock_max_wait_ != 0 &&
+        lock_wait_ >= lock_max_wait_)
+      return CH_LOCK;
+    if (!wrr()) {
+      for (int c = 1; c <= num_client_; ++c)
+        if (requests(req, static_cast<ch_t>(c)))
+          return static_cast<ch_t>(c);
+      return CH_NULL;
+    }
+    if (requests(req, rr_ch_) && rr_cnt_ < burst_len(rr_ch_))
+      return rr_ch_;
+    for (int i = 1; i <= num_client_; ++i) {
+      const ch_t c = static_cast<ch_t>((rr_ch_ - 1 + i) % num_client_ + 1);
+      if (requests(req, c))
+        return c;
+    }
+    return CH_NULL;
+  }
+
+  int num_client_;
+  std::vector<int> weight_;
+  int lock_max_wait_ = 0;
+  ch_t rr_ch_;
+  int rr_cnt_;
+  int lock_wait_;
+};
+
+} // namespace ctrl_arb_qos
+
+#endif // CTRL_ARB_QOS_HPP
@@ -0,0 +1,265 @@
+#ifndef CTRL_ARB_TXN_HPP
+#define CTRL_ARB_TXN_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+
+namespace ctrl_arb_txn {
+
+typedef int32_t code_t;
+
+enum class detect_mode_e : uint8_t {
+  DETECT_MODE_BLOCK = 0,
+  DETECT_MODE_STREAM = 1
+};
+
+// Power detect config of the channel that owns the arbiter, unclamped as it
+// arrives on tuner_pwr_detect_if
+struct DetectConfig {
+  detect_mode_e mode = detect_mode_e::DETECT_MODE_BLOCK;
+  int wait_cycle = 1;
+  int avg_shift = 0;
+  int settle_tol = 0;
+};
+
+struct TxnResult {
+  code_t pwr_commit;       // ctrl_arb_if.pwr_commit at ARB_CTRL_COMMIT
+  code_t ring_tune_commit; // ctrl_arb_if.ring_tune_commit at ARB_CTRL_COMMIT
+  uint64_t sync_cycles;    // cycles the RTL spends in ARB_CTRL_SYNC
+};
+
+// Transaction-level model of tuner_ctrl_arb_phy + tuner_pwr_detect_phy (and
+// the tuner_pwr_detect_if handshake between them). One transact() per tune
+// code fired on tuner_ctrl_arb_if returns what the arbiter commits and how
+// many ARB_CTRL_SYNC cycles it takes, so the simulator never evaluates those
+// cycles. The ring+AFE is settled within the fire cycle (as in the sim
+// DUTs): the detector sees the previous code's sample up to the fire and the
+// new code's sample from then on. Its counters are stepped on that input
+// alone, which keeps the read phase, stale commits at sync_cycle 1 and the
+// streaming window bit-exact with the RTL. Cycles are real (simulated)
+// cycles since reset; skipped_cycles() is what the RTL would add on top.
+class CtrlArbTransactor {
+public:
+  static constexpr int ADC_WIDTH = 8;
+  static constexpr int MAX_SYNC_CYCLE = 16;
+  static constexpr int MAX_WAIT_CYCLE = 16;
+  static constexpr int MAX_NUM_PWR_DETECT = 16;
+  static constexpr int MAX_AVG_SHIFT = 4; // $clog2(MAX_NUM_PWR_DETECT)
+  static constexpr code_t ADC_MAX = (1 << ADC_WIDTH) - 1;
+  static constexpr code_t ACC_MASK = (1 << (ADC_WIDTH + MAX_AVG_SHIFT)) - 1;
+
+  CtrlArbTransactor() { reset(); }
+
+  void reset() {
+    det_ = det_state_e::DETECT_IDLE;
+    wait_cnt_ = 0;
+    detect_cnt_ = 0;
+    acc_ = 0;
+    line_.fill(0);
+    mode_ = detect_mode_e::DETECT_MODE_BLOCK;
+    wait_cycle_ = 1;
+    avg_shift_ = 0;
+    settle_tol_ = 0;
+    if_read_ = true;
+    active_ = false;
+    cfg_in_ = DetectConfig{};
+    sample_ = 0;
+    refresh_pending_ = false;
+    pwr_commit_ = 0;
+    ring_tune_track_ = 0;
+    ring_tune_commit_ = 0;
+    cycle_ = 0;
+    skipped_ = 0;
+    transactions_ = 0;
+  }
+
+  // Detector inputs from cycle on (pwr_detect_active and the owner's config)
+  void set_inputs(uint64_t cycle, bool active, const DetectConfig &cfg) {
+    advance_to(cycle);
+    active_ = active;
+    cfg_in_ = cfg;
+  }
+
+  // ctrl_refresh asserted in cycle
+  void refresh(uint64_t cycle) {
+    advance_to(cycle);
+    refresh_pending_ = true;
+    pwr_commit_ = 0;
+    ring_tune_commit_ = 0;
+    ring_tune_track_ = 0;
+  }
+
+  // ring_tune fired in cycle; sample is the settled ADC code for ring_tune
+  TxnResult transact(uint64_t cycle, code_t ring_tune, code_t sample,
+                     int sync_cycle) {
+    advance_to(cycle);
+    if (!active_)
+      throw std::logic_error(
+          "ctrl_arb_txn: tune fired with the power detector inactive");
+    const int sync_eff = std::clamp(sync_cycle, 1, MAX_SYNC_CYCLE);
+    sample_ = sample;
+    ring_tune_track_ = ring_tune;
+
+    // Fire cycle (ARB_CTRL_TUNE), then ARB_CTRL_SYNC until sync_cnt_done
+    step();
+    ++cycle_;
+    int sync_cnt = 0;
+    uint64_t sync_cycles = 0;
+    for (;;) {
+      ++sync_cycles;
+      const bool done = sync_cnt == sync_eff - 1;
+      const Detect d = step();
+      if (d.update) {
+        pwr_commit_ = d.data;
+        ring_tune_commit_ = ring_tune_track_;
+        ++sync_cnt;
+      }
+      if (done)
+        break;
+    }
+    skipped_ += sync_cycles;
+    ++transactions_;
+    return TxnResult{pwr_commit_, ring_tune_commit_, sync_cycles};
+  }
+
+  uint64_t skipped_cycles() const { return skipped_; }
+  uint64_t transactions() const { return transactions_; }
+  // Cycle count the RTL would have reached at simulated cycle
+  uint64_t accounted_cycle(uint64_t cycle) const { return cycle + skipped_; }
+
+private:
+  enum class det_state_e : uint8_t {
+    DETECT_IDLE = 0,
+    DETECT_WAIT = 1,
+    DETECT_ACTIVE = 2,
+    DETECT_DONE = 3
+  };
+
+  struct Detect {
+    bool update; // pwr_detect_update
+    code_t data; // detect_data
+  };
+
+  // Step the cycles between events on the held inputs
+  void advance_to(uint64_t cycle) {
+    while (cycle_ < cycle) {
+      step();
+      ++cycle_;
+    }
+  }
+
+  // One clock of tuner_pwr_detect_phy and the tuner_pwr_detect_if state
+  Detect step() {
+    const code_t x = sample_;
+    const bool read_val = active_ && if_read_;
+    const bool detect_rdy = active_ && !if_read_;
+    const bool read_rdy = det_ == det_state_e::DETECT_IDLE ||
+                          det_ == det_state_e::DETECT_DONE;
+    const bool read_fire = read_val && read_rdy;
+    const bool detect_fire = det_ == det_state_e::DETECT_DONE && detect_rdy;
+
+    const int wait_in = std::clamp(cfg_in_.wait_cycle, 1, MAX_WAIT_CYCLE);
+    const int shift_in = std::min(cfg_in_.avg_shift, MAX_AVG_SHIFT);
+    const int num_detect = 1 << avg_shift_;
+    const bool stream = mode_ == detect_mode_e::DETECT_MODE_STREAM;
+    const bool stream_keep =
+        stream && cfg_in_.mode == detect_mode_e::DETECT_MODE_STREAM &&
+        shift_in == avg_shift_;
+    const code_t diff = x > line_[0] ? x - line_[0] : line_[0] - x;
+    const bool settled = det_ == det_state_e::DETECT_WAIT &&
+                         settle_tol_ != 0 && wait_cnt_ != 0 &&
+                         diff < settle_tol_;
+
+    const Detect out{detect_fire,
+                     detect_fire ? (acc_ >> avg_shift_) & ADC_MAX : 0};
+
+    det_state_e next = det_;
+    int wait_next = 0;
+    int detect_next = 0;
+    code_t acc_next = 0;
+    switch (det_) {
+    case det_state_e::DETECT_IDLE:
+      if (read_fire)
+        next = det_state_e::DETECT_WAIT;
+      break;
+    case det_state_e::DETECT_WAIT:
+      if (wait_cnt_ == wait_cycle_ - 1 || settled)
+        next = det_state_e::DETECT_ACTIVE;
+      wait_next = wait_cnt_ + 1;
+      break;
+    case det_state_e::DETECT_ACTIVE:
+      if (detect_cnt_ == num_detect - 1)
+        next = det_state_e::DETECT_DONE;
+      detect_next = detect_cnt_ + 1;
+      acc_next = (acc_ + x) & ACC_MASK;
+      break;
+    case det_state_e::DETECT_DONE:
+      if (read_fire && !stream_keep)
+        next = det_state_e::DETECT_WAIT;
+      // Moving average: add the newest sample, drop the oldest
+      acc_next = stream ? (acc_ + x - line_[num_detect - 1]) & ACC_MASK : acc_;
+      break;
+    }
+
+    if (read_fire) {
+      mode_ = cfg_in_.mode;
+      wait_cycle_ = wait_in;
+      avg_shift_ = shift_in;
+      settle_tol_ = cfg_in_.settle_tol;
+    }
+    for (int i = MAX_NUM_PWR_DETECT - 1; i > 0; --i)
+      line_[i] = line_[i - 1];
+    line_[0] = x;
+
+    if (refresh_pending_) {
+      if_read_ = true;
+      refresh_pending_ = false;
+    } else if (active_) {
+      if (if_read_ && read_fire)
+        if_read_ = false;
+      else if (!if_read_ && detect_fire)
+        if_read_ = true;
+    }
+
+    det_ = next;
+    wait_cnt_ = wait_next;
+    detect_cnt_ = detect_next;
+    acc_ = acc_next;
+    return out;
+  }
+
+  // tuner_pwr_detect_phy
+  det_state_e det_;
+  int wait_cnt_;
+  int detect_cnt_;
+  code_t acc_;
+  std::array<code_t, MAX_NUM_PWR_DETECT> line_;
+  detect_mode_e mode_;
+  int wait_cycle_;
+  int avg_shift_;
+  code_t settle_tol_;
+
+  // tuner_pwr_detect_if (PWR_READ when true)
+  bool if_read_;
+
+  // Inputs held between events
+  bool active_;
+  DetectConfig cfg_in_;
+  code_t sample_;
+  bool refresh_pending_;
+
+  // tuner_ctrl_arb_phy commit registers
+  code_t pwr_commit_;
+  code_t ring_tune_track_;
+  code_t ring_tune_commit_;
+
+  uint64_t cycle_;
+  uint64_t skipped_;
+  uint64_t transactions_;
+};
+
+} // namespace ctrl_arb_txn
+
+#endif // CTRL_ARB_TXN_HPP
@@ -0,0 +1,329 @@
+#ifndef LOCK_PHY_HPP
+#define LOCK_PHY_HPP
+
+#include <array>
+#include <cstdint>
+
+namespace lock_phy {
+
+typedef int32_t code_t;
+
+enum class lock_state_e : uint8_t {
+  LOCK_IDLE = 0,
+  LOCK_INIT = 1,
+  LOCK_ACTIVE = 2,
+  LOCK_INTR = 3,
+  LOCK_SEARCH = 4
+};
+
+enum class lock_mode_e : uint8_t { LOCK_MODE_SLOPE = 0, LOCK_MODE_PI = 1 };
+
+// Commit-level model of tuner_lock_phy: one step() per committed detect
+// window, i.e., per tune/commit transaction on tuner_ctrl_arb_if. A lock
+// loss with re-acquire enabled parks the model in LOCK_SEARCH until the
+// caller runs the local sweep over local_search_start()..local_search_end()
+// and hands the result to local_search_done().
+class LockPhyModel {
+public:
+  static constexpr int DAC_WIDTH = 8;
+  static constexpr int ADC_WIDTH = 8;
+  static constexpr int LOCK_DELTA_WINDOW_SIZE = 2;
+  static constexpr int LOCK_PI_GEAR_MAX = 3;
+  static constexpr code_t DAC_MAX = (1 << DAC_WIDTH) - 1;
+
+  LockPhyModel() { reset(); }
+
+  void configure(lock_mode_e mode, uint8_t tune_stride, uint8_t delta_thres,
+                 uint8_t pwr_peak_ratio, uint8_t kp_shift, uint8_t ki_shift) {
+    cfg_mode_ = mode;
+    cfg_tune_stride_ = tune_stride;
+    cfg_delta_thres_ = delta_thres;
+    cfg_pwr_peak_ratio_ = pwr_peak_ratio;
+    cfg_kp_shift_ = kp_shift;
+    cfg_ki_shift_ = ki_shift;
+  }
+
+  // i_cfg_lock_loss_ratio, i_cfg_lock_loss_cnt (0 disables) and
+  // i_cfg_lock_research_halfwidth (0 only flags the loss)
+  void configure_loss(uint8_t loss_ratio, uint8_t loss_cnt,
+                      uint8_t research_halfwidth) {
+    cfg_loss_ratio_ = loss_ratio & 0xf;
+    cfg_loss_cnt_ = loss_cnt & 0xf;
+    cfg_research_halfwidth_ = research_halfwidth;
+  }
+
+  void reset() {
+    state_ = lock_state_e::LOCK_IDLE;
+    ring_tune_ = 0;
+    ring_tune_base_ = 0;
+    ring_tune_delta_ = 0;
+    track_detect_ = false;
+    delta_cnt_ = 0;
+    pwr_win_.fill(0);
+    inc_win_.fill(false);
+    dec_win_.fill(false);
+    pi_err_prev_ = 0;
+    pi_err_valid_ = false;
+    pi_gear_ = 0;
+    pi_slope_pos_ = true;
+    loss_cnt_ = 0;
+    loss_armed_ = false;
+    lock_lost_ = false;
+    intr_pending_ = false;
+  }
+
+  // Equivalent of the LOCK_IDLE -> LOCK_INIT -> LOCK_ACTIVE trigger
+  void start(code_t ring_tune_start, code_t ring_tune_peak, code_t pwr_peak) {
+    reset();
+    ring_tune_peak_ = ring_tune_peak & DAC_MAX;
+    pwr_peak_ = pwr_peak;
+    ring_tune_offset_ = (ring_tune_start & DAC_MAX) - ring_tune_peak_;
+    init(ring_tune_start & DAC_MAX);
+  }
+
+  // Consume the power committed for the current ring_tune()
+  void step(code_t power_sample) {
+    if (state_ != lock_state_e::LOCK_ACTIVE)
+      return;
+    if (detect_loss(power_sample) && cfg_research_halfwidth_ != 0) {
+      state_ = lock_state_e::LOCK_SEARCH;
+      return;
+    }
+    if (cfg_mode_ == lock_mode_e::LOCK_MODE_PI) {
+      step_pi(power_sample);
+    } else {
+      step_slope(power_sample);
+    }
+  }
+
+  // Host interrupt request (lock_if intr): LOCK_ACTIVE -> LOCK_INTR. A
+  // request during LOCK_SEARCH is held until the lock is active again.
+  void interrupt() {
+    if (state_ == lock_state_e::LOCK_ACTIVE) {
+      state_ = lock_state_e::LOCK_INTR;
+    } else if (state_ == lock_state_e::LOCK_SEARCH) {
+      intr_pending_ = true;
+    }
+  }
+
+  // LOCK_INTR -> LOCK_IDLE (no restore)
+  void resume() {
+    if (state_ == lock_state_e::LOCK_INTR)
+      state_ = lock_state_e::LOCK_IDLE;
+  }
+
+  bool intr_pending() const { return intr_pending_; }
+
+  // LOCK_SEARCH sweep range around the last good code
+  code_t local_search_start() const {
+    return ring_tune_good_ > cfg_research_halfwidth_
+               ? ring_tune_good_ - cfg_research_halfwidth_
+               : 0;
+  }
+  code_t local_search_end() const {
+    return ring_tune_good_ < DAC_MAX - cfg_research_halfwidth_
+               ? ring_tune_good_ + cfg_research_halfwidth_
+               : DAC_MAX;
+  }
+
+  // Local sweep result: LOCK_SEARCH -> LOCK_INIT -> LOCK_ACTIVE at the
+  // original start-to-peak offset from the new peak
+  void local_search_done(code_t ring_tune_peak, code_t pwr_peak) {
+    if (state_ != lock_state_e::LOCK_SEARCH)
+      return;
+    ring_tune_peak_ = ring_tune_peak & DAC_MAX;
+    pwr_peak_ = pwr_peak;
+    code_t relock = ring_tune_peak_ + ring_tune_offset_;
+    if (relock < 0)
+      relock = 0;
+    if (relock > DAC_MAX)
+      relock = DAC_MAX;
+    init(relock);
+  }
+
+  code_t ring_tune() const { return ring_tune_; }
+  code_t pwr_tgt() const { return pwr_tgt_; }
+  int pi_gear() const { return pi_gear_; }
+  lock_state_e state() const { return state_; }
+  code_t ring_tune_peak() const { return ring_tune_peak_; }
+  code_t ring_tune_offset() const { return ring_tune_offset_; }
+  // o_dig_lock_err level
+  bool lock_lost() const { return lock_lost_; }
+
+private:
+  // LOCK_INIT: restart the loop at ring_tune_start
+  void init(code_t ring_tune_start) {
+    ring_tune_ = ring_tune_start;
+    ring_tune_base_ = ring_tune_;
+    ring_tune_delta_ = 0;
+    track_detect_ = false;
+    delta_cnt_ = 0;
+    pwr_win_.fill(0);
+    inc_win_.fill(false);
+    dec_win_.fill(false);
+    pi_err_prev_ = 0;
+    pi_err_valid_ = false;
+    pi_gear_ = 0;
+    pwr_tgt_ = (pwr_peak_ * cfg_pwr_peak_ratio_) >> 4;
+    pi_slope_pos_ = ring_tune_start <= ring_tune_peak_;
+    loss_cnt_ = 0;
+    loss_armed_ = false;
+    ring_tune_good_ = ring_tune_peak_;
+    state_ = lock_state_e::LOCK_ACTIVE;
+    if (intr_pending_) {
+      intr_pending_ = false;
+      state_ = lock_state_e::LOCK_INTR;
+    }
+  }
+
+  // Loss counter on the committed power; true on the window the loss fires.
+  // Armed once the power first reaches the threshold, so the pull-in from
+  // the off-peak start is not mistaken for a loss.
+  bool detect_loss(code_t pwr) {
+    const code_t thres = (pwr_peak_ * cfg_loss_ratio_) >> 4;
+    const bool below = pwr < thres;
+    const bool fire = loss_armed_ && below && cfg_loss_cnt_ != 0 &&
+                      loss_cnt_ >= cfg_loss_cnt_ - 1;
+    if (!below) {
+      loss_cnt_ = 0;
+      loss_armed_ = true;
+      ring_tune_good_ = ring_tune_;
+      lock_lost_ = false;
+    } else if (loss_armed_ && loss_cnt_ != 0xf) {
+      ++loss_cnt_;
+    }
+    if (fire)
+      lock_lost_ = true;
+    return fire;
+  }
+
+  // Arithmetic shift right, matching SV >>> on signed operands
+  static code_t asr(code_t v, int sh) { return v >= 0 ? v >> sh : ~(~v >> sh); }
+
+  void step_slope(code_t pwr) {
+    const code_t step = code_t{1} << cfg_tune_stride_;
+
+    // tune_compute at CTRL_TUNE (before the commit)
+    if (!track_detect_) {
+      ring_tune_delta_ = (ring_tune_delta_ + step) & DAC_MAX;
+    } else {
+      ring_tune_base_ = decide_base(step);
+      ring_tune_delta_ = 0;
+    }
+
+    // commit at CTRL_UPDATE
+    if (!track_detect_) {
+      const code_t pwr_prev = pwr_win_[0];
+      for (int j = LOCK_DELTA_WINDOW_SIZE - 1; j > 0; --j) {
+        pwr_win_[j] = pwr_win_[j - 1];
+        inc_win_[j] = inc_win_[j - 1];
+        dec_win_[j] = dec_win_[j - 1];
+      }
+      pwr_win_[0] = pwr;
+      if (delta_cnt_ != 0) {
+        inc_win_[0] = pwr > pwr_prev;
+        dec_win_[0] = pwr < pwr_prev;
+      }
+    }
+    const bool detect_next =
+        !track_detect_ && (delta_cnt_ >= LOCK_DELTA_WINDOW_SIZE);
+    delta_cnt_ = track_detect_ ? 0 : delta_cnt_ + 1;
+    track_detect_ = detect_next;
+    ring_tune_ = (ring_tune_base_ + ring_tune_delta_) & DAC_MAX;
+  }
+
+  code_t decide_base(code_t step) const {
+    int thres = cfg_delta_thres_;
+    if (thres == 0)
+      thres = 1;
+    if (thres > LOCK_DELTA_WINDOW_SIZE)
+      thres = LOCK_DELTA_WINDOW_SIZE;
+    int inc_cnt = 0;
+    int dec_cnt = 0;
+    for (int j = 0; j < LOCK_DELTA_WINDOW_SIZE; ++j) {
+      inc_cnt += inc_win_[j];
+      dec_cnt += dec_win_[j];
+    }
+    const bool inc_vote = inc_cnt >= thres;
+    const bool dec_vote = dec_cnt >= thres;
+    if (inc_vote && dec_vote)
+      return ring_tune_base_;
+    if (dec_vote)
+      return (ring_tune_base_ - step) & DAC_MAX;
+    return (ring_tune_base_ + step) & DAC_MAX;
+  }
+
+  void step_pi(code_t pwr) {
+    const code_t err = pwr_tgt_ - pwr;
+    const code_t err_delta = pi_err_valid_ ? err - pi_err_prev_ : 0;
+    const code_t step_raw =
+        asr(err_delta, cfg_kp_shift_) + asr(err, cfg_ki_shift_);
+    code_t pi_step = asr(step_raw, pi_gear_);
+    // Finest move is a single code so the gear shift never stalls the loop
+    if (step_raw > 0 && pi_step == 0)
+      pi_step = 1;
+    code_t sum = pi_slope_pos_ ? ring_tune_ + pi_step : ring_tune_ - pi_step;
+    if (sum < 0)
+      sum = 0;
+    if (sum > DAC_MAX)
+      sum = DAC_MAX;
+
+    const code_t bound = pwr_tgt_ >> 1;
+    const bool err_large = err > bound || err < -bound;
+    const bool err_flip =
+        pi_err_valid_ && err != 0 && ((err < 0) != (pi_err_prev_ < 0));
+    if (err_large) {
+      pi_gear_ = 0;
+    } else if (err_flip && pi_gear_ < LOCK_PI_GEAR_MAX) {
+      ++pi_gear_;
+    }
+
+    pi_err_prev_ = err;
+    pi_err_valid_ = true;
+    ring_tune_ = sum;
+  }
+
+  lock_mode_e cfg_mode_ = lock_mode_e::LOCK_MODE_SLOPE;
+  int cfg_tune_stride_ = 0;
+  int cfg_delta_thres_ = 1;
+  code_t cfg_pwr_peak_ratio_ = 8;
+  int cfg_kp_shift_ = 4;
+  int cfg_ki_shift_ = 3;
+  code_t cfg_loss_ratio_ = 0;
+  int cfg_loss_cnt_ = 0;
+  code_t cfg_research_halfwidth_ = 0;
+
+  lock_state_e state_ = lock_state_e::LOCK_IDLE;
+  code_t ring_tune_ = 0;
+  code_t pwr_tgt_ = 0;
+  code_t pwr_peak_ = 0;
+  code_t ring_tune_peak_ = 0;
+  // Start-to-peak offset from the trigger, kept across re-acquires
+  code_t ring_tune_offset_ = 0;
+
+  // Slope detection
+  code_t ring_tune_base_ = 0;
+  code_t ring_tune_delta_ = 0;
+  bool track_detect_ = false;
+  int delta_cnt_ = 0;
+  std::array<code_t, LOCK_DELTA_WINDOW_SIZE> pwr_win_{};
+  std::array<bool, LOCK_DELTA_WINDOW_SIZE> inc_win_{};
+  std::array<bool, LOCK_DELTA_WINDOW_SIZE> dec_win_{};
+
+  // PI tracker
+  code_t pi_err_prev_ = 0;
+  bool pi_err_valid_ = false;
+  int pi_gear_ = 0;
+  bool pi_slope_pos_ = true;
+
+  // Lock loss
+  int loss_cnt_ = 0;
+  bool loss_armed_ = false;
+  bool lock_lost_ = false;
+  bool intr_pending_ = false;
+  code_t ring_tune_good_ = 0;
+};
+
+} // namespace lock_phy
+
+#endif // LOCK_PHY_HPP
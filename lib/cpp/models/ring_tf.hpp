@@ -0,0 +1,658 @@
+#ifndef RING_TF_HPP
+#define RING_TF_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Laser -> microring drop -> photodetector -> ADC chain as seen by the tuner.
+// The double path mirrors microring.sv/photodetector.sv/adc.sv/dac.sv. The
+// LUT path replaces the Lorentzian divide with a fixed-point table lookup
+// plus linear interpolation, with a worst-case error bound against the
+// double path, for long closed-loop runs where only ADC codes matter.
+namespace ring_tf {
+
+typedef int32_t code_t;
+
+struct Wave {
+  double wavelength;
+  double power;
+};
+
+// Defaults match sim/tuner_search_lock/dut.sv
+struct ChainConfig {
+  double fwhm = 1.0;
+  double tuning_full_scale = 10.0;
+  double dac_full_scale = 1.0;
+  double adc_full_scale = 1.0;
+  double responsivity = 1.0;
+  int dac_width = 8;
+  int adc_width = 8;
+
+  code_t adc_max() const { return (code_t{1} << adc_width) - 1; }
+  code_t dac_max() const { return (code_t{1} << dac_width) - 1; }
+  // Resonance shift per DAC code (dac.sv times TuningFullScale)
+  double tune_step() const {
+    return dac_full_scale / dac_max() * tuning_full_scale;
+  }
+  // ADC codes per unit of photodetector current
+  double adc_gain() const { return adc_max() / adc_full_scale; }
+};
+
+// microring.sv lorentzian() in normalized detuning u = (x - x0) / (fwhm / 2)
+inline double lorentzian(double u) { return 1.0 / (1.0 + u * u); }
+
+// adc.sv quantization (ideal)
+inline code_t adc_code(const ChainConfig &cfg, double current) {
+  const double x = std::floor(current * cfg.adc_gain());
+  if (x < 0.0)
+    return 0;
+  if (x > cfg.adc_max())
+    return cfg.adc_max();
+  return static_cast<code_t>(x);
+}
+
+// ----------------------------------------------------------------------
+// Lorentzian table
+// ----------------------------------------------------------------------
+// Input u is Q16, output is Q16 (ONE == 1.0). Beyond U_MAX the response is
+// treated as zero.
+class LorentzianLut {
+public:
+  static constexpr int STEP_BITS = 6;
+  static constexpr int INTERP_BITS = 10;
+  static constexpr int U_BITS = STEP_BITS + INTERP_BITS;
+  static constexpr int U_MAX = 64;
+  static constexpr int VALUE_BITS = 16;
+  static constexpr int32_t ONE = int32_t{1} << VALUE_BITS;
+  static constexpr int SIZE = (U_MAX << STEP_BITS) + 1;
+
+  LorentzianLut() : table_(SIZE) {
+    for (int i = 0; i < SIZE; ++i) {
+      const double u = double(i) / (1 << STEP_BITS);
+      table_[i] = static_cast<int32_t>(std::lround(lorentzian(u) * ONE));
+    }
+  }
+
+  static const LorentzianLut &instance() {
+    static const LorentzianLut lut;
+    return lut;
+  }
+
+  int32_t eval_q(int64_t u_q) const {
+    const uint64_t a = static_cast<uint64_t>(u_q < 0 ? -u_q : u_q);
+    if (a >= (uint64_t(U_MAX) << U_BITS))
+      return 0;
+    const size_t idx = static_cast<size_t>(a >> INTERP_BITS);
+    const int32_t frac = static_cast<int32_t>(a & ((1u << INTERP_BITS) - 1));
+    const int32_t y0 = table_[idx];
+    const int32_t y1 = table_[idx + 1];
+    return y0 + (((y1 - y0) * frac) >> INTERP_BITS);
+  }
+
+  double eval(double u) const {
+    return double(eval_q(std::llround(u * (1 << U_BITS)))) / ONE;
+  }
+
+  // Worst-case |eval(u) - lorentzian(u)|
+  static double max_abs_error() {
+    const double h = 1.0 / (1 << STEP_BITS);
+    const double interp = h * h / 8.0 * 2.0; // max|L''| = 2 at u = 0
+    const double rounding = 0.5 / ONE;       // table entries
+    const double arith = 1.0 / ONE;          // interpolation floor
+    const double u_quant = 0.65 * 0.5 / (1 << U_BITS); // max|L'| ~ 0.65
+    const double tail = lorentzian(U_MAX);
+    return interp + rounding + arith + u_quant + tail;
+  }
+
+private:
+  std::vector<int32_t> table_;
+};
+// ----------------------------------------------------------------------
+
+// ----------------------------------------------------------------------
+// Single ring drop chain
+// ----------------------------------------------------------------------
+class RingDropDouble {
+public:
+  RingDropDouble(const ChainConfig &cfg, std::vector<Wave> waves,
+                 double wvl_ring)
+      : cfg_(cfg), waves_(std::move(waves)), wvl_ring_(wvl_ring) {}
+
+  void set_ring(double wvl_ring) { wvl_ring_ = wvl_ring; }
+
+  double current(code_t code) const {
+    return current_at(code * cfg_.tune_step());
+  }
+
+  // Drop current at a resonance shift (e.g. a HeaterRow output times
+  // tuning_full_scale) instead of a settled tune code
+  double current_at(double tune) const {
+    const double resonance = wvl_ring_ + tune;
+    const double hw = cfg_.fwhm / 2.0;
+    double pwr = 0.0;
+    for (const auto &w : waves_) {
+      pwr += w.power * lorentzian((w.wavelength - resonance) / hw);
+    }
+    return pwr * cfg_.responsivity;
+  }
+
+  code_t adc(code_t code) const { return adc_code(cfg_, current(code)); }
+
+private:
+  ChainConfig cfg_;
+  std::vector<Wave> waves_;
+  double wvl_ring_;
+};
+
+class RingDropLut {
+public:
+  RingDropLut(const ChainConfig &cfg, std::vector<Wave> waves, double wvl_ring,
+              const LorentzianLut &lut = LorentzianLut::instance())
+      : cfg_(cfg), waves_(std::move(waves)), lut_(lut) {
+    const double hw = cfg_.fwhm / 2.0;
+    du_q32_ = std::llround(cfg_.tune_step() / hw * kQ32);
+    gain_q16_.resize(waves_.size());
+    for (size_t i = 0; i < waves_.size(); ++i) {
+      gain_q16_[i] = std::llround(waves_[i].power * cfg_.responsivity *
+                                  cfg_.adc_gain() * (1 << 16));
+    }
+    u0_q32_.resize(waves_.size());
+    set_ring(wvl_ring);
+  }
+
+  void set_ring(double wvl_ring) {
+    const double hw = cfg_.fwhm / 2.0;
+    for (size_t i = 0; i < waves_.size(); ++i) {
+      u0_q32_[i] = std::llround((waves_[i].wavelength - wvl_ring) / hw * kQ32);
+    }
+  }
+
+  // Accumulated drop current in ADC LSB, Q32
+  int64_t acc_q32(code_t code) const {
+    int64_t acc = 0;
+    for (size_t i = 0; i < waves_.size(); ++i) {
+      const int64_t u_q = (u0_q32_[i] - code * du_q32_ + (1 << 15)) >> 16;
+      acc += gain_q16_[i] * lut_.eval_q(u_q);
+    }
+    return acc;
+  }
+
+  code_t adc(code_t code) const {
+    const int64_t c = acc_q32(code) >> 32;
+    if (c < 0)
+      return 0;
+    if (c > cfg_.adc_max())
+      return cfg_.adc_max();
+    return static_cast<code_t>(c);
+  }
+
+  double current(code_t code) const {
+    return double(acc_q32(code)) / kQ32 / cfg_.adc_gain();
+  }
+
+  // Worst-case |current - RingDropDouble::current| in ADC LSB. ADC codes of
+  // the two paths differ by at most ceil(error_bound_lsb()).
+  double error_bound_lsb() const {
+    double bound = 0.0;
+    for (const auto g : gain_q16_) {
+      bound += (double(g) / (1 << 16)) * LorentzianLut::max_abs_error() +
+               0.5 / (1 << 16);
+    }
+    return bound;
+  }
+
+private:
+  static constexpr double kQ32 = 4294967296.0;
+
+  ChainConfig cfg_;
+  std::vector<Wave> waves_;
+  const LorentzianLut &lut_;
+  int64_t du_q32_;
+  std::vector<int64_t> u0_q32_;
+  std::vector<int64_t> gain_q16_;
+};
+// ----------------------------------------------------------------------
+
+// ----------------------------------------------------------------------
+// Ring row (microringrow.sv): ring k sees the thru port of ring k-1
+// ----------------------------------------------------------------------
+class RingRowDouble {
+public:
+  RingRowDouble(const ChainConfig &cfg, std::vector<Wave> waves,
+                std::vector<double> wvl_rings)
+      : cfg_(cfg), waves_(std::move(waves)), wvl_rings_(std::move(wvl_rings)) {}
+
+  size_t num_rings() const { return wvl_rings_.size(); }
+  void set_ring(size_t ring, double wvl_ring) { wvl_rings_[ring] = wvl_ring; }
+
+  // Drop currents for all rings at the given tune codes
+  void evaluate(const code_t *codes, double *currents) const {
+    std::vector<double> tunes(wvl_rings_.size());
+    for (size_t r = 0; r < wvl_rings_.size(); ++r)
+      tunes[r] = codes[r] * cfg_.tune_step();
+    evaluate_tune(tunes.data(), currents);
+  }
+
+  // Drop currents for all rings at the given resonance shifts
+  void evaluate_tune(const double *tunes, double *currents) const {
+    const double hw = cfg_.fwhm / 2.0;
+    std::vector<double> pwr(waves_.size());
+    for (size_t i = 0; i < waves_.size(); ++i)
+      pwr[i] = waves_[i].power;
+    for (size_t r = 0; r < wvl_rings_.size(); ++r) {
+      const double resonance = wvl_rings_[r] + tunes[r];
+      double drop = 0.0;
+      for (size_t i = 0; i < waves_.size(); ++i) {
+        const double l = lorentzian((waves_[i].wavelength - resonance) / hw);
+        drop += pwr[i] * l;
+        pwr[i] *= 1.0 - l;
+      }
+      currents[r] = drop * cfg_.responsivity;
+    }
+  }
+
+  void evaluate_adc(const code_t *codes, code_t *adc_codes) const {
+    std::vector<double> currents(wvl_rings_.size());
+    evaluate(codes, currents.data());
+    for (size_t r = 0; r < wvl_rings_.size(); ++r)
+      adc_codes[r] = adc_code(cfg_, currents[r]);
+  }
+
+private:
+  ChainConfig cfg_;
+  std::vector<Wave> waves_;
+  std::vector<double> wvl_rings_;
+};
+
+class RingRowLut {
+public:
+  RingRowLut(const ChainConfig &cfg, std::vector<Wave> waves,
+             std::vector<double> wvl_rings,
+             const LorentzianLut &lut = LorentzianLut::instance())
+      : cfg_(cfg), waves_(std::move(waves)), lut_(lut),
+        num_rings_(wvl_rings.size()) {
+    const double hw = cfg_.fwhm / 2.0;
+    du_q32_ = std::llround(cfg_.tune_step() / hw * kQ32);
+    gain_q16_.resize(waves_.size());
+    for (size_t i = 0; i < waves_.size(); ++i) {
+      gain_q16_[i] = std::llround(waves_[i].power * cfg_.responsivity *
+                                  cfg_.adc_gain() * (1 << 16));
+    }
+    u0_q32_.resize(num_rings_ * waves_.size());
+    for (size_t r = 0; r < num_rings_; ++r)
+      set_ring(r, wvl_rings[r]);
+  }
+
+  size_t num_rings() const { return num_rings_; }
+
+  void set_ring(size_t ring, double wvl_ring) {
+    const double hw = cfg_.fwhm / 2.0;
+    for (size_t i = 0; i < waves_.size(); ++i) {
+      u0_q32_[ring * waves_.size() + i] =
+          std::llround((waves_[i].wavelength - wvl_ring) / hw * kQ32);
+    }
+  }
+
+  // Drop current per ring in ADC LSB, Q48. The remaining power fraction per
+  // wave is carried in Q32 down the row.
+  void evaluate_q48(const code_t *codes, uint64_t *acc) const {
+    std::vector<uint64_t> remain(waves_.size(), uint64_t{1} << 32);
+    for (size_t r = 0; r < num_rings_; ++r) {
+      uint64_t drop = 0;
+      for (size_t i = 0; i < waves_.size(); ++i) {
+        const int64_t u_q =
+            (u0_q32_[r * waves_.size() + i] - codes[r] * du_q32_ + (1 << 15)) >>
+            16;
+        const uint64_t l = static_cast<uint64_t>(lut_.eval_q(u_q));
+        drop += static_cast<uint64_t>(gain_q16_[i]) * ((remain[i] * l) >> 16);
+        remain[i] = (remain[i] * (LorentzianLut::ONE - l)) >> 16;
+      }
+      acc[r] = drop;
+    }
+  }
+
+  void evaluate_adc(const code_t *codes, code_t *adc_codes) const {
+    std::vector<uint64_t> acc(num_rings_);
+    evaluate_q48(codes, acc.data());
+    for (size_t r = 0; r < num_rings_; ++r) {
+      const uint64_t c = acc[r] >> 48;
+      adc_codes[r] = c > uint64_t(cfg_.adc_max()) ? cfg_.adc_max()
+                                                  : static_cast<code_t>(c);
+    }
+  }
+
+  void evaluate(const code_t *codes, double *currents) const {
+    std::vector<uint64_t> acc(num_rings_);
+    evaluate_q48(codes, acc.data());
+    for (size_t r = 0; r < num_rings_; ++r)
+      currents[r] = double(acc[r]) / kQ48 / cfg_.adc_gain();
+  }
+
+  // Ring k accumulates the table error of every ring up to and including k
+  double error_bound_lsb(size_t ring) const {
+    double bound = 0.0;
+    for (const auto g : gain_q16_) {
+      bound += (double(g) / (1 << 16)) *
+                   (ring + 1) * (LorentzianLut::max_abs_error() + 1.0 / kQ32) +
+               0.5 / (1 << 16);
+    }
+    return bound;
+  }
+
+private:
+  static constexpr double kQ32 = 4294967296.0;
+  static constexpr double kQ48 = 281474976710656.0;
+
+  ChainConfig cfg_;
+  std::vector<Wave> waves_;
+  const LorentzianLut &lut_;
+  size_t num_rings_;
+  int64_t du_q32_;
+  std::vector<int64_t> u0_q32_;
+  std::vector<int64_t> gain_q16_;
+};
+
+
+// Incremental RingRowLut. During lock usually one ring moves per cycle, yet
+// a full evaluation walks every ring and wave. Here each ring keeps its
+// transfer factors per tune code (only the waves inside the table range,
+// the rest are exactly zero and pass through), each wave keeps the rings it
+// interacts with, and a code change only re-walks the affected waves from
+// the changed ring down, stopping once the remaining power matches the
+// previous evaluation. Results are bit-exact with RingRowLut, and the cost
+// of an evaluation scales with the changed (ring, wave) pairs plus an O(1)
+// compare per ring.
+class RingRowCascade {
+public:
+  RingRowCascade(const ChainConfig &cfg, std::vector<Wave> waves,
+                 std::vector<double> wvl_rings,
+                 const LorentzianLut &lut = LorentzianLut::instance())
+      : cfg_(cfg), waves_(std::move(waves)), lut_(lut),
+        num_rings_(wvl_rings.size()), num_waves_(waves_.size()) {
+    const double hw = cfg_.fwhm / 2.0;
+    du_q32_ = std::llround(cfg_.tune_step() / hw * kQ32);
+    gain_q16_.resize(num_waves_);
+    for (size_t i = 0; i < num_waves_; ++i) {
+      gain_q16_[i] = std::llround(waves_[i].power * cfg_.responsivity *
+                                  cfg_.adc_gain() * (1 << 16));
+    }
+    const size_t n = num_rings_ * num_waves_;
+    u0_q32_.resize(n);
+    l_.assign(n, 0);
+    remain_.assign(n, 0);
+    term_.assign(n, 0);
+    drop_.assign(num_rings_, 0);
+    code_.assign(num_rings_, kNoCode);
+    factors_.resize(num_rings_);
+    rings_of_.resize(num_waves_);
+    dirty_from_.assign(num_waves_, kClean);
+    dirty_to_.assign(num_waves_, 0);
+    for (size_t r = 0; r < num_rings_; ++r)
+      set_ring(r, wvl_rings[r]);
+  }
+
+  size_t num_rings() const { return num_rings_; }
+
+  // Drops the ring's cached factors, which depend on its resonance
+  void set_ring(size_t ring, double wvl_ring) {
+    const double hw = cfg_.fwhm / 2.0;
+    factor_list_t prev;
+    if (code_[ring] != kNoCode)
+      prev = factors(ring, code_[ring]);
+    for (size_t i = 0; i < num_waves_; ++i) {
+      u0_q32_[ring * num_waves_ + i] =
+          std::llround((waves_[i].wavelength - wvl_ring) / hw * kQ32);
+    }
+    factors_[ring].assign(cfg_.dac_max() + 1, factor_cache_t());
+    if (code_[ring] != kNoCode)
+      apply_factors(ring, prev, factors(ring, code_[ring]));
+  }
+
+  // Codes within [0, dac_max]
+  void set_code(size_t ring, code_t code) {
+    if (code == code_[ring])
+      return;
+    static const factor_list_t kNone;
+    const factor_list_t &prev =
+        code_[ring] == kNoCode ? kNone : factors(ring, code_[ring]);
+    code_[ring] = code;
+    apply_factors(ring, prev, factors(ring, code));
+  }
+
+  // Re-walk the dirty waves; returns the (ring, wave) pairs recomputed
+  size_t update() {
+    size_t updates = 0;
+    for (const uint32_t i : dirty_waves_) {
+      const auto &rings = rings_of_[i];
+      auto it = std::lower_bound(rings.begin(), rings.end(), dirty_from_[i]);
+      uint64_t remain = uint64_t{1} << 32;
+      if (it != rings.begin()) {
+        const size_t p = *(it - 1) * num_waves_ + i;
+        remain = (remain_[p] * (LorentzianLut::ONE - l_[p])) >> 16;
+      }
+      for (; it != rings.end(); ++it) {
+        const size_t r = *it;
+        const size_t k = r * num_waves_ + i;
+        if (r > dirty_to_[i] && remain == remain_[k])
+          break;
+        remain_[k] = remain;
+        const uint64_t term =
+            static_cast<uint64_t>(gain_q16_[i]) * ((remain * l_[k]) >> 16);
+        drop_[r] += term - term_[k];
+        term_[k] = term;
+        remain = (remain * (LorentzianLut::ONE - l_[k])) >> 16;
+        ++updates;
+      }
+      dirty_from_[i] = kClean;
+      dirty_to_[i] = 0;
+    }
+    dirty_waves_.clear();
+    return updates;
+  }
+
+  // Drop current per ring in ADC LSB, Q48 (RingRowLut::evaluate_q48)
+  void evaluate_q48(const code_t *codes, uint64_t *acc) {
+    for (size_t r = 0; r < num_rings_; ++r)
+      set_code(r, codes[r]);
+    update();
+    for (size_t r = 0; r < num_rings_; ++r)
+      acc[r] = drop_[r];
+  }
+
+  void evaluate_adc(const code_t *codes, code_t *adc_codes) {
+    for (size_t r = 0; r < num_rings_; ++r)
+      set_code(r, codes[r]);
+    update();
+    for (size_t r = 0; r < num_rings_; ++r) {
+      const uint64_t c = drop_[r] >> 48;
+      adc_codes[r] = c > uint64_t(cfg_.adc_max()) ? cfg_.adc_max()
+                                                  : static_cast<code_t>(c);
+    }
+  }
+
+  void evaluate(const code_t *codes, double *currents) {
+    for (size_t r = 0; r < num_rings_; ++r)
+      set_code(r, codes[r]);
+    update();
+    for (size_t r = 0; r < num_rings_; ++r)
+      currents[r] = double(drop_[r]) / kQ48 / cfg_.adc_gain();
+  }
+
+private:
+  typedef std::vector<std::pair<uint32_t, int32_t>> factor_list_t;
+
+  static constexpr double kQ32 = 4294967296.0;
+  static constexpr double kQ48 = 281474976710656.0;
+  static constexpr code_t kNoCode = -1;
+  static constexpr uint32_t kClean = UINT32_MAX;
+
+  struct factor_cache_t {
+    bool valid = false;
+    factor_list_t list;
+  };
+
+  // Nonzero factors of a ring at a code, computed once per (ring, code)
+  const factor_list_t &factors(size_t ring, code_t code) {
+    factor_cache_t &f = factors_[ring][code];
+    if (!f.valid) {
+      for (size_t i = 0; i < num_waves_; ++i) {
+        const int64_t u_q =
+            (u0_q32_[ring * num_waves_ + i] - code * du_q32_ + (1 << 15)) >>
+            16;
+        const int32_t l = lut_.eval_q(u_q);
+        if (l != 0)
+          f.list.emplace_back(static_cast<uint32_t>(i), l);
+      }
+      f.valid = true;
+    }
+    return f.list;
+  }
+
+  // Merge two sparse factor lists of a ring (both sorted by wave)
+  void apply_factors(size_t ring, const factor_list_t &prev,
+                     const factor_list_t &next) {
+    size_t a = 0, b = 0;
+    while (a < prev.size() || b < next.size()) {
+      const uint32_t wa = a < prev.size() ? prev[a].first : kClean;
+      const uint32_t wb = b < next.size() ? next[b].first : kClean;
+      if (wa == wb) {
+        if (prev[a].second != next[b].second)
+          set_factor(ring, wa, next[b].second);
+        ++a;
+        ++b;
+      } else if (wa < wb) {
+        set_factor(ring, wa, 0);
+        ++a;
+      } else {
+        set_factor(ring, wb, next[b].second);
+        ++b;
+      }
+    }
+  }
+
+  void set_factor(size_t ring, uint32_t wave, int32_t l) {
+    const size_t k = ring * num_waves_ + wave;
+    auto &rings = rings_of_[wave];
+    auto it = std::lower_bound(rings.begin(), rings.end(), ring);
+    const bool member = it != rings.end() && *it == ring;
+    if (l == 0 && member) {
+      // Passes the wave through untouched from now on
+      rings.erase(it);
+      drop_[ring] -= term_[k];
+      term_[k] = 0;
+    } else if (l != 0 && !member) {
+      rings.insert(it, static_cast<uint32_t>(ring));
+    }
+    l_[k] = l;
+    if (dirty_from_[wave] == kClean)
+      dirty_waves_.push_back(wave);
+    dirty_from_[wave] =
+        std::min(dirty_from_[wave], static_cast<uint32_t>(ring));
+    dirty_to_[wave] = std::max(dirty_to_[wave], static_cast<uint32_t>(ring));
+  }
+
+  ChainConfig cfg_;
+  std::vector<Wave> waves_;
+  const LorentzianLut &lut_;
+  size_t num_rings_;
+  size_t num_waves_;
+  int64_t du_q32_;
+  std::vector<int64_t> u0_q32_;
+  std::vector<int64_t> gain_q16_;
+
+  // Per (ring, wave), ring-major: factor, remaining power into the ring
+  // (Q32) and drop contribution (Q48)
+  std::vector<int32_t> l_;
+  std::vector<uint64_t> remain_;
+  std::vector<uint64_t> term_;
+  std::vector<uint64_t> drop_;
+  std::vector<code_t> code_;
+  std::vector<std::vector<factor_cache_t>> factors_;
+  // Rings with a nonzero factor per wave, ascending
+  std::vector<std::vector<uint32_t>> rings_of_;
+  std::vector<uint32_t> dirty_waves_;
+  std::vector<uint32_t> dirty_from_;
+  std::vector<uint32_t> dirty_to_;
+};
+// ----------------------------------------------------------------------
+
+// ----------------------------------------------------------------------
+// Heater thermal dynamics (heater.sv)
+// ----------------------------------------------------------------------
+// First-order IIR per ring between the DAC output (drive) and the ring
+// tuning input, with nearest-neighbour coupling k:
+//   u[i] = d[i] + k * (d[i-1] + d[i+1])
+//   o[i] = (1 - a) * t[i] + a * u[i],  a = 1 - exp(-1 / tau),  t[i] <= o[i]
+// tau is in clock cycles; tau = 0 (a = 1) passes the coupled drive through.
+class HeaterRow {
+public:
+  explicit HeaterRow(size_t num_rings, double tau_cycles = 0.0,
+                     double coupling = 0.0)
+      : tau_cycles_(tau_cycles), coupling_(coupling),
+        alpha_(alpha(tau_cycles)), temp_(num_rings, 0.0),
+        coupled_(num_rings, 0.0) {}
+
+  static double alpha(double tau_cycles) {
+    return tau_cycles > 0.0 ? 1.0 - std::exp(-1.0 / tau_cycles) : 1.0;
+  }
+
+  size_t num_rings() const { return temp_.size(); }
+  double tau_cycles() const { return tau_cycles_; }
+  double coupling() const { return coupling_; }
+
+  // i_rst: every heater settled at its coupled drive
+  void reset(const double *drive) {
+    couple(drive);
+    temp_ = coupled_;
+  }
+
+  // One clock: tune is what the rings see in the cycle drive is applied
+  void step(const double *drive, double *tune) {
+    couple(drive);
+    for (size_t i = 0; i < temp_.size(); ++i) {
+      tune[i] = (1.0 - alpha_) * temp_[i] + alpha_ * coupled_[i];
+      temp_[i] = tune[i];
+    }
+  }
+
+  // Cycles after a drive step until the remaining error is below tol (same
+  // units as step), counting the cycle the step is applied in. This is the
+  // wait a power detector needs to sample a settled ring.
+  static uint64_t settle_cycles(double tau_cycles, double step, double tol) {
+    const double a = alpha(tau_cycles);
+    step = std::fabs(step);
+    if (a >= 1.0 || step <= tol)
+      return 1;
+    // Error after n cycles is step * (1 - a)^n
+    const double n = std::log(step / tol) / -std::log(1.0 - a);
+    return static_cast<uint64_t>(std::ceil(n));
+  }
+
+private:
+  void couple(const double *drive) {
+    const size_t n = temp_.size();
+    for (size_t i = 0; i < n; ++i) {
+      double u = drive[i];
+      if (i > 0)
+        u += coupling_ * drive[i - 1];
+      if (i + 1 < n)
+        u += coupling_ * drive[i + 1];
+      coupled_[i] = u;
+    }
+  }
+
+  double tau_cycles_;
+  double coupling_;
+  double alpha_;
+  std::vector<double> temp_;
+  std::vector<double> coupled_;
+};
+// ----------------------------------------------------------------------
+
+} // namespace ring_tf
+
+#endif // RING_TF_HPP
@@ -0,0 +1,111 @@
+#ifndef ROW_FF_HPP
+#define ROW_FF_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace row_ff {
+
+typedef int32_t code_t;
+
+// Cycle model of tuner_row_ff: common-mode offload of the lock corrections
+// and first-order heater crosstalk compensation between the per-ring tune
+// codes and the DACs. Bit-exact with the RTL for DAC_WIDTH = 8.
+class RowFeedforward {
+public:
+  static constexpr int DAC_WIDTH = 8;
+  static constexpr int FRAC_WIDTH = 16;
+  static constexpr code_t CODE_MAX = (1 << DAC_WIDTH) - 1;
+
+  explicit RowFeedforward(size_t num_rings)
+      : xtalk_(num_rings * num_rings, 0), ref_(num_rings, 0),
+        active_prev_(num_rings, false), code_(num_rings, 0) {}
+
+  size_t num_rings() const { return ref_.size(); }
+
+  void configure(bool cm_en, int cm_shift) {
+    cm_en_ = cm_en;
+    cm_shift_ = std::clamp(cm_shift, 0, 15);
+  }
+
+  // Fraction of ring j's drive seen by ring i, in 1/256 (i_cfg_ff_xtalk)
+  void set_xtalk(size_t i, size_t j, int coef) {
+    xtalk_[i * num_rings() + j] = std::clamp(coef, -128, 127);
+  }
+
+  void reset() {
+    std::fill(ref_.begin(), ref_.end(), 0);
+    std::fill(active_prev_.begin(), active_prev_.end(), false);
+    acc_ = 0;
+  }
+
+  // Combinational outputs for this cycle's tune codes
+  void apply(const code_t *tune, code_t *out) {
+    const size_t n = num_rings();
+    const code_t cm = ff_cm();
+    for (size_t i = 0; i < n; ++i)
+      code_[i] = clamp_code(tune[i] + cm);
+    for (size_t i = 0; i < n; ++i) {
+      int64_t sum = 0;
+      for (size_t j = 0; j < n; ++j)
+        if (j != i)
+          sum += static_cast<int64_t>(xtalk_[i * n + j]) * code_[j];
+      out[i] = clamp_code(code_[i] - static_cast<code_t>(floor_shift(sum, 8)));
+    }
+  }
+
+  // Clock edge
+  void step(const code_t *tune, const bool *lock_active) {
+    const size_t n = num_rings();
+    int64_t sum = 0;
+    int64_t cnt = 0;
+    for (size_t i = 0; i < n; ++i) {
+      if (lock_active[i] && active_prev_[i]) {
+        sum += tune[i] - ref_[i];
+        ++cnt;
+      }
+    }
+    if (!cm_en_) {
+      acc_ = 0;
+    } else if (cnt != 0) {
+      // Truncating division, as SV
+      const int64_t mean = sum / cnt;
+      const int64_t lim = static_cast<int64_t>(CODE_MAX) << FRAC_WIDTH;
+      acc_ = std::clamp(acc_ + floor_shift(mean * (1 << FRAC_WIDTH), cm_shift_),
+                        -lim, lim);
+    }
+    for (size_t i = 0; i < n; ++i) {
+      if (lock_active[i] && !active_prev_[i])
+        ref_[i] = tune[i];
+      active_prev_[i] = lock_active[i];
+    }
+  }
+
+  // o_dig_ff_cm
+  code_t ff_cm() const {
+    return static_cast<code_t>(floor_shift(acc_, FRAC_WIDTH));
+  }
+
+private:
+  static code_t clamp_code(int64_t code) {
+    return static_cast<code_t>(std::clamp<int64_t>(code, 0, CODE_MAX));
+  }
+
+  // >>> on a signed value
+  static int64_t floor_shift(int64_t v, int s) {
+    return v >= 0 ? v >> s : -((-v + (int64_t{1} << s) - 1) >> s);
+  }
+
+  bool cm_en_ = false;
+  int cm_shift_ = 8;
+  std::vector<int> xtalk_;
+  std::vector<code_t> ref_;
+  std::vector<bool> active_prev_;
+  std::vector<code_t> code_;
+  int64_t acc_ = 0;
+};
+
+} // namespace row_ff
+
+#endif // ROW_FF_HPP
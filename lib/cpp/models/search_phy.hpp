@@ -1,6 +1,7 @@
 #ifndef SEARCH_PHY_HPP
 #define SEARCH_PHY_HPP
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 
@@ -8,6 +9,33 @@ namespace search_phy {
 
 typedef uint32_t code_t;
 
+// Fixed-point Lorentzian fit, bit-exact with tuner_search_phy fit mode.
+// 1/pwr of a Lorentzian is a parabola in the tune code, so samples y0, y1,
+// y2 at x1-h, x1, x1+h around a local maximum give the resonance code
+//   x0 = x1 + h * (u0 - u2) / (2 * (u0 - 2*u1 + u2)),  u = 1/y
+// rounded to the nearest code. Zero-power tails return x1.
+constexpr int FIT_RECIP_SHIFT = 16;
+constexpr int FIT_FRAC_BITS = 4;
+
+inline code_t lorentzian_fit_code(code_t x1, code_t h, code_t y0, code_t y1,
+                                  code_t y2, int dac_width = 8) {
+  if (y0 == 0 || y1 == 0 || y2 == 0)
+    return x1;
+  const int64_t u0 = (int64_t(1) << FIT_RECIP_SHIFT) / y0;
+  const int64_t u1 = (int64_t(1) << FIT_RECIP_SHIFT) / y1;
+  const int64_t u2 = (int64_t(1) << FIT_RECIP_SHIFT) / y2;
+  const int64_t num = (u0 - u2) * int64_t(h) * (int64_t(1) << FIT_FRAC_BITS);
+  const int64_t den = 2 * (u0 - 2 * u1 + u2);
+  int64_t offset = den > 0 ? num / den : 0;
+  const int64_t limit = int64_t(h) << FIT_FRAC_BITS;
+  offset = std::clamp(offset, -limit, limit);
+  int64_t code = ((int64_t(x1) << FIT_FRAC_BITS) + offset +
+                  (int64_t(1) << (FIT_FRAC_BITS - 1))) >>
+                 FIT_FRAC_BITS;
+  code = std::clamp<int64_t>(code, 0, (int64_t(1) << dac_width) - 1);
+  return static_cast<code_t>(code);
+}
+
 enum class search_state_e : uint8_t {
   SEARCH_IDLE = 0,
   SEARCH_INIT = 1,
@@ -23,13 +51,16 @@ public:
   static constexpr int ADC_WIDTH = 8;
   static constexpr int NUM_TARGET = 8;
   static constexpr int PEAK_WINDOW_SIZE = 3; // simple three-sample window
+  static constexpr code_t FIT_MIN_PWR = 16;   // SEARCH_FIT_MIN_PWR
 
   SearchPhyModel() { reset(); }
 
-  void configure(uint8_t start, uint8_t end, uint8_t stride) {
+  void configure(uint8_t start, uint8_t end, uint8_t stride,
+                 bool fit_mode = false) {
     cfg_start_ = start;
     cfg_end_ = end;
     cfg_stride_ = stride;
+    cfg_fit_mode_ = fit_mode;
   }
 
   void reset() {
@@ -62,7 +93,18 @@ public:
     tune_window_[0] = ring_tune_;
     pwr_window_[0] = power_sample;
 
-    if (sample_cnt_ >= 2) {
+    if (sample_cnt_ >= 2 && cfg_fit_mode_) {
+      // Window is newest first: [0] = x1+h, [1] = x1, [2] = x1-h
+      if (pwr_window_[1] > pwr_window_[2] &&
+          pwr_window_[1] >= pwr_window_[0] &&
+          pwr_window_[1] >= FIT_MIN_PWR && peak_count_ < NUM_TARGET) {
+        ring_tune_peaks_[peak_count_] = lorentzian_fit_code(
+            tune_window_[1], ring_tune_step_, pwr_window_[2], pwr_window_[1],
+            pwr_window_[0], DAC_WIDTH);
+        pwr_peaks_[peak_count_] = pwr_window_[1];
+        ++peak_count_;
+      }
+    } else if (sample_cnt_ >= 2) {
       if (pwr_window_[1] > pwr_window_[0] && pwr_window_[1] > pwr_window_[2]) {
         if (peak_count_ < NUM_TARGET) {
           ring_tune_peaks_[peak_count_] = tune_window_[1];
@@ -85,12 +127,15 @@ public:
   const std::array<code_t, NUM_TARGET> &pwr_peaks() const { return pwr_peaks_; }
   code_t peaks_cnt() const { return peak_count_; }
   code_t ring_tune() const { return ring_tune_; }
+  // Tune transactions issued so far
+  code_t samples() const { return sample_cnt_; }
   search_state_e state() const { return state_; }
 
 private:
   code_t cfg_start_ = 0;
   code_t cfg_end_ = 0;
   code_t cfg_stride_ = 0;
+  bool cfg_fit_mode_ = false;
 
   search_state_e state_ = search_state_e::SEARCH_IDLE;
   code_t ring_tune_ = 0;
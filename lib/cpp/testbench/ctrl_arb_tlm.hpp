@@ -0,0 +1,106 @@
+#ifndef TESTBENCH_CTRL_ARB_TLM_HPP
+#define TESTBENCH_CTRL_ARB_TLM_HPP
+
+#include "models/ctrl_arb_txn.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+// DPI-C side of tuner_ctrl_arb_tlm.sv (tuner_phy CTRL_ARB_TLM=1). Each TLM
+// arbiter instance opens a CtrlArbTransactor under its hierarchical name;
+// the bench reads them back to turn simulated cycles into RTL cycles.
+// Include from exactly one translation unit of the bench: it defines the
+// DPI functions, which a model built without CTRL_ARB_TLM never calls.
+namespace ctrl_arb_tlm {
+
+typedef ctrl_arb_txn::CtrlArbTransactor transactor_t;
+
+class Registry {
+public:
+  static Registry &instance() {
+    static Registry registry;
+    return registry;
+  }
+
+  // Kept across models, so a rebuilt model with the same hierarchy (e.g.
+  // in-process runs) reuses the instance; the SV side resets it
+  transactor_t *open(const std::string &name) {
+    auto &t = transactors_[name];
+    if (!t)
+      t = std::make_unique<transactor_t>();
+    return t.get();
+  }
+
+  const std::map<std::string, std::unique_ptr<transactor_t>> &
+  transactors() const {
+    return transactors_;
+  }
+
+  bool empty() const { return transactors_.empty(); }
+
+  // ARB_CTRL_SYNC cycles skipped so far by the slowest instance, i.e. what a
+  // single-arbiter bench adds to its simulated cycle count
+  uint64_t skipped_cycles() const {
+    uint64_t skipped = 0;
+    for (const auto &kv : transactors_)
+      skipped = std::max(skipped, kv.second->skipped_cycles());
+    return skipped;
+  }
+
+  uint64_t transactions() const {
+    uint64_t n = 0;
+    for (const auto &kv : transactors_)
+      n += kv.second->transactions();
+    return n;
+  }
+
+private:
+  std::map<std::string, std::unique_ptr<transactor_t>> transactors_;
+};
+
+} // namespace ctrl_arb_tlm
+
+// Signatures follow the imports in tuner_ctrl_arb_tlm.sv (chandle -> void *,
+// longint -> long long, output int -> int *)
+extern "C" {
+
+void *tuner_ctrl_arb_tlm_open(const char *name) {
+  return ctrl_arb_tlm::Registry::instance().open(name);
+}
+
+void tuner_ctrl_arb_tlm_reset(void *tlm) {
+  static_cast<ctrl_arb_tlm::transactor_t *>(tlm)->reset();
+}
+
+void tuner_ctrl_arb_tlm_inputs(void *tlm, long long cycle, int active,
+                               int mode, int wait_cycle, int avg_shift,
+                               int settle_tol) {
+  ctrl_arb_txn::DetectConfig cfg;
+  cfg.mode = static_cast<ctrl_arb_txn::detect_mode_e>(mode);
+  cfg.wait_cycle = wait_cycle;
+  cfg.avg_shift = avg_shift;
+  cfg.settle_tol = settle_tol;
+  static_cast<ctrl_arb_tlm::transactor_t *>(tlm)->set_inputs(
+      static_cast<uint64_t>(cycle), active != 0, cfg);
+}
+
+void tuner_ctrl_arb_tlm_refresh(void *tlm, long long cycle) {
+  static_cast<ctrl_arb_tlm::transactor_t *>(tlm)->refresh(
+      static_cast<uint64_t>(cycle));
+}
+
+void tuner_ctrl_arb_tlm_txn(void *tlm, long long cycle, int ring_tune,
+                            int sample, int sync_cycle, int *pwr_commit,
+                            int *ring_tune_commit) {
+  const auto r = static_cast<ctrl_arb_tlm::transactor_t *>(tlm)->transact(
+      static_cast<uint64_t>(cycle), ring_tune, sample, sync_cycle);
+  *pwr_commit = r.pwr_commit;
+  *ring_tune_commit = r.ring_tune_commit;
+}
+
+} // extern "C"
+
+#endif // TESTBENCH_CTRL_ARB_TLM_HPP
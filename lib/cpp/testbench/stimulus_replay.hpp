@@ -0,0 +1,309 @@
+#ifndef TESTBENCH_STIMULUS_REPLAY_HPP
+#define TESTBENCH_STIMULUS_REPLAY_HPP
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Replays recorded stimulus (laser power, temperature, ...) into DUT ports.
+//
+// The trace is a CSV whose first column is the capture time in seconds and
+// whose header names the remaining columns:
+//   time,pwr,temp
+//   0.0,1.000,25.00
+//   0.1,0.998,25.01
+// The file is memory-mapped and parsed forward only as simulation time
+// reaches it, so multi-hour captures cost nothing up front. Rows that fall
+// between two updates are skipped without parsing their values.
+namespace stimulus_replay {
+
+// Read-only mapping of a whole file
+class MappedFile {
+public:
+  explicit MappedFile(const std::string &filename) {
+    fd_ = ::open(filename.c_str(), O_RDONLY);
+    if (fd_ < 0)
+      throw std::runtime_error("stimulus_replay: cannot open " + filename);
+    struct stat st;
+    if (::fstat(fd_, &st) != 0) {
+      ::close(fd_);
+      throw std::runtime_error("stimulus_replay: cannot stat " + filename);
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ > 0) {
+      void *p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+      if (p == MAP_FAILED) {
+        ::close(fd_);
+        throw std::runtime_error("stimulus_replay: cannot map " + filename);
+      }
+      data_ = static_cast<const char *>(p);
+      ::madvise(p, size_, MADV_SEQUENTIAL);
+    }
+  }
+  ~MappedFile() {
+    if (data_)
+      ::munmap(const_cast<char *>(data_), size_);
+    if (fd_ >= 0)
+      ::close(fd_);
+  }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  const char *begin() const { return data_; }
+  const char *end() const { return data_ + size_; }
+  size_t size() const { return size_; }
+
+private:
+  int fd_ = -1;
+  const char *data_ = nullptr;
+  size_t size_ = 0;
+};
+
+// Forward-only row cursor over the mapped CSV
+class StimulusFile {
+public:
+  explicit StimulusFile(const std::string &filename) : file_(filename) {
+    pos_ = file_.begin();
+    const char *eol = line_end(pos_);
+    const char *p = pos_;
+    while (p < eol) {
+      const char *comma = static_cast<const char *>(
+          std::memchr(p, ',', static_cast<size_t>(eol - p)));
+      const char *field_end = comma ? comma : eol;
+      columns_.emplace_back(p, trim_cr(p, field_end));
+      p = comma ? comma + 1 : eol;
+    }
+    if (columns_.size() < 2)
+      throw std::runtime_error("stimulus_replay: " + filename +
+                               " needs a time column and one value column");
+    pos_ = next_line(eol);
+  }
+
+  // Column names, time first
+  const std::vector<std::string> &columns() const { return columns_; }
+
+  int column(const std::string &name) const {
+    for (size_t c = 0; c < columns_.size(); ++c) {
+      if (columns_[c] == name)
+        return static_cast<int>(c);
+    }
+    return -1;
+  }
+
+  bool eof() const { return pos_ >= file_.end(); }
+
+  // Time of the next row without consuming it; false at end of file
+  bool peek_time(double &t) const {
+    const char *eol = line_end(pos_);
+    const char *comma = static_cast<const char *>(
+        std::memchr(pos_, ',', static_cast<size_t>(eol - pos_)));
+    return !eof() && parse(pos_, comma ? comma : eol, t);
+  }
+
+  // Consume the next row without parsing its values
+  void skip_row() { pos_ = next_line(line_end(pos_)); }
+
+  // Consume every row with time <= t, parsing only the last of them into
+  // values. Returns the number of rows consumed.
+  uint64_t read_last_at_or_before(double t, double *values) {
+    const char *last = nullptr;
+    uint64_t n = 0;
+    double t_next;
+    while (peek_time(t_next) && t_next <= t) {
+      last = pos_;
+      skip_row();
+      ++n;
+    }
+    if (last) {
+      const char *resume = pos_;
+      pos_ = last;
+      read_row(values);
+      pos_ = resume;
+    }
+    return n;
+  }
+
+  // Consume the next row; values gets one entry per column, time first
+  bool read_row(double *values) {
+    if (eof())
+      return false;
+    const char *eol = line_end(pos_);
+    const char *p = pos_;
+    for (size_t c = 0; c < columns_.size(); ++c) {
+      const char *comma = static_cast<const char *>(
+          std::memchr(p, ',', static_cast<size_t>(eol - p)));
+      const char *field_end = comma ? comma : eol;
+      if (!parse(p, field_end, values[c]))
+        throw std::runtime_error("stimulus_replay: malformed row at byte " +
+                                 std::to_string(pos_ - file_.begin()));
+      p = comma ? comma + 1 : eol;
+    }
+    pos_ = next_line(eol);
+    return true;
+  }
+
+private:
+  const char *line_end(const char *p) const {
+    const char *eol = static_cast<const char *>(
+        std::memchr(p, '\n', static_cast<size_t>(file_.end() - p)));
+    return eol ? eol : file_.end();
+  }
+
+  // Step past the newline and any blank lines
+  const char *next_line(const char *eol) const {
+    const char *p = eol < file_.end() ? eol + 1 : eol;
+    while (p < file_.end() && (*p == '\n' || *p == '\r'))
+      ++p;
+    return p;
+  }
+
+  static const char *trim_cr(const char *first, const char *last) {
+    while (last > first && (last[-1] == '\r' || last[-1] == ' '))
+      --last;
+    return last;
+  }
+
+  static bool parse(const char *first, const char *last, double &v) {
+    while (first < last && *first == ' ')
+      ++first;
+    last = trim_cr(first, last);
+    // from_chars rejects a leading '+'
+    if (first < last && *first == '+')
+      ++first;
+    const auto r = std::from_chars(first, last, v);
+    return r.ec == std::errc() && r.ptr == last;
+  }
+
+  MappedFile file_;
+  const char *pos_ = nullptr;
+  std::vector<std::string> columns_;
+};
+
+// Drives double-typed (real) DUT ports from a stimulus file.
+//
+// Simulation time maps to trace time as
+//   t_trace = trace_start + time_ps * trace_per_ps
+// so trace_per_ps compresses hours of capture into a feasible cycle count.
+// Values are linearly interpolated between the two rows bracketing t_trace
+// and held at the first/last row outside the capture. update() is meant to
+// be called every cycle; with update_interval_ps set it only re-interpolates
+// that often, and once the capture is exhausted it returns immediately.
+class StimulusReplay {
+public:
+  StimulusReplay(const std::string &filename, double trace_per_ps,
+                 double trace_start = 0.0, uint64_t update_interval_ps = 0)
+      : file_(filename), trace_per_ps_(trace_per_ps),
+        trace_start_(trace_start), update_interval_ps_(update_interval_ps),
+        lo_(file_.columns().size(), 0.0), hi_(file_.columns().size(), 0.0) {
+    if (!file_.read_row(lo_.data()))
+      throw std::runtime_error("stimulus_replay: " + filename + " has no rows");
+    hi_ = lo_;
+    rows_read_ = 1;
+    if (file_.read_row(hi_.data()))
+      ++rows_read_;
+    last_t_ = trace_start_;
+  }
+
+  bool has_column(const std::string &name) const {
+    return file_.column(name) > 0;
+  }
+
+  // port = offset + gain * column
+  void bind(const std::string &name, double *port, double gain = 1.0,
+            double offset = 0.0) {
+    bindings_.push_back({value_column(name), port, gain, offset});
+  }
+
+  void update(uint64_t time_ps) {
+    if (time_ps < next_update_ps_)
+      return;
+    next_update_ps_ = time_ps + update_interval_ps_;
+    if (held_)
+      return;
+    last_t_ = trace_start_ + static_cast<double>(time_ps) * trace_per_ps_;
+    if (last_t_ >= hi_[0])
+      advance(last_t_);
+    const double frac = fraction();
+    for (const auto &b : bindings_) {
+      const double v = lo_[b.col] + frac * (hi_[b.col] - lo_[b.col]);
+      *b.port = b.offset + b.gain * v;
+    }
+    held_ = file_.eof() && last_t_ >= hi_[0];
+  }
+
+  // Interpolated value of a column at the last update (for monitors)
+  double value(const std::string &name) const {
+    const size_t c = value_column(name);
+    return lo_[c] + fraction() * (hi_[c] - lo_[c]);
+  }
+
+  // Trace time of the last update, in seconds
+  double trace_time() const { return last_t_; }
+  // True once the last row has been reached; ports hold from then on
+  bool exhausted() const { return held_; }
+  uint64_t rows_read() const { return rows_read_; }
+  uint64_t rows_skipped() const { return rows_skipped_; }
+
+private:
+  struct Binding {
+    size_t col;
+    double *port;
+    double gain;
+    double offset;
+  };
+
+  size_t value_column(const std::string &name) const {
+    const int c = file_.column(name);
+    if (c <= 0)
+      throw std::runtime_error("stimulus_replay: no column '" + name + "'");
+    return static_cast<size_t>(c);
+  }
+
+  double fraction() const {
+    const double span = hi_[0] - lo_[0];
+    const double frac = span > 0.0 ? (last_t_ - lo_[0]) / span : 0.0;
+    return frac < 0.0 ? 0.0 : (frac > 1.0 ? 1.0 : frac);
+  }
+
+  // Move the [lo, hi] bracket forward so that lo <= t < hi. Rows that fall
+  // wholly between two updates are stepped over on their timestamp alone.
+  void advance(double t) {
+    lo_.swap(hi_);
+    const uint64_t n = file_.read_last_at_or_before(t, lo_.data());
+    if (n > 0) {
+      rows_skipped_ += n - 1;
+      ++rows_read_;
+    }
+    if (file_.read_row(hi_.data()))
+      ++rows_read_;
+    else
+      hi_ = lo_;
+  }
+
+  StimulusFile file_;
+  double trace_per_ps_;
+  double trace_start_;
+  uint64_t update_interval_ps_;
+  std::vector<double> lo_;
+  std::vector<double> hi_;
+  std::vector<Binding> bindings_;
+  uint64_t next_update_ps_ = 0;
+  double last_t_ = 0.0;
+  bool held_ = false;
+  uint64_t rows_read_ = 0;
+  uint64_t rows_skipped_ = 0;
+};
+
+} // namespace stimulus_replay
+
+#endif // TESTBENCH_STIMULUS_REPLAY_HPP
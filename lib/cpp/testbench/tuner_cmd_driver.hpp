@@ -0,0 +1,193 @@
+#ifndef TESTBENCH_TUNER_CMD_DRIVER_HPP
+#define TESTBENCH_TUNER_CMD_DRIVER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Host side of tuner_cmd_seq. Commands for every ring are queued up front
+// and streamed into the per-ring command FIFOs as space frees up; completion
+// events are drained every cycle. The bench only supplies the clock.
+namespace tuner_cmd {
+
+// tuner_pkg::tuner_cmd_e
+enum class cmd_e : uint8_t { INIT = 0, SEARCH = 1, LOCK = 2, UNLOCK = 3 };
+
+// tuner_pkg::tuner_state_e
+enum class state_e : uint8_t { IDLE = 0, ACTIVE = 1, DONE = 2, ERROR = 3 };
+
+struct Command {
+  cmd_e cmd;
+  uint32_t arg0 = 0;
+  uint32_t arg1 = 0;
+  uint32_t arg2 = 0;
+
+  // Search window; stride is the step exponent
+  static Command init(int start, int end, int stride) {
+    return {cmd_e::INIT, static_cast<uint32_t>(start),
+            static_cast<uint32_t>(end), static_cast<uint32_t>(stride)};
+  }
+  static Command search() { return {cmd_e::SEARCH}; }
+  // Start at peak + offset; settle is in units of 2^LOCK_SETTLE_SHIFT cycles
+  static Command lock(int offset, int settle) {
+    return {cmd_e::LOCK, static_cast<uint32_t>(offset),
+            static_cast<uint32_t>(settle), 0};
+  }
+  static Command unlock() { return {cmd_e::UNLOCK}; }
+};
+
+struct Event {
+  size_t ring;
+  cmd_e cmd;
+  state_e state;
+  int ring_tune;
+  int pwr;
+  int peaks_cnt;
+  uint32_t cycle_cnt; // cycles from issue to completion
+  uint64_t cycle;     // driver cycle when the event was popped
+
+  bool ok() const { return state == state_e::DONE; }
+};
+
+inline std::string cmd_string(cmd_e cmd) {
+  switch (cmd) {
+  case cmd_e::INIT:
+    return "INIT";
+  case cmd_e::SEARCH:
+    return "SEARCH";
+  case cmd_e::LOCK:
+    return "LOCK";
+  case cmd_e::UNLOCK:
+    return "UNLOCK";
+  default:
+    return "UNKNOWN";
+  }
+}
+
+inline std::string state_string(state_e state) {
+  switch (state) {
+  case state_e::IDLE:
+    return "IDLE";
+  case state_e::ACTIVE:
+    return "ACTIVE";
+  case state_e::DONE:
+    return "DONE";
+  case state_e::ERROR:
+    return "ERROR";
+  default:
+    return "UNKNOWN";
+  }
+}
+
+// TDut must expose the sim/tuner_cmd_seq_row ports indexed by ring
+template <typename TDut> class TunerCmdDriver {
+public:
+  typedef std::vector<std::vector<Command>> batch_t;
+
+  TunerCmdDriver(TDut *dut, size_t num_rings)
+      : dut_(dut), pending_(num_rings), outstanding_(num_rings, 0) {}
+
+  // Idle the command/event ports; call before reset
+  void init() {
+    for (size_t r = 0; r < pending_.size(); ++r) {
+      dut_->i_cmd_val[r] = 0;
+      dut_->i_evt_rdy[r] = 1;
+    }
+  }
+
+  void submit(size_t ring, const Command &cmd) {
+    pending_[ring].push_back(cmd);
+    ++outstanding_[ring];
+  }
+
+  // One command stream per ring
+  void submit(const batch_t &batch) {
+    for (size_t r = 0; r < batch.size() && r < pending_.size(); ++r) {
+      for (const auto &cmd : batch[r]) {
+        submit(r, cmd);
+      }
+    }
+  }
+
+  bool busy() const {
+    for (auto n : outstanding_) {
+      if (n != 0)
+        return true;
+    }
+    return false;
+  }
+
+  // Clock until every submitted command has reported, or max_cycles.
+  // step() must advance one clock; on_event is called as events pop.
+  // Returns false on timeout.
+  bool run(const std::function<void()> &step, uint64_t max_cycles,
+           const std::function<void(const Event &)> &on_event = nullptr) {
+    for (uint64_t cycle = 0; cycle < max_cycles && busy(); ++cycle) {
+      // Present heads; o_cmd_rdy/o_evt_val are register-driven, so their
+      // pre-edge values decide the handshakes
+      std::vector<bool> push(pending_.size(), false);
+      std::vector<bool> pop(pending_.size(), false);
+      for (size_t r = 0; r < pending_.size(); ++r) {
+        if (!pending_[r].empty()) {
+          const auto &cmd = pending_[r].front();
+          dut_->i_cmd_val[r] = 1;
+          dut_->i_cmd[r] = static_cast<uint8_t>(cmd.cmd);
+          dut_->i_cmd_arg0[r] = cmd.arg0;
+          dut_->i_cmd_arg1[r] = cmd.arg1;
+          dut_->i_cmd_arg2[r] = cmd.arg2;
+          push[r] = dut_->o_cmd_rdy[r];
+        } else {
+          dut_->i_cmd_val[r] = 0;
+        }
+        pop[r] = dut_->o_evt_val[r];
+        if (pop[r]) {
+          Event e;
+          e.ring = r;
+          e.cmd = static_cast<cmd_e>(dut_->o_evt_cmd[r]);
+          e.state = static_cast<state_e>(dut_->o_evt_state[r]);
+          e.ring_tune = dut_->o_evt_ring_tune[r];
+          e.pwr = dut_->o_evt_pwr[r];
+          e.peaks_cnt = dut_->o_evt_peaks_cnt[r];
+          e.cycle_cnt = dut_->o_evt_cycle_cnt[r];
+          e.cycle = cycles_;
+          events_.push_back(e);
+        }
+      }
+      step();
+      for (size_t r = 0; r < pending_.size(); ++r) {
+        if (push[r])
+          pending_[r].pop_front();
+        if (pop[r]) {
+          --outstanding_[r];
+        }
+      }
+      ++cycles_;
+      for (; reported_ < events_.size(); ++reported_) {
+        if (on_event)
+          on_event(events_[reported_]);
+      }
+    }
+    for (size_t r = 0; r < pending_.size(); ++r) {
+      dut_->i_cmd_val[r] = 0;
+    }
+    return !busy();
+  }
+
+  const std::vector<Event> &events() const { return events_; }
+  uint64_t cycles() const { return cycles_; }
+
+private:
+  TDut *dut_;
+  std::vector<std::deque<Command>> pending_;
+  std::vector<size_t> outstanding_;
+  std::vector<Event> events_;
+  size_t reported_ = 0;
+  uint64_t cycles_ = 0;
+};
+
+} // namespace tuner_cmd
+
+#endif // TESTBENCH_TUNER_CMD_DRIVER_HPP
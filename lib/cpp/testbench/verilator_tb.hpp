@@ -3,13 +3,21 @@
 
 #include "verilated.h"
 #include "verilated_vcd_c.h"
+#if VM_COVERAGE
+#include "verilated_cov.h"
+#endif
+
+#include "utils/profiler.hpp"
 
 #include <cassert>
 #include <cstdlib>
+#include <iostream>
 #include <memory>
 #include <string>
 #include <utility>
 
+// An empty waveform_file builds the bench without VCD tracing (e.g. for
+// in-process batch runs); WAVEFORM_FILE only redirects an enabled trace.
 template <typename TDut> class VerilatorTb {
 public:
   explicit VerilatorTb(int argc, char **argv,
@@ -24,6 +32,11 @@ public:
     context_->commandArgs(argc, argv);
     assert((clk_period_ps_ % 2) == 0 && "clk_period_ps must be even");
 
+    if (waveform_file_.empty()) {
+      trace_.reset();
+      trace_enabled_ = false;
+      return;
+    }
     if (const char *waveform_env = std::getenv("WAVEFORM_FILE");
         waveform_env != nullptr && waveform_env[0] != '\0') {
       waveform_file_ = waveform_env;
@@ -40,18 +53,32 @@ public:
     if (trace_) {
       trace_->close();
     }
+#if VM_COVERAGE
+    const char *coverage_env = std::getenv("COVERAGE_FILE");
+    context_->coveragep()->write(coverage_env != nullptr && coverage_env[0]
+                                     ? coverage_env
+                                     : "coverage.dat");
+#endif
+    profiler::global().report(std::cerr);
   }
 
   TDut *dut() { return dut_.get(); }
   const TDut *dut() const { return dut_.get(); }
 
   vluint64_t time_ps() const { return time_ps_; }
+  vluint64_t clk_period_ps() const { return clk_period_ps_; }
 
-  void eval() { dut_->eval(); }
+  // Pause VCD dumping, e.g. across long replay runs
+  void set_trace_enabled(bool enabled) { trace_enabled_ = enabled && trace_; }
+
+  void eval() {
+    profiler::ScopedTimer timer(eval_phase_);
+    dut_->eval();
+  }
 
   void advance_time(vluint64_t delta_ps) {
     eval();
-    trace_->dump(time_ps_);
+    dump();
     time_ps_ += delta_ps;
     context_->timeInc(delta_ps);
   }
@@ -65,9 +92,10 @@ public:
   }
 
   template <typename TClk> void step_clk(TClk &clk_signal) {
+    profiler::ScopedTimer timer(step_phase_);
     step_half_clk(clk_signal);
     step_half_clk(clk_signal);
-    trace_->dump(time_ps_);
+    dump();
   }
 
   template <typename TClk, typename TRst>
@@ -82,12 +110,24 @@ public:
   }
 
 private:
+  void dump() {
+    if (trace_enabled_) {
+      profiler::ScopedTimer timer(trace_phase_);
+      trace_->dump(time_ps_);
+    }
+  }
+
   std::unique_ptr<VerilatedContext> context_;
   std::unique_ptr<VerilatedVcdC> trace_;
   std::unique_ptr<TDut> dut_;
   std::string waveform_file_;
   vluint64_t time_ps_ = 0;
   vluint64_t clk_period_ps_;
+  bool trace_enabled_ = true;
+  // Profiled phases (TB_PROFILE=1): step_clk includes eval and trace
+  profiler::Phase step_phase_{"step_clk"};
+  profiler::Phase eval_phase_{"eval"};
+  profiler::Phase trace_phase_{"trace"};
 };
 
 #endif // TESTBENCH_VERILATOR_TB_HPP
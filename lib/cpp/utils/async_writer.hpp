@@ -0,0 +1,167 @@
+#ifndef ASYNC_WRITER_HPP
+#define ASYNC_WRITER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Background writer for monitor samples. The simulation thread copies each
+// fixed-size record into a lock-free single-producer/single-consumer ring;
+// a writer thread drains it in batches and hands them to a sink that does
+// the formatting and file writes (e.g. MonitorBinWriter::append).
+namespace async_writer {
+
+// Bounded SPSC ring of trivially copyable records. head_ and tail_ live on
+// separate cache lines, and each side caches the other's index so the
+// common case touches no shared line.
+template <typename T> class SpscRing {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "SpscRing records must be trivially copyable");
+
+public:
+  explicit SpscRing(size_t capacity)
+      : mask_(round_up_pow2(capacity) - 1), buf_(mask_ + 1) {}
+
+  SpscRing(const SpscRing &) = delete;
+  SpscRing &operator=(const SpscRing &) = delete;
+
+  size_t capacity() const { return mask_ + 1; }
+
+  // Producer side
+  bool try_push(const T &v) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_cache_ > mask_) {
+      tail_cache_ = tail_.load(std::memory_order_acquire);
+      if (head - tail_cache_ > mask_)
+        return false;
+    }
+    buf_[head & mask_] = v;
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side: up to max records into out, returns the count
+  size_t pop(T *out, size_t max) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (head_cache_ - tail < max)
+      head_cache_ = head_.load(std::memory_order_acquire);
+    const size_t n = std::min(max, head_cache_ - tail);
+    for (size_t i = 0; i < n; ++i)
+      out[i] = buf_[(tail + i) & mask_];
+    tail_.store(tail + n, std::memory_order_release);
+    return n;
+  }
+
+private:
+  static size_t round_up_pow2(size_t n) {
+    size_t p = 1;
+    while (p < n)
+      p <<= 1;
+    return p;
+  }
+
+  alignas(64) std::atomic<size_t> head_{0};
+  size_t tail_cache_ = 0;
+  alignas(64) std::atomic<size_t> tail_{0};
+  size_t head_cache_ = 0;
+  alignas(64) const size_t mask_;
+  std::vector<T> buf_;
+};
+
+// What push() does when the ring is full
+enum class backpressure_e : uint8_t {
+  BLOCK = 0, // wait for the writer; no sample is lost
+  DROP = 1   // discard the sample and count it
+};
+
+inline backpressure_e parse_backpressure(const std::string &s) {
+  if (s == "block")
+    return backpressure_e::BLOCK;
+  if (s == "drop")
+    return backpressure_e::DROP;
+  throw std::invalid_argument("async_writer: backpressure must be block or "
+                              "drop, got '" +
+                              s + "'");
+}
+
+template <typename Rec> class AsyncWriter {
+public:
+  using Sink = std::function<void(const Rec *, size_t)>;
+  static constexpr size_t kBatch = 1024;
+
+  AsyncWriter(Sink sink, size_t capacity = size_t{1} << 16,
+              backpressure_e policy = backpressure_e::BLOCK)
+      : sink_(std::move(sink)), ring_(capacity), policy_(policy),
+        thread_([this] { run(); }) {}
+
+  ~AsyncWriter() { close(); }
+
+  AsyncWriter(const AsyncWriter &) = delete;
+  AsyncWriter &operator=(const AsyncWriter &) = delete;
+
+  // Simulation thread: one record copy unless the ring is full
+  void push(const Rec &r) {
+    if (ring_.try_push(r))
+      return;
+    if (policy_ == backpressure_e::DROP) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    stalls_.fetch_add(1, std::memory_order_relaxed);
+    while (!ring_.try_push(r))
+      std::this_thread::yield();
+  }
+
+  // Drain everything pushed so far and stop the writer thread
+  void close() {
+    if (!thread_.joinable())
+      return;
+    done_.store(true, std::memory_order_release);
+    thread_.join();
+  }
+
+  uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+  // Pushes that had to wait for the writer (BLOCK)
+  uint64_t stalls() const { return stalls_.load(std::memory_order_relaxed); }
+
+private:
+  void run() {
+    std::vector<Rec> batch(kBatch);
+    for (;;) {
+      // done_ is read before draining, so records pushed before close()
+      // are always seen by the final pass
+      const bool done = done_.load(std::memory_order_acquire);
+      size_t n;
+      bool idle = true;
+      while ((n = ring_.pop(batch.data(), kBatch)) > 0) {
+        sink_(batch.data(), n);
+        idle = false;
+      }
+      if (done)
+        return;
+      if (idle)
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+  }
+
+  Sink sink_;
+  SpscRing<Rec> ring_;
+  backpressure_e policy_;
+  std::atomic<bool> done_{false};
+  std::atomic<uint64_t> dropped_{0};
+  std::atomic<uint64_t> stalls_{0};
+  std::thread thread_;
+};
+
+} // namespace async_writer
+
+#endif // ASYNC_WRITER_HPP
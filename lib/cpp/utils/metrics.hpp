@@ -0,0 +1,44 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+// Scalar results of one bench run, written as "key = value" lines
+// (metrics.toml). utils/sweep_run collects these per point and caches them
+// under the point's content hash.
+class BenchMetrics {
+public:
+  template <typename T> void set(const std::string &key, const T &value) {
+    std::ostringstream os;
+    if constexpr (std::is_same_v<T, bool>) {
+      os << (value ? "true" : "false");
+    } else if constexpr (std::is_convertible_v<T, std::string>) {
+      os << "\"" << std::string(value) << "\"";
+    } else {
+      os << std::setprecision(17) << value;
+    }
+    values_[key] = os.str();
+  }
+
+  // Formatted values by key, e.g. for in-process callers
+  const std::map<std::string, std::string> &values() const { return values_; }
+
+  void write(const std::string &filename = "metrics.toml") const {
+    std::ofstream ofs(filename);
+    if (!ofs)
+      throw std::runtime_error("metrics: cannot write " + filename);
+    for (const auto &kv : values_)
+      ofs << kv.first << " = " << kv.second << "\n";
+  }
+
+private:
+  std::map<std::string, std::string> values_;
+};
+
+#endif // METRICS_HPP
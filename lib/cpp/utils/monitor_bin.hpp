@@ -0,0 +1,297 @@
+#ifndef MONITOR_BIN_HPP
+#define MONITOR_BIN_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Chunked binary monitor format (.swm), read by utils/plot_wave.
+//
+// Little-endian layout:
+//   header   "SWMON01\n", u32 num_cols, u32 chunk_rows, u64 num_rows,
+//            u64 index_offset, then per column: u8 type, u8 name_len, name,
+//            u16 num_labels, labels (u8 len, bytes); padded to 8 bytes
+//   chunks   column-major, each column block padded to 8 bytes
+//   index    per chunk: u64 offset, u64 rows, per column f64 min, f64 max
+//
+// Column 0 is the time axis, so the index also gives each chunk's time span.
+// Readers locate any range from the index and can plot whole chunks from the
+// min/max summaries without touching the samples.
+namespace monitor_bin {
+
+enum class col_type_e : uint8_t { F64 = 0, I32 = 1, U8 = 2 };
+
+inline size_t col_type_size(col_type_e type) {
+  switch (type) {
+  case col_type_e::F64:
+    return 8;
+  case col_type_e::I32:
+    return 4;
+  default:
+    return 1;
+  }
+}
+
+struct Column {
+  std::string name;
+  col_type_e type;
+  // Labels for enum-coded U8 columns (e.g., FSM states), empty otherwise
+  std::vector<std::string> labels;
+};
+
+constexpr char kMagic[8] = {'S', 'W', 'M', 'O', 'N', '0', '1', '\n'};
+constexpr uint32_t kDefaultChunkRows = 65536;
+
+inline size_t pad8(size_t n) { return (n + 7) & ~size_t{7}; }
+
+// Streaming writer: rows are buffered per column and flushed one chunk at a
+// time, so memory stays at one chunk regardless of run length
+class MonitorBinWriter {
+public:
+  explicit MonitorBinWriter(uint32_t chunk_rows = kDefaultChunkRows)
+      : chunk_rows_(chunk_rows) {}
+  ~MonitorBinWriter() { close(); }
+
+  MonitorBinWriter(const MonitorBinWriter &) = delete;
+  MonitorBinWriter &operator=(const MonitorBinWriter &) = delete;
+
+  void add_column(const std::string &name, col_type_e type,
+                  std::vector<std::string> labels = {}) {
+    if (ofs_.is_open())
+      throw std::logic_error("monitor_bin: add_column after open");
+    columns_.push_back({name, type, std::move(labels)});
+  }
+
+  void open(const std::string &filename) {
+    ofs_.open(filename, std::ios::binary | std::ios::trunc);
+    if (!ofs_)
+      throw std::runtime_error("monitor_bin: cannot open " + filename);
+    write_header();
+    bufs_.assign(columns_.size(), {});
+    mins_.assign(columns_.size(), std::numeric_limits<double>::infinity());
+    maxs_.assign(columns_.size(), -std::numeric_limits<double>::infinity());
+    for (size_t c = 0; c < columns_.size(); ++c)
+      bufs_[c].reserve(size_t{chunk_rows_} * col_type_size(columns_[c].type));
+  }
+
+  bool is_open() const { return ofs_.is_open(); }
+
+  // One value per column, in column order
+  template <typename... Ts> void append(Ts... values) {
+    if (sizeof...(Ts) != columns_.size())
+      throw std::logic_error("monitor_bin: column count mismatch");
+    size_t c = 0;
+    (put(c++, static_cast<double>(values)), ...);
+    if (++chunk_fill_ == chunk_rows_)
+      flush_chunk();
+  }
+
+  void close() {
+    if (!ofs_.is_open())
+      return;
+    flush_chunk();
+    const uint64_t index_offset = static_cast<uint64_t>(ofs_.tellp());
+    ofs_.write(index_.data(), static_cast<std::streamsize>(index_.size()));
+    ofs_.seekp(kRowsOffset);
+    write_u64(num_rows_);
+    write_u64(index_offset);
+    ofs_.close();
+  }
+
+  uint64_t num_rows() const { return num_rows_ + chunk_fill_; }
+
+private:
+  static constexpr std::streamoff kRowsOffset = 16;
+
+  void put(size_t c, double v) {
+    auto &buf = bufs_[c];
+    switch (columns_[c].type) {
+    case col_type_e::F64: {
+      append_raw(buf, v);
+      break;
+    }
+    case col_type_e::I32: {
+      const int32_t x = static_cast<int32_t>(v);
+      append_raw(buf, x);
+      v = x;
+      break;
+    }
+    default: {
+      const uint8_t x = static_cast<uint8_t>(v);
+      append_raw(buf, x);
+      v = x;
+      break;
+    }
+    }
+    mins_[c] = std::min(mins_[c], v);
+    maxs_[c] = std::max(maxs_[c], v);
+  }
+
+  template <typename T> static void append_raw(std::vector<char> &buf, T v) {
+    const size_t n = buf.size();
+    buf.resize(n + sizeof(T));
+    std::memcpy(buf.data() + n, &v, sizeof(T));
+  }
+
+  void flush_chunk() {
+    if (chunk_fill_ == 0)
+      return;
+    const uint64_t offset = static_cast<uint64_t>(ofs_.tellp());
+    static const char zeros[8] = {};
+    for (auto &buf : bufs_) {
+      ofs_.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+      ofs_.write(zeros,
+                 static_cast<std::streamsize>(pad8(buf.size()) - buf.size()));
+      buf.clear();
+    }
+    append_raw(index_, offset);
+    append_raw(index_, uint64_t{chunk_fill_});
+    for (size_t c = 0; c < columns_.size(); ++c) {
+      append_raw(index_, mins_[c]);
+      append_raw(index_, maxs_[c]);
+      mins_[c] = std::numeric_limits<double>::infinity();
+      maxs_[c] = -std::numeric_limits<double>::infinity();
+    }
+    num_rows_ += chunk_fill_;
+    chunk_fill_ = 0;
+  }
+
+  void write_header() {
+    std::vector<char> h(kMagic, kMagic + sizeof(kMagic));
+    append_raw(h, static_cast<uint32_t>(columns_.size()));
+    append_raw(h, chunk_rows_);
+    append_raw(h, uint64_t{0}); // num_rows, patched at close
+    append_raw(h, uint64_t{0}); // index_offset, patched at close
+    for (const auto &col : columns_) {
+      append_raw(h, static_cast<uint8_t>(col.type));
+      append_raw(h, static_cast<uint8_t>(col.name.size()));
+      h.insert(h.end(), col.name.begin(), col.name.end());
+      append_raw(h, static_cast<uint16_t>(col.labels.size()));
+      for (const auto &l : col.labels) {
+        append_raw(h, static_cast<uint8_t>(l.size()));
+        h.insert(h.end(), l.begin(), l.end());
+      }
+    }
+    h.resize(pad8(h.size()), 0);
+    ofs_.write(h.data(), static_cast<std::streamsize>(h.size()));
+  }
+
+  void write_u64(uint64_t v) {
+    ofs_.write(reinterpret_cast<const char *>(&v), sizeof(v));
+  }
+
+  uint32_t chunk_rows_;
+  std::vector<Column> columns_;
+  std::ofstream ofs_;
+  std::vector<std::vector<char>> bufs_;
+  std::vector<double> mins_;
+  std::vector<double> maxs_;
+  std::vector<char> index_;
+  uint32_t chunk_fill_ = 0;
+  uint64_t num_rows_ = 0;
+};
+
+// Index-only reader, for C++ post-processing and tests
+class MonitorBinReader {
+public:
+  struct Chunk {
+    uint64_t offset;
+    uint64_t rows;
+    std::vector<double> min;
+    std::vector<double> max;
+  };
+
+  explicit MonitorBinReader(const std::string &filename)
+      : ifs_(filename, std::ios::binary) {
+    if (!ifs_)
+      throw std::runtime_error("monitor_bin: cannot open " + filename);
+    char magic[8];
+    ifs_.read(magic, sizeof(magic));
+    if (std::memcmp(magic, kMagic, sizeof(kMagic)) != 0)
+      throw std::runtime_error("monitor_bin: bad magic in " + filename);
+    const uint32_t num_cols = read<uint32_t>();
+    chunk_rows_ = read<uint32_t>();
+    num_rows_ = read<uint64_t>();
+    const uint64_t index_offset = read<uint64_t>();
+    for (uint32_t c = 0; c < num_cols; ++c) {
+      Column col;
+      col.type = static_cast<col_type_e>(read<uint8_t>());
+      col.name = read_str(read<uint8_t>());
+      const uint16_t num_labels = read<uint16_t>();
+      for (uint16_t l = 0; l < num_labels; ++l)
+        col.labels.push_back(read_str(read<uint8_t>()));
+      columns_.push_back(col);
+    }
+    if (index_offset == 0)
+      throw std::runtime_error("monitor_bin: file not closed " + filename);
+    ifs_.seekg(static_cast<std::streamoff>(index_offset));
+    for (uint64_t rows = 0; rows < num_rows_;) {
+      Chunk ch;
+      ch.offset = read<uint64_t>();
+      ch.rows = read<uint64_t>();
+      for (uint32_t c = 0; c < num_cols; ++c) {
+        ch.min.push_back(read<double>());
+        ch.max.push_back(read<double>());
+      }
+      rows += ch.rows;
+      chunks_.push_back(ch);
+    }
+  }
+
+  const std::vector<Column> &columns() const { return columns_; }
+  const std::vector<Chunk> &chunks() const { return chunks_; }
+  uint64_t num_rows() const { return num_rows_; }
+  uint32_t chunk_rows() const { return chunk_rows_; }
+
+  // Samples of one column within one chunk, widened to double
+  std::vector<double> read_column(size_t chunk, size_t col) {
+    const Chunk &ch = chunks_[chunk];
+    uint64_t offset = ch.offset;
+    for (size_t c = 0; c < col; ++c)
+      offset += pad8(ch.rows * col_type_size(columns_[c].type));
+    ifs_.seekg(static_cast<std::streamoff>(offset));
+    std::vector<double> out(ch.rows);
+    for (auto &v : out) {
+      switch (columns_[col].type) {
+      case col_type_e::F64:
+        v = read<double>();
+        break;
+      case col_type_e::I32:
+        v = read<int32_t>();
+        break;
+      default:
+        v = read<uint8_t>();
+        break;
+      }
+    }
+    return out;
+  }
+
+private:
+  template <typename T> T read() {
+    T v;
+    ifs_.read(reinterpret_cast<char *>(&v), sizeof(T));
+    return v;
+  }
+
+  std::string read_str(size_t n) {
+    std::string s(n, '\0');
+    ifs_.read(&s[0], static_cast<std::streamsize>(n));
+    return s;
+  }
+
+  std::ifstream ifs_;
+  uint32_t chunk_rows_ = 0;
+  uint64_t num_rows_ = 0;
+  std::vector<Column> columns_;
+  std::vector<Chunk> chunks_;
+};
+
+} // namespace monitor_bin
+
+#endif // MONITOR_BIN_HPP
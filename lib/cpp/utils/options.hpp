@@ -0,0 +1,339 @@
+#ifndef OPTIONS_HPP
+#define OPTIONS_HPP
+
+#include <array>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Runtime bench knobs from the command line and config files, so operating
+// points (the runtime config inputs in PARAMS.md) change without a rebuild.
+//
+// Sources, later ones winning:
+//   defaults passed to get()
+//   --config=<file> / +config=<file>, TOML-style or flat JSON, in order
+//   --key=value / +key=value
+// TOML-style files hold "key = value" lines, "# comments" and "[section]"
+// headers, which prefix the keys below them with "section.". JSON files hold
+// one object; nested objects flatten the same way. Arrays are "[a, b]".
+//
+// Per-ring knobs take an array, a scalar for every ring, or element
+// overrides "key.<ring>", e.g. +lock_offset.1=25. Arguments that are not
+// options (e.g. Verilator's) are left alone.
+namespace options {
+
+class Options {
+public:
+  Options() = default;
+
+  Options(int argc, char **argv) {
+    std::vector<std::pair<std::string, std::string>> args;
+    for (int i = 1; i < argc; ++i) {
+      std::string a = argv[i];
+      if (a.rfind("--", 0) == 0)
+        a = a.substr(2);
+      else if (a.rfind("+", 0) == 0)
+        a = a.substr(1);
+      else
+        continue;
+      const size_t eq = a.find('=');
+      if (eq == std::string::npos || a.rfind("verilator+", 0) == 0)
+        continue;
+      args.emplace_back(a.substr(0, eq), a.substr(eq + 1));
+    }
+    for (const auto &kv : args) {
+      if (kv.first == "config")
+        load_file(kv.second);
+    }
+    for (const auto &kv : args) {
+      if (kv.first != "config")
+        set(kv.first, kv.second);
+    }
+  }
+
+  void load_file(const std::string &filename) {
+    std::ifstream ifs(filename);
+    if (!ifs)
+      throw std::runtime_error("options: cannot read " + filename);
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    const std::string text = ss.str();
+    const size_t first = text.find_first_not_of(" \t\r\n");
+    if (first != std::string::npos && text[first] == '{') {
+      size_t pos = first;
+      parse_json_object(text, pos, "");
+    } else {
+      parse_toml(text);
+    }
+  }
+
+  void set(const std::string &key, const std::string &value) {
+    values_[key] = unquote(trim(value));
+  }
+
+  bool has(const std::string &key) const { return values_.count(key) != 0; }
+
+  template <typename T> T get(const std::string &key, const T &def) {
+    used_.insert(key);
+    const auto it = values_.find(key);
+    const T v = it == values_.end() ? def : convert<T>(key, it->second);
+    effective_[key] = format(v);
+    return v;
+  }
+
+  template <typename T, size_t N>
+  std::array<T, N> get_array(const std::string &key,
+                             const std::array<T, N> &def) {
+    used_.insert(key);
+    std::array<T, N> v = def;
+    const auto it = values_.find(key);
+    if (it != values_.end()) {
+      const auto items = split_array(it->second);
+      if (items.size() == 1) {
+        v.fill(convert<T>(key, items[0]));
+      } else if (items.size() == N) {
+        for (size_t i = 0; i < N; ++i)
+          v[i] = convert<T>(key, items[i]);
+      } else {
+        throw std::runtime_error("options: " + key + " needs 1 or " +
+                                 std::to_string(N) + " values");
+      }
+    }
+    for (size_t i = 0; i < N; ++i) {
+      const std::string elem = key + "." + std::to_string(i);
+      used_.insert(elem);
+      const auto e = values_.find(elem);
+      if (e != values_.end())
+        v[i] = convert<T>(elem, e->second);
+    }
+    std::string s = "[";
+    for (size_t i = 0; i < N; ++i)
+      s += (i ? ", " : "") + format(v[i]);
+    effective_[key] = s + "]";
+    return v;
+  }
+
+  // Same default for every element
+  template <typename T, size_t N>
+  std::array<T, N> get_array(const std::string &key, const T &def) {
+    std::array<T, N> v;
+    v.fill(def);
+    return get_array<T, N>(key, v);
+  }
+
+  // Keys that were given but never read, usually typos
+  std::vector<std::string> unused() const {
+    std::vector<std::string> out;
+    for (const auto &kv : values_) {
+      if (!used_.count(kv.first))
+        out.push_back(kv.first);
+    }
+    return out;
+  }
+
+  // Call after every get(); throws on unknown keys
+  void check_unused() const {
+    const auto keys = unused();
+    if (keys.empty())
+      return;
+    std::string msg = "options: unknown keys:";
+    for (const auto &k : keys)
+      msg += " " + k;
+    throw std::runtime_error(msg);
+  }
+
+  // Every value read so far, as a config file that reproduces the run
+  void write_effective(const std::string &filename) const {
+    std::ofstream ofs(filename);
+    for (const auto &kv : effective_)
+      ofs << kv.first << " = " << kv.second << "\n";
+  }
+
+private:
+  static std::string trim(const std::string &s) {
+    const size_t b = s.find_first_not_of(" \t\r\n");
+    if (b == std::string::npos)
+      return "";
+    const size_t e = s.find_last_not_of(" \t\r\n");
+    return s.substr(b, e - b + 1);
+  }
+
+  static std::string unquote(const std::string &s) {
+    if (s.size() >= 2 && (s.front() == '"' || s.front() == '\'') &&
+        s.back() == s.front())
+      return s.substr(1, s.size() - 2);
+    return s;
+  }
+
+  static std::vector<std::string> split_array(const std::string &s) {
+    std::string body = trim(s);
+    if (!body.empty() && body.front() == '[' && body.back() == ']')
+      body = body.substr(1, body.size() - 2);
+    std::vector<std::string> items;
+    std::stringstream ss(body);
+    std::string item;
+    while (std::getline(ss, item, ','))
+      items.push_back(unquote(trim(item)));
+    return items;
+  }
+
+  template <typename T>
+  static T convert(const std::string &key, const std::string &s) {
+    try {
+      if constexpr (std::is_same_v<T, std::string>) {
+        return s;
+      } else if constexpr (std::is_same_v<T, bool>) {
+        if (s == "true" || s == "1")
+          return true;
+        if (s == "false" || s == "0")
+          return false;
+        throw std::invalid_argument(s);
+      } else if constexpr (std::is_floating_point_v<T>) {
+        size_t n = 0;
+        const double v = std::stod(s, &n);
+        if (n != s.size())
+          throw std::invalid_argument(s);
+        return static_cast<T>(v);
+      } else if constexpr (std::is_unsigned_v<T>) {
+        size_t n = 0;
+        const unsigned long long v = std::stoull(s, &n, 0);
+        if (n != s.size() || s.front() == '-')
+          throw std::invalid_argument(s);
+        return static_cast<T>(v);
+      } else {
+        size_t n = 0;
+        const long long v = std::stoll(s, &n, 0);
+        if (n != s.size())
+          throw std::invalid_argument(s);
+        return static_cast<T>(v);
+      }
+    } catch (const std::logic_error &) {
+      throw std::runtime_error("options: bad value for " + key + ": '" + s +
+                               "'");
+    }
+  }
+
+  template <typename T> static std::string format(const T &v) {
+    if constexpr (std::is_same_v<T, std::string>) {
+      return "\"" + v + "\"";
+    } else if constexpr (std::is_same_v<T, bool>) {
+      return v ? "true" : "false";
+    } else {
+      std::ostringstream os;
+      os << std::setprecision(17) << v;
+      return os.str();
+    }
+  }
+
+  void parse_toml(const std::string &text) {
+    std::stringstream ss(text);
+    std::string line;
+    std::string prefix;
+    while (std::getline(ss, line)) {
+      // Strip comments outside quotes
+      bool quoted = false;
+      for (size_t i = 0; i < line.size(); ++i) {
+        if (line[i] == '"')
+          quoted = !quoted;
+        else if (line[i] == '#' && !quoted) {
+          line.resize(i);
+          break;
+        }
+      }
+      line = trim(line);
+      if (line.empty())
+        continue;
+      if (line.front() == '[' && line.back() == ']' &&
+          line.find('=') == std::string::npos) {
+        const std::string section = trim(line.substr(1, line.size() - 2));
+        prefix = section.empty() ? "" : section + ".";
+        continue;
+      }
+      const size_t eq = line.find('=');
+      if (eq == std::string::npos)
+        throw std::runtime_error("options: expected key = value: " + line);
+      set(prefix + trim(line.substr(0, eq)), line.substr(eq + 1));
+    }
+  }
+
+  static void skip_ws(const std::string &t, size_t &pos) {
+    while (pos < t.size() && std::isspace(static_cast<unsigned char>(t[pos])))
+      ++pos;
+  }
+
+  static void expect(const std::string &t, size_t &pos, char c) {
+    skip_ws(t, pos);
+    if (pos >= t.size() || t[pos] != c)
+      throw std::runtime_error(std::string("options: JSON expected '") + c +
+                               "' at byte " + std::to_string(pos));
+    ++pos;
+  }
+
+  static std::string parse_json_string(const std::string &t, size_t &pos) {
+    expect(t, pos, '"');
+    std::string s;
+    while (pos < t.size() && t[pos] != '"') {
+      if (t[pos] == '\\' && pos + 1 < t.size())
+        ++pos;
+      s += t[pos++];
+    }
+    expect(t, pos, '"');
+    return s;
+  }
+
+  void parse_json_object(const std::string &t, size_t &pos,
+                         const std::string &prefix) {
+    expect(t, pos, '{');
+    skip_ws(t, pos);
+    if (pos < t.size() && t[pos] == '}') {
+      ++pos;
+      return;
+    }
+    while (true) {
+      const std::string key = prefix + parse_json_string(t, pos);
+      expect(t, pos, ':');
+      skip_ws(t, pos);
+      if (pos < t.size() && t[pos] == '{') {
+        parse_json_object(t, pos, key + ".");
+      } else if (pos < t.size() && t[pos] == '"') {
+        values_[key] = parse_json_string(t, pos);
+      } else if (pos < t.size() && t[pos] == '[') {
+        const size_t end = t.find(']', pos);
+        if (end == std::string::npos)
+          throw std::runtime_error("options: JSON unterminated array");
+        set(key, t.substr(pos, end - pos + 1));
+        pos = end + 1;
+      } else {
+        const size_t end = t.find_first_of(",}", pos);
+        if (end == std::string::npos)
+          throw std::runtime_error("options: JSON unterminated value");
+        set(key, t.substr(pos, end - pos));
+        pos = end;
+      }
+      skip_ws(t, pos);
+      if (pos < t.size() && t[pos] == ',') {
+        ++pos;
+        continue;
+      }
+      expect(t, pos, '}');
+      return;
+    }
+  }
+
+  std::map<std::string, std::string> values_;
+  std::set<std::string> used_;
+  std::map<std::string, std::string> effective_;
+};
+
+} // namespace options
+
+#endif // OPTIONS_HPP
@@ -0,0 +1,297 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hot-path profiler for the bench loop. Phases (model eval, trace dump,
+// monitor sample, ...) accumulate TSC ticks through scoped timers; nested
+// timers split each phase into inclusive and self time. Enabled at runtime
+// with TB_PROFILE=1, or TB_PROFILE=perf to add whole-run hardware counters.
+// A disabled timer costs one branch. VerilatorTb prints the report at exit.
+namespace profiler {
+
+inline uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+}
+
+inline uint64_t now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+struct PhaseStats {
+  std::string name;
+  uint64_t calls = 0;
+  uint64_t ticks = 0;       // inclusive
+  uint64_t child_ticks = 0; // spent in nested timers
+  int depth = 0;            // nesting depth at first entry
+};
+
+// Whole-run hardware counters via perf_event_open. Unavailable counters
+// (no PMU, perf_event_paranoid) are skipped.
+class PerfCounters {
+public:
+  static constexpr int kNumCounters = 4;
+
+  PerfCounters() { fds_.fill(-1); }
+  PerfCounters(const PerfCounters &) = delete;
+  PerfCounters &operator=(const PerfCounters &) = delete;
+  ~PerfCounters() { close(); }
+
+  bool open() {
+#ifdef __linux__
+    static const uint64_t kConfigs[kNumCounters] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+    bool any = false;
+    for (int i = 0; i < kNumCounters; ++i) {
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = kConfigs[i];
+      attr.disabled = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      fds_[i] = static_cast<int>(
+          syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+      if (fds_[i] >= 0) {
+        ioctl(fds_[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(fds_[i], PERF_EVENT_IOC_ENABLE, 0);
+        any = true;
+      }
+    }
+    return any;
+#else
+    return false;
+#endif
+  }
+
+  // Counter values, or -1 where the counter is unavailable
+  std::array<int64_t, kNumCounters> read() const {
+    std::array<int64_t, kNumCounters> values;
+    values.fill(-1);
+#ifdef __linux__
+    for (int i = 0; i < kNumCounters; ++i) {
+      uint64_t v;
+      if (fds_[i] >= 0 && ::read(fds_[i], &v, sizeof(v)) == sizeof(v))
+        values[i] = static_cast<int64_t>(v);
+    }
+#endif
+    return values;
+  }
+
+  void close() {
+#ifdef __linux__
+    for (auto &fd : fds_) {
+      if (fd >= 0)
+        ::close(fd);
+      fd = -1;
+    }
+#endif
+  }
+
+private:
+  std::array<int, kNumCounters> fds_;
+};
+
+class Profiler {
+public:
+  Profiler() : start_ticks_(ticks()), start_ns_(now_ns()) {
+    if (const char *env = std::getenv("TB_PROFILE");
+        env != nullptr && env[0] != '\0' && std::string(env) != "0") {
+      enabled_ = true;
+      perf_requested_ = std::string(env) == "perf";
+      if (perf_requested_)
+        perf_enabled_ = perf_.open();
+    }
+  }
+
+  bool enabled() const { return enabled_; }
+  void set_enabled(bool enabled) { enabled_ = enabled; }
+
+  // Stable handle to a named phase; repeated names share one entry
+  PhaseStats *phase(const std::string &name) {
+    for (auto &p : phases_)
+      if (p.name == name)
+        return &p;
+    phases_.push_back(PhaseStats{name});
+    return &phases_.back();
+  }
+
+  const std::deque<PhaseStats> &phases() const { return phases_; }
+
+  // Ticks per nanosecond, measured against steady_clock over the run
+  double ticks_per_ns() const {
+    uint64_t t1 = ticks(), n1 = now_ns();
+    if (n1 - start_ns_ < 10000000) { // stretch short runs to 10 ms
+      while (now_ns() - start_ns_ < 10000000) {
+      }
+      t1 = ticks();
+      n1 = now_ns();
+    }
+    return static_cast<double>(t1 - start_ticks_) /
+           static_cast<double>(n1 - start_ns_);
+  }
+
+  void report(std::ostream &os) const {
+    if (!enabled_)
+      return;
+    const uint64_t wall_ticks = ticks() - start_ticks_;
+    const double tpn = ticks_per_ns();
+    const double wall_ms = wall_ticks / tpn * 1e-6;
+
+    std::vector<const PhaseStats *> order;
+    uint64_t top_ticks = 0;
+    for (const auto &p : phases_) {
+      order.push_back(&p);
+      if (p.depth == 0)
+        top_ticks += p.ticks;
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [](const PhaseStats *a, const PhaseStats *b) {
+                       return a->ticks > b->ticks;
+                     });
+
+    const auto flags = os.flags();
+    const auto precision = os.precision();
+    os << "--- Profile: " << std::fixed << std::setprecision(1) << wall_ms
+       << " ms wall ---\n";
+    os << std::left << std::setw(20) << "phase" << std::right
+       << std::setw(12) << "calls" << std::setw(12) << "incl ms"
+       << std::setw(12) << "self ms" << std::setw(8) << "self%"
+       << std::setw(10) << "ns/call" << "\n";
+    auto row = [&](const std::string &name, uint64_t calls, uint64_t incl,
+                   uint64_t self) {
+      os << std::left << std::setw(20) << name << std::right << std::setw(12)
+         << calls << std::setprecision(2) << std::setw(12)
+         << incl / tpn * 1e-6 << std::setw(12) << self / tpn * 1e-6
+         << std::setprecision(1) << std::setw(8)
+         << 100.0 * self / std::max<uint64_t>(wall_ticks, 1)
+         << std::setw(10);
+      if (calls > 0)
+        os << incl / tpn / calls;
+      else
+        os << "-";
+      os << "\n";
+    };
+    for (const auto *p : order)
+      row(std::string(2 * p->depth, ' ') + p->name, p->calls, p->ticks,
+          p->ticks - std::min(p->child_ticks, p->ticks));
+    const uint64_t rest = wall_ticks - std::min(top_ticks, wall_ticks);
+    row("(untimed)", 0, rest, rest);
+
+    if (perf_enabled_) {
+      const auto v = perf_.read();
+      static const char *kNames[PerfCounters::kNumCounters] = {
+          "cycles", "instructions", "cache-misses", "branch-misses"};
+      for (int i = 0; i < PerfCounters::kNumCounters; ++i) {
+        if (v[i] >= 0)
+          os << std::left << std::setw(20) << kNames[i] << std::right
+             << std::setw(16) << v[i] << "\n";
+      }
+      if (v[0] > 0 && v[1] >= 0)
+        os << std::left << std::setw(20) << "IPC" << std::right
+           << std::setprecision(2) << std::setw(16)
+           << static_cast<double>(v[1]) / v[0] << "\n";
+    } else if (perf_requested_) {
+      os << "(perf counters unavailable)\n";
+    }
+    os.flags(flags);
+    os.precision(precision);
+  }
+
+private:
+  bool enabled_ = false;
+  bool perf_requested_ = false;
+  bool perf_enabled_ = false;
+  uint64_t start_ticks_;
+  uint64_t start_ns_;
+  std::deque<PhaseStats> phases_;
+  PerfCounters perf_;
+};
+
+inline Profiler &global() {
+  static Profiler instance;
+  return instance;
+}
+
+// Named phase in the global profiler; declare as a function-local static
+class Phase {
+public:
+  explicit Phase(const std::string &name) : stats_(global().phase(name)) {}
+  PhaseStats *stats() const { return stats_; }
+
+private:
+  PhaseStats *stats_;
+};
+
+class ScopedTimer;
+inline thread_local ScopedTimer *current_timer = nullptr;
+
+class ScopedTimer {
+public:
+  explicit ScopedTimer(const Phase &phase) {
+    if (!global().enabled())
+      return;
+    stats_ = phase.stats();
+    parent_ = current_timer;
+    depth_ = parent_ ? parent_->depth_ + 1 : 0;
+    if (stats_->calls == 0)
+      stats_->depth = depth_;
+    current_timer = this;
+    start_ = ticks();
+  }
+
+  ScopedTimer(const ScopedTimer &) = delete;
+  ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+  ~ScopedTimer() {
+    if (stats_ == nullptr)
+      return;
+    const uint64_t elapsed = ticks() - start_;
+    stats_->ticks += elapsed;
+    ++stats_->calls;
+    if (parent_)
+      parent_->stats_->child_ticks += elapsed;
+    current_timer = parent_;
+  }
+
+private:
+  PhaseStats *stats_ = nullptr;
+  ScopedTimer *parent_ = nullptr;
+  int depth_ = 0;
+  uint64_t start_ = 0;
+};
+
+} // namespace profiler
+
+#endif // PROFILER_HPP
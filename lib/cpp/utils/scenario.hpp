@@ -0,0 +1,277 @@
+#ifndef SCENARIO_HPP
+#define SCENARIO_HPP
+
+#include "models/afe_noise.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Seeded scenario generator for yield sweeps.
+//
+// Every random draw is a pure function of (seed, scenario index, field,
+// element) through the Philox counter RNG in afe_noise, so scenario k is
+// regenerated in O(1) without drawing scenarios 0..k-1, and any shard of a
+// sweep produces the same scenarios on any machine. A manifest records the
+// seed and distributions alongside the drawn values, and
+// ScenarioGenerator::from_manifest rebuilds the generator from it.
+namespace scenario {
+
+// ----------------------------------------------------------------------
+// Distributions
+// ----------------------------------------------------------------------
+enum class dist_e { CONST, UNIFORM, NORMAL };
+
+struct Dist {
+  dist_e kind = dist_e::CONST;
+  double a = 0.0; // value, lower bound or mean
+  double b = 0.0; // upper bound or sigma
+
+  static Dist constant(double v) { return {dist_e::CONST, v, 0.0}; }
+  static Dist uniform(double lo, double hi) { return {dist_e::UNIFORM, lo, hi}; }
+  static Dist normal(double mean, double sigma) {
+    return {dist_e::NORMAL, mean, sigma};
+  }
+
+  // r holds two independent 32-bit draws
+  double sample(uint32_t r0, uint32_t r1) const {
+    switch (kind) {
+    case dist_e::UNIFORM:
+      return a + (b - a) * afe_noise::u01(r0);
+    case dist_e::NORMAL: {
+      constexpr double kTwoPi = 6.283185307179586;
+      const double m = std::sqrt(-2.0 * std::log(afe_noise::u01(r0)));
+      return a + b * m * std::cos(kTwoPi * afe_noise::u01(r1));
+    }
+    default:
+      return a;
+    }
+  }
+
+  // "const(v)", "uniform(lo,hi)" or "normal(mean,sigma)"
+  std::string str() const {
+    std::ostringstream os;
+    os << std::setprecision(17);
+    switch (kind) {
+    case dist_e::UNIFORM:
+      os << "uniform(" << a << "," << b << ")";
+      break;
+    case dist_e::NORMAL:
+      os << "normal(" << a << "," << b << ")";
+      break;
+    default:
+      os << "const(" << a << ")";
+      break;
+    }
+    return os.str();
+  }
+
+  static Dist parse(const std::string &s) {
+    Dist d;
+    double x = 0.0, y = 0.0;
+    if (std::sscanf(s.c_str(), "uniform(%lf,%lf)", &x, &y) == 2)
+      d = uniform(x, y);
+    else if (std::sscanf(s.c_str(), "normal(%lf,%lf)", &x, &y) == 2)
+      d = normal(x, y);
+    else if (std::sscanf(s.c_str(), "const(%lf)", &x) == 1)
+      d = constant(x);
+    else
+      throw std::runtime_error("scenario: bad distribution '" + s + "'");
+    return d;
+  }
+};
+// ----------------------------------------------------------------------
+
+// ----------------------------------------------------------------------
+// Scenario
+// ----------------------------------------------------------------------
+// Wavelengths in nm. Laser k sits at laser_wvl_start + k * laser_spacing
+// plus a common grid offset and its own error; ring k is designed at
+// ring_wvl_start + k * ring_spacing and lands off by its fabrication
+// offset. FWHM and TuningFullScale draws are multipliers on the RTL
+// parameters (i_fwhm_scale / i_tune_scale).
+struct ScenarioConfig {
+  size_t num_lasers = 2;
+  size_t num_rings = 2;
+  double laser_wvl_start = 1300.0;
+  double laser_spacing = 2.0;
+  Dist laser_grid_offset = Dist::constant(0.0);
+  Dist laser_wvl_error = Dist::constant(0.0);
+  Dist laser_pwr = Dist::constant(1000.0);
+  double ring_wvl_start = 1295.0;
+  double ring_spacing = 3.0;
+  Dist ring_fab_offset = Dist::constant(0.0);
+  Dist fwhm_scale = Dist::constant(1.0);
+  Dist tune_scale = Dist::constant(1.0);
+};
+
+struct Scenario {
+  uint64_t index;
+  double laser_pwr;
+  std::vector<double> laser_wvl;
+  std::vector<double> ring_wvl;
+  std::vector<double> fwhm_scale;
+  std::vector<double> tune_scale;
+};
+
+// Field tags keep the draws of different quantities independent
+enum field_tag_e : uint32_t {
+  TAG_LASER_GRID = 0x1000,
+  TAG_LASER_WVL = 0x1001,
+  TAG_LASER_PWR = 0x1002,
+  TAG_RING_FAB = 0x2000,
+  TAG_RING_FWHM = 0x2001,
+  TAG_RING_TUNE = 0x2002
+};
+
+class ScenarioGenerator {
+public:
+  ScenarioGenerator(const ScenarioConfig &cfg, uint64_t seed)
+      : cfg_(cfg), seed_(seed) {}
+
+  const ScenarioConfig &config() const { return cfg_; }
+  uint64_t seed() const { return seed_; }
+
+  Scenario generate(uint64_t index) const {
+    Scenario s;
+    s.index = index;
+    s.laser_pwr = draw(cfg_.laser_pwr, index, TAG_LASER_PWR, 0);
+    const double grid = draw(cfg_.laser_grid_offset, index, TAG_LASER_GRID, 0);
+    for (size_t k = 0; k < cfg_.num_lasers; ++k) {
+      s.laser_wvl.push_back(cfg_.laser_wvl_start + k * cfg_.laser_spacing +
+                            grid +
+                            draw(cfg_.laser_wvl_error, index, TAG_LASER_WVL, k));
+    }
+    for (size_t k = 0; k < cfg_.num_rings; ++k) {
+      s.ring_wvl.push_back(cfg_.ring_wvl_start + k * cfg_.ring_spacing +
+                           draw(cfg_.ring_fab_offset, index, TAG_RING_FAB, k));
+      s.fwhm_scale.push_back(draw(cfg_.fwhm_scale, index, TAG_RING_FWHM, k));
+      s.tune_scale.push_back(draw(cfg_.tune_scale, index, TAG_RING_TUNE, k));
+    }
+    return s;
+  }
+
+  // Manifest: "# key=value" lines for the seed and config, then one CSV
+  // row per scenario in [first, last)
+  void write_manifest(const std::string &filename, uint64_t first,
+                      uint64_t last) const {
+    std::ofstream ofs(filename);
+    if (!ofs)
+      throw std::runtime_error("scenario: cannot write " + filename);
+    ofs << std::setprecision(17);
+    ofs << "# seed=" << seed_ << "\n";
+    ofs << "# num_lasers=" << cfg_.num_lasers << "\n";
+    ofs << "# num_rings=" << cfg_.num_rings << "\n";
+    ofs << "# laser_wvl_start=" << cfg_.laser_wvl_start << "\n";
+    ofs << "# laser_spacing=" << cfg_.laser_spacing << "\n";
+    ofs << "# laser_grid_offset=" << cfg_.laser_grid_offset.str() << "\n";
+    ofs << "# laser_wvl_error=" << cfg_.laser_wvl_error.str() << "\n";
+    ofs << "# laser_pwr=" << cfg_.laser_pwr.str() << "\n";
+    ofs << "# ring_wvl_start=" << cfg_.ring_wvl_start << "\n";
+    ofs << "# ring_spacing=" << cfg_.ring_spacing << "\n";
+    ofs << "# ring_fab_offset=" << cfg_.ring_fab_offset.str() << "\n";
+    ofs << "# fwhm_scale=" << cfg_.fwhm_scale.str() << "\n";
+    ofs << "# tune_scale=" << cfg_.tune_scale.str() << "\n";
+
+    ofs << "index,laser_pwr";
+    for (size_t k = 0; k < cfg_.num_lasers; ++k)
+      ofs << ",laser_wvl" << k;
+    for (const char *name : {"ring_wvl", "fwhm_scale", "tune_scale"}) {
+      for (size_t k = 0; k < cfg_.num_rings; ++k)
+        ofs << "," << name << k;
+    }
+    ofs << "\n";
+    for (uint64_t i = first; i < last; ++i) {
+      const Scenario s = generate(i);
+      ofs << s.index << "," << s.laser_pwr;
+      for (double v : s.laser_wvl)
+        ofs << "," << v;
+      for (const auto *vec : {&s.ring_wvl, &s.fwhm_scale, &s.tune_scale}) {
+        for (double v : *vec)
+          ofs << "," << v;
+      }
+      ofs << "\n";
+    }
+  }
+
+  // Rebuild the generator that wrote a manifest
+  static ScenarioGenerator from_manifest(const std::string &filename) {
+    std::ifstream ifs(filename);
+    if (!ifs)
+      throw std::runtime_error("scenario: cannot read " + filename);
+    ScenarioConfig cfg;
+    uint64_t seed = 0;
+    std::string line;
+    while (std::getline(ifs, line) && line.rfind("# ", 0) == 0) {
+      const size_t eq = line.find('=');
+      if (eq == std::string::npos)
+        continue;
+      const std::string key = line.substr(2, eq - 2);
+      const std::string val = line.substr(eq + 1);
+      if (key == "seed")
+        seed = std::stoull(val);
+      else if (key == "num_lasers")
+        cfg.num_lasers = std::stoul(val);
+      else if (key == "num_rings")
+        cfg.num_rings = std::stoul(val);
+      else if (key == "laser_wvl_start")
+        cfg.laser_wvl_start = std::stod(val);
+      else if (key == "laser_spacing")
+        cfg.laser_spacing = std::stod(val);
+      else if (key == "laser_grid_offset")
+        cfg.laser_grid_offset = Dist::parse(val);
+      else if (key == "laser_wvl_error")
+        cfg.laser_wvl_error = Dist::parse(val);
+      else if (key == "laser_pwr")
+        cfg.laser_pwr = Dist::parse(val);
+      else if (key == "ring_wvl_start")
+        cfg.ring_wvl_start = std::stod(val);
+      else if (key == "ring_spacing")
+        cfg.ring_spacing = std::stod(val);
+      else if (key == "ring_fab_offset")
+        cfg.ring_fab_offset = Dist::parse(val);
+      else if (key == "fwhm_scale")
+        cfg.fwhm_scale = Dist::parse(val);
+      else if (key == "tune_scale")
+        cfg.tune_scale = Dist::parse(val);
+    }
+    return ScenarioGenerator(cfg, seed);
+  }
+
+private:
+  double draw(const Dist &d, uint64_t index, uint32_t tag,
+              size_t element) const {
+    if (d.kind == dist_e::CONST)
+      return d.a;
+    const auto r = afe_noise::Philox4x32::generate(
+        {static_cast<uint32_t>(element), tag, static_cast<uint32_t>(index),
+         static_cast<uint32_t>(index >> 32)},
+        {static_cast<uint32_t>(seed_), static_cast<uint32_t>(seed_ >> 32)});
+    return d.sample(r[0], r[1]);
+  }
+
+  ScenarioConfig cfg_;
+  uint64_t seed_;
+};
+// ----------------------------------------------------------------------
+
+// Contiguous slice [first, last) of num_scenarios for shard k of n
+inline std::pair<uint64_t, uint64_t> shard_range(uint64_t num_scenarios,
+                                                 uint64_t shard,
+                                                 uint64_t num_shards) {
+  const uint64_t base = num_scenarios / num_shards;
+  const uint64_t extra = num_scenarios % num_shards;
+  const uint64_t first = shard * base + (shard < extra ? shard : extra);
+  return {first, first + base + (shard < extra ? 1 : 0)};
+}
+
+} // namespace scenario
+
+#endif // SCENARIO_HPP
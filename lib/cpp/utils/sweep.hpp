@@ -1,6 +1,11 @@
 #ifndef SWEEP_H
 #define SWEEP_H
 
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <vector>
+
 typedef std::vector<std::string> csv_row_t;
 typedef std::vector<csv_row_t> csv_t;
 
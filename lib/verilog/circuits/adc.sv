@@ -2,7 +2,9 @@
 // Author: Sunjin Choi
 // Description: 
 // Signals:
-// Note: 
+// Note: i_real_offset and i_real_inl are in LSB. The input is offset, then
+// shifted by the INL of its ideal code before quantization. Benches drive
+// them from lib/cpp/models/afe_noise.hpp (tie to 0.0 for an ideal ADC).
 // Variable naming conventions:
 //    signals => snake_case
 //    Parameters (aliasing signal values) => SNAKE_CASE with all caps
@@ -20,27 +22,40 @@ module adc #(
 ) (
 
     input var real i_ana,
+    input var real i_real_offset,
+    input var real i_real_inl[2**ADC_WIDTH],
     output logic [ADC_WIDTH-1:0] o_dig
 );
 
+  localparam int MaxCode = 2 ** ADC_WIDTH - 1;
+
+  real real_code;
+  real real_code_inl;
+  integer int_code;
+  integer int_code_inl;
+
   /* verilator lint_off REALCVT */
-  integer tmp_int_out = $floor(i_ana * (2 ** ADC_WIDTH - 1) / FullScaleRange);
-  /* verilator lint_off WIDTHTRUNC */
-  /*assign o_dig = tmp_int_out & ((1 << ADC_WIDTH) - 1);*/
   // If it hits the upper limit, it will be truncated to the maximum value.
   always_comb begin
-    if (tmp_int_out < 0) begin
+    real_code = i_ana * MaxCode / FullScaleRange + i_real_offset;
+    int_code = $floor(real_code);
+    if (int_code < 0) int_code = 0;
+    else if (int_code > MaxCode) int_code = MaxCode;
+
+    real_code_inl = real_code - i_real_inl[int_code];
+    int_code_inl = $floor(real_code_inl);
+    if (int_code_inl < 0) begin
       o_dig = '0;  // If the input is negative, output zero.
     end
-    else if (tmp_int_out >= (1 << ADC_WIDTH)) begin
-      o_dig = (1 << ADC_WIDTH) - 1;  // If it exceeds the maximum value, output the maximum value.
+    else if (int_code_inl > MaxCode) begin
+      o_dig = ADC_WIDTH'(MaxCode);  // If it exceeds the maximum value, output the maximum value.
     end
     else begin
-      o_dig = tmp_int_out;
+      o_dig = ADC_WIDTH'(int_code_inl);
     end
   end
+  /* verilator lint_on REALCVT */
 
 endmodule
 
 `default_nettype wire
-
@@ -2,7 +2,8 @@
 // Author: Sunjin Choi
 // Description: 
 // Signals:
-// Note: 
+// Note: i_real_inl is in LSB and indexed by the input code. Benches drive it
+// from lib/cpp/models/afe_noise.hpp (tie to 0.0 for an ideal DAC).
 // Variable naming conventions:
 //    signals => snake_case
 //    Parameters (aliasing signal values) => SNAKE_CASE with all caps
@@ -20,10 +21,12 @@ module dac #(
 ) (
 
     input var logic [DAC_WIDTH-1:0] i_dig,
+    input var real i_real_inl[2**DAC_WIDTH],
     output real o_ana
 );
 
-  assign o_ana = i_dig * FullScaleRange / real'((2 ** DAC_WIDTH - 1));
+  assign o_ana = (real'(i_dig) + i_real_inl[i_dig]) * FullScaleRange /
+      real'((2 ** DAC_WIDTH - 1));
 
 endmodule
 
@@ -0,0 +1,85 @@
+//==============================================================================
+// Author: Sunjin Choi
+// Description: First-order thermal response of ring heaters with nearest-
+// neighbour coupling, between the tuning DAC and the ring resonance
+// Signals:
+//    i_real_tau_cycles: thermal time constant in clock cycles (0 is
+//    instantaneous, i.e. the original combinational DAC -> ring path)
+//    i_real_coupling: fraction of each neighbour's drive seen by a ring
+//    i_real_drive: heater drive per ring (DAC output)
+//    o_real_tuning_dist: resonance tuning per ring (microring tuning input)
+// Note: Per ring, u[i] = d[i] + k * (d[i-1] + d[i+1]) and
+//    o[i] = (1 - a) * t[i] + a * u[i], a = 1 - exp(-1 / tau), t[i] <= o[i]
+// every clock. The output follows the drive within the cycle it changes
+// (a = 1 is exact pass-through) and reset starts the heaters settled.
+// Mirrors lib/cpp/models/ring_tf.hpp HeaterRow.
+// Variable naming conventions:
+//    signals => snake_case
+//    Parameters (aliasing signal values) => SNAKE_CASE with all caps
+//    Module Parameters => ALL_CAPS_SNAKE_CASE
+//    Local Parameters => CamelCase
+//==============================================================================
+
+// verilog_format: off
+`timescale 1ns/1ps
+`default_nettype none
+// verilog_format: on
+
+module heater #(
+    parameter int NUM_CHANNEL = 1
+) (
+    input var logic i_clk,
+    input var logic i_rst,
+
+    input var real i_real_tau_cycles,
+    input var real i_real_coupling,
+
+    // input signals
+    input var real i_real_drive[NUM_CHANNEL],
+
+    // output signals
+    output real o_real_tuning_dist[NUM_CHANNEL]
+);
+
+  // ----------------------------------------------------------------------
+  // Signals
+  // ----------------------------------------------------------------------
+  real alpha;
+  real drive_coupled[NUM_CHANNEL];
+  real temp[NUM_CHANNEL];
+  // ----------------------------------------------------------------------
+
+  // ----------------------------------------------------------------------
+  // Assigns
+  // ----------------------------------------------------------------------
+  always_comb begin : update_alpha
+    alpha = (i_real_tau_cycles > 0.0) ? 1.0 - $exp(-1.0 / i_real_tau_cycles) : 1.0;
+  end
+
+  always_comb begin : couple_drive
+    for (int i = 0; i < NUM_CHANNEL; i++) begin
+      drive_coupled[i] = i_real_drive[i];
+      if (i > 0) drive_coupled[i] += i_real_coupling * i_real_drive[i-1];
+      if (i < NUM_CHANNEL - 1) drive_coupled[i] += i_real_coupling * i_real_drive[i+1];
+    end
+  end
+
+  always_comb begin : thermal_iir
+    for (int i = 0; i < NUM_CHANNEL; i++) begin
+      o_real_tuning_dist[i] = (1.0 - alpha) * temp[i] + alpha * drive_coupled[i];
+    end
+  end
+
+  always_ff @(posedge i_clk or posedge i_rst) begin
+    if (i_rst) begin
+      temp <= drive_coupled;
+    end
+    else begin
+      temp <= o_real_tuning_dist;
+    end
+  end
+  // ----------------------------------------------------------------------
+
+endmodule
+
+`default_nettype wire
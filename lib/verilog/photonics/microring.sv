@@ -27,6 +27,10 @@ module microring #(
     input var real i_real_tuning_dist,
     input var real i_real_temperature,
 
+    // Fabrication variation: multiply FWHM / TuningFullScale (nominal 1.0)
+    input var real i_real_fwhm_scale,
+    input var real i_real_tune_scale,
+
     // output signals
     output waves_t o_phot_waves_drop,
     output waves_t o_phot_waves_thru
@@ -44,11 +48,13 @@ module microring #(
   // Assigns
   // ----------------------------------------------------------------------
   /*initial ring_resonance_wavelength = ResonanceWavelength;*/
-  initial ring_fwhm = FWHM;
+  always_comb ring_fwhm = FWHM * i_real_fwhm_scale;
 
   // TODO: implement temperature sensitivity
-  always @(i_real_tuning_dist, i_real_temperature) begin : update_resonance
-    ring_resonance_wavelength = i_real_wvl_ring + i_real_tuning_dist * TuningFullScale;
+  always @(i_real_wvl_ring, i_real_tuning_dist, i_real_tune_scale, i_real_temperature)
+  begin : update_resonance
+    ring_resonance_wavelength =
+        i_real_wvl_ring + i_real_tuning_dist * TuningFullScale * i_real_tune_scale;
   end
 
   always_comb begin : ring_tf
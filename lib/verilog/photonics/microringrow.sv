@@ -28,6 +28,10 @@ module microringrow #(
     input var real i_real_tuning_dist[NUM_CHANNEL],
     input var real i_real_temperature[NUM_CHANNEL],
 
+    // Per-ring fabrication variation (nominal 1.0), see microring
+    input var real i_real_fwhm_scale[NUM_CHANNEL],
+    input var real i_real_tune_scale[NUM_CHANNEL],
+
     // output signals
     output waves_t o_phot_waves_drop[NUM_CHANNEL],
     output waves_t o_phot_waves_thru
@@ -63,6 +67,8 @@ module microringrow #(
           .i_real_wvl_ring(i_real_wvl_ring[i]),
           .i_real_tuning_dist(i_real_tuning_dist[i]),
           .i_real_temperature(i_real_temperature[i]),
+          .i_real_fwhm_scale(i_real_fwhm_scale[i]),
+          .i_real_tune_scale(i_real_tune_scale[i]),
           .o_phot_waves_drop(o_phot_waves_drop[i]),
           .o_phot_waves_thru(waves_thru_int[i])
       );
@@ -2,7 +2,8 @@
 // Author: Sunjin Choi
 // Description: 
 // Signals:
-// Note: 
+// Note: i_real_noise is added to the output current; benches drive it from
+// lib/cpp/models/afe_noise.hpp (tie to 0.0 for an ideal detector).
 // Variable naming conventions:
 //    signals => snake_case
 //    Parameters (aliasing signal values) => SNAKE_CASE with all caps
@@ -21,6 +22,7 @@ module photodetector #(
 
     // input signals
     input var waves_t i_phot_waves,
+    input var real i_real_noise,
 
     // output signals
     output real o_real_current
@@ -46,7 +48,7 @@ module photodetector #(
   // ----------------------------------------------------------------------
   // Assigns
   // ----------------------------------------------------------------------
-  assign o_real_current = real_pwr_tot * Responsivity;
+  assign o_real_current = real_pwr_tot * Responsivity + i_real_noise;
   // ----------------------------------------------------------------------
 
 endmodule
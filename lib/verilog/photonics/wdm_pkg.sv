@@ -19,6 +19,8 @@ package wdm_pkg;
   `DEFINE_WAVES_TYPE(4)
   `DEFINE_WAVES_TYPE(8)
   `DEFINE_WAVES_TYPE(16)
+  `DEFINE_WAVES_TYPE(32)
+  `DEFINE_WAVES_TYPE(64)
 
   `define DECLARE_WAVES_TYPE(WIDTH) \
     typedef waves``WIDTH``_t WAVES_TYPE; \
@@ -0,0 +1,470 @@
+//==============================================================================
+// Author: Sunjin Choi
+// Description: Host command sequencer in front of a single tuner_phy. Queues
+// tuner_cmd_e commands from the host and executes them back-to-back on the
+// search/lock interfaces, reporting one completion event per command.
+// Signals:
+//    i_cmd_*   : command push (val/rdy), CMD_DEPTH entries
+//    o_evt_*   : completion event pop (val/rdy), CMD_DEPTH entries
+// Note:
+//    INIT   arg0 = search start, arg1 = search end, arg2 = search stride
+//    SEARCH sweeps the INIT window; keeps the max-power peak for LOCK
+//    LOCK   arg0 = signed start offset from the peak, arg1 = settle time in
+//           units of 2**LOCK_SETTLE_SHIFT cycles spent in LOCK_ACTIVE
+//    UNLOCK interrupts the lock and returns it to LOCK_IDLE
+//    A command completes with DONE or ERROR (no peak found, lock requested
+//    without a peak, search/lock requested while locked, lock lost at the
+//    end of settling). Commands run in order; an ERROR does not flush the
+//    queue.
+// Variable naming conventions:
+//    signals => snake_case
+//    Parameters (aliasing signal values) => SNAKE_CASE with all caps
+//    Module Parameters => ALL_CAPS_SNAKE_CASE
+//    Local Parameters => CamelCase
+//==============================================================================
+
+// verilog_format: off
+`timescale 1ns/1ps
+`default_nettype none
+// verilog_format: on
+
+import tuner_phy_pkg::*;
+
+// tuner_pkg imported locally: its ERROR state shadows tuner_dir_e::ERROR
+module tuner_cmd_seq
+  import tuner_pkg::*;
+#(
+    parameter int DAC_WIDTH = 8,
+    parameter int ADC_WIDTH = 8,
+    parameter int NUM_TARGET = 8,
+    parameter int CMD_DEPTH = 8,
+    parameter int LOCK_SETTLE_SHIFT = 6,
+    parameter int EVT_CYCLE_WIDTH = 32
+) (
+    input var logic i_clk,
+    input var logic i_rst,
+
+    // Host command queue
+    input var logic i_cmd_val,
+    output logic o_cmd_rdy,
+    input var tuner_cmd_e i_cmd,
+    input var logic [DAC_WIDTH-1:0] i_cmd_arg0,
+    input var logic [DAC_WIDTH-1:0] i_cmd_arg1,
+    input var logic [$clog2(DAC_WIDTH)-1:0] i_cmd_arg2,
+
+    // Completion events
+    output logic o_evt_val,
+    input var logic i_evt_rdy,
+    output tuner_cmd_e o_evt_cmd,
+    output tuner_state_e o_evt_state,
+    output logic [DAC_WIDTH-1:0] o_evt_ring_tune,
+    output logic [ADC_WIDTH-1:0] o_evt_pwr,
+    output logic [$clog2(NUM_TARGET)-1:0] o_evt_peaks_cnt,
+    output logic [EVT_CYCLE_WIDTH-1:0] o_evt_cycle_cnt,
+
+    // Tuner PHY status
+    input var logic [DAC_WIDTH-1:0] i_dig_ring_tune,
+    input var logic [ADC_WIDTH-1:0] i_dig_ring_pwr,
+    input var tuner_phy_lock_state_e i_dig_lock_state_mon,
+    input var logic i_dig_lock_err,
+
+    // Tuner PHY config driven by the sequencer
+    output logic [DAC_WIDTH-1:0] o_cfg_ring_tune_start,
+    output logic [DAC_WIDTH-1:0] o_cfg_ring_tune_end,
+    output logic [$clog2(DAC_WIDTH)-1:0] o_cfg_ring_tune_stride,
+    output logic [ADC_WIDTH-1:0] o_cfg_pwr_peak,
+    output logic [DAC_WIDTH-1:0] o_cfg_ring_tune_peak,
+
+    tuner_search_if.consumer search_if,
+    tuner_lock_if.consumer   lock_if,
+
+    output tuner_state_e o_state,
+    output tuner_phy_seq_state_e o_seq_state_mon,
+    output logic o_locked
+);
+
+  // ----------------------------------------------------------------------
+  // Types
+  // ----------------------------------------------------------------------
+  typedef struct packed {
+    tuner_cmd_e cmd;
+    logic [DAC_WIDTH-1:0] arg0;
+    logic [DAC_WIDTH-1:0] arg1;
+    logic [$clog2(DAC_WIDTH)-1:0] arg2;
+  } cmd_entry_t;
+
+  typedef struct packed {
+    tuner_cmd_e cmd;
+    tuner_state_e state;
+    logic [DAC_WIDTH-1:0] ring_tune;
+    logic [ADC_WIDTH-1:0] pwr;
+    logic [$clog2(NUM_TARGET)-1:0] peaks_cnt;
+    logic [EVT_CYCLE_WIDTH-1:0] cycle_cnt;
+  } evt_entry_t;
+  // ----------------------------------------------------------------------
+
+  // ----------------------------------------------------------------------
+  // Signals
+  // ----------------------------------------------------------------------
+  localparam int PtrWidth = $clog2(CMD_DEPTH);
+  localparam int SettleWidth = DAC_WIDTH + LOCK_SETTLE_SHIFT;
+
+  tuner_phy_seq_state_e state, state_next;
+
+  // Command queue
+  cmd_entry_t cmd_mem[CMD_DEPTH];
+  logic [PtrWidth-1:0] cmd_wr_ptr, cmd_rd_ptr;
+  logic [PtrWidth:0] cmd_cnt;
+  logic cmd_push, cmd_pop;
+  cmd_entry_t cmd_head;
+  cmd_entry_t cmd_curr;
+
+  // Event queue
+  evt_entry_t evt_mem[CMD_DEPTH];
+  logic [PtrWidth-1:0] evt_wr_ptr, evt_rd_ptr;
+  logic [PtrWidth:0] evt_cnt;
+  logic evt_push, evt_pop;
+  evt_entry_t evt_head;
+  evt_entry_t evt_curr;
+
+  // Issue / completion
+  logic cmd_issue;
+  logic lock_idle;
+  logic search_trig_fire, search_peaks_fire;
+  logic lock_trig_fire, lock_resume_fire;
+  logic settle_done;
+  logic [SettleWidth-1:0] settle_cnt;
+  logic [EVT_CYCLE_WIDTH-1:0] cycle_cnt;
+
+  // Search window from INIT
+  logic [DAC_WIDTH-1:0] search_start, search_end;
+  logic [$clog2(DAC_WIDTH)-1:0] search_stride;
+
+  // Best peak from the last SEARCH
+  logic peak_valid;
+  logic [DAC_WIDTH-1:0] ring_tune_peak;
+  logic [ADC_WIDTH-1:0] pwr_peak;
+  logic [DAC_WIDTH-1:0] ring_tune_peak_best;
+  logic [ADC_WIDTH-1:0] pwr_peak_best;
+
+  // Lock start from the LOCK offset
+  logic signed [DAC_WIDTH+1:0] lock_start_sum;
+  logic [DAC_WIDTH-1:0] lock_start;
+  logic [DAC_WIDTH-1:0] lock_start_curr;
+  logic lock_sel;
+  logic lock_done;
+  // ----------------------------------------------------------------------
+
+  // ----------------------------------------------------------------------
+  // Command Queue
+  // ----------------------------------------------------------------------
+  assign o_cmd_rdy = (cmd_cnt != (PtrWidth + 1)'(CMD_DEPTH));
+  assign cmd_push = i_cmd_val && o_cmd_rdy;
+  assign cmd_head = cmd_mem[cmd_rd_ptr];
+
+  always_ff @(posedge i_clk) begin
+    if (cmd_push) begin
+      cmd_mem[cmd_wr_ptr] <= '{cmd: i_cmd, arg0: i_cmd_arg0, arg1: i_cmd_arg1, arg2: i_cmd_arg2};
+    end
+  end
+
+  always_ff @(posedge i_clk or posedge i_rst) begin
+    if (i_rst) begin
+      cmd_wr_ptr <= '0;
+      cmd_rd_ptr <= '0;
+      cmd_cnt <= '0;
+    end
+    else begin
+      if (cmd_push) cmd_wr_ptr <= (cmd_wr_ptr == PtrWidth'(CMD_DEPTH - 1)) ? '0 : cmd_wr_ptr + 1'b1;
+      if (cmd_pop) cmd_rd_ptr <= (cmd_rd_ptr == PtrWidth'(CMD_DEPTH - 1)) ? '0 : cmd_rd_ptr + 1'b1;
+      cmd_cnt <= cmd_cnt + cmd_push - cmd_pop;
+    end
+  end
+  // ----------------------------------------------------------------------
+
+  // ----------------------------------------------------------------------
+  // Event Queue
+  // ----------------------------------------------------------------------
+  assign evt_head = evt_mem[evt_rd_ptr];
+  assign o_evt_val = (evt_cnt != '0);
+  assign evt_pop = o_evt_val && i_evt_rdy;
+  assign o_evt_cmd = evt_head.cmd;
+  assign o_evt_state = evt_head.state;
+  assign o_evt_ring_tune = evt_head.ring_tune;
+  assign o_evt_pwr = evt_head.pwr;
+  assign o_evt_peaks_cnt = evt_head.peaks_cnt;
+  assign o_evt_cycle_cnt = evt_head.cycle_cnt;
+
+  always_ff @(posedge i_clk) begin
+    if (evt_push) begin
+      evt_mem[evt_wr_ptr] <= evt_curr;
+    end
+  end
+
+  always_ff @(posedge i_clk or posedge i_rst) begin
+    if (i_rst) begin
+      evt_wr_ptr <= '0;
+      evt_rd_ptr <= '0;
+      evt_cnt <= '0;
+    end
+    else begin
+      if (evt_push) evt_wr_ptr <= (evt_wr_ptr == PtrWidth'(CMD_DEPTH - 1)) ? '0 : evt_wr_ptr + 1'b1;
+      if (evt_pop) evt_rd_ptr <= (evt_rd_ptr == PtrWidth'(CMD_DEPTH - 1)) ? '0 : evt_rd_ptr + 1'b1;
+      evt_cnt <= evt_cnt + evt_push - evt_pop;
+    end
+  end
+  // ----------------------------------------------------------------------
+
+  // ----------------------------------------------------------------------
+  // State Machine
+  // ----------------------------------------------------------------------
+  // Issue only with room for the completion event, so events never drop
+  assign cmd_issue = (state == SEQ_IDLE) && (cmd_cnt != '0) &&
+      (evt_cnt != (PtrWidth + 1)'(CMD_DEPTH));
+  assign cmd_pop = cmd_issue;
+  assign evt_push = (state == SEQ_REPORT);
+
+  assign lock_idle = (i_dig_lock_state_mon == LOCK_IDLE);
+  assign search_trig_fire = (state == SEQ_SEARCH_TRIG) && search_if.get_trig_ack();
+  assign search_peaks_fire = (state == SEQ_SEARCH_WAIT) && search_if.get_peaks_ack();
+  assign lock_trig_fire = (state == SEQ_LOCK_TRIG) && lock_if.get_trig_ack();
+  assign lock_resume_fire = (state == SEQ_UNLOCK_RESUME) && lock_if.get_resume_ack();
+  assign settle_done = (state == SEQ_LOCK_SETTLE) && (settle_cnt == '0);
+
+  always_ff @(posedge i_clk or posedge i_rst) begin
+    if (i_rst) begin
+      state <= SEQ_IDLE;
+    end
+    else begin
+      state <= state_next;
+    end
+  end
+
+  always_comb begin
+    state_next = state;
+    case (state)
+      SEQ_IDLE: begin
+        if (cmd_issue) begin
+          case (cmd_head.cmd)
+            SEARCH: state_next = lock_idle ? SEQ_SEARCH_TRIG : SEQ_REPORT;
+            LOCK: state_next = (lock_idle && peak_valid) ? SEQ_LOCK_TRIG : SEQ_REPORT;
+            UNLOCK: state_next = lock_idle ? SEQ_REPORT : SEQ_UNLOCK_INTR;
+            default: state_next = SEQ_REPORT;
+          endcase
+        end
+      end
+      SEQ_SEARCH_TRIG: if (search_trig_fire) state_next = SEQ_SEARCH_WAIT;
+      SEQ_SEARCH_WAIT: if (search_peaks_fire) state_next = SEQ_REPORT;
+      SEQ_LOCK_TRIG: if (lock_trig_fire) state_next = SEQ_LOCK_SETTLE;
+      SEQ_LOCK_SETTLE: if (settle_done) state_next = SEQ_REPORT;
+      SEQ_UNLOCK_INTR: if (i_dig_lock_state_mon == LOCK_INTR) state_next = SEQ_UNLOCK_RESUME;
+      SEQ_UNLOCK_RESUME: if (lock_resume_fire) state_next = SEQ_REPORT;
+      SEQ_REPORT: state_next = SEQ_IDLE;
+      default: state_next = SEQ_IDLE;
+    endcase
+  end
+
+  // Cycles since issue, reported with each event
+  always_ff @(posedge i_clk or posedge i_rst) begin
+    if (i_rst) begin
+      cycle_cnt <= '0;
+    end
+    else if (cmd_issue) begin
+      cycle_cnt <= '0;
+    end
+    else if (cycle_cnt != '1) begin
+      cycle_cnt <= cycle_cnt + 1'b1;
+    end
+  end
+
+  always_ff @(posedge i_clk or posedge i_rst) begin
+    if (i_rst) begin
+      cmd_curr <= '0;
+    end
+    else if (cmd_issue) begin
+      cmd_curr <= cmd_head;
+    end
+  end
+
+  assign o_state = (state != SEQ_IDLE) ? ACTIVE : (cmd_cnt != '0) ? ACTIVE : IDLE;
+  assign o_seq_state_mon = state;
+  // ----------------------------------------------------------------------
+
+  // ----------------------------------------------------------------------
+  // INIT - Search Window
+  // ----------------------------------------------------------------------
+  always_ff @(posedge i_clk or posedge i_rst) begin
+    if (i_rst) begin
+      search_start <= '0;
+      search_end <= '1;
+      search_stride <= '0;
+    end
+    else if (cmd_issue && (cmd_head.cmd == INIT)) begin
+      search_start <= cmd_head.arg0;
+      search_end <= cmd_head.arg1;
+      search_stride <= cmd_head.arg2;
+    end
+  end
+  // ----------------------------------------------------------------------
+
+  // ----------------------------------------------------------------------
+  // SEARCH - Peak Selection
+  // ----------------------------------------------------------------------
+  assign search_if.trig_val = (state == SEQ_SEARCH_TRIG);
+  assign search_if.peaks_rdy = (state == SEQ_SEARCH_WAIT);
+
+  // Max-power peak among the reported ones (first wins on ties)
+  always_comb begin
+    ring_tune_peak_best = search_if.ring_tune_peaks[0];
+    pwr_peak_best = search_if.pwr_peaks[0];
+    for (int i = 1; i < NUM_TARGET; i++) begin
+      if ((i < int'(search_if.peaks_cnt)) && (search_if.pwr_peaks[i] > pwr_peak_best)) begin
+        ring_tune_peak_best = search_if.ring_tune_peaks[i];
+        pwr_peak_best = search_if.pwr_peaks[i];
+      end
+    end
+  end
+
+  always_ff @(posedge i_clk or posedge i_rst) begin
+    if (i_rst) begin
+      peak_valid <= 1'b0;
+      ring_tune_peak <= '0;
+      pwr_peak <= '0;
+    end
+    else if (search_trig_fire) begin
+      peak_valid <= 1'b0;
+    end
+    else if (search_peaks_fire) begin
+      peak_valid <= (search_if.peaks_cnt != '0);
+      ring_tune_peak <= ring_tune_peak_best;
+      pwr_peak <= pwr_peak_best;
+    end
+  end
+  // ----------------------------------------------------------------------
+
+  // ----------------------------------------------------------------------
+  // LOCK - Start Offset and Settling
+  // ----------------------------------------------------------------------
+  assign lock_start_sum = $signed({2'b00, ring_tune_peak}) +
+      $signed({{2{cmd_head.arg0[DAC_WIDTH-1]}}, cmd_head.arg0});
+  always_comb begin
+    if (lock_start_sum < 0) begin
+      lock_start = '0;
+    end
+    else if (lock_start_sum > $signed({2'b00, {DAC_WIDTH{1'b1}}})) begin
+      lock_start = '1;
+    end
+    else begin
+      lock_start = lock_start_sum[DAC_WIDTH-1:0];
+    end
+  end
+
+  // i_cfg_ring_tune_start is shared: sweep start for search, start code for
+  // lock. Hold the lock start from LOCK issue until the next SEARCH.
+  always_ff @(posedge i_clk or posedge i_rst) begin
+    if (i_rst) begin
+      lock_sel <= 1'b0;
+      lock_start_curr <= '0;
+    end
+    else if (cmd_issue && (cmd_head.cmd == LOCK)) begin
+      lock_sel <= 1'b1;
+      lock_start_curr <= lock_start;
+    end
+    else if (cmd_issue && (cmd_head.cmd == SEARCH)) begin
+      lock_sel <= 1'b0;
+    end
+  end
+
+  assign lock_if.trig_val = (state == SEQ_LOCK_TRIG);
+
+  // Settle counts cycles in LOCK_ACTIVE only, so re-acquire time is excluded
+  always_ff @(posedge i_clk or posedge i_rst) begin
+    if (i_rst) begin
+      settle_cnt <= '0;
+    end
+    else if (cmd_issue && (cmd_head.cmd == LOCK)) begin
+      settle_cnt <= SettleWidth'(cmd_head.arg1) << LOCK_SETTLE_SHIFT;
+    end
+    else if ((state == SEQ_LOCK_SETTLE) && (i_dig_lock_state_mon == LOCK_ACTIVE) &&
+             (settle_cnt != '0)) begin
+      settle_cnt <= settle_cnt - 1'b1;
+    end
+  end
+  // ----------------------------------------------------------------------
+
+  // ----------------------------------------------------------------------
+  // UNLOCK - Interrupt and Resume
+  // ----------------------------------------------------------------------
+  // tuner_lock_phy raises intr_val once intr_rdy drops; accept it next cycle
+  assign lock_if.intr_rdy = (state == SEQ_UNLOCK_INTR) ? lock_if.intr_val : 1'b1;
+  assign lock_if.resume_val = (state == SEQ_UNLOCK_RESUME);
+  // ----------------------------------------------------------------------
+
+  // ----------------------------------------------------------------------
+  // Completion Events
+  // ----------------------------------------------------------------------
+  always_ff @(posedge i_clk or posedge i_rst) begin
+    if (i_rst) begin
+      evt_curr <= '0;
+    end
+    else if (state_next == SEQ_REPORT) begin
+      evt_curr.cmd <= (state == SEQ_IDLE) ? cmd_head.cmd : cmd_curr.cmd;
+      evt_curr.ring_tune <= i_dig_ring_tune;
+      evt_curr.pwr <= i_dig_ring_pwr;
+      evt_curr.peaks_cnt <= '0;
+      evt_curr.cycle_cnt <= (state == SEQ_IDLE) ? '0 : cycle_cnt;
+      case (state)
+        SEQ_IDLE: begin
+          // Immediate completion: INIT, UNLOCK when idle, or a rejection
+          evt_curr.state <= ((cmd_head.cmd == INIT) ||
+                             ((cmd_head.cmd == UNLOCK) && lock_idle)) ? DONE : tuner_pkg::ERROR;
+          if (cmd_head.cmd == INIT) begin
+            evt_curr.ring_tune <= cmd_head.arg0;
+          end
+        end
+        SEQ_SEARCH_WAIT: begin
+          evt_curr.state <= (search_if.peaks_cnt != '0) ? DONE : tuner_pkg::ERROR;
+          evt_curr.ring_tune <= ring_tune_peak_best;
+          evt_curr.pwr <= pwr_peak_best;
+          evt_curr.peaks_cnt <= search_if.peaks_cnt;
+        end
+        SEQ_LOCK_SETTLE: begin
+          evt_curr.state <= i_dig_lock_err ? tuner_pkg::ERROR : DONE;
+        end
+        default: begin
+          evt_curr.state <= DONE;
+        end
+      endcase
+    end
+  end
+
+  // Locked once a LOCK completes, until the next UNLOCK or lock loss
+  always_ff @(posedge i_clk or posedge i_rst) begin
+    if (i_rst) begin
+      lock_done <= 1'b0;
+    end
+    else if (evt_push) begin
+      if (is_lock_done(evt_curr.cmd, evt_curr.state)) lock_done <= 1'b1;
+      else if (evt_curr.cmd == UNLOCK) lock_done <= 1'b0;
+    end
+    else if (lock_idle) begin
+      lock_done <= 1'b0;
+    end
+  end
+
+  assign o_locked = lock_done && !i_dig_lock_err;
+  // ----------------------------------------------------------------------
+
+  // ----------------------------------------------------------------------
+  // Tuner PHY Config
+  // ----------------------------------------------------------------------
+  assign o_cfg_ring_tune_start = lock_sel ? lock_start_curr : search_start;
+  assign o_cfg_ring_tune_end = search_end;
+  assign o_cfg_ring_tune_stride = search_stride;
+  assign o_cfg_pwr_peak = pwr_peak;
+  assign o_cfg_ring_tune_peak = ring_tune_peak;
+  // ----------------------------------------------------------------------
+
+endmodule
+
+`default_nettype wire
@@ -19,7 +19,9 @@
 
 interface tuner_ctrl_arb_if #(
     parameter int DAC_WIDTH = 8,
-    parameter int ADC_WIDTH = 8
+    parameter int ADC_WIDTH = 8,
+    // Controller clients on channels 1..NUM_CLIENT (CH_SEARCH, CH_LOCK, ...)
+    parameter int NUM_CLIENT = 2
 ) (
     input logic i_clk,
     input logic i_rst
@@ -29,10 +31,8 @@ interface tuner_ctrl_arb_if #(
   // ----------------------------------------------------------------------
   // Signals
   // ----------------------------------------------------------------------
-  // Assume two channels always (Search/Lock Ctrl PHYs)
-  // Search ctrl channel: CH_SEARCH (1'b0)
-  // Lock ctrl channel: CH_LOCK (1'b1)
-  localparam int NumChannel = 4;
+  // Channel-indexed; entry 0 (CH_NULL) is unused
+  localparam int NumChannel = NUM_CLIENT + 1;
 
   logic                 ctrl_refresh     [NumChannel];
   logic                 ctrl_active      [NumChannel];
@@ -52,8 +52,22 @@ interface tuner_ctrl_arb_if #(
   // Controller
   logic                 commit_rdy       [NumChannel];
 
+  // QoS config, driven by the instantiating module. All weights zero is
+  // fixed priority (lowest channel first); any nonzero weight switches to
+  // weighted round-robin, where a channel keeps the grant for up to
+  // cfg_weight (min 1) transactions in a row. With cfg_lock_max_wait != 0,
+  // CH_LOCK is granted once it has waited that many transactions.
+  logic [3:0]           cfg_weight       [NumChannel];
+  logic [3:0]           cfg_lock_max_wait;
+
   // Internal signal
+  // ch_prev owns the last granted transaction (and so its commit)
   tuner_ctrl_ch_e ch_curr, ch_prev;
+  tuner_ctrl_ch_e ch_grant;
+  tuner_ctrl_ch_e rr_ch;
+  logic [3:0] rr_cnt;
+  logic [3:0] lock_wait;
+  logic txn_busy;
   // ----------------------------------------------------------------------
 
   // ----------------------------------------------------------------------
@@ -67,90 +81,181 @@ interface tuner_ctrl_arb_if #(
     return commit_rdy[ch] && commit_val;
   endfunction
 
-  // Priority level for multi-channel design
-  // 1. Search takes priority over Lock
-  // 2. If one claims ring_tune, it should also claim commit
-  // TODO: implemenet explicit channel select instead?
+  function automatic logic is_wrr();
+    for (int c = 1; c < NumChannel; c++) begin
+      if (cfg_weight[c] != '0) return 1'b1;
+    end
+    return 1'b0;
+  endfunction
+
+  function automatic logic [3:0] get_burst_len(tuner_ctrl_ch_e ch);
+    return (cfg_weight[ch] == '0) ? 4'd1 : cfg_weight[ch];
+  endfunction
+
+  // Tune grant, one transaction at a time
+  // 1. CH_LOCK once it has waited cfg_lock_max_wait grants
+  // 2. Fixed priority, or WRR: finish the current burst, then the next
+  //    requesting channel after it
+  // The commit always goes back to the granted channel (ch_prev)
   function automatic tuner_ctrl_ch_e select_channel();
-    logic search_tune_ack, search_commit_ack;
-    logic lock_tune_ack, lock_commit_ack;
-
-    search_tune_ack = get_ctrl_tune_ch_ack(CH_SEARCH);
-    search_commit_ack = get_ctrl_commit_ch_ack(CH_SEARCH);
-    lock_tune_ack = get_ctrl_tune_ch_ack(CH_LOCK);
-    lock_commit_ack = get_ctrl_commit_ch_ack(CH_LOCK);
-
-    // TODO: does this need to be stateful?
-    if (search_tune_ack) return CH_SEARCH;
-    else if (lock_tune_ack) return CH_LOCK;
-    else if (search_commit_ack) return CH_SEARCH;
-    else if (lock_commit_ack) return CH_LOCK;
-    /*else return CH_SEARCH;  // Default to search channel if no ack*/
-    /*else
-     *  return ch_curr;  // Need to latch channel state*/
-    else
+    tuner_ctrl_ch_e ch;
+    if (!tune_rdy) return CH_NULL;
+
+    if ((NumChannel > int'(CH_LOCK)) && tune_val[CH_LOCK] &&
+        (cfg_lock_max_wait != '0) && (lock_wait >= cfg_lock_max_wait))
+      return CH_LOCK;
+
+    if (!is_wrr()) begin
+      for (int c = 1; c < NumChannel; c++) begin
+        if (tune_val[c]) return tuner_ctrl_ch_e'(c);
+      end
       return CH_NULL;
+    end
+
+    if (tune_val[rr_ch] && (rr_cnt < get_burst_len(rr_ch))) return rr_ch;
+    for (int i = 1; i < NumChannel; i++) begin
+      ch = tuner_ctrl_ch_e'((int'(rr_ch) - 1 + i) % NUM_CLIENT + 1);
+      if (tune_val[ch]) return ch;
+    end
+    return CH_NULL;
   endfunction
 
-  // Update current channel
+  assign ch_grant = select_channel();
+
+  // Update owner, WRR burst, and lock wait at every grant
   always_ff @(posedge i_clk or posedge i_rst) begin
     if (i_rst) begin
       ch_prev <= CH_SEARCH;  // Default to search channel on reset
+      rr_ch <= CH_SEARCH;
+      rr_cnt <= '0;
+      lock_wait <= '0;
     end
-    else begin
-      if (select_channel() != CH_NULL) begin
-        ch_prev <= select_channel();
+    else if (ch_grant != CH_NULL) begin
+      ch_prev <= ch_grant;
+      if (ch_grant == rr_ch) begin
+        rr_cnt <= (rr_cnt == '1) ? rr_cnt : rr_cnt + 1'b1;
+      end
+      else begin
+        rr_ch <= ch_grant;
+        rr_cnt <= 4'd1;
+      end
+      if ((NumChannel > int'(CH_LOCK)) && (ch_grant != CH_LOCK) && tune_val[CH_LOCK]) begin
+        lock_wait <= (lock_wait == '1) ? lock_wait : lock_wait + 1'b1;
+      end
+      else begin
+        lock_wait <= '0;
       end
     end
+    else if ((NumChannel > int'(CH_LOCK)) && !tune_val[CH_LOCK]) begin
+      lock_wait <= '0;
+    end
   end
 
-  assign ch_curr = (select_channel() == CH_NULL) ? ch_prev : select_channel();
+  assign ch_curr = (ch_grant == CH_NULL) ? ch_prev : ch_grant;
+
+  // Transaction in flight from grant to commit; its owner must still be
+  // active, or the power detector never completes it
+  always_ff @(posedge i_clk or posedge i_rst) begin
+    if (i_rst) begin
+      txn_busy <= 1'b0;
+    end
+    else if (get_ctrl_refresh()) begin
+      txn_busy <= 1'b0;
+    end
+    else if (ch_grant != CH_NULL) begin
+      txn_busy <= 1'b1;
+    end
+    else if (any_ctrl_commit_ack()) begin
+      txn_busy <= 1'b0;
+    end
+  end
+
+  // Functional coverage (verilator --coverage-user): contended selects
+  cov_sim_tune_ack :
+  cover property (@(posedge i_clk) disable iff (i_rst)
+      get_ctrl_tune_ch_ack(CH_SEARCH) && get_ctrl_tune_ch_ack(CH_LOCK));
+  cov_sim_commit_ack :
+  cover property (@(posedge i_clk) disable iff (i_rst)
+      get_ctrl_commit_ch_ack(CH_SEARCH) && get_ctrl_commit_ch_ack(CH_LOCK));
+  cov_lock_tune_over_search_commit :
+  cover property (@(posedge i_clk) disable iff (i_rst)
+      get_ctrl_tune_ch_ack(CH_LOCK) && get_ctrl_commit_ch_ack(CH_SEARCH));
+  cov_ch_switch :
+  cover property (@(posedge i_clk) disable iff (i_rst)
+      (ch_grant != CH_NULL) && (ch_grant != ch_prev));
+  cov_lock_wait_bound :
+  cover property (@(posedge i_clk) disable iff (i_rst)
+      (ch_grant == CH_LOCK) && (cfg_lock_max_wait != '0) &&
+      (lock_wait >= cfg_lock_max_wait));
+  cov_refresh_held :
+  cover property (@(posedge i_clk) disable iff (i_rst)
+      any_ctrl_refresh() && !get_ctrl_refresh());
   // ----------------------------------------------------------------------
 
   // ----------------------------------------------------------------------
   // APIs
   // ----------------------------------------------------------------------
   function automatic logic get_ctrl_tune_ack(tuner_ctrl_ch_e ch);
-    /*return get_ctrl_tune_ch_ack(ch) && (select_channel() == ch);*/
     return get_ctrl_tune_ch_ack(ch) && (ch_curr == ch);
   endfunction
 
   function automatic logic get_ctrl_commit_ack(tuner_ctrl_ch_e ch);
-    /*return get_ctrl_commit_ch_ack(ch) && (select_channel() == ch);*/
     return get_ctrl_commit_ch_ack(ch) && (ch_curr == ch);
   endfunction
 
-  // FIXME
+  function automatic logic any_ctrl_refresh();
+    for (int c = 1; c < NumChannel; c++) begin
+      if (ctrl_refresh[c]) return 1'b1;
+    end
+    return 1'b0;
+  endfunction
+
+  // A refresh restarts the arbiter and power detector, so while another
+  // channel's transaction is in flight (or being granted) it is held off
+  // until that transaction commits. The refreshing channel is not waiting
+  // on the arbiter, so nothing is lost.
   function automatic logic get_ctrl_refresh();
-    // ***CAUTION***
-    // One channel should never be in the "refresh" state while another
-    // is in active state
-    // Currently it is not happening, as refresh is only happening during INIT
-    // TODO: flag error state
-    return ctrl_refresh[CH_SEARCH] || ctrl_refresh[CH_LOCK];
+    logic busy;
+    busy = txn_busy && ctrl_active[ch_prev];
+    for (int c = 1; c < NumChannel; c++) begin
+      if (ctrl_refresh[c] && !(busy && (ch_prev != tuner_ctrl_ch_e'(c))) &&
+          !((ch_grant != CH_NULL) && (ch_grant != tuner_ctrl_ch_e'(c))))
+        return 1'b1;
+    end
+    return 1'b0;
   endfunction
 
   function automatic logic get_pwr_detect_active();
-    /*return ctrl_active[select_channel()];*/
     return ctrl_active[ch_curr];
   endfunction
 
+  function automatic tuner_ctrl_ch_e get_ctrl_ch();
+    return ch_curr;
+  endfunction
+
+  // Granted channel in the tune fire cycle, CH_NULL otherwise (monitor)
+  function automatic tuner_ctrl_ch_e get_ctrl_grant();
+    return ch_grant;
+  endfunction
+
   function automatic logic [DAC_WIDTH-1:0] get_ring_tune();
-    /*return ring_tune[select_channel()];*/
     return ring_tune[ch_curr];
   endfunction
 
   // Polling functions
   function automatic logic any_ctrl_tune_val();
-    return tune_val[CH_SEARCH] || tune_val[CH_LOCK];
+    for (int c = 1; c < NumChannel; c++) begin
+      if (tune_val[c]) return 1'b1;
+    end
+    return 1'b0;
   endfunction
 
   function automatic logic any_ctrl_tune_ack();
-    return get_ctrl_tune_ack(CH_SEARCH) || get_ctrl_tune_ack(CH_LOCK);
+    return ch_grant != CH_NULL;
   endfunction
 
   function automatic logic any_ctrl_commit_ack();
-    return get_ctrl_commit_ack(CH_SEARCH) || get_ctrl_commit_ack(CH_LOCK);
+    return get_ctrl_commit_ack(ch_prev);
   endfunction
   // ----------------------------------------------------------------------
 
@@ -190,6 +295,8 @@ interface tuner_ctrl_arb_if #(
       import get_ctrl_refresh,
       import get_pwr_detect_active,
       import get_ring_tune,
+      import get_ctrl_ch,
+      import get_ctrl_grant,
       import any_ctrl_tune_val,
       import any_ctrl_tune_ack,
       import any_ctrl_commit_ack
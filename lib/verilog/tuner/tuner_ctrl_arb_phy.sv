@@ -2,7 +2,10 @@
 // Author: Sunjin Choi
 // Description: 
 // Signals:
-// Note: 
+// Note: i_cfg_sync_cal_* enable sync-cycle calibration, which measures how
+// many power detect updates the ring actually needs to settle after a step
+// and syncs for that instead of i_cfg_sync_cycle (see ARB_CTRL_SYNC -
+// Calibration).
 // Variable naming conventions:
 //    signals => snake_case
 //    Parameters (aliasing signal values) => SNAKE_CASE with all caps
@@ -21,12 +24,32 @@
 module tuner_ctrl_arb_phy #(
     parameter int DAC_WIDTH  = 8,
     parameter int ADC_WIDTH  = 8,
-    parameter int MAX_SYNC_CYCLE = 16
+    parameter int MAX_SYNC_CYCLE = 16,
+    parameter int MAX_WAIT_CYCLE = 16,
+    parameter int MAX_NUM_PWR_DETECT = 16
 ) (
     input var logic i_clk,
     input var logic i_rst,
     input var logic [$clog2(MAX_SYNC_CYCLE + 1)-1:0] i_cfg_sync_cycle,
 
+    // Sync-cycle calibration
+    input var logic i_cfg_sync_cal_en,
+    input var logic [DAC_WIDTH-1:0] i_cfg_sync_cal_step,
+    input var logic [3:0] i_cfg_sync_cal_tol,
+    input var logic [1:0] i_cfg_sync_cal_margin,
+    input var logic [15:0] i_cfg_sync_cal_period,
+    output logic [$clog2(MAX_SYNC_CYCLE + 1)-1:0] o_dig_sync_cal_cycle,
+
+    // Power detect config per requesting channel
+    input var logic i_cfg_search_detect_mode,
+    input var logic [$clog2(MAX_WAIT_CYCLE + 1)-1:0] i_cfg_search_detect_wait_cycle,
+    input var logic [$clog2($clog2(MAX_NUM_PWR_DETECT) + 1)-1:0] i_cfg_search_detect_avg_shift,
+    input var logic [3:0] i_cfg_search_detect_settle_tol,
+    input var logic i_cfg_lock_detect_mode,
+    input var logic [$clog2(MAX_WAIT_CYCLE + 1)-1:0] i_cfg_lock_detect_wait_cycle,
+    input var logic [$clog2($clog2(MAX_NUM_PWR_DETECT) + 1)-1:0] i_cfg_lock_detect_avg_shift,
+    input var logic [3:0] i_cfg_lock_detect_settle_tol,
+
     // Power Detector Interface
     tuner_pwr_detect_if.consumer pwr_detect_if,
 
@@ -68,6 +91,7 @@ module tuner_ctrl_arb_phy #(
   logic pwr_detect_update;
   logic [SyncCycleWidth-1:0] sync_cnt;
   logic [SyncCycleWidth-1:0] sync_cycle_eff;
+  logic [SyncCycleWidth-1:0] sync_cycle_use;
   logic sync_cnt_done;
   logic sync_cnt_update;
   logic ctrl_refresh;
@@ -85,6 +109,25 @@ module tuner_ctrl_arb_phy #(
   logic [DAC_WIDTH-1:0] ring_tune_commit;
   logic [ADC_WIDTH-1:0] pwr_commit;
 
+  // Sync-cycle calibration
+  tuner_phy_sync_cal_state_e cal_state;
+  logic cal_pending;
+  logic cal_start;
+  logic cal_update;
+  logic cal_leg_done;
+  logic cal_done;
+  logic [SyncCycleWidth-1:0] cal_cnt;
+  logic [SyncCycleWidth-1:0] cal_leg_max;
+  logic [SyncCycleWidth-1:0] cal_leg_slow;
+  logic [SyncCycleWidth:0] cal_sum;
+  logic [ADC_WIDTH-1:0] cal_pwr_prev;
+  logic [ADC_WIDTH-1:0] cal_pwr_diff;
+  logic [DAC_WIDTH:0] cal_probe_up;
+  logic [DAC_WIDTH-1:0] cal_probe;
+  logic [SyncCycleWidth-1:0] sync_cal;
+  logic sync_cal_valid;
+  logic [15:0] cal_commit_cnt;
+
   assign afe_tune_fire = i_afe_ring_tune_rdy && o_afe_ring_tune_val;
   /*assign ctrl_ring_tune_fire = i_ctrl_ring_tune_val && o_ctrl_ring_tune_rdy;*/
   /*assign ctrl_commit_fire = i_ctrl_commit_rdy && o_ctrl_commit_val;*/
@@ -158,6 +201,23 @@ module tuner_ctrl_arb_phy #(
 
   assign pwr_detect_update = pwr_detect_if.pwr_detect_update;
 
+  // Each read carries the config of the channel that currently owns the
+  // arbiter, so search and lock can trade settling/noise independently
+  always_comb begin
+    if (ctrl_arb_if.get_ctrl_ch() == CH_LOCK) begin
+      pwr_detect_if.cfg_mode = i_cfg_lock_detect_mode;
+      pwr_detect_if.cfg_wait_cycle = i_cfg_lock_detect_wait_cycle;
+      pwr_detect_if.cfg_avg_shift = i_cfg_lock_detect_avg_shift;
+      pwr_detect_if.cfg_settle_tol = i_cfg_lock_detect_settle_tol;
+    end
+    else begin
+      pwr_detect_if.cfg_mode = i_cfg_search_detect_mode;
+      pwr_detect_if.cfg_wait_cycle = i_cfg_search_detect_wait_cycle;
+      pwr_detect_if.cfg_avg_shift = i_cfg_search_detect_avg_shift;
+      pwr_detect_if.cfg_settle_tol = i_cfg_search_detect_settle_tol;
+    end
+  end
+
   always_comb begin
     if (i_cfg_sync_cycle == '0) begin
       sync_cycle_eff = 'd1;
@@ -170,6 +230,16 @@ module tuner_ctrl_arb_phy #(
     end
   end
 
+  // Calibrated count once available, bounded by the static setting
+  always_comb begin
+    if (i_cfg_sync_cal_en && sync_cal_valid && (sync_cal < sync_cycle_eff)) begin
+      sync_cycle_use = sync_cal;
+    end
+    else begin
+      sync_cycle_use = sync_cycle_eff;
+    end
+  end
+
   // Sync counter update when power detection is active
   // So that it essentially waits for the current tune code's resulting pwr
   assign sync_cnt_update = pwr_detect_update;
@@ -209,7 +279,7 @@ module tuner_ctrl_arb_phy #(
   end
 
   assign sync_cnt_done =
-      (state == ARB_CTRL_SYNC) && (sync_cnt == sync_cycle_eff - 1'b1);
+      (state == ARB_CTRL_SYNC) && (sync_cnt == sync_cycle_use - 1'b1);
 
   always_comb begin
     case (state)
@@ -221,8 +291,15 @@ module tuner_ctrl_arb_phy #(
       ARB_CTRL_TUNE: state_next = ring_tune_fire ? ARB_CTRL_SYNC : state;
       // Commit the control status to the higher-level logic (search/lock)
       ARB_CTRL_COMMIT: state_next = ctrl_commit_fire ? ARB_CTRL_TUNE : state;
-      // Tune-to-detect sync counter
-      ARB_CTRL_SYNC: state_next = sync_cnt_done ? ARB_CTRL_COMMIT : state;
+      // Tune-to-detect sync counter, or the calibration legs
+      ARB_CTRL_SYNC: begin
+        if (cal_state != SYNC_CAL_IDLE) begin
+          state_next = cal_done ? ARB_CTRL_COMMIT : state;
+        end
+        else begin
+          state_next = sync_cnt_done ? ARB_CTRL_COMMIT : state;
+        end
+      end
       default: state_next = state;
     endcase
   end
@@ -259,7 +336,8 @@ module tuner_ctrl_arb_phy #(
   assign o_afe_ring_tune_val = ctrl_arb_if.any_ctrl_tune_val() && (state == ARB_CTRL_TUNE);
   assign ctrl_arb_if.tune_rdy = i_afe_ring_tune_rdy && (state == ARB_CTRL_TUNE);
 
-  assign o_dig_afe_ring_tune = ring_tune;
+  // The probe leg of a calibration overrides the tracked code
+  assign o_dig_afe_ring_tune = (cal_state == SYNC_CAL_AWAY) ? cal_probe : ring_tune;
   // ----------------------------------------------------------------------
 
   // ----------------------------------------------------------------------
@@ -270,7 +348,9 @@ module tuner_ctrl_arb_phy #(
   // done and therefore, synchronized
   // sync_cnt_update is controlled by the pwr_detect_update signal
   // (pwr_detect_if)
-  assign ctrl_sync = (state == ARB_CTRL_SYNC) && sync_cnt_update;
+  // Probe leg updates belong to the probe code and are never committed
+  assign ctrl_sync = (state == ARB_CTRL_SYNC) && sync_cnt_update &&
+      (cal_state != SYNC_CAL_AWAY);
 
   always_ff @(posedge i_clk or posedge i_rst) begin
     if (i_rst) begin
@@ -294,6 +374,97 @@ module tuner_ctrl_arb_phy #(
 
   // ----------------------------------------------------------------------
 
+  // ----------------------------------------------------------------------
+  // ARB_CTRL_SYNC - Calibration
+  // ----------------------------------------------------------------------
+  // With i_cfg_sync_cal_en, the first tune fired after reset, and again
+  // after every i_cfg_sync_cal_period commits (0: only once), is calibrated
+  // instead of synced. The AFE steps to a probe code i_cfg_sync_cal_step
+  // away (SYNC_CAL_AWAY) and back to the fired code (SYNC_CAL_BACK). On each
+  // leg, power detect updates are counted until one is within
+  // i_cfg_sync_cal_tol of the previous one; the update before it already
+  // read the settled power, so its index is what that leg needs
+  // (MAX_SYNC_CYCLE if none settles). The slower leg plus
+  // i_cfg_sync_cal_margin becomes the calibrated sync count, and the
+  // transaction commits the settled power of the fired code. Later syncs use
+  // min(calibrated, i_cfg_sync_cycle): the static setting is the ceiling and
+  // the fallback until the first calibration. Calibrate where the ring
+  // responds to the probe step; on a flat response both legs settle at once.
+  assign cal_start = ring_tune_fire && i_cfg_sync_cal_en && cal_pending;
+  assign cal_update = (state == ARB_CTRL_SYNC) && (cal_state != SYNC_CAL_IDLE) &&
+      pwr_detect_update;
+  assign cal_pwr_diff = (pwr_detect_if.detect_data > cal_pwr_prev) ?
+      pwr_detect_if.detect_data - cal_pwr_prev : cal_pwr_prev - pwr_detect_if.detect_data;
+  assign cal_leg_done = cal_update && (((cal_cnt != '0) &&
+      (cal_pwr_diff <= ADC_WIDTH'(i_cfg_sync_cal_tol))) || (cal_cnt == MaxSyncCycleValue));
+  assign cal_done = cal_leg_done && (cal_state == SYNC_CAL_BACK);
+  assign cal_leg_slow = (cal_cnt > cal_leg_max) ? cal_cnt : cal_leg_max;
+  assign cal_sum = {1'b0, cal_leg_slow} + (SyncCycleWidth + 1)'(i_cfg_sync_cal_margin);
+
+  // Step up unless that overflows the DAC
+  assign cal_probe_up = {1'b0, ring_tune} + {1'b0, i_cfg_sync_cal_step};
+
+  always_ff @(posedge i_clk or posedge i_rst) begin
+    if (i_rst) begin
+      cal_state <= SYNC_CAL_IDLE;
+      cal_pending <= 1'b1;
+      cal_cnt <= '0;
+      cal_leg_max <= '0;
+      cal_pwr_prev <= '0;
+      cal_probe <= '0;
+    end
+    else if (ctrl_refresh) begin
+      // An interrupted calibration is retried at the next fire
+      if (cal_state != SYNC_CAL_IDLE) cal_pending <= 1'b1;
+      cal_state <= SYNC_CAL_IDLE;
+      cal_cnt <= '0;
+    end
+    else if (cal_start) begin
+      cal_state <= SYNC_CAL_AWAY;
+      cal_pending <= 1'b0;
+      cal_cnt <= '0;
+      cal_leg_max <= '0;
+      cal_probe <= cal_probe_up[DAC_WIDTH] ?
+          ring_tune - i_cfg_sync_cal_step : cal_probe_up[DAC_WIDTH-1:0];
+    end
+    else if (cal_update) begin
+      cal_pwr_prev <= pwr_detect_if.detect_data;
+      if (cal_leg_done) begin
+        cal_cnt <= '0;
+        cal_leg_max <= cal_leg_slow;
+        cal_state <= (cal_state == SYNC_CAL_AWAY) ? SYNC_CAL_BACK : SYNC_CAL_IDLE;
+      end
+      else begin
+        cal_cnt <= cal_cnt + 1'b1;
+      end
+    end
+    else if (ctrl_commit_fire && sync_cal_valid && (i_cfg_sync_cal_period != '0) &&
+             (cal_commit_cnt == i_cfg_sync_cal_period - 1'b1)) begin
+      cal_pending <= 1'b1;
+    end
+  end
+
+  always_ff @(posedge i_clk or posedge i_rst) begin
+    if (i_rst) begin
+      sync_cal <= '0;
+      sync_cal_valid <= 1'b0;
+      cal_commit_cnt <= '0;
+    end
+    else if (cal_done) begin
+      sync_cal <= (cal_sum > {1'b0, MaxSyncCycleValue}) ?
+          MaxSyncCycleValue : cal_sum[SyncCycleWidth-1:0];
+      sync_cal_valid <= 1'b1;
+      cal_commit_cnt <= '0;
+    end
+    else if (ctrl_commit_fire && sync_cal_valid && (i_cfg_sync_cal_period != '0)) begin
+      cal_commit_cnt <= (cal_commit_cnt == i_cfg_sync_cal_period - 1'b1) ?
+          '0 : cal_commit_cnt + 1'b1;
+    end
+  end
+
+  assign o_dig_sync_cal_cycle = sync_cal_valid ? sync_cal : '0;
+  // ----------------------------------------------------------------------
+
   // ----------------------------------------------------------------------
   // ARB_CTRL_COMMIT
   // ----------------------------------------------------------------------
@@ -0,0 +1,242 @@
+//==============================================================================
+// Author: Sunjin Choi
+// Description: Transaction-level stand-in for tuner_ctrl_arb_phy +
+// tuner_pwr_detect_phy (tuner_phy CTRL_ARB_TLM=1)
+// Signals:
+// Note: Same tuner_ctrl_arb_if consumer behavior as tuner_ctrl_arb_phy, but
+// ARB_CTRL_SYNC is not simulated: at the tune fire, a C++ transactor
+// (lib/cpp/models/ctrl_arb_txn.hpp through lib/cpp/testbench/ctrl_arb_tlm.hpp)
+// returns the committed power and ring tune, and the arbiter goes straight
+// to ARB_CTRL_COMMIT. The transactor steps the detector counters on the
+// settled i_dig_ring_pwr of each code and accounts the skipped SYNC cycles,
+// so commits are bit-exact with the RTL and the bench can report cycle
+// counts as if every cycle had been simulated. Per-cycle AFE noise is only
+// seen through the one sample taken at each fire.
+// Variable naming conventions:
+//    signals => snake_case
+//    Parameters (aliasing signal values) => SNAKE_CASE with all caps
+//    Module Parameters => ALL_CAPS_SNAKE_CASE
+//    Local Parameters => CamelCase
+//==============================================================================
+
+// verilog_format: off
+`timescale 1ns/1ps
+`default_nettype none
+// verilog_format: on
+
+module tuner_ctrl_arb_tlm #(
+    parameter int DAC_WIDTH  = 8,
+    parameter int ADC_WIDTH  = 8,
+    parameter int MAX_SYNC_CYCLE = 16,
+    parameter int MAX_WAIT_CYCLE = 16,
+    parameter int MAX_NUM_PWR_DETECT = 16
+) (
+    input var logic i_clk,
+    input var logic i_rst,
+    input var logic [$clog2(MAX_SYNC_CYCLE + 1)-1:0] i_cfg_sync_cycle,
+
+    // Power detect config per requesting channel
+    input var logic i_cfg_search_detect_mode,
+    input var logic [$clog2(MAX_WAIT_CYCLE + 1)-1:0] i_cfg_search_detect_wait_cycle,
+    input var logic [$clog2($clog2(MAX_NUM_PWR_DETECT) + 1)-1:0] i_cfg_search_detect_avg_shift,
+    input var logic [3:0] i_cfg_search_detect_settle_tol,
+    input var logic i_cfg_lock_detect_mode,
+    input var logic [$clog2(MAX_WAIT_CYCLE + 1)-1:0] i_cfg_lock_detect_wait_cycle,
+    input var logic [$clog2($clog2(MAX_NUM_PWR_DETECT) + 1)-1:0] i_cfg_lock_detect_avg_shift,
+    input var logic [3:0] i_cfg_lock_detect_settle_tol,
+
+    // Ring power as the power detector would sample it
+    input var logic [ADC_WIDTH-1:0] i_dig_ring_pwr,
+
+    tuner_ctrl_arb_if.consumer ctrl_arb_if,
+
+    // Tuner AFE Interface
+    output logic [DAC_WIDTH-1:0] o_dig_afe_ring_tune,
+    input logic i_afe_ring_tune_rdy,
+    output logic o_afe_ring_tune_val
+);
+
+  import tuner_phy_pkg::*;
+
+  // ----------------------------------------------------------------------
+  // Transactor (DPI-C)
+  // ----------------------------------------------------------------------
+  import "DPI-C" function chandle tuner_ctrl_arb_tlm_open(input string name);
+  import "DPI-C" function void tuner_ctrl_arb_tlm_reset(input chandle tlm);
+  import "DPI-C" function void tuner_ctrl_arb_tlm_inputs(
+      input chandle tlm, input longint cycle, input int active, input int mode,
+      input int wait_cycle, input int avg_shift, input int settle_tol);
+  import "DPI-C" function void tuner_ctrl_arb_tlm_refresh(
+      input chandle tlm, input longint cycle);
+  import "DPI-C" function void tuner_ctrl_arb_tlm_txn(
+      input chandle tlm, input longint cycle, input int ring_tune,
+      input int sample, input int sync_cycle, output int pwr_commit,
+      output int ring_tune_commit);
+
+  chandle tlm;
+  initial tlm = tuner_ctrl_arb_tlm_open($sformatf("%m"));
+  // ----------------------------------------------------------------------
+
+  // ----------------------------------------------------------------------
+  // Internal States and Signals
+  // ----------------------------------------------------------------------
+  localparam int WaitCycleWidth = $clog2(MAX_WAIT_CYCLE + 1);
+  localparam int AvgShiftWidth = $clog2($clog2(MAX_NUM_PWR_DETECT) + 1);
+  // {active, mode, wait_cycle, avg_shift, settle_tol}
+  localparam int DetectInputWidth = 2 + WaitCycleWidth + AvgShiftWidth + 4;
+
+  tuner_phy_ctrl_arb_state_e state, state_next;
+  longint cycle_cnt;
+
+  logic ctrl_refresh;
+  logic ctrl_tune_fire;
+  logic afe_tune_fire;
+  logic ring_tune_fire;
+  logic ctrl_commit_fire;
+
+  logic [DAC_WIDTH-1:0] ring_tune;
+  logic [DAC_WIDTH-1:0] ring_tune_track;
+  logic [ADC_WIDTH-1:0] pwr_detected_commit;
+  logic [DAC_WIDTH-1:0] ring_tune_commit;
+
+  logic [DetectInputWidth-1:0] detect_input;
+  logic [DetectInputWidth-1:0] detect_input_prev;
+  logic detect_input_sent;
+
+  assign afe_tune_fire = i_afe_ring_tune_rdy && o_afe_ring_tune_val;
+  assign ctrl_tune_fire = ctrl_arb_if.any_ctrl_tune_ack();
+  assign ctrl_commit_fire = ctrl_arb_if.any_ctrl_commit_ack();
+  assign ring_tune_fire = afe_tune_fire && ctrl_tune_fire;
+  assign ctrl_refresh = ctrl_arb_if.get_ctrl_refresh();
+  // ----------------------------------------------------------------------
+
+  // ----------------------------------------------------------------------
+  // Power Detect Inputs
+  // ----------------------------------------------------------------------
+  // What tuner_ctrl_arb_phy would drive on tuner_pwr_detect_if; the
+  // transactor is told whenever it changes
+  always_comb begin
+    if (ctrl_arb_if.get_ctrl_ch() == CH_LOCK) begin
+      detect_input = {
+        ctrl_arb_if.get_pwr_detect_active(),
+        i_cfg_lock_detect_mode,
+        i_cfg_lock_detect_wait_cycle,
+        i_cfg_lock_detect_avg_shift,
+        i_cfg_lock_detect_settle_tol
+      };
+    end
+    else begin
+      detect_input = {
+        ctrl_arb_if.get_pwr_detect_active(),
+        i_cfg_search_detect_mode,
+        i_cfg_search_detect_wait_cycle,
+        i_cfg_search_detect_avg_shift,
+        i_cfg_search_detect_settle_tol
+      };
+    end
+  end
+  // ----------------------------------------------------------------------
+
+  // ----------------------------------------------------------------------
+  // State Machine
+  // ----------------------------------------------------------------------
+  always_ff @(posedge i_clk or posedge i_rst) begin
+    if (i_rst) begin
+      state <= ARB_CTRL_INIT;
+    end
+    else if (ctrl_refresh) begin
+      state <= ARB_CTRL_INIT;
+    end
+    else begin
+      state <= state_next;
+    end
+  end
+
+  // ARB_CTRL_SYNC is accounted by the transactor
+  always_comb begin
+    case (state)
+      ARB_CTRL_INIT: state_next = ARB_CTRL_TUNE;
+      ARB_CTRL_TUNE: state_next = ring_tune_fire ? ARB_CTRL_COMMIT : state;
+      ARB_CTRL_COMMIT: state_next = ctrl_commit_fire ? ARB_CTRL_TUNE : state;
+      default: state_next = state;
+    endcase
+  end
+  // ----------------------------------------------------------------------
+
+  // ----------------------------------------------------------------------
+  // ARB_CTRL_TUNE
+  // ----------------------------------------------------------------------
+  assign ring_tune = ring_tune_fire ? ctrl_arb_if.get_ring_tune() : ring_tune_track;
+
+  always_ff @(posedge i_clk or posedge i_rst) begin
+    if (i_rst) begin
+      ring_tune_track <= '0;
+    end
+    else if (ctrl_refresh) begin
+      ring_tune_track <= '0;
+    end
+    else if (ring_tune_fire) begin
+      ring_tune_track <= ring_tune;
+    end
+  end
+
+  assign o_afe_ring_tune_val = ctrl_arb_if.any_ctrl_tune_val() && (state == ARB_CTRL_TUNE);
+  assign ctrl_arb_if.tune_rdy = i_afe_ring_tune_rdy && (state == ARB_CTRL_TUNE);
+
+  assign o_dig_afe_ring_tune = ring_tune;
+  // ----------------------------------------------------------------------
+
+  // ----------------------------------------------------------------------
+  // Transactions
+  // ----------------------------------------------------------------------
+  // i_dig_ring_pwr already reflects ring_tune in the fire cycle (the ring and
+  // AFE models are combinational), which is the settled sample
+  always_ff @(posedge i_clk or posedge i_rst) begin
+    int txn_pwr;
+    int txn_tune;
+    if (i_rst) begin
+      cycle_cnt <= '0;
+      detect_input_prev <= '0;
+      detect_input_sent <= 1'b0;
+      pwr_detected_commit <= '0;
+      ring_tune_commit <= '0;
+      tuner_ctrl_arb_tlm_reset(tlm);
+    end
+    else begin
+      cycle_cnt <= cycle_cnt + 1;
+      if (!detect_input_sent || (detect_input != detect_input_prev)) begin
+        tuner_ctrl_arb_tlm_inputs(tlm, cycle_cnt,
+                                  int'(detect_input[DetectInputWidth-1]),
+                                  int'(detect_input[DetectInputWidth-2]),
+                                  int'(detect_input[AvgShiftWidth+4+:WaitCycleWidth]),
+                                  int'(detect_input[4+:AvgShiftWidth]),
+                                  int'(detect_input[3:0]));
+        detect_input_prev <= detect_input;
+        detect_input_sent <= 1'b1;
+      end
+      if (ctrl_refresh) begin
+        tuner_ctrl_arb_tlm_refresh(tlm, cycle_cnt);
+        pwr_detected_commit <= '0;
+        ring_tune_commit <= '0;
+      end
+      else if (ring_tune_fire) begin
+        tuner_ctrl_arb_tlm_txn(tlm, cycle_cnt, int'(ring_tune), int'(i_dig_ring_pwr),
+                               int'(i_cfg_sync_cycle), txn_pwr, txn_tune);
+        pwr_detected_commit <= ADC_WIDTH'(txn_pwr);
+        ring_tune_commit <= DAC_WIDTH'(txn_tune);
+      end
+    end
+  end
+  // ----------------------------------------------------------------------
+
+  // ----------------------------------------------------------------------
+  // ARB_CTRL_COMMIT
+  // ----------------------------------------------------------------------
+  assign ctrl_arb_if.pwr_commit       = pwr_detected_commit;
+  assign ctrl_arb_if.ring_tune_commit = ring_tune_commit;
+  assign ctrl_arb_if.commit_val       = (state == ARB_CTRL_COMMIT);
+  // ----------------------------------------------------------------------
+
+endmodule
+
+`default_nettype wire
@@ -0,0 +1,81 @@
+//==============================================================================
+// Author: Sunjin Choi
+// Description: Local search request interface between a requester (e.g.,
+// tuner_lock_phy re-acquire) and tuner_search_phy. The search PHY sweeps
+// [ring_tune_start, ring_tune_end] and returns the max-power code.
+// Note: done_val is a single-cycle pulse; there is no back-pressure since the
+// requester is expected to be waiting on it.
+// Variable naming conventions:
+//    signals => snake_case
+//    Parameters (aliasing signal values) => SNAKE_CASE with all caps
+//    Module Parameters => ALL_CAPS_SNAKE_CASE
+//    Local Parameters => CamelCase
+//==============================================================================
+
+// verilog_format: off
+`timescale 1ns/1ps
+`default_nettype none
+// verilog_format: on
+
+interface tuner_local_search_if #(
+    parameter int DAC_WIDTH = 8,
+    parameter int ADC_WIDTH = 8
+) (
+    input logic i_clk,
+    input logic i_rst
+);
+
+  // ----------------------------------------------------------------------
+  // Signals
+  // ----------------------------------------------------------------------
+  logic trig_val;
+  logic trig_rdy;
+  logic [DAC_WIDTH-1:0] ring_tune_start;
+  logic [DAC_WIDTH-1:0] ring_tune_end;
+
+  logic done_val;
+  logic [DAC_WIDTH-1:0] ring_tune_peak;
+  logic [ADC_WIDTH-1:0] pwr_peak;
+  // ----------------------------------------------------------------------
+
+  // ----------------------------------------------------------------------
+  // APIs
+  // ----------------------------------------------------------------------
+  function automatic logic get_trig_ack();
+    return trig_val & trig_rdy;
+  endfunction
+  // ----------------------------------------------------------------------
+
+  // ----------------------------------------------------------------------
+  // Modports
+  // ----------------------------------------------------------------------
+  // Search PHY
+  modport producer(
+      input trig_val,
+      output trig_rdy,
+      input ring_tune_start,
+      input ring_tune_end,
+      output done_val,
+      output ring_tune_peak,
+      output pwr_peak,
+
+      // APIs
+      import get_trig_ack
+  );
+
+  // Requester (Lock PHY)
+  modport consumer(
+      output trig_val,
+      input trig_rdy,
+      output ring_tune_start,
+      output ring_tune_end,
+      input done_val,
+      input ring_tune_peak,
+      input pwr_peak,
+
+      // APIs
+      import get_trig_ack
+  );
+  // ----------------------------------------------------------------------
+
+endinterface
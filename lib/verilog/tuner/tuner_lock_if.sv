@@ -47,6 +47,8 @@ interface tuner_lock_if #(
   /*logic [ADC_WIDTH-1:0] mon_pwr_peak;
    *logic [DAC_WIDTH-1:0] mon_ring_tune_peak;*/
   tuner_phy_lock_state_e mon_state;
+  // Level: set at lock loss, cleared once the power recovers
+  logic mon_lock_lost;
   // ----------------------------------------------------------------------
 
   // ----------------------------------------------------------------------
@@ -81,6 +83,7 @@ interface tuner_lock_if #(
       /*output mon_pwr_peak,
        *output mon_ring_tune_peak,*/
       output mon_state,
+      output mon_lock_lost,
 
       // APIs
       import get_trig_ack,
@@ -103,7 +106,7 @@ interface tuner_lock_if #(
       import get_resume_ack
   );
 
-  modport monitor(input mon_state);
+  modport monitor(input mon_state, input mon_lock_lost);
   // ----------------------------------------------------------------------
 
 endinterface
@@ -28,11 +28,22 @@
 // implement *unlock* by locking to low power e.g., 10%
 // TODO: local search to dynamically determine the target via interface with
 // search_phy
-// TODO: gear shift?
+
+// Lock loss: when the committed power stays below pwr_peak * loss_ratio / 16
+// for i_cfg_lock_loss_cnt windows, the lock escapes to LOCK_SEARCH, sweeps
+// +-i_cfg_lock_research_halfwidth around the last good code through
+// tuner_search_phy, and re-enters LOCK_ACTIVE at the same offset from the
+// new peak without host intervention
+
+// Two lock algorithms are selectable at runtime via i_cfg_lock_mode:
+// - LOCK_MODE_SLOPE: ramp + majority-vote slope detection (bang-bang)
+// - LOCK_MODE_PI: velocity-form PI on (pwr_tgt - pwr) with gear shifting,
+//   i.e., coarse steps during pull-in that are halved at every overshoot
 module tuner_lock_phy #(
     parameter int DAC_WIDTH = 8,
     parameter int ADC_WIDTH = 8,
-    parameter int LOCK_DELTA_WINDOW_SIZE = 4
+    parameter int LOCK_DELTA_WINDOW_SIZE = 4,
+    parameter int LOCK_PI_GEAR_MAX = 3
     /*parameter logic [DAC_WIDTH-1:0] DZ_SIZE = 4*/
 ) (
     input var logic i_clk,
@@ -43,10 +54,18 @@ module tuner_lock_phy #(
     input var logic [DAC_WIDTH-1:0] i_cfg_ring_tune_start,
     input var logic [$clog2(DAC_WIDTH)-1:0] i_cfg_lock_tune_stride,
     input var logic [$clog2(LOCK_DELTA_WINDOW_SIZE + 1)-1:0] i_cfg_lock_pwr_delta_thres,
+    input var logic i_cfg_lock_mode,
+    input var logic [$clog2(ADC_WIDTH)-1:0] i_cfg_lock_pi_kp_shift,
+    input var logic [$clog2(ADC_WIDTH)-1:0] i_cfg_lock_pi_ki_shift,
     //    // end is not used if local search is not enabled
     //    input var logic [DAC_WIDTH-1:0] i_cfg_ring_tune_end,
     //    /*input var logic [ADC_WIDTH-1:0] i_cfg_ring_pwr_peak,*/
     input var logic [3:0] i_cfg_ring_pwr_peak_ratio,
+    // lock loss detection (cnt == 0 disables) and re-acquire (halfwidth == 0
+    // disables, then only flags the loss)
+    input var logic [3:0] i_cfg_lock_loss_ratio,
+    input var logic [3:0] i_cfg_lock_loss_cnt,
+    input var logic [DAC_WIDTH-1:0] i_cfg_lock_research_halfwidth,
 
     input var logic [ADC_WIDTH-1:0] i_dig_pwr_peak,
     input var logic [DAC_WIDTH-1:0] i_dig_ring_tune_peak,
@@ -56,18 +75,18 @@ module tuner_lock_phy #(
     // Controller Arbiter Interface
     tuner_ctrl_arb_if.producer ctrl_arb_if,
 
+    // Local search requests for re-acquire
+    tuner_local_search_if.consumer local_search_if,
+
     // Tuner Controller Interface
     tuner_lock_if.producer lock_if
 );
   import tuner_phy_pkg::*;
 
-  // TODO: lock-to-target
-  // TODO: simple PI (bang-bang) control
   // TODO: more configs for global/local-search and others
 
-  // TODO: If slope & power level comparison mismatches, then ideally should re-tr
-  // re-trigger either local search or global search, but need to first esca
-  // escape to the corresponding ERROR state
+  // TODO: If slope & power level comparison mismatches, then ideally should
+  // re-trigger local search as well; only the power level is checked for now
 
   // ----------------------------------------------------------------------
   // Internal States and Parameters
@@ -127,6 +146,24 @@ module tuner_lock_phy #(
   logic [DAC_WIDTH-1:0] ring_tune_peak;
   logic [ADC_WIDTH-1:0] pwr_tgt;
 
+  // Lock loss and re-acquire
+  logic [DAC_WIDTH-1:0] ring_tune_start;
+  logic signed [DAC_WIDTH:0] ring_tune_offset;
+  logic signed [DAC_WIDTH+1:0] ring_tune_relock_sum;
+  logic [DAC_WIDTH-1:0] ring_tune_relock;
+  logic [DAC_WIDTH-1:0] ring_tune_good;
+  logic [ADC_WIDTH+3:0] pwr_loss_scaled;
+  logic [ADC_WIDTH-1:0] pwr_loss_thres;
+  logic pwr_loss_below;
+  logic [3:0] loss_cnt;
+  logic loss_armed;
+  logic lock_loss_fire;
+  logic lock_lost;
+  logic reacquire_en;
+  logic relock_pending;
+  logic local_trig_sent;
+  logic local_done_fire;
+
   logic [DAC_WIDTH-1:0] ring_tune_track_win[LOCK_DELTA_WINDOW_SIZE];
   logic [ADC_WIDTH-1:0] pwr_det_track_win[LOCK_DELTA_WINDOW_SIZE];
   logic [LOCK_DELTA_WINDOW_SIZE-1:0] pwr_inc_track_win;
@@ -139,13 +176,42 @@ module tuner_lock_phy #(
   logic is_ctrl_active_state, is_update_state, is_tune_state;
   logic tune_fire, commit_fire;
   logic tune_compute, tune_compute_done, update_commit_done;
+
+  // PI tracker; wide enough to hold the error delta plus the ring tune code
+  localparam int LockPiWidth = ((ADC_WIDTH > DAC_WIDTH) ? ADC_WIDTH : DAC_WIDTH) + 3;
+  localparam int LockPiGearWidth = $clog2(LOCK_PI_GEAR_MAX + 1);
+  localparam logic [LockPiGearWidth-1:0] LockPiGearMaxValue =
+      LockPiGearWidth'(LOCK_PI_GEAR_MAX);
+
+  logic is_lock_mode_pi;
+  logic [ADC_WIDTH+3:0] pwr_tgt_scaled;
+  logic pi_update;
+  logic pi_slope_pos;
+  logic pi_err_valid;
+  logic pi_err_flip;
+  logic pi_err_large;
+  logic [LockPiGearWidth-1:0] pi_gear;
+  logic signed [LockPiWidth-1:0] pi_err;
+  logic signed [LockPiWidth-1:0] pi_err_prev;
+  logic signed [LockPiWidth-1:0] pi_err_delta;
+  logic signed [LockPiWidth-1:0] pi_err_bound;
+  logic signed [LockPiWidth-1:0] pi_p_term;
+  logic signed [LockPiWidth-1:0] pi_i_term;
+  logic signed [LockPiWidth-1:0] pi_step_raw;
+  logic signed [LockPiWidth-1:0] pi_step_geared;
+  logic signed [LockPiWidth-1:0] pi_step;
+  logic signed [LockPiWidth-1:0] ring_tune_pi_sum;
+  logic [DAC_WIDTH-1:0] ring_tune_pi_next;
   // ----------------------------------------------------------------------
 
   // ----------------------------------------------------------------------
   // Assigns
   // ----------------------------------------------------------------------
-  /*assign pwr_tgt = i_dig_pwr_peak * i_cfg_ring_pwr_peak_ratio / 16;*/
+  // pwr_tgt = pwr_peak * ratio / 16
+  assign pwr_tgt_scaled = pwr_peak * i_cfg_ring_pwr_peak_ratio;
+  assign pwr_tgt = pwr_tgt_scaled[ADC_WIDTH+3:4];
   assign ring_tune_step   = (1 << i_cfg_lock_tune_stride);
+  assign is_lock_mode_pi = (i_cfg_lock_mode == LOCK_MODE_PI);
 
   always_comb begin
     if (i_cfg_lock_pwr_delta_thres == '0) begin
@@ -171,16 +237,18 @@ module tuner_lock_phy #(
     if (i_rst) begin
       intr_pending <= 1'b0;
     end
-    else if (state != LOCK_ACTIVE) begin
+    else if ((state == LOCK_IDLE) || (state == LOCK_INTR)) begin
       intr_pending <= 1'b0;
     end
     else begin
+      // A request during LOCK_SEARCH (and the re-acquire LOCK_INIT) is held
+      // and served once the lock is back in LOCK_ACTIVE
       if (!lock_if.intr_rdy) intr_pending <= 1'b1;
-      else if (lock_if.get_intr_ack()) intr_pending <= 1'b0;
+      else if (lock_intr_fire) intr_pending <= 1'b0;
     end
   end
 
-  assign lock_if.intr_val = intr_pending;
+  assign lock_if.intr_val = intr_pending && (state == LOCK_ACTIVE);
   assign lock_intr_fire = (state == LOCK_ACTIVE) && lock_if.get_intr_ack();
 
   // Resume handshake
@@ -206,7 +274,11 @@ module tuner_lock_phy #(
     case (state)
       LOCK_IDLE: if (lock_trig_fire) state_next = LOCK_INIT;
       LOCK_INIT: state_next = LOCK_ACTIVE;
-      LOCK_ACTIVE: if (lock_intr_fire) state_next = LOCK_INTR;
+      LOCK_ACTIVE: begin
+        if (lock_intr_fire) state_next = LOCK_INTR;
+        else if (lock_loss_fire && reacquire_en) state_next = LOCK_SEARCH;
+      end
+      LOCK_SEARCH: if (local_done_fire) state_next = LOCK_INIT;
       LOCK_INTR: if (lock_resume_fire) state_next = lock_restore ? LOCK_ACTIVE : LOCK_IDLE;
       default: state_next = LOCK_IDLE;
     endcase
@@ -224,7 +296,7 @@ module tuner_lock_phy #(
       ring_tune <= '0;
     end
     else if (lock_refresh) begin
-      ring_tune <= i_cfg_ring_tune_start;
+      ring_tune <= ring_tune_start;
     end
     else if (lock_active_update) begin
       ring_tune <= ring_tune_next;
@@ -298,7 +370,7 @@ module tuner_lock_phy #(
       ring_tune_delta <= '0;
     end
     else if (lock_refresh) begin
-      ring_tune_base  <= i_cfg_ring_tune_start;
+      ring_tune_base  <= ring_tune_start;
       ring_tune_delta <= '0;
     end
     else if (tune_compute) begin
@@ -342,7 +414,7 @@ module tuner_lock_phy #(
     endcase
   end
 
-  assign ring_tune_next = ring_tune_base + ring_tune_delta;
+  assign ring_tune_next = is_lock_mode_pi ? ring_tune_pi_next : (ring_tune_base + ring_tune_delta);
   assign ctrl_arb_if.ring_tune[CH_LOCK] = ring_tune;
   // ----------------------------------------------------------------------
 
@@ -463,20 +535,235 @@ module tuner_lock_phy #(
   end
   // ----------------------------------------------------------------------
 
+  // ----------------------------------------------------------------------
+  // Peak Registers
+  // ----------------------------------------------------------------------
+  // Host-provided peak at trigger, replaced by the local search result at
+  // re-acquire. The start offset from the peak is kept across re-acquires.
+  always_ff @(posedge i_clk or posedge i_rst) begin
+    if (i_rst) begin
+      pwr_peak <= '0;
+      ring_tune_peak <= '0;
+      ring_tune_offset <= '0;
+    end
+    else if (lock_trig_fire) begin
+      pwr_peak <= i_dig_pwr_peak;
+      ring_tune_peak <= i_dig_ring_tune_peak;
+      ring_tune_offset <= $signed({1'b0, i_cfg_ring_tune_start}) -
+          $signed({1'b0, i_dig_ring_tune_peak});
+    end
+    else if (local_done_fire) begin
+      pwr_peak <= local_search_if.pwr_peak;
+      ring_tune_peak <= local_search_if.ring_tune_peak;
+    end
+  end
+
+  assign ring_tune_relock_sum = $signed({2'b00, ring_tune_peak}) + ring_tune_offset;
+  always_comb begin
+    if (ring_tune_relock_sum < 0) begin
+      ring_tune_relock = '0;
+    end
+    else if (ring_tune_relock_sum > $signed({2'b00, {DAC_WIDTH{1'b1}}})) begin
+      ring_tune_relock = '1;
+    end
+    else begin
+      ring_tune_relock = ring_tune_relock_sum[DAC_WIDTH-1:0];
+    end
+  end
+
+  // LOCK_INIT after re-acquire restarts from the relocated peak
+  assign ring_tune_start = relock_pending ? ring_tune_relock : i_cfg_ring_tune_start;
+  // ----------------------------------------------------------------------
+
+  // ----------------------------------------------------------------------
+  // LOCK_ACTIVE - Lock Loss Detection
+  // ----------------------------------------------------------------------
+  // Armed only after the power first reaches the threshold, so that the
+  // pull-in from the (off-peak) start code is not mistaken for a loss
+  assign pwr_loss_scaled = pwr_peak * i_cfg_lock_loss_ratio;
+  assign pwr_loss_thres = pwr_loss_scaled[ADC_WIDTH+3:4];
+  assign pwr_loss_below = ctrl_arb_if.pwr_commit < pwr_loss_thres;
+  assign reacquire_en = (i_cfg_lock_research_halfwidth != '0);
+
+  assign lock_loss_fire = lock_active_update && loss_armed && pwr_loss_below &&
+      (i_cfg_lock_loss_cnt != '0) && (loss_cnt >= i_cfg_lock_loss_cnt - 1'b1);
+
+  always_ff @(posedge i_clk or posedge i_rst) begin
+    if (i_rst) begin
+      loss_cnt <= '0;
+      loss_armed <= 1'b0;
+      ring_tune_good <= '0;
+    end
+    else if (lock_refresh) begin
+      loss_cnt <= '0;
+      loss_armed <= 1'b0;
+      ring_tune_good <= ring_tune_peak;
+    end
+    else if (lock_active_update) begin
+      if (!pwr_loss_below) begin
+        loss_cnt <= '0;
+        loss_armed <= 1'b1;
+        ring_tune_good <= ctrl_arb_if.ring_tune_commit;
+      end
+      else if (loss_armed && (loss_cnt != '1)) begin
+        loss_cnt <= loss_cnt + 1'b1;
+      end
+    end
+  end
+
+  // Interrupt level to the host: set at loss, cleared at re-arm or trigger
+  always_ff @(posedge i_clk or posedge i_rst) begin
+    if (i_rst) begin
+      lock_lost <= 1'b0;
+    end
+    else if (lock_trig_fire) begin
+      lock_lost <= 1'b0;
+    end
+    else if (lock_loss_fire) begin
+      lock_lost <= 1'b1;
+    end
+    else if (lock_active_update && !pwr_loss_below) begin
+      lock_lost <= 1'b0;
+    end
+  end
+
+  assign lock_if.mon_lock_lost = lock_lost;
+  // ----------------------------------------------------------------------
+
+  // ----------------------------------------------------------------------
+  // LOCK_SEARCH - Local Re-acquire
+  // ----------------------------------------------------------------------
+  assign local_search_if.trig_val = (state == LOCK_SEARCH) && !local_trig_sent;
+  assign local_search_if.ring_tune_start =
+      (ring_tune_good > i_cfg_lock_research_halfwidth) ?
+      (ring_tune_good - i_cfg_lock_research_halfwidth) : '0;
+  assign local_search_if.ring_tune_end =
+      (ring_tune_good < ({DAC_WIDTH{1'b1}} - i_cfg_lock_research_halfwidth)) ?
+      (ring_tune_good + i_cfg_lock_research_halfwidth) : '1;
+  assign local_done_fire = (state == LOCK_SEARCH) && local_trig_sent && local_search_if.done_val;
+
+  always_ff @(posedge i_clk or posedge i_rst) begin
+    if (i_rst) begin
+      local_trig_sent <= 1'b0;
+    end
+    else if (state != LOCK_SEARCH) begin
+      local_trig_sent <= 1'b0;
+    end
+    else if (local_search_if.get_trig_ack()) begin
+      local_trig_sent <= 1'b1;
+    end
+  end
+
+  always_ff @(posedge i_clk or posedge i_rst) begin
+    if (i_rst) begin
+      relock_pending <= 1'b0;
+    end
+    else if (local_done_fire) begin
+      relock_pending <= 1'b1;
+    end
+    else if (lock_refresh) begin
+      relock_pending <= 1'b0;
+    end
+  end
+  // ----------------------------------------------------------------------
+
   function automatic logic majority_vote(input logic [LOCK_DELTA_WINDOW_SIZE-1:0] votes,
                                          input logic [LockDeltaThresWidth-1:0] threshold);
     return $countones(votes) >= threshold;
   endfunction
 
 
-  // TODO: implement - skip for now
   // ----------------------------------------------------------------------
-  // LOCK_ACTIVE - Simple BB Tracker
+  // LOCK_ACTIVE - PI Tracker with Gear Shift
+  // ----------------------------------------------------------------------
+  // Compare with power level, if lower than target, then move toward the
+  // peak, if higher than target, then move away from the peak
+  // Velocity form so that the ring tune register itself is the integrator:
+  //   step = ((e - e_prev) >>> kp_shift + e >>> ki_shift) >>> gear
+  // The flank is latched at LOCK_INIT from the start code w.r.t. the peak
+  assign pi_update = lock_active_update && is_lock_mode_pi;
+
+  // Positive when the detected power is below the target
+  assign pi_err = $signed(LockPiWidth'(pwr_tgt)) - $signed(LockPiWidth'(ctrl_arb_if.pwr_commit));
+  assign pi_err_delta = pi_err_valid ? (pi_err - pi_err_prev) : $signed(LockPiWidth'(0));
+  assign pi_p_term = pi_err_delta >>> i_cfg_lock_pi_kp_shift;
+  assign pi_i_term = pi_err >>> i_cfg_lock_pi_ki_shift;
+  assign pi_step_raw = pi_p_term + pi_i_term;
+  assign pi_step_geared = pi_step_raw >>> pi_gear;
+  // Finest move is a single code so the gear shift never stalls the loop
+  assign pi_step = ((pi_step_raw > 0) && (pi_step_geared == 0)) ?
+      $signed(LockPiWidth'(1)) : pi_step_geared;
+
+  assign ring_tune_pi_sum = pi_slope_pos ? ($signed(LockPiWidth'(ring_tune)) + pi_step) :
+                                           ($signed(LockPiWidth'(ring_tune)) - pi_step);
+
+  // Saturate to the DAC range instead of wrapping around
+  always_comb begin
+    if (ring_tune_pi_sum < 0) begin
+      ring_tune_pi_next = '0;
+    end
+    else if (ring_tune_pi_sum > $signed(LockPiWidth'({DAC_WIDTH{1'b1}}))) begin
+      ring_tune_pi_next = '1;
+    end
+    else begin
+      ring_tune_pi_next = ring_tune_pi_sum[DAC_WIDTH-1:0];
+    end
+  end
+
+  // Gear shift: overshoot (error sign flip) shifts down to finer steps, and
+  // a large error (e.g., after a disturbance) shifts back to the coarsest
+  assign pi_err_bound = $signed(LockPiWidth'(pwr_tgt >> 1));
+  assign pi_err_flip = pi_err_valid && (pi_err != 0) &&
+      (pi_err[LockPiWidth-1] != pi_err_prev[LockPiWidth-1]);
+  assign pi_err_large = (pi_err > pi_err_bound) || (pi_err < -pi_err_bound);
+
+  always_ff @(posedge i_clk or posedge i_rst) begin
+    if (i_rst) begin
+      pi_err_prev  <= '0;
+      pi_err_valid <= 1'b0;
+      pi_gear      <= '0;
+      pi_slope_pos <= 1'b1;
+    end
+    else if (lock_refresh) begin
+      pi_err_prev  <= '0;
+      pi_err_valid <= 1'b0;
+      pi_gear      <= '0;
+      // Start below the peak code means power rises with the tune code
+      pi_slope_pos <= (ring_tune_start <= ring_tune_peak);
+    end
+    else if (pi_update) begin
+      pi_err_prev  <= pi_err;
+      pi_err_valid <= 1'b1;
+      if (pi_err_large) begin
+        pi_gear <= '0;
+      end
+      else if (pi_err_flip && (pi_gear < LockPiGearMaxValue)) begin
+        pi_gear <= pi_gear + 1'b1;
+      end
+    end
+  end
   // ----------------------------------------------------------------------
-  // Compare with power level, if lower than target, then increase the heat code,
-  // if higher than target, then decrease the heat code
 
   // ----------------------------------------------------------------------
+  // Functional coverage (verilator --coverage-user)
+  // ----------------------------------------------------------------------
+  cov_lock_intr :
+  cover property (@(posedge i_clk) disable iff (i_rst) lock_intr_fire);
+  cov_lock_intr_pending :
+  cover property (@(posedge i_clk) disable iff (i_rst)
+      (state == LOCK_ACTIVE) && intr_pending && !lock_intr_fire);
+  cov_lock_intr_held_search :
+  cover property (@(posedge i_clk) disable iff (i_rst)
+      (state == LOCK_SEARCH) && intr_pending);
+  cov_lock_resume :
+  cover property (@(posedge i_clk) disable iff (i_rst) lock_resume_fire);
+  cov_lock_loss_reacquire :
+  cover property (@(posedge i_clk) disable iff (i_rst)
+      (state == LOCK_ACTIVE) && lock_loss_fire && reacquire_en);
+  cov_lock_reacquired :
+  cover property (@(posedge i_clk) disable iff (i_rst)
+      (state == LOCK_SEARCH) && local_done_fire);
+  // ----------------------------------------------------------------------
 
 
 endmodule
@@ -28,7 +28,15 @@ module tuner_phy #(
     parameter int SEARCH_PEAK_THRES = 2,
     // Lock PHY Parameters
     parameter int LOCK_DELTA_WINDOW_SIZE = 2,
-    parameter int MAX_SYNC_CYCLE = 16
+    parameter int LOCK_PI_GEAR_MAX = 3,
+    parameter int MAX_SYNC_CYCLE = 16,
+    // Power Detect PHY Parameters
+    parameter int MAX_WAIT_CYCLE = 16,
+    parameter int MAX_NUM_PWR_DETECT = 16,
+    // Replace the power detect and ctrl arbiter PHYs with the DPI-C
+    // transactor (tuner_ctrl_arb_tlm); commits are unchanged but the
+    // ARB_CTRL_SYNC cycles are accounted instead of simulated
+    parameter bit CTRL_ARB_TLM = 1'b0
 ) (
     // input signals
     input var logic i_clk,
@@ -39,13 +47,41 @@ module tuner_phy #(
     input var logic [DAC_WIDTH-1:0] i_cfg_ring_tune_start,
     input var logic [DAC_WIDTH-1:0] i_cfg_ring_tune_end,
     input var logic [$clog2(DAC_WIDTH)-1:0] i_cfg_ring_tune_stride,
+    input var logic i_cfg_search_fit_mode,
     input var logic [$clog2(DAC_WIDTH)-1:0] i_cfg_lock_tune_stride,
     input var logic [$clog2(MAX_SYNC_CYCLE + 1)-1:0] i_cfg_sync_cycle,
+    // Sync-cycle calibration (tuner_ctrl_arb_phy; ignored with CTRL_ARB_TLM)
+    input var logic i_cfg_sync_cal_en,
+    input var logic [DAC_WIDTH-1:0] i_cfg_sync_cal_step,
+    input var logic [3:0] i_cfg_sync_cal_tol,
+    input var logic [1:0] i_cfg_sync_cal_margin,
+    input var logic [15:0] i_cfg_sync_cal_period,
+    // Search/lock arbitration QoS (tuner_ctrl_arb_if; all zero is the
+    // search-first fixed priority)
+    input var logic [3:0] i_cfg_arb_search_weight,
+    input var logic [3:0] i_cfg_arb_lock_weight,
+    input var logic [3:0] i_cfg_arb_lock_max_wait,
     input var logic [$clog2(LOCK_DELTA_WINDOW_SIZE + 1)-1:0] i_cfg_lock_pwr_delta_thres,
+    input var logic i_cfg_lock_mode,
+    input var logic [$clog2(ADC_WIDTH)-1:0] i_cfg_lock_pi_kp_shift,
+    input var logic [$clog2(ADC_WIDTH)-1:0] i_cfg_lock_pi_ki_shift,
     input var logic [3:0] i_cfg_ring_pwr_peak_ratio,
+    input var logic [3:0] i_cfg_lock_loss_ratio,
+    input var logic [3:0] i_cfg_lock_loss_cnt,
+    input var logic [DAC_WIDTH-1:0] i_cfg_lock_research_halfwidth,
     input var logic [ADC_WIDTH-1:0] i_cfg_pwr_peak,
     input var logic [DAC_WIDTH-1:0] i_cfg_ring_tune_peak,
 
+    // Config Inputs for Power Detect, per requesting PHY
+    input var logic i_cfg_search_detect_mode,
+    input var logic [$clog2(MAX_WAIT_CYCLE + 1)-1:0] i_cfg_search_detect_wait_cycle,
+    input var logic [$clog2($clog2(MAX_NUM_PWR_DETECT) + 1)-1:0] i_cfg_search_detect_avg_shift,
+    input var logic [3:0] i_cfg_search_detect_settle_tol,
+    input var logic i_cfg_lock_detect_mode,
+    input var logic [$clog2(MAX_WAIT_CYCLE + 1)-1:0] i_cfg_lock_detect_wait_cycle,
+    input var logic [$clog2($clog2(MAX_NUM_PWR_DETECT) + 1)-1:0] i_cfg_lock_detect_avg_shift,
+    input var logic [3:0] i_cfg_lock_detect_settle_tol,
+
     // Interfaces to the main controller
     tuner_search_if.producer search_if,
     tuner_lock_if.producer   lock_if,
@@ -55,7 +91,13 @@ module tuner_phy #(
     output tuner_phy_search_state_e o_dig_search_state_mon,
     output tuner_phy_lock_state_e o_dig_lock_state_mon,
     output logic o_dig_search_err,
-    output logic o_dig_lock_err
+    output logic o_dig_lock_err,
+    // Calibrated sync count (0 until the first calibration)
+    output logic [$clog2(MAX_SYNC_CYCLE + 1)-1:0] o_dig_sync_cal_cycle,
+    // Arbiter monitor: lock tune request, and the channel granted a tune in
+    // this cycle (CH_NULL otherwise)
+    output logic o_dig_arb_lock_req,
+    output tuner_ctrl_ch_e o_dig_arb_grant
 );
   /*import tuner_phy_pkg::*;*/
 
@@ -63,7 +105,9 @@ module tuner_phy #(
   // Interfaces
   // ----------------------------------------------------------------------
   tuner_pwr_detect_if #(
-      .ADC_WIDTH(ADC_WIDTH)
+      .ADC_WIDTH(ADC_WIDTH),
+      .MAX_WAIT_CYCLE(MAX_WAIT_CYCLE),
+      .MAX_NUM_PWR_DETECT(MAX_NUM_PWR_DETECT)
   ) pwr_detect_if (
       .i_clk(i_clk),
       .i_rst(i_rst)
@@ -85,36 +129,102 @@ module tuner_phy #(
       .i_rst(i_rst)
   );
 
+  tuner_local_search_if #(
+      .DAC_WIDTH(DAC_WIDTH),
+      .ADC_WIDTH(ADC_WIDTH)
+  ) local_search_if (
+      .i_clk(i_clk),
+      .i_rst(i_rst)
+  );
+
   // ----------------------------------------------------------------------
 
   // ----------------------------------------------------------------------
   // Signals
   // ----------------------------------------------------------------------
   logic [DAC_WIDTH-1:0] search_phy_ring_tune;
+
+  assign ctrl_arb_if.cfg_weight[CH_NULL] = '0;
+  assign ctrl_arb_if.cfg_weight[CH_SEARCH] = i_cfg_arb_search_weight;
+  assign ctrl_arb_if.cfg_weight[CH_LOCK] = i_cfg_arb_lock_weight;
+  assign ctrl_arb_if.cfg_lock_max_wait = i_cfg_arb_lock_max_wait;
   // ----------------------------------------------------------------------
 
   // ----------------------------------------------------------------------
   // Instantiations
   // ----------------------------------------------------------------------
-  tuner_pwr_detect_phy pwr_detect_phy_inst (
-      .i_clk(i_clk),
-      .i_rst(i_rst),
-      .i_dig_ring_pwr(i_dig_ring_pwr),
-      .pwr_detect_if(pwr_detect_if.producer)
-  );
+  generate
+    if (CTRL_ARB_TLM) begin : g_ctrl_arb_tlm
+      tuner_ctrl_arb_tlm #(
+          .DAC_WIDTH(DAC_WIDTH),
+          .ADC_WIDTH(ADC_WIDTH),
+          .MAX_SYNC_CYCLE(MAX_SYNC_CYCLE),
+          .MAX_WAIT_CYCLE(MAX_WAIT_CYCLE),
+          .MAX_NUM_PWR_DETECT(MAX_NUM_PWR_DETECT)
+      ) ctrl_arb_tlm_inst (
+          .i_clk(i_clk),
+          .i_rst(i_rst),
+          .i_cfg_sync_cycle(i_cfg_sync_cycle),
+          .i_cfg_search_detect_mode(i_cfg_search_detect_mode),
+          .i_cfg_search_detect_wait_cycle(i_cfg_search_detect_wait_cycle),
+          .i_cfg_search_detect_avg_shift(i_cfg_search_detect_avg_shift),
+          .i_cfg_search_detect_settle_tol(i_cfg_search_detect_settle_tol),
+          .i_cfg_lock_detect_mode(i_cfg_lock_detect_mode),
+          .i_cfg_lock_detect_wait_cycle(i_cfg_lock_detect_wait_cycle),
+          .i_cfg_lock_detect_avg_shift(i_cfg_lock_detect_avg_shift),
+          .i_cfg_lock_detect_settle_tol(i_cfg_lock_detect_settle_tol),
+          .i_dig_ring_pwr(i_dig_ring_pwr),
+          .ctrl_arb_if(ctrl_arb_if.consumer),
+          .o_dig_afe_ring_tune(o_dig_ring_tune),
+          .i_afe_ring_tune_rdy(1'b1),
+          .o_afe_ring_tune_val()
+      );
+      assign o_dig_sync_cal_cycle = '0;
+    end
+    else begin : g_ctrl_arb
+      tuner_pwr_detect_phy #(
+          .ADC_WIDTH(ADC_WIDTH),
+          .MAX_WAIT_CYCLE(MAX_WAIT_CYCLE),
+          .MAX_NUM_PWR_DETECT(MAX_NUM_PWR_DETECT)
+      ) pwr_detect_phy_inst (
+          .i_clk(i_clk),
+          .i_rst(i_rst),
+          .i_dig_ring_pwr(i_dig_ring_pwr),
+          .pwr_detect_if(pwr_detect_if.producer)
+      );
 
-  tuner_ctrl_arb_phy #(
-      .MAX_SYNC_CYCLE(MAX_SYNC_CYCLE)
-  ) ctrl_arb_phy_inst (
-      .i_clk(i_clk),
-      .i_rst(i_rst),
-      .i_cfg_sync_cycle(i_cfg_sync_cycle),
-      .pwr_detect_if(pwr_detect_if.consumer),
-      .ctrl_arb_if(ctrl_arb_if.consumer),
-      .o_dig_afe_ring_tune(o_dig_ring_tune),
-      .i_afe_ring_tune_rdy(1'b1),
-      .o_afe_ring_tune_val()
-  );
+      tuner_ctrl_arb_phy #(
+          .DAC_WIDTH(DAC_WIDTH),
+          .ADC_WIDTH(ADC_WIDTH),
+          .MAX_SYNC_CYCLE(MAX_SYNC_CYCLE),
+          .MAX_WAIT_CYCLE(MAX_WAIT_CYCLE),
+          .MAX_NUM_PWR_DETECT(MAX_NUM_PWR_DETECT)
+      ) ctrl_arb_phy_inst (
+          .i_clk(i_clk),
+          .i_rst(i_rst),
+          .i_cfg_sync_cycle(i_cfg_sync_cycle),
+          .i_cfg_sync_cal_en(i_cfg_sync_cal_en),
+          .i_cfg_sync_cal_step(i_cfg_sync_cal_step),
+          .i_cfg_sync_cal_tol(i_cfg_sync_cal_tol),
+          .i_cfg_sync_cal_margin(i_cfg_sync_cal_margin),
+          .i_cfg_sync_cal_period(i_cfg_sync_cal_period),
+          .o_dig_sync_cal_cycle(o_dig_sync_cal_cycle),
+          .i_cfg_search_detect_mode(i_cfg_search_detect_mode),
+          .i_cfg_search_detect_wait_cycle(i_cfg_search_detect_wait_cycle),
+          .i_cfg_search_detect_avg_shift(i_cfg_search_detect_avg_shift),
+          .i_cfg_search_detect_settle_tol(i_cfg_search_detect_settle_tol),
+          .i_cfg_lock_detect_mode(i_cfg_lock_detect_mode),
+          .i_cfg_lock_detect_wait_cycle(i_cfg_lock_detect_wait_cycle),
+          .i_cfg_lock_detect_avg_shift(i_cfg_lock_detect_avg_shift),
+          .i_cfg_lock_detect_settle_tol(i_cfg_lock_detect_settle_tol),
+          .pwr_detect_if(pwr_detect_if.consumer),
+          .ctrl_arb_if(ctrl_arb_if.consumer),
+          .o_dig_afe_ring_tune(o_dig_ring_tune),
+          .i_afe_ring_tune_rdy(1'b1),
+          .o_afe_ring_tune_val()
+      );
+    end
+  endgenerate
 
   tuner_ctrl_txn_adapter #(
       .DAC_WIDTH(DAC_WIDTH),
@@ -140,16 +250,19 @@ module tuner_phy #(
       .i_dig_ring_tune_start(i_cfg_ring_tune_start),
       .i_dig_ring_tune_end(i_cfg_ring_tune_end),
       .i_dig_ring_tune_stride(i_cfg_ring_tune_stride),
+      .i_dig_search_fit_mode(i_cfg_search_fit_mode),
 
       .txn_if(search_txn_if.ctrl),
       .search_if(search_if),
+      .local_search_if(local_search_if.producer),
       .o_dig_ring_tune(search_phy_ring_tune)
   );
 
   tuner_lock_phy #(
       .DAC_WIDTH(DAC_WIDTH),
       .ADC_WIDTH(ADC_WIDTH),
-      .LOCK_DELTA_WINDOW_SIZE(LOCK_DELTA_WINDOW_SIZE)
+      .LOCK_DELTA_WINDOW_SIZE(LOCK_DELTA_WINDOW_SIZE),
+      .LOCK_PI_GEAR_MAX(LOCK_PI_GEAR_MAX)
   ) lock_phy_inst (
       .i_clk(i_clk),
       .i_rst(i_rst),
@@ -157,11 +270,18 @@ module tuner_phy #(
       .i_cfg_ring_tune_start(i_cfg_ring_tune_start),
       .i_cfg_lock_tune_stride(i_cfg_lock_tune_stride),
       .i_cfg_lock_pwr_delta_thres(i_cfg_lock_pwr_delta_thres),
+      .i_cfg_lock_mode(i_cfg_lock_mode),
+      .i_cfg_lock_pi_kp_shift(i_cfg_lock_pi_kp_shift),
+      .i_cfg_lock_pi_ki_shift(i_cfg_lock_pi_ki_shift),
       .i_cfg_ring_pwr_peak_ratio(i_cfg_ring_pwr_peak_ratio),
+      .i_cfg_lock_loss_ratio(i_cfg_lock_loss_ratio),
+      .i_cfg_lock_loss_cnt(i_cfg_lock_loss_cnt),
+      .i_cfg_lock_research_halfwidth(i_cfg_lock_research_halfwidth),
       .i_dig_pwr_peak(i_cfg_pwr_peak),
       .i_dig_ring_tune_peak(i_cfg_ring_tune_peak),
 
       .ctrl_arb_if(ctrl_arb_if.producer),
+      .local_search_if(local_search_if.consumer),
       .lock_if(lock_if)
   );
   // ----------------------------------------------------------------------
@@ -172,9 +292,13 @@ module tuner_phy #(
   assign o_dig_search_state_mon = search_if.mon_state;
   assign o_dig_lock_state_mon = lock_if.mon_state;
 
-  // No error logic implemented yet
+  // No search error logic implemented yet
   assign o_dig_search_err = 1'b0;
-  assign o_dig_lock_err = 1'b0;
+  // Lock loss interrupt (level)
+  assign o_dig_lock_err = lock_if.mon_lock_lost;
+
+  assign o_dig_arb_lock_req = ctrl_arb_if.tune_val[CH_LOCK];
+  assign o_dig_arb_grant = ctrl_arb_if.get_ctrl_grant();
   // ----------------------------------------------------------------------
 
 endmodule
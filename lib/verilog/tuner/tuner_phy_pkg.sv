@@ -33,9 +33,28 @@ package tuner_phy_pkg;
     /*LOCK_SEARCH = 8'h2,*/
     /*LOCK_DONE   = 8'h3,*/
     LOCK_ACTIVE = 8'h2,
-    LOCK_INTR   = 8'h3
+    LOCK_INTR   = 8'h3,
+    LOCK_SEARCH = 8'h4   // Local re-acquire after lock loss
   } tuner_phy_lock_state_e  /*verilator public*/;
 
+  // Host command sequencer (tuner_cmd_seq)
+  typedef enum logic [TUNER_STATE_WIDTH-1:0] {
+    SEQ_IDLE          = 8'h0,
+    SEQ_SEARCH_TRIG   = 8'h1,
+    SEQ_SEARCH_WAIT   = 8'h2,
+    SEQ_LOCK_TRIG     = 8'h3,
+    SEQ_LOCK_SETTLE   = 8'h4,
+    SEQ_UNLOCK_INTR   = 8'h5,
+    SEQ_UNLOCK_RESUME = 8'h6,
+    SEQ_REPORT        = 8'h7
+  } tuner_phy_seq_state_e  /*verilator public*/;
+
+  // Lock algorithm select
+  typedef enum logic {
+    LOCK_MODE_SLOPE = 1'b0,  // Slope detection (bang-bang) around the peak
+    LOCK_MODE_PI    = 1'b1   // PI on drop power error against pwr_tgt
+  } tuner_phy_lock_mode_e;
+
   typedef enum logic [2:0] {
     DETECT_IDLE   = 3'b000,
     DETECT_WAIT   = 3'b001,
@@ -43,12 +62,25 @@ package tuner_phy_pkg;
     DETECT_DONE   = 3'b011
   } tuner_phy_detect_state_e;
 
+  // Power detector averaging select
+  typedef enum logic {
+    DETECT_MODE_BLOCK  = 1'b0,  // Wait, then average a fresh block per read
+    DETECT_MODE_STREAM = 1'b1   // Moving-average decimator, every cycle after warm-up
+  } tuner_phy_detect_mode_e;
+
   typedef enum logic [1:0] {
     ARB_CTRL_INIT   = 2'b00,
     ARB_CTRL_TUNE   = 2'b01,  // Tuner update
     ARB_CTRL_SYNC   = 2'b10,  // Synchronize tuner code-to-pwr detect
     ARB_CTRL_COMMIT = 2'b11   // Compute next tuner code
   } tuner_phy_ctrl_arb_state_e;
+
+  // Sync-cycle calibration phase, within ARB_CTRL_SYNC
+  typedef enum logic [1:0] {
+    SYNC_CAL_IDLE = 2'b00,  // Static/calibrated sync count
+    SYNC_CAL_AWAY = 2'b01,  // Probe code, count updates until stable
+    SYNC_CAL_BACK = 2'b10   // Fired code, count updates until stable
+  } tuner_phy_sync_cal_state_e;
   // ----------------------------------------------------------------------
 
   // ----------------------------------------------------------------------
@@ -80,11 +112,14 @@ package tuner_phy_pkg;
     CTRL_UPDATE = 2'b01   // Synchronize tuner code-to-pwr detect
   } tuner_phy_ctrl_arb_if_state_e;
 
-  // Predefined Controller Channels
-  typedef enum logic [1:0] {
-    CH_SEARCH = 2'b01,
-    CH_LOCK   = 2'b10,
-    CH_NULL   = 2'b00
+  // Predefined Controller Channels. tuner_ctrl_arb_if serves channels
+  // 1..NUM_CLIENT; CH_CAL/CH_MON are the next client slots.
+  typedef enum logic [2:0] {
+    CH_NULL   = 3'd0,
+    CH_SEARCH = 3'd1,
+    CH_LOCK   = 3'd2,
+    CH_CAL    = 3'd3,
+    CH_MON    = 3'd4
   } tuner_ctrl_ch_e;
   // ----------------------------------------------------------------------
 
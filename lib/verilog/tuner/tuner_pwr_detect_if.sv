@@ -2,7 +2,8 @@
 // Author: Sunjin Choi
 // Description: 
 // Signals:
-// Note: 
+// Note: cfg_* are driven by the consumer and latched by the producer at each
+// read, so the detect settings can change per request.
 // Variable naming conventions:
 //    signals => snake_case
 //    Parameters (aliasing signal values) => SNAKE_CASE with all caps
@@ -18,7 +19,9 @@
 
 // TODO: fix such that it accounts for AFE rdy/val
 interface tuner_pwr_detect_if #(
-    parameter int ADC_WIDTH = 8
+    parameter int ADC_WIDTH = 8,
+    parameter int MAX_WAIT_CYCLE = 16,
+    parameter int MAX_NUM_PWR_DETECT = 16
 ) (
     input logic i_clk,
     input logic i_rst
@@ -35,6 +38,12 @@ interface tuner_pwr_detect_if #(
   logic detect_val;
   logic [ADC_WIDTH-1:0] detect_data;
 
+  // Per-request detect config
+  logic cfg_mode;
+  logic [$clog2(MAX_WAIT_CYCLE+1)-1:0] cfg_wait_cycle;
+  logic [$clog2($clog2(MAX_NUM_PWR_DETECT)+1)-1:0] cfg_avg_shift;
+  logic [3:0] cfg_settle_tol;
+
   /*typedef enum logic {
    *  PWR_READ,
    *  PWR_DETECT
@@ -110,6 +119,10 @@ interface tuner_pwr_detect_if #(
       output read_rdy,
       output detect_val,
       output detect_data,
+      input cfg_mode,
+      input cfg_wait_cycle,
+      input cfg_avg_shift,
+      input cfg_settle_tol,
       import get_read_ack,
       import get_detect_ack
   );
@@ -121,6 +134,10 @@ interface tuner_pwr_detect_if #(
       input read_rdy,
       input detect_val,
       input detect_data,
+      output cfg_mode,
+      output cfg_wait_cycle,
+      output cfg_avg_shift,
+      output cfg_settle_tol,
       // Consumer-side arbitration interface
       output pwr_detect_refresh,
       output pwr_detect_active,
@@ -2,8 +2,14 @@
 // Author: Sunjin Choi
 // Description: 
 // Signals:
-// Note: Wait for WAIT_CYCLES, then detect power from the microring via
-// averaging for NUM_PWR_DETECT cycles.
+// Note: Wait for cfg_wait_cycle, then detect power from the microring via
+// averaging for 2^cfg_avg_shift cycles. All settings come from
+// pwr_detect_if and are latched at each read.
+// - DETECT_MODE_BLOCK: every read waits and averages a fresh block
+// - DETECT_MODE_STREAM: after the first block (warm-up), the average slides
+//   every cycle, and back-to-back reads skip the wait entirely
+// - cfg_settle_tol != 0 ends the wait early once two consecutive samples
+//   differ by less than cfg_settle_tol
 // Variable naming conventions:
 //    signals => snake_case
 //    Parameters (aliasing signal values) => SNAKE_CASE with all caps
@@ -20,8 +26,9 @@
 // TODO: implement a lightweight pwr threshold detector
 module tuner_pwr_detect_phy #(
     parameter int ADC_WIDTH = 8,
-    parameter int WAIT_CYCLE = 4,
-    parameter int NUM_PWR_DETECT = 1
+    parameter int MAX_WAIT_CYCLE = 16,
+    // Must be a power of two
+    parameter int MAX_NUM_PWR_DETECT = 16
 ) (
     input var logic i_clk,
     input var logic i_rst,
@@ -46,22 +53,90 @@ module tuner_pwr_detect_phy #(
   // ----------------------------------------------------------------------
   // Signals
   // ----------------------------------------------------------------------
+  localparam int WaitCycleWidth = $clog2(MAX_WAIT_CYCLE + 1);
+  localparam int MaxAvgShift = $clog2(MAX_NUM_PWR_DETECT);
+  localparam int AvgShiftWidth = $clog2(MaxAvgShift + 1);
+  localparam int DetectCntWidth = $clog2(MAX_NUM_PWR_DETECT + 1);
+
   /*state_t state, state_next;*/
   tuner_phy_detect_state_e state, state_next;
 
-  logic [$clog2(WAIT_CYCLE+1)-1:0] wait_cnt;
-  logic [$clog2(NUM_PWR_DETECT+1)-1:0] detect_cnt;
-  logic [(ADC_WIDTH+$clog2(NUM_PWR_DETECT))-1:0] acc_pwr;
+  logic [WaitCycleWidth-1:0] wait_cnt;
+  logic [DetectCntWidth-1:0] detect_cnt;
+  logic [(ADC_WIDTH+MaxAvgShift)-1:0] acc_pwr;
+
+  // Latched per-request config
+  tuner_phy_detect_mode_e cfg_mode;
+  logic [WaitCycleWidth-1:0] cfg_wait_cycle;
+  logic [AvgShiftWidth-1:0] cfg_avg_shift;
+  logic [3:0] cfg_settle_tol;
+
+  tuner_phy_detect_mode_e cfg_mode_in;
+  logic [WaitCycleWidth-1:0] cfg_wait_cycle_in;
+  logic [AvgShiftWidth-1:0] cfg_avg_shift_in;
+  logic [DetectCntWidth-1:0] num_detect;
+
+  // Sample history for the moving average and settle detection
+  logic [ADC_WIDTH-1:0] pwr_line[MAX_NUM_PWR_DETECT];
+  logic [ADC_WIDTH-1:0] pwr_diff;
+  logic pwr_settled;
+  logic stream_keep;
 
   logic pwr_read_fire;
   logic pwr_detect_fire;
   // ----------------------------------------------------------------------
 
+  // ----------------------------------------------------------------------
+  // Config
+  // ----------------------------------------------------------------------
+  // Clamp the requested wait to 1..MAX_WAIT_CYCLE and the averaging to
+  // MAX_NUM_PWR_DETECT samples
+  always_comb begin
+    cfg_mode_in = tuner_phy_detect_mode_e'(pwr_detect_if.cfg_mode);
+    if (pwr_detect_if.cfg_wait_cycle == '0) begin
+      cfg_wait_cycle_in = 'd1;
+    end
+    else if (pwr_detect_if.cfg_wait_cycle > WaitCycleWidth'(MAX_WAIT_CYCLE)) begin
+      cfg_wait_cycle_in = WaitCycleWidth'(MAX_WAIT_CYCLE);
+    end
+    else begin
+      cfg_wait_cycle_in = pwr_detect_if.cfg_wait_cycle;
+    end
+    if (pwr_detect_if.cfg_avg_shift > AvgShiftWidth'(MaxAvgShift)) begin
+      cfg_avg_shift_in = AvgShiftWidth'(MaxAvgShift);
+    end
+    else begin
+      cfg_avg_shift_in = pwr_detect_if.cfg_avg_shift;
+    end
+  end
+
+  always_ff @(posedge i_clk or posedge i_rst) begin
+    if (i_rst) begin
+      cfg_mode <= DETECT_MODE_BLOCK;
+      cfg_wait_cycle <= 'd1;
+      cfg_avg_shift <= '0;
+      cfg_settle_tol <= '0;
+    end
+    else if (pwr_read_fire) begin
+      cfg_mode <= cfg_mode_in;
+      cfg_wait_cycle <= cfg_wait_cycle_in;
+      cfg_avg_shift <= cfg_avg_shift_in;
+      cfg_settle_tol <= pwr_detect_if.cfg_settle_tol;
+    end
+  end
+
+  assign num_detect = DetectCntWidth'(1) << cfg_avg_shift;
+
+  // A streaming window stays valid across reads only if its length is kept
+  assign stream_keep = (cfg_mode == DETECT_MODE_STREAM) &&
+      (cfg_mode_in == DETECT_MODE_STREAM) && (cfg_avg_shift_in == cfg_avg_shift);
+  // ----------------------------------------------------------------------
+
   // ----------------------------------------------------------------------
   // Assigns
   // ----------------------------------------------------------------------
   // When pwr_read_fire goes high, we start entering WAIT state where:
-  // - wait_cnt counts up to WAIT_CYCLE
+  // - wait_cnt counts up to cfg_wait_cycle
   // - acc_pwr is reset to 0
   /*assign o_dig_pwr_read_rdy = (state == DETECT_IDLE) || (state == DETECT_DONE);
    *assign pwr_read_fire = i_dig_pwr_read_val && o_dig_pwr_read_rdy;*/
@@ -76,7 +151,14 @@ module tuner_pwr_detect_phy #(
   assign pwr_detect_fire = pwr_detect_if.get_detect_ack();
   /*assign pwr_detect_if.detect_data = pwr_detect_fire ? (acc_pwr / NUM_PWR_DETECT) : '0;*/
   // TODO: pulsation is bad for SI?
-  assign pwr_detect_if.detect_data = pwr_detect_fire ? (acc_pwr >> $clog2(NUM_PWR_DETECT)) : '0;
+  assign pwr_detect_if.detect_data =
+      pwr_detect_fire ? ADC_WIDTH'(acc_pwr >> cfg_avg_shift) : '0;
+
+  // Early exit from the wait once the ring+afe output stops moving
+  assign pwr_diff = (i_dig_ring_pwr > pwr_line[0]) ?
+      (i_dig_ring_pwr - pwr_line[0]) : (pwr_line[0] - i_dig_ring_pwr);
+  assign pwr_settled = (state == DETECT_WAIT) && (cfg_settle_tol != '0) &&
+      (wait_cnt != '0) && (pwr_diff < ADC_WIDTH'(cfg_settle_tol));
 
   // State machine with cycle counts
   // *Note*: when "read" is asserted, we enter the WAIT state instead of
@@ -117,13 +199,31 @@ module tuner_pwr_detect_phy #(
   always_comb begin
     case (state)
       DETECT_IDLE: state_next = pwr_read_fire ? DETECT_WAIT : DETECT_IDLE;
-      DETECT_WAIT: state_next = (wait_cnt == WAIT_CYCLE - 1) ? DETECT_ACTIVE : DETECT_WAIT;
-      DETECT_ACTIVE: state_next = (detect_cnt == NUM_PWR_DETECT - 1) ? DETECT_DONE : DETECT_ACTIVE;
-      DETECT_DONE: state_next = pwr_read_fire ? DETECT_WAIT : DETECT_DONE;
+      DETECT_WAIT:
+      state_next = ((wait_cnt == cfg_wait_cycle - 1) || pwr_settled) ?
+          DETECT_ACTIVE : DETECT_WAIT;
+      DETECT_ACTIVE: state_next = (detect_cnt == num_detect - 1) ? DETECT_DONE : DETECT_ACTIVE;
+      DETECT_DONE:
+      state_next = pwr_read_fire ? (stream_keep ? DETECT_DONE : DETECT_WAIT) : DETECT_DONE;
       default: state_next = state;
     endcase
   end
 
+  // Sample history shifts every cycle; pwr_line[k] is k+1 cycles old
+  always_ff @(posedge i_clk or posedge i_rst) begin
+    if (i_rst) begin
+      for (int i = 0; i < MAX_NUM_PWR_DETECT; i++) begin
+        pwr_line[i] <= '0;
+      end
+    end
+    else begin
+      pwr_line[0] <= i_dig_ring_pwr;
+      for (int i = 1; i < MAX_NUM_PWR_DETECT; i++) begin
+        pwr_line[i] <= pwr_line[i-1];
+      end
+    end
+  end
+
   always_ff @(posedge i_clk or posedge i_rst) begin
     if (i_rst) begin
       acc_pwr <= '0;
@@ -133,7 +233,11 @@ module tuner_pwr_detect_phy #(
         DETECT_IDLE: acc_pwr <= '0;
         DETECT_WAIT: acc_pwr <= '0;
         DETECT_ACTIVE: acc_pwr <= acc_pwr + i_dig_ring_pwr;
-        DETECT_DONE: acc_pwr <= acc_pwr;
+        // Moving average: add the newest sample, drop the one num_detect
+        // cycles old
+        DETECT_DONE:
+        acc_pwr <= (cfg_mode == DETECT_MODE_STREAM) ?
+            (acc_pwr + i_dig_ring_pwr - pwr_line[num_detect-1]) : acc_pwr;
         default: acc_pwr <= '0;
       endcase
     end
@@ -143,4 +247,3 @@ module tuner_pwr_detect_phy #(
 endmodule
 
 `default_nettype wire
-
@@ -0,0 +1,176 @@
+//==============================================================================
+// Author: Sunjin Choi
+// Description: Row-level feedforward between the per-ring tuner_phy tune
+// codes and the tuning DACs: common-mode drift offload and heater crosstalk
+// compensation
+// Signals:
+//    i_dig_ring_tune: tune code per ring (tuner_phy o_dig_ring_tune)
+//    i_dig_lock_active: ring is in LOCK_ACTIVE
+//    i_cfg_ff_cm_en: enable the common-mode integrator (off holds it at 0)
+//    i_cfg_ff_cm_shift: integrator gain, 2^-shift per cycle
+//    i_cfg_ff_xtalk: coupling matrix, [i][j] is the fraction of ring j's
+//    drive seen by ring i in 1/256 (signed, diagonal ignored)
+//    o_dig_ring_tune: DAC code per ring
+//    o_dig_ff_cm: common-mode offset added to every ring
+// Note: Each locked ring's correction is its tune code minus the code it
+// entered LOCK_ACTIVE with. The mean correction over the locked rings is
+// integrated into ff_cm, which is added to every ring, so a common drift
+// seen by the first rings to react moves the whole row and each lock loop
+// only keeps its own differential part. ff_cm holds when no ring is locked.
+// The crosstalk stage then subtracts xtalk[i][j] * code[j] from ring i, the
+// first-order inverse of the heater neighbour coupling (heater.sv), so a
+// neighbour's tune step no longer disturbs a locked ring. All zero config
+// is pass-through. Mirrors lib/cpp/models/row_ff.hpp.
+// Variable naming conventions:
+//    signals => snake_case
+//    Parameters (aliasing signal values) => SNAKE_CASE with all caps
+//    Module Parameters => ALL_CAPS_SNAKE_CASE
+//    Local Parameters => CamelCase
+//==============================================================================
+
+// verilog_format: off
+`timescale 1ns/1ps
+`default_nettype none
+// verilog_format: on
+
+module tuner_row_ff #(
+    parameter int DAC_WIDTH   = 8,
+    parameter int NUM_CHANNEL = 2
+) (
+    input var logic i_clk,
+    input var logic i_rst,
+
+    // config
+    input var logic i_cfg_ff_cm_en,
+    input var logic [3:0] i_cfg_ff_cm_shift,
+    input var logic signed [7:0] i_cfg_ff_xtalk[NUM_CHANNEL][NUM_CHANNEL],
+
+    // input signals
+    input var logic [DAC_WIDTH-1:0] i_dig_ring_tune[NUM_CHANNEL],
+    input var logic i_dig_lock_active[NUM_CHANNEL],
+
+    // output signals
+    output logic [DAC_WIDTH-1:0] o_dig_ring_tune[NUM_CHANNEL],
+    output logic signed [DAC_WIDTH:0] o_dig_ff_cm
+);
+
+  // ----------------------------------------------------------------------
+  // Signals
+  // ----------------------------------------------------------------------
+  // Integrator keeps FracWidth bits below the code LSB
+  localparam int FracWidth = 16;
+  localparam int CodeWidth = DAC_WIDTH + 2;
+  localparam int AccWidth = CodeWidth + FracWidth;
+  localparam int SumWidth = CodeWidth + $clog2(NUM_CHANNEL + 1);
+  localparam int XtalkWidth = CodeWidth + 8 + $clog2(NUM_CHANNEL + 1);
+  localparam int CodeMax = 2 ** DAC_WIDTH - 1;
+
+  logic [DAC_WIDTH-1:0] ring_tune_ref[NUM_CHANNEL];
+  logic lock_active_prev[NUM_CHANNEL];
+
+  logic signed [SumWidth-1:0] corr_sum;
+  logic [$clog2(NUM_CHANNEL + 1)-1:0] corr_cnt;
+  logic signed [SumWidth-1:0] corr_mean;
+
+  logic signed [AccWidth-1:0] ff_cm_acc;
+  logic signed [AccWidth-1:0] ff_cm_acc_next;
+  logic signed [CodeWidth-1:0] ff_cm;
+
+  logic [DAC_WIDTH-1:0] ring_code[NUM_CHANNEL];
+  logic signed [XtalkWidth-1:0] xtalk_sum[NUM_CHANNEL];
+  // ----------------------------------------------------------------------
+
+  // ----------------------------------------------------------------------
+  // Common-Mode Estimate
+  // ----------------------------------------------------------------------
+  // Reference taken in the cycle a ring enters LOCK_ACTIVE
+  always_ff @(posedge i_clk or posedge i_rst) begin
+    if (i_rst) begin
+      ring_tune_ref <= '{default: '0};
+      lock_active_prev <= '{default: 1'b0};
+    end
+    else begin
+      for (int i = 0; i < NUM_CHANNEL; i++) begin
+        lock_active_prev[i] <= i_dig_lock_active[i];
+        if (i_dig_lock_active[i] && !lock_active_prev[i]) begin
+          ring_tune_ref[i] <= i_dig_ring_tune[i];
+        end
+      end
+    end
+  end
+
+  always_comb begin : sum_correction
+    corr_sum = '0;
+    corr_cnt = '0;
+    for (int i = 0; i < NUM_CHANNEL; i++) begin
+      if (i_dig_lock_active[i] && lock_active_prev[i]) begin
+        corr_sum += SumWidth'(signed'({1'b0, i_dig_ring_tune[i]})) -
+                    SumWidth'(signed'({1'b0, ring_tune_ref[i]}));
+        corr_cnt += 1'b1;
+      end
+    end
+    corr_mean = (corr_cnt != '0) ? corr_sum / signed'({1'b0, corr_cnt}) : '0;
+  end
+
+  // ff_cm += mean correction * 2^-shift, clamped to the code range
+  always_comb begin : integrate_cm
+    ff_cm_acc_next = ff_cm_acc +
+        ((AccWidth'(corr_mean) <<< FracWidth) >>> i_cfg_ff_cm_shift);
+    if (ff_cm_acc_next > (AccWidth'(CodeMax) <<< FracWidth))
+      ff_cm_acc_next = AccWidth'(CodeMax) <<< FracWidth;
+    if (ff_cm_acc_next < -(AccWidth'(CodeMax) <<< FracWidth))
+      ff_cm_acc_next = -(AccWidth'(CodeMax) <<< FracWidth);
+  end
+
+  always_ff @(posedge i_clk or posedge i_rst) begin
+    if (i_rst) begin
+      ff_cm_acc <= '0;
+    end
+    else if (!i_cfg_ff_cm_en) begin
+      ff_cm_acc <= '0;
+    end
+    else if (corr_cnt != '0) begin
+      ff_cm_acc <= ff_cm_acc_next;
+    end
+  end
+
+  assign ff_cm = CodeWidth'(ff_cm_acc >>> FracWidth);
+  // ----------------------------------------------------------------------
+
+  // ----------------------------------------------------------------------
+  // Apply
+  // ----------------------------------------------------------------------
+  function automatic logic [DAC_WIDTH-1:0] clamp_code(
+      logic signed [XtalkWidth-1:0] code);
+    if (code < 0) return '0;
+    if (code > CodeMax) return DAC_WIDTH'(CodeMax);
+    return DAC_WIDTH'(code);
+  endfunction
+
+  always_comb begin : apply_cm
+    for (int i = 0; i < NUM_CHANNEL; i++) begin
+      ring_code[i] = clamp_code(XtalkWidth'(signed'({1'b0, i_dig_ring_tune[i]})) +
+                                XtalkWidth'(ff_cm));
+    end
+  end
+
+  always_comb begin : apply_xtalk
+    for (int i = 0; i < NUM_CHANNEL; i++) begin
+      xtalk_sum[i] = '0;
+      for (int j = 0; j < NUM_CHANNEL; j++) begin
+        if (j != i) begin
+          xtalk_sum[i] += XtalkWidth'(i_cfg_ff_xtalk[i][j]) *
+                          XtalkWidth'(signed'({1'b0, ring_code[j]}));
+        end
+      end
+      o_dig_ring_tune[i] = clamp_code(XtalkWidth'(signed'({1'b0, ring_code[i]})) -
+                                      (xtalk_sum[i] >>> 8));
+    end
+  end
+
+  assign o_dig_ff_cm = (DAC_WIDTH + 1)'(ff_cm);
+  // ----------------------------------------------------------------------
+
+endmodule
+
+`default_nettype wire
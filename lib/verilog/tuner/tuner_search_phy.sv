@@ -28,7 +28,9 @@ module tuner_search_phy #(
     /*parameter logic [DAC_WIDTH-1:0] SEARCH_STEP = 8'h01,*/
     // SEARCH_STEP = 2**SEARCH_STRIDE
     parameter int SEARCH_PEAK_WINDOW_HALFSIZE = 4,
-    parameter int SEARCH_PEAK_THRES = 2
+    parameter int SEARCH_PEAK_THRES = 2,
+    // Fit mode: minimum power of a local maximum to be reported as a peak
+    parameter int SEARCH_FIT_MIN_PWR = 16
 ) (
     input var logic i_clk,
     input var logic i_rst,
@@ -38,6 +40,8 @@ module tuner_search_phy #(
     input var logic [DAC_WIDTH-1:0] i_dig_ring_tune_start,
     input var logic [DAC_WIDTH-1:0] i_dig_ring_tune_end,
     input var logic [$clog2(DAC_WIDTH)-1:0] i_dig_ring_tune_stride,
+    // 0: voting-window peak detect, 1: sparse sweep with Lorentzian fit
+    input var logic i_dig_search_fit_mode,
 
     /*// Power Detector Interface
      *tuner_pwr_detect_if.consumer pwr_detect_if,*/
@@ -48,6 +52,10 @@ module tuner_search_phy #(
     // Search Interface for local search
     tuner_search_if.producer search_if,
 
+    // Local search requests (e.g., lock re-acquire), reports the max-power
+    // code instead of the voted peaks
+    tuner_local_search_if.producer local_search_if,
+
     // Tuner AFE Interface
     output logic [DAC_WIDTH-1:0] o_dig_ring_tune
 
@@ -92,6 +100,21 @@ module tuner_search_phy #(
   // all be determined as peaks, which is erroneous
   // Plus, physically the closeby peaks are not distinguishable
   localparam int PeakInvalidWindowSize = SEARCH_PEAK_THRES * 4;
+
+  // Lorentzian fit fixed point: reciprocal power scale and fractional bits
+  // of the fitted code before rounding
+  localparam int FitRecipShift = 16;
+  localparam int FitFracBits = 4;
+  // 1/pwr <= 2^FitRecipShift; the denominator 2*(u0 - 2*u1 + u2) and the
+  // numerator (u0 - u2)*step*2^F are signed, and the offset magnitude is
+  // bounded by step*2^F, so the quotient needs DAC_WIDTH + F bits
+  localparam int FitRecipWidth = FitRecipShift + 1;
+  localparam int FitDenWidth = FitRecipWidth + 3;
+  localparam int FitNumWidth = FitRecipWidth + 1 + DAC_WIDTH + FitFracBits;
+  localparam int FitQuotWidth = DAC_WIDTH + FitFracBits;
+  localparam int FitDivWidth = FitDenWidth + FitQuotWidth;
+  localparam int FitCodeWidth = DAC_WIDTH + FitFracBits + 2;
+  localparam int FitCntWidth = $clog2(FitQuotWidth + 1);
   // ----------------------------------------------------------------------
 
   // ----------------------------------------------------------------------
@@ -104,6 +127,14 @@ module tuner_search_phy #(
   logic search_peaks_fire;
   logic search_refresh;
 
+  logic local_trig_fire;
+  logic local_active;
+  logic peaks_held;
+  logic [DAC_WIDTH-1:0] ring_tune_start;
+  logic [DAC_WIDTH-1:0] ring_tune_end;
+  logic [DAC_WIDTH-1:0] ring_tune_max;
+  logic [ADC_WIDTH-1:0] pwr_max;
+
   /*logic pwr_read_fire;*/
   /*logic pwr_detect_fire;*/
   logic is_ctrl_active_state;
@@ -113,6 +144,7 @@ module tuner_search_phy #(
   int search_active_cnt_max;
   logic search_active_update;
   logic search_active_done;
+  logic search_active_exit;
 
   logic [DAC_WIDTH-1:0] ring_tune_step;
   logic [DAC_WIDTH-1:0] ring_tune;
@@ -139,6 +171,30 @@ module tuner_search_phy #(
   logic [$clog2(PeakInvalidWindowSize)-1:0] peak_invalid_cnt;
   logic peak_invalid;
   logic peak_commit;
+  logic peak_store;
+
+  logic fit_found;
+  logic fit_start;
+  logic fit_done;
+  logic fit_busy;
+  logic fit_div_en;
+  logic [FitRecipWidth-1:0] fit_recip_lut[2**ADC_WIDTH];
+  logic [FitRecipWidth-1:0] fit_u0, fit_u1, fit_u2;
+  logic signed [FitDenWidth-1:0] fit_den;
+  logic signed [FitNumWidth-1:0] fit_num;
+  logic [FitNumWidth-1:0] fit_num_mag;
+  logic [DAC_WIDTH-1:0] fit_x1;
+  logic [ADC_WIDTH-1:0] fit_pwr;
+  logic fit_div_neg;
+  logic fit_div_sat;
+  logic [FitDivWidth-1:0] fit_div_rem;
+  logic [FitDivWidth-1:0] fit_div_den;
+  logic [FitQuotWidth-1:0] fit_div_quot;
+  logic [FitCntWidth-1:0] fit_div_cnt;
+  logic [FitQuotWidth-1:0] fit_limit;
+  logic [FitQuotWidth-1:0] fit_mag;
+  logic signed [FitCodeWidth-1:0] fit_code;
+  logic [DAC_WIDTH-1:0] fit_ring_tune;
 
   logic [DAC_WIDTH-1:0] ring_tune_peaks[NUM_TARGET];
   logic [ADC_WIDTH-1:0] pwr_peaks[NUM_TARGET];
@@ -152,15 +208,46 @@ module tuner_search_phy #(
   /*assign o_dig_search_trig_rdy = (state == SEARCH_IDLE) || (state == SEARCH_DONE);*/
   /*assign o_dig_search_peaks_val = (state == SEARCH_DONE);*/
   assign search_if.trig_rdy = (state == SEARCH_IDLE) || (state == SEARCH_DONE);
-  assign search_if.peaks_val = (state == SEARCH_DONE);
+  // Global results stay valid through a local search started from
+  // SEARCH_DONE, until the next host trigger
+  assign search_if.peaks_val = peaks_held;
 
   assign search_refresh = state == SEARCH_INIT;
 
   /*assign search_trig_fire = o_dig_search_trig_rdy && i_dig_search_trig_val;*/
   /*assign search_peaks_fire = o_dig_search_peaks_val && i_dig_search_peaks_rdy;*/
-  assign search_trig_fire = search_if.get_trig_ack();
+  assign search_trig_fire = search_if.get_trig_ack() || local_trig_fire;
   assign search_peaks_fire = search_if.get_peaks_ack();
 
+  // Host trigger takes priority over local search requests
+  assign local_search_if.trig_rdy = search_if.trig_rdy && !search_if.trig_val;
+  assign local_trig_fire = local_search_if.get_trig_ack();
+
+  // Latch the requester at trigger, valid from SEARCH_INIT onward
+  always_ff @(posedge i_clk or posedge i_rst) begin
+    if (i_rst) begin
+      local_active <= 1'b0;
+    end
+    else if (search_trig_fire) begin
+      local_active <= local_trig_fire;
+    end
+  end
+
+  always_ff @(posedge i_clk or posedge i_rst) begin
+    if (i_rst) begin
+      peaks_held <= 1'b0;
+    end
+    else if (search_trig_fire && !local_trig_fire) begin
+      peaks_held <= 1'b0;
+    end
+    else if ((state == SEARCH_ACTIVE) && search_active_exit && !local_active) begin
+      peaks_held <= 1'b1;
+    end
+  end
+
+  assign ring_tune_start = local_active ? local_search_if.ring_tune_start : i_dig_ring_tune_start;
+  assign ring_tune_end = local_active ? local_search_if.ring_tune_end : i_dig_ring_tune_end;
+
   // State machine
   always_ff @(posedge i_clk or posedge i_rst) begin
     if (i_rst) begin
@@ -179,7 +266,8 @@ module tuner_search_phy #(
       SEARCH_INIT: state_next = SEARCH_ACTIVE;
       // If search is done, go to SEARCH_DONE
       // If search is not done, stay at SEARCH_ACTIVE
-      SEARCH_ACTIVE: state_next = search_active_done ? SEARCH_DONE : state;
+      // Local search has no peaks handshake, return to where it started
+      SEARCH_ACTIVE: state_next = search_active_exit ? ((local_active && !peaks_held) ? SEARCH_IDLE : SEARCH_DONE) : state;
       // Stay at SEARCH_DONE until search_trig_fire
       /*SEARCH_DONE: state_next = search_trig_fire ? SEARCH_ACTIVE : state;*/
       SEARCH_DONE: state_next = search_trig_fire ? SEARCH_INIT : state;
@@ -242,7 +330,8 @@ module tuner_search_phy #(
   // ----------------------------------------------------------------------
   assign is_ctrl_active_state = (state == SEARCH_ACTIVE);
   assign search_active_update = txn_if.fire();
-  assign txn_if.val = is_ctrl_active_state && txn_valid;
+  // No new sample while the fit divider runs
+  assign txn_if.val = is_ctrl_active_state && txn_valid && !fit_busy;
   assign txn_if.tune_code = ring_tune;
 
   // ----------------------------------------------------------------------
@@ -256,7 +345,7 @@ module tuner_search_phy #(
     if (i_rst) begin
       ring_tune <= '0;
     end else if (search_refresh) begin
-      ring_tune <= i_dig_ring_tune_start;
+      ring_tune <= ring_tune_start;
     end else if (txn_if.fire()) begin
       ring_tune <= ring_tune + ring_tune_step;
     end
@@ -266,8 +355,10 @@ module tuner_search_phy #(
 
   // ----------------------------------------------------------------------
   // Count the number of power detections taken during SEARCH_ACTIVE
-  assign search_active_cnt_max = (i_dig_ring_tune_end - i_dig_ring_tune_start) >> i_dig_ring_tune_stride;
+  assign search_active_cnt_max = (ring_tune_end - ring_tune_start) >> i_dig_ring_tune_stride;
   assign search_active_done = (search_active_cnt >= search_active_cnt_max);
+  // The last fit is stored before SEARCH_ACTIVE exits
+  assign search_active_exit = search_active_done && !fit_busy && !fit_start;
 
   always_ff @(posedge i_clk or posedge i_rst) begin
     if (i_rst) begin
@@ -308,7 +399,7 @@ module tuner_search_phy #(
     else if (search_refresh) begin
       // TODO: misleading information? pwr is not 0 at the tune_start
       pwr_det_track   <= '0;  // Initialize power detected track
-      ring_tune_track <= i_dig_ring_tune_start;  // Start from the initial tune code
+      ring_tune_track <= ring_tune_start;  // Start from the initial tune code
     end
     else if (search_active_update) begin
       // Receive the committed ring tune and power from the controller arbiter
@@ -409,8 +500,104 @@ module tuner_search_phy #(
     end
   end
 
+  // ----------------------------------------------------------------------
+  // SEARCH_ACTIVE - Lorentzian Fit (fit mode)
+  // ----------------------------------------------------------------------
+  // 1/pwr of a Lorentzian is a parabola in the tune code, so the three
+  // samples around a local maximum (y0, y1, y2 at x1-h, x1, x1+h) give
+  //   x0 = x1 + h * (u0 - u2) / (2 * (u0 - 2*u1 + u2)),  u = 1/y
+  // Samples only need to be closer than about one linewidth, so the sweep
+  // can use a much larger stride. y2 is the live transaction result.
+  // 1/y comes from a 2^ADC_WIDTH entry ROM, and the single num/den runs on
+  // a restoring divider, one quotient bit per cycle, while the sweep waits.
+  generate
+    for (genvar p = 0; p < 2 ** ADC_WIDTH; p++) begin
+      localparam int FitRecip = (1 << FitRecipShift) / ((p == 0) ? 1 : p);
+      assign fit_recip_lut[p] = (p == 0) ? '0 : FitRecipWidth'(FitRecip);
+    end
+  endgenerate
+
+  assign fit_found = (search_active_cnt >= 2) &&
+                     (pwr_det_track > pwr_det_track_win[0]) &&
+                     (pwr_det_track >= txn_if.meas_power) &&
+                     (pwr_det_track >= ADC_WIDTH'(SEARCH_FIT_MIN_PWR));
+
+  assign fit_u0 = fit_recip_lut[pwr_det_track_win[0]];
+  assign fit_u1 = fit_recip_lut[pwr_det_track];
+  assign fit_u2 = fit_recip_lut[txn_if.meas_power];
+  assign fit_den = (FitDenWidth'(fit_u0) - (FitDenWidth'(fit_u1) << 1) +
+                    FitDenWidth'(fit_u2)) << 1;
+  assign fit_num = ((FitNumWidth'(fit_u0) - FitNumWidth'(fit_u2)) *
+                    FitNumWidth'(ring_tune_step)) << FitFracBits;
+  assign fit_num_mag = fit_num[FitNumWidth-1] ? -fit_num : fit_num;
+  // Tails at zero power carry no shape information; keep the sample
+  assign fit_div_en = (pwr_det_track_win[0] != '0) && (txn_if.meas_power != '0) &&
+                      (fit_den > 0);
+
+  assign fit_start = search_active_update && i_dig_search_fit_mode && fit_found &&
+                     !local_active;
+  assign fit_done = fit_busy && (fit_div_cnt == '0);
+
+  always_ff @(posedge i_clk or posedge i_rst) begin
+    if (i_rst) begin
+      fit_busy <= 1'b0;
+      fit_x1 <= '0;
+      fit_pwr <= '0;
+      fit_div_neg <= 1'b0;
+      fit_div_sat <= 1'b0;
+      fit_div_rem <= '0;
+      fit_div_den <= '0;
+      fit_div_quot <= '0;
+      fit_div_cnt <= '0;
+    end
+    else if (fit_start) begin
+      fit_busy <= 1'b1;
+      fit_x1 <= ring_tune_track;
+      fit_pwr <= pwr_det_track;
+      fit_div_neg <= fit_num[FitNumWidth-1];
+      // A quotient past 2^FitQuotWidth is clamped to the step anyway
+      fit_div_sat <= fit_div_en &&
+                     (FitDivWidth'(fit_num_mag) >= (FitDivWidth'(fit_den) << FitQuotWidth));
+      fit_div_rem <= fit_div_en ? FitDivWidth'(fit_num_mag) : '0;
+      fit_div_den <= FitDivWidth'(fit_den) << (FitQuotWidth - 1);
+      fit_div_quot <= '0;
+      fit_div_cnt <= fit_div_en ? FitCntWidth'(FitQuotWidth) : '0;
+    end
+    else if (fit_done) begin
+      fit_busy <= 1'b0;
+    end
+    else if (fit_div_cnt != '0) begin
+      if (fit_div_rem >= fit_div_den) begin
+        fit_div_rem <= fit_div_rem - fit_div_den;
+        fit_div_quot <= {fit_div_quot[FitQuotWidth-2:0], 1'b1};
+      end
+      else begin
+        fit_div_quot <= {fit_div_quot[FitQuotWidth-2:0], 1'b0};
+      end
+      fit_div_den <= fit_div_den >> 1;
+      fit_div_cnt <= fit_div_cnt - 1'b1;
+    end
+  end
+
+  // The vertex lies between the outer samples; the quotient truncates
+  // toward zero and is clamped to one step
+  assign fit_limit = FitQuotWidth'(ring_tune_step) << FitFracBits;
+  assign fit_mag = (fit_div_sat || (fit_div_quot > fit_limit)) ? fit_limit : fit_div_quot;
+
+  always_comb begin
+    fit_code = (FitCodeWidth'(fit_x1) << FitFracBits) +
+               (fit_div_neg ? -FitCodeWidth'(fit_mag) : FitCodeWidth'(fit_mag)) +
+               FitCodeWidth'(1 << (FitFracBits - 1));
+    fit_code = fit_code >>> FitFracBits;
+    if (fit_code < 0) fit_ring_tune = '0;
+    else if (fit_code > (1 << DAC_WIDTH) - 1) fit_ring_tune = '1;
+    else fit_ring_tune = DAC_WIDTH'(fit_code);
+  end
+
   // commit the peak only if it is valid
-  assign peak_commit = peak_found && !peak_invalid;
+  assign peak_commit = i_dig_search_fit_mode ? fit_found : (peak_found && !peak_invalid);
+  // A fit peak is stored when its divide finishes
+  assign peak_store = i_dig_search_fit_mode ? fit_done : (search_active_update && peak_commit);
 
   always_ff @(posedge i_clk or posedge i_rst) begin
     if (i_rst) begin
@@ -418,21 +605,47 @@ module tuner_search_phy #(
       pwr_peaks <= '{default: '0};
       peak_ptr <= '0;
     end
-    // Reset the peak pointer at search_init
-    else if (search_refresh) begin
+    // Reset the peak pointer at search_init; a local search leaves the
+    // global results alone
+    else if (search_refresh && !local_active) begin
       ring_tune_peaks <= '{default: '0};
       pwr_peaks <= '{default: '0};
       peak_ptr <= '0;
     end
-    else if (search_active_update & peak_commit) begin
+    else if (peak_store && !local_active) begin
       // Store the peak in the array
-      ring_tune_peaks[peak_ptr] <= ring_tune_peak_track;
-      pwr_peaks[peak_ptr] <= pwr_peak_track;
+      ring_tune_peaks[peak_ptr] <= i_dig_search_fit_mode ? fit_ring_tune : ring_tune_peak_track;
+      pwr_peaks[peak_ptr] <= i_dig_search_fit_mode ? fit_pwr : pwr_peak_track;
       peak_ptr <= peak_ptr + 1;
     end
   end
   // ----------------------------------------------------------------------
 
+  // ----------------------------------------------------------------------
+  // SEARCH_ACTIVE - Max Power Tracker (Local Search)
+  // ----------------------------------------------------------------------
+  // A local sweep is narrow enough to hold a single resonance, so the
+  // max-power code is the peak and needs no voting window warm-up
+  always_ff @(posedge i_clk or posedge i_rst) begin
+    if (i_rst) begin
+      ring_tune_max <= '0;
+      pwr_max <= '0;
+    end
+    else if (search_refresh) begin
+      ring_tune_max <= ring_tune_start;
+      pwr_max <= '0;
+    end
+    else if (search_active_update && (txn_if.meas_power > pwr_max)) begin
+      ring_tune_max <= ring_tune;
+      pwr_max <= txn_if.meas_power;
+    end
+  end
+
+  assign local_search_if.done_val = (state == SEARCH_ACTIVE) && search_active_done && local_active;
+  assign local_search_if.ring_tune_peak = ring_tune_max;
+  assign local_search_if.pwr_peak = pwr_max;
+  // ----------------------------------------------------------------------
+
   // ----------------------------------------------------------------------
   // SEARCH_DONE
   // ----------------------------------------------------------------------
@@ -472,6 +685,17 @@ module tuner_search_phy #(
   assign search_if.mon_state = state;
   // ----------------------------------------------------------------------
 
+  // ----------------------------------------------------------------------
+  // Functional coverage (verilator --coverage-user)
+  // ----------------------------------------------------------------------
+  cov_peak_commit :
+  cover property (@(posedge i_clk) disable iff (i_rst)
+      peak_store);
+  cov_peak_suppressed :
+  cover property (@(posedge i_clk) disable iff (i_rst)
+      search_active_update && peak_found && peak_invalid);
+  // ----------------------------------------------------------------------
+
 endmodule
 
 `default_nettype wire
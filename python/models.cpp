@@ -0,0 +1,185 @@
+#include "models/ring_tf.hpp"
+#include "models/search_phy.hpp"
+#include "utils/sweep.hpp"
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <stdexcept>
+
+// svwdm_models: the C++ tuner models and sweep generators, in process.
+// Array results are NumPy views over the model's own storage (base keeps
+// the owner alive) or arrays the C++ loop fills in place; nothing goes
+// through files or per-sample Python calls.
+namespace py = pybind11;
+using search_phy::code_t;
+using search_phy::search_state_e;
+using search_phy::SearchPhyModel;
+
+// Read-only view over storage owned by base
+template <typename T, size_t N>
+static py::array_t<T> view(const std::array<T, N> &a, py::handle base) {
+  py::array_t<T> out({static_cast<py::ssize_t>(N)}, {sizeof(T)}, a.data(),
+                     base);
+  out.attr("setflags")(py::arg("write") = false);
+  return out;
+}
+
+// One search per row of pwr, a drop-power table indexed by tune code, with
+// the GIL released for the whole batch
+static py::tuple
+search_batch(py::array_t<uint8_t, py::array::c_style | py::array::forcecast>
+                 pwr,
+             uint8_t start, uint8_t end, uint8_t stride, bool fit_mode) {
+  constexpr py::ssize_t kCodes = py::ssize_t{1} << SearchPhyModel::DAC_WIDTH;
+  constexpr py::ssize_t kTargets = SearchPhyModel::NUM_TARGET;
+  if (pwr.ndim() != 2 || pwr.shape(1) != kCodes)
+    throw std::invalid_argument("search_batch: pwr must be (N, 256)");
+  const py::ssize_t n = pwr.shape(0);
+  py::array_t<code_t> peaks({n, kTargets});
+  py::array_t<code_t> pwr_peaks({n, kTargets});
+  py::array_t<code_t> num_peaks(n);
+  py::array_t<code_t> samples(n);
+  auto in = pwr.unchecked<2>();
+  auto out_peaks = peaks.mutable_unchecked<2>();
+  auto out_pwr = pwr_peaks.mutable_unchecked<2>();
+  auto out_num = num_peaks.mutable_unchecked<1>();
+  auto out_samples = samples.mutable_unchecked<1>();
+  {
+    py::gil_scoped_release release;
+    SearchPhyModel model;
+    model.configure(start, end, stride, fit_mode);
+    for (py::ssize_t i = 0; i < n; ++i) {
+      model.start();
+      while (model.state() == search_state_e::SEARCH_ACTIVE)
+        model.step(in(i, model.ring_tune()));
+      for (py::ssize_t t = 0; t < kTargets; ++t) {
+        out_peaks(i, t) = model.ring_tune_peaks()[t];
+        out_pwr(i, t) = model.pwr_peaks()[t];
+      }
+      out_num(i) = model.peaks_cnt();
+      out_samples(i) = model.samples();
+    }
+  }
+  return py::make_tuple(peaks, pwr_peaks, num_peaks, samples);
+}
+
+// Drop ADC codes of a microring row along a tune-code trajectory, one row
+// of codes per step. Lock trajectories move a ring or two per step, so the
+// row is evaluated incrementally (RingRowCascade, bit-exact with
+// RingRowLut) instead of walking every ring and wave at each step.
+static py::array_t<ring_tf::code_t> row_adc_batch(
+    py::array_t<ring_tf::code_t, py::array::c_style | py::array::forcecast>
+        codes,
+    std::vector<double> wvl_rings, std::vector<double> wvl_waves,
+    std::vector<double> pwr_waves, double fwhm, double tuning_full_scale,
+    double adc_full_scale, double responsivity) {
+  const size_t num_rings = wvl_rings.size();
+  if (codes.ndim() != 2 || codes.shape(1) != py::ssize_t(num_rings))
+    throw std::invalid_argument("row_adc_batch: codes must be (T, rings)");
+  if (pwr_waves.size() != wvl_waves.size())
+    throw std::invalid_argument("row_adc_batch: one power per wavelength");
+  ring_tf::ChainConfig cfg;
+  cfg.fwhm = fwhm;
+  cfg.tuning_full_scale = tuning_full_scale;
+  cfg.adc_full_scale = adc_full_scale;
+  cfg.responsivity = responsivity;
+  std::vector<ring_tf::Wave> waves;
+  for (size_t i = 0; i < wvl_waves.size(); ++i)
+    waves.push_back({wvl_waves[i], pwr_waves[i]});
+  const py::ssize_t n = codes.shape(0);
+  auto in = codes.unchecked<2>();
+  for (py::ssize_t t = 0; t < n; ++t) {
+    for (size_t r = 0; r < num_rings; ++r) {
+      if (in(t, r) < 0 || in(t, r) > cfg.dac_max())
+        throw std::invalid_argument("row_adc_batch: code out of range");
+    }
+  }
+  py::array_t<ring_tf::code_t> adc({n, py::ssize_t(num_rings)});
+  const ring_tf::code_t *src = codes.data();
+  ring_tf::code_t *dst = adc.mutable_data();
+  {
+    py::gil_scoped_release release;
+    ring_tf::RingRowCascade row(cfg, std::move(waves), std::move(wvl_rings));
+    for (py::ssize_t t = 0; t < n; ++t)
+      row.evaluate_adc(src + t * num_rings, dst + t * num_rings);
+  }
+  return adc;
+}
+
+// All records of a sweep generator as a structured array, built in place
+template <typename Sweep, typename Rec>
+static py::array_t<Rec> sweep_records(const Sweep &sweep) {
+  py::array_t<Rec> out(sweep.count());
+  Rec *dst = out.mutable_data();
+  for (int i = 0; i < sweep.count(); ++i)
+    sweep.update_rec(dst[i], i);
+  return out;
+}
+
+PYBIND11_MODULE(svwdm_models, m) {
+  m.doc() = "In-process tuner models and sweep generators";
+
+  PYBIND11_NUMPY_DTYPE(wvl_tf_t, i_pwr, i_wvl, o_pwr);
+  PYBIND11_NUMPY_DTYPE(dac_tf_t, i_pwr, i_code, o_pwr);
+
+  py::enum_<search_state_e>(m, "SearchState")
+      .value("IDLE", search_state_e::SEARCH_IDLE)
+      .value("INIT", search_state_e::SEARCH_INIT)
+      .value("ACTIVE", search_state_e::SEARCH_ACTIVE)
+      .value("DONE", search_state_e::SEARCH_DONE)
+      .value("ERROR", search_state_e::SEARCH_ERROR)
+      .value("INTR", search_state_e::SEARCH_INTR);
+
+  py::class_<SearchPhyModel>(m, "SearchPhyModel")
+      .def(py::init<>())
+      .def("configure", &SearchPhyModel::configure, py::arg("start"),
+           py::arg("end"), py::arg("stride"), py::arg("fit_mode") = false)
+      .def("reset", &SearchPhyModel::reset)
+      .def("start", &SearchPhyModel::start)
+      .def("step", &SearchPhyModel::step, py::arg("power_sample"))
+      .def_property_readonly("state", &SearchPhyModel::state)
+      .def_property_readonly("ring_tune", &SearchPhyModel::ring_tune)
+      .def_property_readonly("samples", &SearchPhyModel::samples)
+      .def_property_readonly("peaks_cnt", &SearchPhyModel::peaks_cnt)
+      .def_property_readonly("ring_tune_peaks",
+                             [](py::object self) {
+                               return view(self.cast<const SearchPhyModel &>()
+                                               .ring_tune_peaks(),
+                                           self);
+                             })
+      .def_property_readonly("pwr_peaks", [](py::object self) {
+        return view(self.cast<const SearchPhyModel &>().pwr_peaks(), self);
+      });
+
+  m.def("lorentzian_fit_code", &search_phy::lorentzian_fit_code,
+        py::arg("x1"), py::arg("h"), py::arg("y0"), py::arg("y1"),
+        py::arg("y2"), py::arg("dac_width") = 8);
+  m.def("search_batch", &search_batch, py::arg("pwr"), py::arg("start") = 0,
+        py::arg("end") = 255, py::arg("stride") = 0,
+        py::arg("fit_mode") = false,
+        "Search every row of an (N, 256) uint8 drop-power table; returns "
+        "(peaks, pwr_peaks, num_peaks, samples)");
+
+  m.def("row_adc_batch", &row_adc_batch, py::arg("codes"),
+        py::arg("wvl_rings"), py::arg("wvl_waves"), py::arg("pwr_waves"),
+        py::arg("fwhm") = 1.0, py::arg("tuning_full_scale") = 10.0,
+        py::arg("adc_full_scale") = 1.0, py::arg("responsivity") = 1.0,
+        "Drop ADC codes of a ring row for each row of a (T, rings) int32 "
+        "tune-code trajectory; returns (T, rings)");
+
+  m.def(
+      "wavelength_sweep",
+      [](double i_pwr, double wvl_start, double wvl_end, int count) {
+        return sweep_records<WavelengthSweep, wvl_tf_t>(
+            WavelengthSweep(i_pwr, wvl_start, wvl_end, count));
+      },
+      py::arg("i_pwr"), py::arg("wvl_start"), py::arg("wvl_end"),
+      py::arg("count"));
+  m.def(
+      "dac_sweep",
+      [](double i_pwr, int code_start, int code_end, int count) {
+        return sweep_records<DACSweep, dac_tf_t>(
+            DACSweep(i_pwr, code_start, code_end, count));
+      },
+      py::arg("i_pwr"), py::arg("code_start"), py::arg("code_end"),
+      py::arg("count"));
+}
@@ -21,6 +21,13 @@ plot_if_exists() {
   local output_file="$2"
   shift 2
 
+  # Prefer the binary monitor when the bench streamed one alongside
+  local swm_file="${csv_file%.csv}.swm"
+  if [[ -f "$swm_file" ]]; then
+    "$plot_wave" "$swm_file" --filepath "$output_file" "$@"
+    return 0
+  fi
+
   if [[ ! -f "$csv_file" ]]; then
     printf 'Skipping missing CSV: %s\n' "$csv_file" >&2
     return 0
@@ -44,6 +51,12 @@ plot_if_exists \
   "${plots_dir}/tuner_search_lock_row_ring1.png" \
   --state_col lock_state
 
+# Binary monitor only
+plot_if_exists \
+  "${repo_root}/build/sim/tuner_search_lock_replay/search_lock_replay.csv" \
+  "${plots_dir}/tuner_search_lock_replay.png" \
+  --state_col lock_state
+
 plot_if_exists \
   "${repo_root}/build/sim/tuner_search_row/search_waveform_ring0.csv" \
   "${plots_dir}/tuner_search_row_ring0.png"
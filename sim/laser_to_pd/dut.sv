@@ -60,6 +60,7 @@ module dut (
       .waves_t(WAVES_TYPE)
   ) photodetector (
       .i_phot_waves  (waves),
+      .i_real_noise  (0.0),
       .o_real_current(o_pd)
   );
   // ----------------------------------------------------------------------
@@ -69,6 +69,8 @@ module dut (
       .i_real_wvl_ring(i_wvl_ring),
       .i_real_tuning_dist(0.0),  // No tuning for now
       .i_real_temperature(0.0),  // No temperature sensitivity for now
+      .i_real_fwhm_scale (1.0),
+      .i_real_tune_scale (1.0),
       .o_phot_waves_drop(waves_drop),
       .o_phot_waves_thru(waves_thru)
   );
@@ -77,6 +79,7 @@ module dut (
       .waves_t(WAVES_TYPE)
   ) pd_drop (
       .i_phot_waves  (waves_drop),
+      .i_real_noise  (0.0),
       .o_real_current(o_pwr_drop)
   );
 
@@ -84,6 +87,7 @@ module dut (
       .waves_t(WAVES_TYPE)
   ) pd_thru (
       .i_phot_waves  (waves_thru),
+      .i_real_noise  (0.0),
       .o_real_current(o_pwr_thru)
   );
   // ----------------------------------------------------------------------
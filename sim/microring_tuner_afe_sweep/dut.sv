@@ -38,6 +38,7 @@ module dut #(
     output logic [ADC_WIDTH-1:0] o_dig_pwr_thru_detect
 );
   import wdm_pkg::*;
+  import tuner_phy_pkg::*;
 
   `DECLARE_WAVES_TYPE(1)
 
@@ -70,6 +71,11 @@ module dut #(
   assign o_dig_pwr_thru_detect = pwr_detect_if.detect_data;
   assign pwr_detect_if.pwr_detect_active = 1'b1;
   assign pwr_detect_if.pwr_detect_refresh = 1'b0;
+  // Fixed settling, single-sample detect
+  assign pwr_detect_if.cfg_mode = DETECT_MODE_BLOCK;
+  assign pwr_detect_if.cfg_wait_cycle = 'd4;
+  assign pwr_detect_if.cfg_avg_shift = '0;
+  assign pwr_detect_if.cfg_settle_tol = '0;
   // ----------------------------------------------------------------------
 
   // ----------------------------------------------------------------------
@@ -94,6 +100,8 @@ module dut #(
       .i_real_wvl_ring(i_wvl_ring),
       .i_real_tuning_dist(ana_tune),  // No tuning for now
       .i_real_temperature(0.0),  // No temperature sensitivity for now
+      .i_real_fwhm_scale (1.0),
+      .i_real_tune_scale (1.0),
       .o_phot_waves_drop(waves_drop),
       .o_phot_waves_thru(waves_thru)
   );
@@ -103,6 +111,7 @@ module dut #(
       .FullScaleRange(1.0)
   ) dac_tune (
       .i_dig(i_dac_tune),
+      .i_real_inl('{default: 0.0}),
       .o_ana(ana_tune)
   );
 
@@ -110,6 +119,7 @@ module dut #(
       .waves_t(WAVES_TYPE)
   ) pd_drop (
       .i_phot_waves  (waves_drop),
+      .i_real_noise  (0.0),
       .o_real_current(o_pwr_drop)
   );
 
@@ -117,6 +127,7 @@ module dut #(
       .waves_t(WAVES_TYPE)
   ) pd_thru (
       .i_phot_waves  (waves_thru),
+      .i_real_noise  (0.0),
       .o_real_current(o_pwr_thru)
   );
 
@@ -125,6 +136,8 @@ module dut #(
       .FullScaleRange(1.0)
   ) adc_thru (
       .i_ana(o_pwr_thru),
+      .i_real_offset(0.0),
+      .i_real_inl('{default: 0.0}),
       .o_dig(o_adc_thru)
   );
 
@@ -133,6 +146,8 @@ module dut #(
       .FullScaleRange(1.0)
   ) adc_drop (
       .i_ana(o_pwr_drop),
+      .i_real_offset(0.0),
+      .i_real_inl('{default: 0.0}),
       .o_dig(o_adc_drop)
   );
 
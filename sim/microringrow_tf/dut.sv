@@ -68,6 +68,8 @@ module dut (
       .i_real_wvl_ring(i_wvl_ring),
       .i_real_tuning_dist('{default: 0.0}),  // No tuning for now
       .i_real_temperature('{default: 0.0}),  // No temperature sensitivity for now
+      .i_real_fwhm_scale ('{default: 1.0}),
+      .i_real_tune_scale ('{default: 1.0}),
       .o_phot_waves_drop(waves_drop),
       .o_phot_waves_thru(waves_thru)
   );
@@ -78,6 +80,7 @@ module dut (
           .waves_t(WAVES_TYPE)
       ) pd_drop (
           .i_phot_waves  (waves_drop[i]),
+          .i_real_noise  (0.0),
           .o_real_current(o_pwr_drop[i])
       );
     end
@@ -87,6 +90,7 @@ module dut (
       .waves_t(WAVES_TYPE)
   ) pd_thru (
       .i_phot_waves  (waves_thru),
+      .i_real_noise  (0.0),
       .o_real_current(o_pwr_thru)
   );
   // ----------------------------------------------------------------------
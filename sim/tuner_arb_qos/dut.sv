@@ -0,0 +1,322 @@
+//==============================================================================
+// Author: Sunjin Choi
+// Description: DUT for tuner_arb_qos simulation (tuner_search_lock DUT with
+// the search/lock arbitration QoS config and grant monitor exposed)
+//==============================================================================
+
+// verilog_format: off
+`timescale 1ns/1ps
+`default_nettype none
+// verilog_format: on
+
+module dut #(
+    parameter int DAC_WIDTH    = 8,
+    parameter int ADC_WIDTH    = 8,
+    parameter int NUM_TARGET   = 8,
+    parameter int LOCK_DELTA_WINDOW_SIZE = 2,
+    parameter int MAX_SYNC_CYCLE = 16,
+    parameter int MAX_WAIT_CYCLE = 16,
+    parameter int MAX_NUM_PWR_DETECT = 16
+) (
+    input var logic i_clk,
+    input var logic i_rst,
+
+    // input signals
+    input var real i_pwr,
+    input var real i_wvl_ls,
+    input var real i_wvl_ring,
+
+    // Config Inputs for Search/Lock
+    input var logic [DAC_WIDTH-1:0] i_cfg_ring_tune_start,
+    input var logic [DAC_WIDTH-1:0] i_cfg_ring_tune_end,
+    input var logic [$clog2(DAC_WIDTH)-1:0] i_cfg_ring_tune_stride,
+    input var logic [$clog2(DAC_WIDTH)-1:0] i_cfg_lock_tune_stride,
+    input var logic [$clog2(MAX_SYNC_CYCLE + 1)-1:0] i_cfg_sync_cycle,
+    input var logic i_cfg_sync_cal_en,
+    input var logic [DAC_WIDTH-1:0] i_cfg_sync_cal_step,
+    input var logic [3:0] i_cfg_sync_cal_tol,
+    input var logic [1:0] i_cfg_sync_cal_margin,
+    input var logic [15:0] i_cfg_sync_cal_period,
+    input var logic [3:0] i_cfg_arb_search_weight,
+    input var logic [3:0] i_cfg_arb_lock_weight,
+    input var logic [3:0] i_cfg_arb_lock_max_wait,
+    input var logic [$clog2(LOCK_DELTA_WINDOW_SIZE + 1)-1:0] i_cfg_lock_pwr_delta_thres,
+    input var logic i_cfg_lock_mode,
+    input var logic [$clog2(ADC_WIDTH)-1:0] i_cfg_lock_pi_kp_shift,
+    input var logic [$clog2(ADC_WIDTH)-1:0] i_cfg_lock_pi_ki_shift,
+    input var logic [3:0] i_cfg_ring_pwr_peak_ratio,
+    input var logic [3:0] i_cfg_lock_loss_ratio,
+    input var logic [3:0] i_cfg_lock_loss_cnt,
+    input var logic [DAC_WIDTH-1:0] i_cfg_lock_research_halfwidth,
+
+    input var logic [ADC_WIDTH-1:0] i_cfg_pwr_peak,
+    input var logic [DAC_WIDTH-1:0] i_cfg_ring_tune_peak,
+
+    // Power Detect Config per requesting PHY
+    input var logic i_cfg_search_detect_mode,
+    input var logic [$clog2(MAX_WAIT_CYCLE + 1)-1:0] i_cfg_search_detect_wait_cycle,
+    input var logic [$clog2($clog2(MAX_NUM_PWR_DETECT) + 1)-1:0] i_cfg_search_detect_avg_shift,
+    input var logic [3:0] i_cfg_search_detect_settle_tol,
+    input var logic i_cfg_lock_detect_mode,
+    input var logic [$clog2(MAX_WAIT_CYCLE + 1)-1:0] i_cfg_lock_detect_wait_cycle,
+    input var logic [$clog2($clog2(MAX_NUM_PWR_DETECT) + 1)-1:0] i_cfg_lock_detect_avg_shift,
+    input var logic [3:0] i_cfg_lock_detect_settle_tol,
+
+    // Search Interface
+    input var logic i_search_trig_val,
+    output var logic o_search_trig_rdy,
+    input var logic i_search_done_rdy,
+    output var logic o_search_done_val,
+    output var logic [DAC_WIDTH-1:0] o_pwr_peak_tune_codes[NUM_TARGET],
+    output var logic [ADC_WIDTH-1:0] o_pwr_peak_codes[NUM_TARGET],
+    output var logic [$clog2(NUM_TARGET):0] o_num_peaks,
+
+    // Lock Interface
+    input var  logic i_lock_trig_val,
+    output var logic o_lock_trig_rdy,
+    input var  logic i_lock_intr_rdy,
+    output var logic o_lock_intr_val,
+    input var  logic i_lock_resume_val,
+    output var logic o_lock_resume_rdy,
+
+    // AFE nonideality injection (lib/cpp/models/afe_noise.hpp), drop path
+    input var real i_pd_noise,
+    input var real i_adc_offset,
+    input var real i_adc_inl[2**ADC_WIDTH],
+    input var real i_dac_inl[2**DAC_WIDTH],
+
+    // Heater thermal time constant in cycles (0 is instantaneous)
+    input var real i_heater_tau,
+
+    // output signals
+    output real o_pwr_thru,
+    output real o_pwr_drop,
+    output logic [DAC_WIDTH-1:0] o_ring_tune,
+    output tuner_phy_search_state_e o_search_state,
+    output tuner_phy_lock_state_e o_lock_state,
+    output logic o_search_err,
+    output logic o_lock_err,
+    output logic [$clog2(MAX_SYNC_CYCLE + 1)-1:0] o_sync_cal_cycle,
+    output logic o_arb_lock_req,
+    output tuner_ctrl_ch_e o_arb_grant,
+    output logic [ADC_WIDTH-1:0] o_adc_thru,
+    output logic [ADC_WIDTH-1:0] o_adc_drop
+);
+  import wdm_pkg::*;
+  import tuner_phy_pkg::*;
+
+  `DECLARE_WAVES_TYPE(1)
+
+  // ----------------------------------------------------------------------
+  // Interfaces
+  // ----------------------------------------------------------------------
+  tuner_search_if #(
+      .DAC_WIDTH (DAC_WIDTH),
+      .ADC_WIDTH (ADC_WIDTH),
+      .NUM_TARGET(NUM_TARGET)
+  ) search_if ();
+  tuner_lock_if #(
+      .DAC_WIDTH (DAC_WIDTH),
+      .ADC_WIDTH (ADC_WIDTH),
+      .NUM_TARGET(NUM_TARGET)
+  ) lock_if ();
+  // ----------------------------------------------------------------------
+
+
+  // ----------------------------------------------------------------------
+  // Signals
+  // ----------------------------------------------------------------------
+  WAVES_TYPE waves_in;
+  WAVES_TYPE waves_thru;
+  WAVES_TYPE waves_drop;
+  real wvls[WAVES_WIDTH];
+  real pwrs[WAVES_WIDTH];
+
+  real ana_tune;
+  real heater_drive[1];
+  real heater_tune[1];
+
+  logic [ADC_WIDTH-1:0] adc_thru;
+  logic [ADC_WIDTH-1:0] adc_drop;
+
+  always_comb begin
+    for (int i = 0; i < WAVES_WIDTH; i++) begin
+      wvls[i] = i_wvl_ls;
+      pwrs[i] = i_pwr;
+    end
+  end
+  // ----------------------------------------------------------------------
+
+  // ----------------------------------------------------------------------
+  // Instances
+  // ----------------------------------------------------------------------
+  laser #(
+      .waves_t  (WAVES_TYPE),
+      .NUM_WAVES(WAVES_WIDTH)
+  ) laser (
+      .i_real_pwr  (pwrs),
+      .i_real_wvl  (wvls),
+      .o_phot_waves(waves_in)
+  );
+
+  microring #(
+      .waves_t(WAVES_TYPE),
+      .FWHM(1.0),
+      .TuningFullScale(10.0)
+  ) microring (
+      .i_phot_waves(waves_in),
+      .i_real_wvl_ring(i_wvl_ring),
+      .i_real_tuning_dist(heater_tune[0]),
+      .i_real_temperature(0.0),
+      .i_real_fwhm_scale (1.0),
+      .i_real_tune_scale (1.0),
+      .o_phot_waves_drop(waves_drop),
+      .o_phot_waves_thru(waves_thru)
+  );
+
+  dac #(
+      .DAC_WIDTH(DAC_WIDTH),
+      .FullScaleRange(1.0)
+  ) dac_tune (
+      .i_dig(o_ring_tune),
+      .i_real_inl(i_dac_inl),
+      .o_ana(ana_tune)
+  );
+
+  always_comb heater_drive[0] = ana_tune;
+
+  heater #(
+      .NUM_CHANNEL(1)
+  ) heater_tune_inst (
+      .i_clk(i_clk),
+      .i_rst(i_rst),
+      .i_real_tau_cycles(i_heater_tau),
+      .i_real_coupling(0.0),
+      .i_real_drive(heater_drive),
+      .o_real_tuning_dist(heater_tune)
+  );
+
+  photodetector #(
+      .waves_t(WAVES_TYPE)
+  ) pd_drop (
+      .i_phot_waves  (waves_drop),
+      .i_real_noise  (i_pd_noise),
+      .o_real_current(o_pwr_drop)
+  );
+
+  photodetector #(
+      .waves_t(WAVES_TYPE)
+  ) pd_thru (
+      .i_phot_waves  (waves_thru),
+      .i_real_noise  (0.0),
+      .o_real_current(o_pwr_thru)
+  );
+
+  adc #(
+      .ADC_WIDTH(ADC_WIDTH),
+      .FullScaleRange(1.0)
+  ) adc_thru_inst (
+      .i_ana(o_pwr_thru),
+      .i_real_offset(0.0),
+      .i_real_inl('{default: 0.0}),
+      .o_dig(adc_thru)
+  );
+
+  adc #(
+      .ADC_WIDTH(ADC_WIDTH),
+      .FullScaleRange(1.0)
+  ) adc_drop_inst (
+      .i_ana(o_pwr_drop),
+      .i_real_offset(i_adc_offset),
+      .i_real_inl(i_adc_inl),
+      .o_dig(adc_drop)
+  );
+
+  tuner_phy #(
+      .DAC_WIDTH(DAC_WIDTH),
+      .ADC_WIDTH(ADC_WIDTH),
+      .NUM_TARGET(NUM_TARGET),
+      .SEARCH_PEAK_WINDOW_HALFSIZE(4),
+      .SEARCH_PEAK_THRES(2),
+      .LOCK_DELTA_WINDOW_SIZE(LOCK_DELTA_WINDOW_SIZE),
+      .MAX_SYNC_CYCLE(MAX_SYNC_CYCLE),
+      .MAX_WAIT_CYCLE(MAX_WAIT_CYCLE),
+      .MAX_NUM_PWR_DETECT(MAX_NUM_PWR_DETECT)
+  ) tuner_phy_inst (
+      .i_clk(i_clk),
+      .i_rst(i_rst),
+      .i_dig_ring_pwr(adc_drop),
+      .i_cfg_ring_tune_start(i_cfg_ring_tune_start),
+      .i_cfg_ring_tune_end(i_cfg_ring_tune_end),
+      .i_cfg_ring_tune_stride(i_cfg_ring_tune_stride),
+      .i_cfg_search_fit_mode(1'b0),
+      .i_cfg_lock_tune_stride(i_cfg_lock_tune_stride),
+      .i_cfg_sync_cycle(i_cfg_sync_cycle),
+      .i_cfg_sync_cal_en(i_cfg_sync_cal_en),
+      .i_cfg_sync_cal_step(i_cfg_sync_cal_step),
+      .i_cfg_sync_cal_tol(i_cfg_sync_cal_tol),
+      .i_cfg_sync_cal_margin(i_cfg_sync_cal_margin),
+      .i_cfg_sync_cal_period(i_cfg_sync_cal_period),
+      .i_cfg_arb_search_weight(i_cfg_arb_search_weight),
+      .i_cfg_arb_lock_weight(i_cfg_arb_lock_weight),
+      .i_cfg_arb_lock_max_wait(i_cfg_arb_lock_max_wait),
+      .i_cfg_lock_pwr_delta_thres(i_cfg_lock_pwr_delta_thres),
+      .i_cfg_lock_mode(i_cfg_lock_mode),
+      .i_cfg_lock_pi_kp_shift(i_cfg_lock_pi_kp_shift),
+      .i_cfg_lock_pi_ki_shift(i_cfg_lock_pi_ki_shift),
+      .i_cfg_ring_pwr_peak_ratio(i_cfg_ring_pwr_peak_ratio),
+      .i_cfg_lock_loss_ratio(i_cfg_lock_loss_ratio),
+      .i_cfg_lock_loss_cnt(i_cfg_lock_loss_cnt),
+      .i_cfg_lock_research_halfwidth(i_cfg_lock_research_halfwidth),
+      .i_cfg_pwr_peak(i_cfg_pwr_peak),
+      .i_cfg_ring_tune_peak(i_cfg_ring_tune_peak),
+      .i_cfg_search_detect_mode(i_cfg_search_detect_mode),
+      .i_cfg_search_detect_wait_cycle(i_cfg_search_detect_wait_cycle),
+      .i_cfg_search_detect_avg_shift(i_cfg_search_detect_avg_shift),
+      .i_cfg_search_detect_settle_tol(i_cfg_search_detect_settle_tol),
+      .i_cfg_lock_detect_mode(i_cfg_lock_detect_mode),
+      .i_cfg_lock_detect_wait_cycle(i_cfg_lock_detect_wait_cycle),
+      .i_cfg_lock_detect_avg_shift(i_cfg_lock_detect_avg_shift),
+      .i_cfg_lock_detect_settle_tol(i_cfg_lock_detect_settle_tol),
+      .search_if(search_if.producer),
+      .lock_if(lock_if.producer),
+      .o_dig_ring_tune(o_ring_tune),
+      .o_dig_search_state_mon(o_search_state),
+      .o_dig_lock_state_mon(o_lock_state),
+      .o_dig_search_err(o_search_err),
+      .o_dig_lock_err(o_lock_err),
+      .o_dig_sync_cal_cycle(o_sync_cal_cycle),
+      .o_dig_arb_lock_req(o_arb_lock_req),
+      .o_dig_arb_grant(o_arb_grant)
+  );
+  // ----------------------------------------------------------------------
+
+  // ----------------------------------------------------------------------
+  // Search Interface Logic
+  // ----------------------------------------------------------------------
+  assign search_if.trig_val = i_search_trig_val;
+  assign o_search_trig_rdy = search_if.trig_rdy;
+  assign search_if.peaks_rdy = i_search_done_rdy;
+  assign o_search_done_val = search_if.peaks_val;
+  assign o_pwr_peak_tune_codes = search_if.ring_tune_peaks;
+  assign o_pwr_peak_codes = search_if.pwr_peaks;
+  assign o_num_peaks = search_if.peaks_cnt;
+  // ----------------------------------------------------------------------
+
+  // ----------------------------------------------------------------------
+  // Lock Interface Logic
+  // ----------------------------------------------------------------------
+  assign lock_if.trig_val = i_lock_trig_val;
+  assign o_lock_trig_rdy = lock_if.trig_rdy;
+  assign o_lock_intr_val = lock_if.intr_val;
+  assign lock_if.intr_rdy = i_lock_intr_rdy;
+  assign lock_if.resume_val = i_lock_resume_val;
+  assign o_lock_resume_rdy = lock_if.resume_rdy;
+  // ----------------------------------------------------------------------
+
+  assign o_adc_thru = adc_thru;
+  assign o_adc_drop = adc_drop;
+
+endmodule
+
+`default_nettype wire
@@ -0,0 +1,273 @@
+#include "Vdut.h"
+#include "models/afe_noise.hpp"
+#include "models/ctrl_arb_qos.hpp"
+#include "testbench/verilator_tb.hpp"
+#include "utils/options.hpp"
+#include "utils/sweep.hpp"
+#include <csv2/writer.hpp>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Lock update latency through tuner_ctrl_arb_if: from the cycle lock raises
+// its tune request (o_arb_lock_req) to the cycle the arbiter grants CH_LOCK,
+// also counted in transactions granted to other channels meanwhile
+class ArbQosMonitor {
+public:
+  typedef struct {
+    uint64_t cycle;
+    int latency_cycles;
+    int wait_grants;
+    bool contended;
+  } lock_grant_record_t;
+
+  struct stats_t {
+    uint64_t grants = 0;
+    uint64_t latency_sum = 0;
+    int latency_max = 0;
+    int wait_grants_max = 0;
+
+    double latency_mean() const {
+      return grants ? static_cast<double>(latency_sum) / grants : 0.0;
+    }
+  };
+
+  explicit ArbQosMonitor(Vdut *dut) : dut_(dut) {}
+
+  // Once per cycle, after the clock edge; contended tags the grants taken
+  // while a background search is running
+  void sample(uint64_t cycle, bool contended) {
+    const int grant = dut_->o_arb_grant;
+    if (dut_->o_arb_lock_req && !pending_) {
+      pending_ = true;
+      req_cycle_ = cycle;
+      wait_grants_ = 0;
+    }
+    if (!pending_)
+      return;
+    if (grant == ctrl_arb_qos::CH_LOCK) {
+      lock_grant_record_t r;
+      r.cycle = cycle;
+      r.latency_cycles = static_cast<int>(cycle - req_cycle_);
+      r.wait_grants = wait_grants_;
+      r.contended = contended;
+      records_.push_back(r);
+      auto &s = contended ? contended_ : baseline_;
+      s.grants++;
+      s.latency_sum += r.latency_cycles;
+      s.latency_max = std::max(s.latency_max, r.latency_cycles);
+      s.wait_grants_max = std::max(s.wait_grants_max, r.wait_grants);
+      pending_ = false;
+    } else if (grant != ctrl_arb_qos::CH_NULL) {
+      wait_grants_++;
+    }
+  }
+
+  void write_csv(const std::string &filename) const {
+    std::ofstream ofs(filename);
+    csv2::Writer<csv2::delimiter<','>> writer(ofs);
+
+    writer.write_row(csv_row_t{"cycle", "latency_cycles", "wait_grants",
+                               "contended"});
+    for (auto &r : records_) {
+      writer.write_row(csv_row_t{
+          std::to_string(r.cycle), std::to_string(r.latency_cycles),
+          std::to_string(r.wait_grants), std::to_string(r.contended)});
+    }
+    ofs.close();
+  }
+
+  const stats_t &baseline() const { return baseline_; }
+  const stats_t &contended() const { return contended_; }
+
+private:
+  Vdut *dut_;
+  bool pending_ = false;
+  uint64_t req_cycle_ = 0;
+  int wait_grants_ = 0;
+  std::vector<lock_grant_record_t> records_;
+  stats_t baseline_;
+  stats_t contended_;
+};
+
+int main(int argc, char **argv) {
+  options::Options opts(argc, argv);
+  // tuner_ctrl_arb_if QoS: all zero is the legacy search-first priority
+  const int kArbSearchWeight = opts.get<int>("arb_search_weight", 0);
+  const int kArbLockWeight = opts.get<int>("arb_lock_weight", 0);
+  const int kArbLockMaxWait = opts.get<int>("arb_lock_max_wait", 0);
+  // Background searches over [search_start, search_end] while locked
+  const int kNumSearch = opts.get<int>("num_search", 4);
+  const int kSearchStart = opts.get<int>("search_start", 0);
+  const int kSearchEnd = opts.get<int>("search_end", 255);
+  const int kSearchStride = opts.get<int>("search_stride", 1);
+  const int kLockSettleCycles = opts.get<int>("lock_settle_cycles", 1000);
+  const int kMaxSearchCycles = opts.get<int>("max_search_cycles", 1000000);
+  const int kLockTuneStride = opts.get<int>("lock_tune_stride", 1);
+  const int kLockPwrDeltaThres = opts.get<int>("lock_pwr_delta_thres", 2);
+  const int kSyncCycle = opts.get<int>("sync_cycle", 4);
+  // 0: LOCK_MODE_SLOPE, 1: LOCK_MODE_PI
+  const int kLockMode = opts.get<int>("lock_mode", 0);
+  const int kLockPiKpShift = opts.get<int>("lock_pi_kp_shift", 4);
+  const int kLockPiKiShift = opts.get<int>("lock_pi_ki_shift", 3);
+  const double kWvlRing = opts.get<double>("wvl_ring", 1295.0);
+  const int kSearchDetectMode = opts.get<int>("search_detect_mode", 0);
+  const int kSearchDetectWaitCycle =
+      opts.get<int>("search_detect_wait_cycle", 4);
+  const int kSearchDetectAvgShift = opts.get<int>("search_detect_avg_shift", 0);
+  const int kSearchDetectSettleTol =
+      opts.get<int>("search_detect_settle_tol", 0);
+  const int kLockDetectMode = opts.get<int>("lock_detect_mode", 0);
+  const int kLockDetectWaitCycle = opts.get<int>("lock_detect_wait_cycle", 4);
+  const int kLockDetectAvgShift = opts.get<int>("lock_detect_avg_shift", 0);
+  const int kLockDetectSettleTol = opts.get<int>("lock_detect_settle_tol", 0);
+  opts.check_unused();
+  opts.write_effective("tb_config.toml");
+  VerilatorTb<Vdut> tb(argc, argv);
+  auto *dut = tb.dut();
+
+  ArbQosMonitor monitor(dut);
+  afe_noise::AfeNoise<8, 8> afe(afe_noise::AfeNoiseConfig{}, 0);
+
+  ctrl_arb_qos::QosArbiter arb;
+  arb.set_weight(ctrl_arb_qos::CH_SEARCH, kArbSearchWeight);
+  arb.set_weight(ctrl_arb_qos::CH_LOCK, kArbLockWeight);
+  arb.set_lock_max_wait(kArbLockMaxWait);
+
+  uint64_t cycle = 0;
+  bool contended = false;
+  uint64_t lock_lost_cycles = 0;
+  auto advance_clk = [&]() {
+    tb.step_clk(dut->i_clk);
+    ++cycle;
+    monitor.sample(cycle, contended);
+    if (contended && dut->o_lock_state != 2 /*ACTIVE*/)
+      ++lock_lost_cycles;
+  };
+
+  // Returns the cycles from trigger to DONE, or -1 on timeout
+  auto search_routine = [&](int start, int end, int stride) -> int {
+    dut->i_cfg_ring_tune_start = start;
+    dut->i_cfg_ring_tune_end = end;
+    dut->i_cfg_ring_tune_stride = stride;
+    dut->i_search_trig_val = 1;
+    advance_clk();
+    dut->i_search_trig_val = 0;
+    int cycles = 1;
+    while (dut->o_search_state != 3 /*DONE*/ && cycles < kMaxSearchCycles) {
+      advance_clk();
+      ++cycles;
+    }
+    dut->i_search_done_rdy = 1;
+    advance_clk();
+    dut->i_search_done_rdy = 0;
+    return cycles < kMaxSearchCycles ? cycles : -1;
+  };
+
+  dut->i_pwr = 1.0;
+  dut->i_wvl_ls = 1300.0;
+  dut->i_wvl_ring = kWvlRing;
+  dut->i_search_trig_val = 0;
+  dut->i_search_done_rdy = 0;
+  dut->i_lock_trig_val = 0;
+  dut->i_lock_intr_rdy = 1;
+  dut->i_lock_resume_val = 0;
+  dut->i_cfg_ring_pwr_peak_ratio = 8;
+  dut->i_cfg_lock_tune_stride = kLockTuneStride;
+  dut->i_cfg_lock_pwr_delta_thres = kLockPwrDeltaThres;
+  dut->i_cfg_sync_cycle = kSyncCycle;
+  dut->i_cfg_sync_cal_en = 0;
+  dut->i_cfg_arb_search_weight = kArbSearchWeight;
+  dut->i_cfg_arb_lock_weight = kArbLockWeight;
+  dut->i_cfg_arb_lock_max_wait = kArbLockMaxWait;
+  dut->i_cfg_lock_mode = kLockMode;
+  dut->i_cfg_lock_pi_kp_shift = kLockPiKpShift;
+  dut->i_cfg_lock_pi_ki_shift = kLockPiKiShift;
+  dut->i_cfg_lock_loss_ratio = 0; // no lock-loss re-search
+  dut->i_cfg_lock_loss_cnt = 0;
+  dut->i_cfg_lock_research_halfwidth = 0;
+  dut->i_cfg_search_detect_mode = kSearchDetectMode;
+  dut->i_cfg_search_detect_wait_cycle = kSearchDetectWaitCycle;
+  dut->i_cfg_search_detect_avg_shift = kSearchDetectAvgShift;
+  dut->i_cfg_search_detect_settle_tol = kSearchDetectSettleTol;
+  dut->i_cfg_lock_detect_mode = kLockDetectMode;
+  dut->i_cfg_lock_detect_wait_cycle = kLockDetectWaitCycle;
+  dut->i_cfg_lock_detect_avg_shift = kLockDetectAvgShift;
+  dut->i_cfg_lock_detect_settle_tol = kLockDetectSettleTol;
+
+  dut->i_pd_noise = 0.0;
+  dut->i_adc_offset = afe.adc.offset_lsb();
+  afe_noise::load_table(dut->i_adc_inl, afe.adc.inl_table());
+  afe_noise::load_table(dut->i_dac_inl, afe.dac.inl_table());
+  dut->i_heater_tau = 0.0;
+
+  dut->i_clk = 0;
+  tb.reset(dut->i_clk, dut->i_rst);
+
+  // Find the resonance, then lock on it from 20 codes below
+  if (search_routine(0, 255, 2) < 0) {
+    std::cerr << "Initial search did not complete" << std::endl;
+    return 1;
+  }
+  const int peak_code = dut->o_pwr_peak_tune_codes[0];
+  dut->i_cfg_ring_tune_start = peak_code - 20;
+  dut->i_cfg_ring_tune_peak = peak_code;
+  dut->i_cfg_pwr_peak = dut->o_pwr_peak_codes[0];
+  dut->i_lock_trig_val = 1;
+  advance_clk();
+  while (dut->o_lock_state != 2 /*ACTIVE*/) {
+    advance_clk();
+  }
+  for (int i = 0; i < kLockSettleCycles; ++i) {
+    advance_clk();
+  }
+
+  // Full-range searches contend with the active lock loop
+  contended = true;
+  int search_cycles_max = 0;
+  for (int n = 0; n < kNumSearch; ++n) {
+    const int cycles = search_routine(kSearchStart, kSearchEnd, kSearchStride);
+    if (cycles < 0) {
+      std::cerr << "Background search " << n << " did not complete"
+                << std::endl;
+      return 1;
+    }
+    search_cycles_max = std::max(search_cycles_max, cycles);
+  }
+  contended = false;
+  for (int i = 0; i < kLockSettleCycles; ++i) {
+    advance_clk();
+  }
+
+  monitor.write_csv("arb_qos_latency.csv");
+
+  const auto &base = monitor.baseline();
+  const auto &cont = monitor.contended();
+  std::cout << "Lock alone: " << base.grants << " grants, latency mean "
+            << base.latency_mean() << " max " << base.latency_max
+            << " cycles" << std::endl;
+  std::cout << "Lock with search: " << cont.grants << " grants, latency mean "
+            << cont.latency_mean() << " max " << cont.latency_max
+            << " cycles, max " << cont.wait_grants_max
+            << " search transactions ahead" << std::endl;
+  std::cout << "Search: " << search_cycles_max << " cycles max over "
+            << kNumSearch << " runs" << std::endl;
+  std::cout << "Lock not ACTIVE for " << lock_lost_cycles
+            << " cycles during search" << std::endl;
+
+  const int bound = arb.lock_wait_bound();
+  if (bound < 0) {
+    std::cout << "Lock wait bound: none (fixed priority)" << std::endl;
+  } else {
+    std::cout << "Lock wait bound: " << bound << " transactions" << std::endl;
+    if (cont.wait_grants_max > bound) {
+      std::cerr << "Lock waited " << cont.wait_grants_max
+                << " transactions, above the bound" << std::endl;
+      return 1;
+    }
+  }
+
+  return 0;
+}
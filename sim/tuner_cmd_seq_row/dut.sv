@@ -0,0 +1,349 @@
+//==============================================================================
+// Author: Sunjin Choi
+// Description: DUT for tuner_cmd_seq_row simulation. Each ring's tuner_phy
+// is driven by a tuner_cmd_seq, so the host only pushes commands and pops
+// completion events.
+//==============================================================================
+
+// verilog_format: off
+`timescale 1ns/1ps
+`default_nettype none
+// verilog_format: on
+
+import wdm_pkg::*;
+import tuner_pkg::tuner_cmd_e;
+import tuner_pkg::tuner_state_e;
+import tuner_phy_pkg::*;
+
+module dut #(
+    parameter int DAC_WIDTH    = 8,
+    parameter int ADC_WIDTH    = 8,
+    parameter int NUM_TARGET   = 4,
+    parameter int NUM_WAVES    = 2,
+    parameter int NUM_CHANNEL  = 2,
+    parameter int LOCK_DELTA_WINDOW_SIZE = 2,
+    parameter int MAX_SYNC_CYCLE = 16,
+    parameter int MAX_WAIT_CYCLE = 16,
+    parameter int MAX_NUM_PWR_DETECT = 16,
+    parameter int CMD_DEPTH = 8
+) (
+    input var logic i_clk,
+    input var logic i_rst,
+
+    // input signals
+    input var real i_pwr,
+    input var real i_wvl_ls  [NUM_WAVES],
+    input var real i_wvl_ring[NUM_CHANNEL],
+
+    // Config Inputs for Search/Lock (window and peak come from the sequencer)
+    input var logic [$clog2(DAC_WIDTH)-1:0] i_cfg_lock_tune_stride[NUM_CHANNEL],
+    input var logic [$clog2(MAX_SYNC_CYCLE + 1)-1:0] i_cfg_sync_cycle[NUM_CHANNEL],
+    input var logic [$clog2(LOCK_DELTA_WINDOW_SIZE + 1)-1:0]
+        i_cfg_lock_pwr_delta_thres[NUM_CHANNEL],
+    input var logic i_cfg_lock_mode[NUM_CHANNEL],
+    input var logic [$clog2(ADC_WIDTH)-1:0] i_cfg_lock_pi_kp_shift[NUM_CHANNEL],
+    input var logic [$clog2(ADC_WIDTH)-1:0] i_cfg_lock_pi_ki_shift[NUM_CHANNEL],
+    input var logic [3:0] i_cfg_ring_pwr_peak_ratio[NUM_CHANNEL],
+    input var logic [3:0] i_cfg_lock_loss_ratio[NUM_CHANNEL],
+    input var logic [3:0] i_cfg_lock_loss_cnt[NUM_CHANNEL],
+    input var logic [DAC_WIDTH-1:0] i_cfg_lock_research_halfwidth[NUM_CHANNEL],
+
+    // Power Detect Config per requesting PHY
+    input var logic i_cfg_search_detect_mode[NUM_CHANNEL],
+    input var logic [$clog2(MAX_WAIT_CYCLE + 1)-1:0] i_cfg_search_detect_wait_cycle[NUM_CHANNEL],
+    input var logic [$clog2($clog2(MAX_NUM_PWR_DETECT) + 1)-1:0] i_cfg_search_detect_avg_shift[NUM_CHANNEL],
+    input var logic [3:0] i_cfg_search_detect_settle_tol[NUM_CHANNEL],
+    input var logic i_cfg_lock_detect_mode[NUM_CHANNEL],
+    input var logic [$clog2(MAX_WAIT_CYCLE + 1)-1:0] i_cfg_lock_detect_wait_cycle[NUM_CHANNEL],
+    input var logic [$clog2($clog2(MAX_NUM_PWR_DETECT) + 1)-1:0] i_cfg_lock_detect_avg_shift[NUM_CHANNEL],
+    input var logic [3:0] i_cfg_lock_detect_settle_tol[NUM_CHANNEL],
+
+    // Host command queue
+    input var logic i_cmd_val[NUM_CHANNEL],
+    output var logic o_cmd_rdy[NUM_CHANNEL],
+    input var tuner_cmd_e i_cmd[NUM_CHANNEL],
+    input var logic [DAC_WIDTH-1:0] i_cmd_arg0[NUM_CHANNEL],
+    input var logic [DAC_WIDTH-1:0] i_cmd_arg1[NUM_CHANNEL],
+    input var logic [$clog2(DAC_WIDTH)-1:0] i_cmd_arg2[NUM_CHANNEL],
+
+    // Completion events
+    output var logic o_evt_val[NUM_CHANNEL],
+    input var logic i_evt_rdy[NUM_CHANNEL],
+    output tuner_cmd_e o_evt_cmd[NUM_CHANNEL],
+    output tuner_state_e o_evt_state[NUM_CHANNEL],
+    output logic [DAC_WIDTH-1:0] o_evt_ring_tune[NUM_CHANNEL],
+    output logic [ADC_WIDTH-1:0] o_evt_pwr[NUM_CHANNEL],
+    output logic [$clog2(NUM_TARGET)-1:0] o_evt_peaks_cnt[NUM_CHANNEL],
+    output logic [31:0] o_evt_cycle_cnt[NUM_CHANNEL],
+
+    // AFE nonideality injection (lib/cpp/models/afe_noise.hpp), drop path
+    input var real i_pd_noise[NUM_CHANNEL],
+    input var real i_adc_offset[NUM_CHANNEL],
+    input var real i_adc_inl[NUM_CHANNEL][2**ADC_WIDTH],
+    input var real i_dac_inl[NUM_CHANNEL][2**DAC_WIDTH],
+
+    // output signals
+    output real o_pwr_thru,
+    output real o_pwr_drop[NUM_CHANNEL],
+    output logic [DAC_WIDTH-1:0] o_ring_tune[NUM_CHANNEL],
+    output tuner_phy_search_state_e o_search_state[NUM_CHANNEL],
+    output tuner_phy_lock_state_e o_lock_state[NUM_CHANNEL],
+    output logic o_search_err[NUM_CHANNEL],
+    output logic o_lock_err[NUM_CHANNEL],
+    output tuner_state_e o_seq_state[NUM_CHANNEL],
+    output tuner_phy_seq_state_e o_seq_state_mon[NUM_CHANNEL],
+    output logic o_locked[NUM_CHANNEL],
+    output logic [ADC_WIDTH-1:0] o_adc_thru,
+    output logic [ADC_WIDTH-1:0] o_adc_drop[NUM_CHANNEL]
+);
+
+  typedef struct {
+    wave_t wave_bundle[NUM_WAVES-1:0];
+  } WAVES_TYPE;
+  localparam int WAVES_WIDTH = NUM_WAVES;
+
+  // ----------------------------------------------------------------------
+  // Interfaces
+  // ----------------------------------------------------------------------
+  tuner_search_if #(
+      .DAC_WIDTH (DAC_WIDTH),
+      .ADC_WIDTH (ADC_WIDTH),
+      .NUM_TARGET(NUM_TARGET)
+  ) search_if[NUM_CHANNEL] (
+      .i_clk(i_clk),
+      .i_rst(i_rst)
+  );
+  tuner_lock_if #(
+      .DAC_WIDTH (DAC_WIDTH),
+      .ADC_WIDTH (ADC_WIDTH),
+      .NUM_TARGET(NUM_TARGET)
+  ) lock_if[NUM_CHANNEL] (
+      .*
+  );
+  tuner_ctrl_arb_if #(
+      .DAC_WIDTH(DAC_WIDTH),
+      .ADC_WIDTH(ADC_WIDTH)
+  ) ctrl_arb_if[NUM_CHANNEL] (
+      .*
+  );
+  tuner_pwr_detect_if #(
+      .ADC_WIDTH(ADC_WIDTH)
+  ) pwr_detect_if[NUM_CHANNEL] (
+      .i_clk(i_clk),
+      .i_rst(i_rst)
+  );
+  // ----------------------------------------------------------------------
+
+  // ----------------------------------------------------------------------
+  // Signals
+  // ----------------------------------------------------------------------
+  WAVES_TYPE waves_in;
+  WAVES_TYPE waves_thru;
+  WAVES_TYPE waves_drop[NUM_CHANNEL];
+  real wvls[WAVES_WIDTH];
+  real pwrs[WAVES_WIDTH];
+
+  real ana_tune[NUM_CHANNEL];
+  real real_tuning_dist[NUM_CHANNEL];
+  logic [DAC_WIDTH-1:0] ring_tune_dig[NUM_CHANNEL];
+  logic [ADC_WIDTH-1:0] adc_thru;
+  logic [ADC_WIDTH-1:0] adc_drop[NUM_CHANNEL];
+
+  logic [DAC_WIDTH-1:0] cfg_ring_tune_start[NUM_CHANNEL];
+  logic [DAC_WIDTH-1:0] cfg_ring_tune_end[NUM_CHANNEL];
+  logic [$clog2(DAC_WIDTH)-1:0] cfg_ring_tune_stride[NUM_CHANNEL];
+  logic [ADC_WIDTH-1:0] cfg_pwr_peak[NUM_CHANNEL];
+  logic [DAC_WIDTH-1:0] cfg_ring_tune_peak[NUM_CHANNEL];
+
+  always_comb begin
+    for (int i = 0; i < WAVES_WIDTH; i++) begin
+      wvls[i] = i_wvl_ls[i];
+      pwrs[i] = i_pwr;
+    end
+    for (int j = 0; j < NUM_CHANNEL; j++) begin
+      real_tuning_dist[j] = ana_tune[j];
+    end
+  end
+  // ----------------------------------------------------------------------
+
+  // ----------------------------------------------------------------------
+  // Instances
+  // ----------------------------------------------------------------------
+  laser #(
+      .waves_t  (WAVES_TYPE),
+      .NUM_WAVES(WAVES_WIDTH)
+  ) laser (
+      .i_real_pwr  (pwrs),
+      .i_real_wvl  (wvls),
+      .o_phot_waves(waves_in)
+  );
+
+  microringrow #(
+      .waves_t        (WAVES_TYPE),
+      .NUM_CHANNEL    (NUM_CHANNEL),
+      .FWHM           (0.25),
+      .TuningFullScale(10.0)
+  ) microringrow (
+      .i_phot_waves      (waves_in),
+      .i_real_wvl_ring   (i_wvl_ring),
+      .i_real_tuning_dist(real_tuning_dist),
+      .i_real_temperature('{default: 0.0}),
+      .i_real_fwhm_scale ('{default: 1.0}),
+      .i_real_tune_scale ('{default: 1.0}),
+      .o_phot_waves_drop (waves_drop),
+      .o_phot_waves_thru (waves_thru)
+  );
+
+  generate
+    for (genvar ch = 0; ch < NUM_CHANNEL; ch++) begin : g_ring_hw
+      dac #(
+          .DAC_WIDTH(DAC_WIDTH),
+          .FullScaleRange(1.0)
+      ) dac_tune (
+          .i_dig(ring_tune_dig[ch]),
+          .i_real_inl(i_dac_inl[ch]),
+          .o_ana(ana_tune[ch])
+      );
+
+      photodetector #(
+          .waves_t(WAVES_TYPE)
+      ) pd_drop (
+          .i_phot_waves  (waves_drop[ch]),
+          .i_real_noise  (i_pd_noise[ch]),
+          .o_real_current(o_pwr_drop[ch])
+      );
+
+      adc #(
+          .ADC_WIDTH(ADC_WIDTH),
+          .FullScaleRange(1000.0)
+      ) adc_drop_inst (
+          .i_ana(o_pwr_drop[ch]),
+          .i_real_offset(i_adc_offset[ch]),
+          .i_real_inl(i_adc_inl[ch]),
+          .o_dig(adc_drop[ch])
+      );
+
+      tuner_phy #(
+          .DAC_WIDTH(DAC_WIDTH),
+          .ADC_WIDTH(ADC_WIDTH),
+          .NUM_TARGET(NUM_TARGET),
+          .SEARCH_PEAK_WINDOW_HALFSIZE(4),
+          .SEARCH_PEAK_THRES(2),
+          .LOCK_DELTA_WINDOW_SIZE(LOCK_DELTA_WINDOW_SIZE),
+          .MAX_SYNC_CYCLE(MAX_SYNC_CYCLE),
+          .MAX_WAIT_CYCLE(MAX_WAIT_CYCLE),
+          .MAX_NUM_PWR_DETECT(MAX_NUM_PWR_DETECT)
+      ) tuner_phy_inst (
+          .i_clk(i_clk),
+          .i_rst(i_rst),
+          .i_dig_ring_pwr(adc_drop[ch]),
+          .i_cfg_ring_tune_start(cfg_ring_tune_start[ch]),
+          .i_cfg_ring_tune_end(cfg_ring_tune_end[ch]),
+          .i_cfg_ring_tune_stride(cfg_ring_tune_stride[ch]),
+          .i_cfg_search_fit_mode(1'b0),
+          .i_cfg_lock_tune_stride(i_cfg_lock_tune_stride[ch]),
+          .i_cfg_sync_cycle(i_cfg_sync_cycle[ch]),
+          .i_cfg_sync_cal_en(1'b0),
+          .i_cfg_sync_cal_step('0),
+          .i_cfg_sync_cal_tol('0),
+          .i_cfg_sync_cal_margin('0),
+          .i_cfg_sync_cal_period('0),
+          .i_cfg_arb_search_weight('0),
+          .i_cfg_arb_lock_weight('0),
+          .i_cfg_arb_lock_max_wait('0),
+          .i_cfg_lock_pwr_delta_thres(i_cfg_lock_pwr_delta_thres[ch]),
+          .i_cfg_lock_mode(i_cfg_lock_mode[ch]),
+          .i_cfg_lock_pi_kp_shift(i_cfg_lock_pi_kp_shift[ch]),
+          .i_cfg_lock_pi_ki_shift(i_cfg_lock_pi_ki_shift[ch]),
+          .i_cfg_ring_pwr_peak_ratio(i_cfg_ring_pwr_peak_ratio[ch]),
+          .i_cfg_lock_loss_ratio(i_cfg_lock_loss_ratio[ch]),
+          .i_cfg_lock_loss_cnt(i_cfg_lock_loss_cnt[ch]),
+          .i_cfg_lock_research_halfwidth(i_cfg_lock_research_halfwidth[ch]),
+          .i_cfg_pwr_peak(cfg_pwr_peak[ch]),
+          .i_cfg_ring_tune_peak(cfg_ring_tune_peak[ch]),
+          .i_cfg_search_detect_mode(i_cfg_search_detect_mode[ch]),
+          .i_cfg_search_detect_wait_cycle(i_cfg_search_detect_wait_cycle[ch]),
+          .i_cfg_search_detect_avg_shift(i_cfg_search_detect_avg_shift[ch]),
+          .i_cfg_search_detect_settle_tol(i_cfg_search_detect_settle_tol[ch]),
+          .i_cfg_lock_detect_mode(i_cfg_lock_detect_mode[ch]),
+          .i_cfg_lock_detect_wait_cycle(i_cfg_lock_detect_wait_cycle[ch]),
+          .i_cfg_lock_detect_avg_shift(i_cfg_lock_detect_avg_shift[ch]),
+          .i_cfg_lock_detect_settle_tol(i_cfg_lock_detect_settle_tol[ch]),
+          .search_if(search_if[ch].producer),
+          .lock_if(lock_if[ch].producer),
+          .o_dig_ring_tune(ring_tune_dig[ch]),
+          .o_dig_search_state_mon(o_search_state[ch]),
+          .o_dig_lock_state_mon(o_lock_state[ch]),
+          .o_dig_search_err(o_search_err[ch]),
+          .o_dig_lock_err(o_lock_err[ch]),
+          .o_dig_sync_cal_cycle(),
+          .o_dig_arb_lock_req(),
+          .o_dig_arb_grant()
+      );
+
+      tuner_cmd_seq #(
+          .DAC_WIDTH(DAC_WIDTH),
+          .ADC_WIDTH(ADC_WIDTH),
+          .NUM_TARGET(NUM_TARGET),
+          .CMD_DEPTH(CMD_DEPTH)
+      ) tuner_cmd_seq_inst (
+          .i_clk(i_clk),
+          .i_rst(i_rst),
+          .i_cmd_val(i_cmd_val[ch]),
+          .o_cmd_rdy(o_cmd_rdy[ch]),
+          .i_cmd(i_cmd[ch]),
+          .i_cmd_arg0(i_cmd_arg0[ch]),
+          .i_cmd_arg1(i_cmd_arg1[ch]),
+          .i_cmd_arg2(i_cmd_arg2[ch]),
+          .o_evt_val(o_evt_val[ch]),
+          .i_evt_rdy(i_evt_rdy[ch]),
+          .o_evt_cmd(o_evt_cmd[ch]),
+          .o_evt_state(o_evt_state[ch]),
+          .o_evt_ring_tune(o_evt_ring_tune[ch]),
+          .o_evt_pwr(o_evt_pwr[ch]),
+          .o_evt_peaks_cnt(o_evt_peaks_cnt[ch]),
+          .o_evt_cycle_cnt(o_evt_cycle_cnt[ch]),
+          .i_dig_ring_tune(ring_tune_dig[ch]),
+          .i_dig_ring_pwr(adc_drop[ch]),
+          .i_dig_lock_state_mon(o_lock_state[ch]),
+          .i_dig_lock_err(o_lock_err[ch]),
+          .o_cfg_ring_tune_start(cfg_ring_tune_start[ch]),
+          .o_cfg_ring_tune_end(cfg_ring_tune_end[ch]),
+          .o_cfg_ring_tune_stride(cfg_ring_tune_stride[ch]),
+          .o_cfg_pwr_peak(cfg_pwr_peak[ch]),
+          .o_cfg_ring_tune_peak(cfg_ring_tune_peak[ch]),
+          .search_if(search_if[ch].consumer),
+          .lock_if(lock_if[ch].consumer),
+          .o_state(o_seq_state[ch]),
+          .o_seq_state_mon(o_seq_state_mon[ch]),
+          .o_locked(o_locked[ch])
+      );
+
+      assign o_ring_tune[ch]           = ring_tune_dig[ch];
+      assign o_adc_drop[ch]            = adc_drop[ch];
+    end
+  endgenerate
+
+  photodetector #(
+      .waves_t(WAVES_TYPE)
+  ) pd_thru (
+      .i_phot_waves  (waves_thru),
+      .i_real_noise  (0.0),
+      .o_real_current(o_pwr_thru)
+  );
+
+      adc #(
+          .ADC_WIDTH(ADC_WIDTH),
+      .FullScaleRange(1.0)
+  ) adc_thru_inst (
+      .i_ana(o_pwr_thru),
+      .i_real_offset(0.0),
+      .i_real_inl('{default: 0.0}),
+      .o_dig(adc_thru)
+  );
+
+  assign o_adc_thru = adc_thru;
+
+endmodule
+
+`default_nettype wire
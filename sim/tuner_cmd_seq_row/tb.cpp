@@ -0,0 +1,201 @@
+#include "Vsim.h"
+#include "testbench/tuner_cmd_driver.hpp"
+#include "testbench/verilator_tb.hpp"
+#include "utils/options.hpp"
+#include "utils/profiler.hpp"
+#include "utils/sweep.hpp"
+#include <array>
+#include <cassert>
+#include <csv2/writer.hpp>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+class CmdSeqMonitor {
+public:
+  typedef struct {
+    double time;
+    int tune_code;
+    double o_pwr_drop;
+    int search_state_enum;
+    int lock_state_enum;
+    int seq_state_enum;
+  } cmd_seq_record_t;
+
+  CmdSeqMonitor(Vsim *dut, int ring, int interval = 1)
+      : dut_(dut), ring_(ring), sample_interval_(interval) {}
+
+  void sample(vluint64_t time) {
+    static profiler::Phase phase("monitor.sample");
+    profiler::ScopedTimer timer(phase);
+    if ((interval_count_++ % sample_interval_) != 0)
+      return;
+    cmd_seq_record_t r;
+    r.time = static_cast<double>(time);
+    r.tune_code = dut_->o_ring_tune[ring_];
+    r.o_pwr_drop = dut_->o_pwr_drop[ring_];
+    r.search_state_enum = dut_->o_search_state[ring_];
+    r.lock_state_enum = dut_->o_lock_state[ring_];
+    r.seq_state_enum = dut_->o_seq_state_mon[ring_];
+    records_.push_back(r);
+  }
+
+  void write_csv(const std::string &filename) const {
+    std::ofstream ofs(filename);
+    csv2::Writer<csv2::delimiter<','>> writer(ofs);
+
+    writer.write_row(csv_row_t{"time", "tune_code", "o_pwr_drop",
+                               "search_state", "lock_state", "seq_state"});
+    for (auto &r : records_) {
+      writer.write_row(csv_row_t{
+          std::to_string(r.time), std::to_string(r.tune_code),
+          std::to_string(r.o_pwr_drop), std::to_string(r.search_state_enum),
+          std::to_string(r.lock_state_enum), std::to_string(r.seq_state_enum)});
+    }
+    ofs.close();
+  }
+
+private:
+  Vsim *dut_;
+  int ring_;
+  int sample_interval_;
+  int interval_count_ = 0;
+  std::vector<cmd_seq_record_t> records_;
+};
+
+int main(int argc, char **argv) {
+  options::Options opts(argc, argv);
+  constexpr size_t kNumRings = 2;
+  const auto kLockTuneStride =
+      opts.get_array<int, kNumRings>("lock_tune_stride", {0, 0});
+  const auto kLockPwrDeltaThres =
+      opts.get_array<int, kNumRings>("lock_pwr_delta_thres", {2, 2});
+  const auto kSyncCycle = opts.get_array<int, kNumRings>("sync_cycle", {4, 4});
+  // 0: LOCK_MODE_SLOPE, 1: LOCK_MODE_PI
+  const auto kLockMode = opts.get_array<int, kNumRings>("lock_mode", {0, 0});
+  const auto kLockPiKpShift =
+      opts.get_array<int, kNumRings>("lock_pi_kp_shift", {5, 5});
+  const auto kLockPiKiShift =
+      opts.get_array<int, kNumRings>("lock_pi_ki_shift", {5, 5});
+  const auto kLockLossRatio =
+      opts.get_array<int, kNumRings>("lock_loss_ratio", {4, 4});
+  const auto kLockLossCnt =
+      opts.get_array<int, kNumRings>("lock_loss_cnt", {4, 4});
+  const auto kLockResearchHalfwidth =
+      opts.get_array<int, kNumRings>("lock_research_halfwidth", {16, 16});
+  const auto kSearchDetectMode =
+      opts.get_array<int, kNumRings>("search_detect_mode", {0, 0});
+  const auto kSearchDetectWaitCycle =
+      opts.get_array<int, kNumRings>("search_detect_wait_cycle", {4, 4});
+  const auto kSearchDetectAvgShift =
+      opts.get_array<int, kNumRings>("search_detect_avg_shift", {0, 0});
+  const auto kSearchDetectSettleTol =
+      opts.get_array<int, kNumRings>("search_detect_settle_tol", 0);
+  const auto kLockDetectMode =
+      opts.get_array<int, kNumRings>("lock_detect_mode", {0, 0});
+  const auto kLockDetectWaitCycle =
+      opts.get_array<int, kNumRings>("lock_detect_wait_cycle", {4, 4});
+  const auto kLockDetectAvgShift =
+      opts.get_array<int, kNumRings>("lock_detect_avg_shift", {0, 0});
+  const auto kLockDetectSettleTol =
+      opts.get_array<int, kNumRings>("lock_detect_settle_tol", {0, 0});
+  // Command stream per ring
+  const auto kLockOffset =
+      opts.get_array<int, kNumRings>("lock_offset", {-20, 20});
+  const int kLockSettle =
+      opts.get<int>("lock_settle", 160); // x 2^LOCK_SETTLE_SHIFT cycles
+  const uint64_t kMaxCycles = opts.get<uint64_t>("max_cycles", 1000000);
+
+  const auto kWvlRing =
+      opts.get_array<double, kNumRings>("wvl_ring", {1295.0, 1298.0});
+  opts.check_unused();
+  opts.write_effective("tb_config.toml");
+  VerilatorTb<Vsim> tb(argc, argv);
+  auto *dut = tb.dut();
+
+  std::array<CmdSeqMonitor, kNumRings> monitor{CmdSeqMonitor(dut, 0, 8),
+                                               CmdSeqMonitor(dut, 1, 8)};
+
+  auto advance_clk = [&]() {
+    tb.step_clk(dut->i_clk);
+    for (size_t ring = 0; ring < kNumRings; ++ring) {
+      monitor[ring].sample(tb.time_ps());
+    }
+  };
+
+  dut->i_pwr = 1000.0;
+  dut->i_wvl_ls[0] = 1300.0;
+  dut->i_wvl_ls[1] = 1302.0;
+
+  for (size_t i = 0; i < kWvlRing.size(); ++i) {
+    dut->i_wvl_ring[i] = kWvlRing[i];
+  }
+
+  for (size_t r = 0; r < kNumRings; ++r) {
+    dut->i_cfg_ring_pwr_peak_ratio[r] = 8;
+    dut->i_cfg_lock_tune_stride[r] = kLockTuneStride[r];
+    dut->i_cfg_lock_pwr_delta_thres[r] = kLockPwrDeltaThres[r];
+    dut->i_cfg_sync_cycle[r] = kSyncCycle[r];
+    dut->i_cfg_lock_mode[r] = kLockMode[r];
+    dut->i_cfg_lock_pi_kp_shift[r] = kLockPiKpShift[r];
+    dut->i_cfg_lock_pi_ki_shift[r] = kLockPiKiShift[r];
+    dut->i_cfg_lock_loss_ratio[r] = kLockLossRatio[r];
+    dut->i_cfg_lock_loss_cnt[r] = kLockLossCnt[r];
+    dut->i_cfg_lock_research_halfwidth[r] = kLockResearchHalfwidth[r];
+    dut->i_cfg_search_detect_mode[r] = kSearchDetectMode[r];
+    dut->i_cfg_search_detect_wait_cycle[r] = kSearchDetectWaitCycle[r];
+    dut->i_cfg_search_detect_avg_shift[r] = kSearchDetectAvgShift[r];
+    dut->i_cfg_search_detect_settle_tol[r] = kSearchDetectSettleTol[r];
+    dut->i_cfg_lock_detect_mode[r] = kLockDetectMode[r];
+    dut->i_cfg_lock_detect_wait_cycle[r] = kLockDetectWaitCycle[r];
+    dut->i_cfg_lock_detect_avg_shift[r] = kLockDetectAvgShift[r];
+    dut->i_cfg_lock_detect_settle_tol[r] = kLockDetectSettleTol[r];
+    dut->i_pd_noise[r] = 0.0;
+    dut->i_adc_offset[r] = 0.0;
+    for (int k = 0; k < 256; ++k) {
+      dut->i_adc_inl[r][k] = 0.0;
+      dut->i_dac_inl[r][k] = 0.0;
+    }
+  }
+
+  tuner_cmd::TunerCmdDriver<Vsim> driver(dut, kNumRings);
+  driver.init();
+
+  dut->i_clk = 0;
+  tb.reset(dut->i_clk, dut->i_rst);
+
+  // Row bring-up as a single batch: all rings run concurrently
+  tuner_cmd::TunerCmdDriver<Vsim>::batch_t batch(kNumRings);
+  for (size_t r = 0; r < kNumRings; ++r) {
+    batch[r] = {tuner_cmd::Command::init(0, 255, 2),
+                tuner_cmd::Command::search(),
+                tuner_cmd::Command::lock(kLockOffset[r], kLockSettle),
+                tuner_cmd::Command::unlock()};
+  }
+  driver.submit(batch);
+
+  const bool done =
+      driver.run(advance_clk, kMaxCycles, [&](const tuner_cmd::Event &e) {
+        std::cout << "[cycle " << e.cycle << "] Ring " << e.ring << " "
+                  << tuner_cmd::cmd_string(e.cmd) << " "
+                  << tuner_cmd::state_string(e.state)
+                  << " tune=" << e.ring_tune << " pwr=" << e.pwr
+                  << " peaks=" << e.peaks_cnt << " latency=" << e.cycle_cnt
+                  << std::endl;
+      });
+  assert(done && "command batch did not complete");
+
+  int errors = 0;
+  for (const auto &e : driver.events()) {
+    errors += !e.ok();
+  }
+  std::cout << "Batch: " << driver.events().size() << " events, " << errors
+            << " errors, " << driver.cycles() << " cycles" << std::endl;
+
+  for (size_t r = 0; r < kNumRings; ++r) {
+    monitor[r].write_csv("cmd_seq_waveform_ring" + std::to_string(r) +
+                         ".csv");
+  }
+
+  return errors == 0 ? 0 : 1;
+}
@@ -15,7 +15,9 @@
 // verilog_format: on
 
 module dut #(
-    parameter int ADC_WIDTH = 8
+    parameter int ADC_WIDTH = 8,
+    parameter int MAX_WAIT_CYCLE = 16,
+    parameter int MAX_NUM_PWR_DETECT = 16
 ) (
     input var logic i_clk,
     input var logic i_rst,
@@ -25,6 +27,12 @@ module dut #(
     input var real i_wvl_ls,
     input var real i_wvl_ring,
 
+    // power detect config
+    input var logic i_cfg_detect_mode,
+    input var logic [$clog2(MAX_WAIT_CYCLE + 1)-1:0] i_cfg_detect_wait_cycle,
+    input var logic [$clog2($clog2(MAX_NUM_PWR_DETECT) + 1)-1:0] i_cfg_detect_avg_shift,
+    input var logic [3:0] i_cfg_detect_settle_tol,
+
     // output signals
     output real o_pwr_thru,
     output real o_pwr_drop,
@@ -58,7 +66,9 @@ module dut #(
   end
 
   tuner_pwr_detect_if #(
-      .ADC_WIDTH(ADC_WIDTH)
+      .ADC_WIDTH(ADC_WIDTH),
+      .MAX_WAIT_CYCLE(MAX_WAIT_CYCLE),
+      .MAX_NUM_PWR_DETECT(MAX_NUM_PWR_DETECT)
   ) pwr_detect_if (
       .i_clk(i_clk),
       .i_rst(i_rst)
@@ -73,6 +83,10 @@ module dut #(
 
   assign pwr_detect_if.pwr_detect_active = 1'b1;
   assign pwr_detect_if.pwr_detect_refresh = 1'b0;
+  assign pwr_detect_if.cfg_mode = i_cfg_detect_mode;
+  assign pwr_detect_if.cfg_wait_cycle = i_cfg_detect_wait_cycle;
+  assign pwr_detect_if.cfg_avg_shift = i_cfg_detect_avg_shift;
+  assign pwr_detect_if.cfg_settle_tol = i_cfg_detect_settle_tol;
   // ----------------------------------------------------------------------
 
   // ----------------------------------------------------------------------
@@ -97,6 +111,8 @@ module dut #(
       .i_real_wvl_ring(i_wvl_ring),
       .i_real_tuning_dist(0.0),  // No tuning for now
       .i_real_temperature(0.0),  // No temperature sensitivity for now
+      .i_real_fwhm_scale (1.0),
+      .i_real_tune_scale (1.0),
       .o_phot_waves_drop(waves_drop),
       .o_phot_waves_thru(waves_thru)
   );
@@ -105,6 +121,7 @@ module dut #(
       .waves_t(WAVES_TYPE)
   ) pd_drop (
       .i_phot_waves  (waves_drop),
+      .i_real_noise  (0.0),
       .o_real_current(o_pwr_drop)
   );
 
@@ -112,6 +129,7 @@ module dut #(
       .waves_t(WAVES_TYPE)
   ) pd_thru (
       .i_phot_waves  (waves_thru),
+      .i_real_noise  (0.0),
       .o_real_current(o_pwr_thru)
   );
 
@@ -120,6 +138,8 @@ module dut #(
       .FullScaleRange(1.0)
   ) adc_thru (
       .i_ana(o_pwr_thru),
+      .i_real_offset(0.0),
+      .i_real_inl('{default: 0.0}),
       .o_dig(o_adc_thru)
   );
 
@@ -128,10 +148,16 @@ module dut #(
       .FullScaleRange(1.0)
   ) adc_drop (
       .i_ana(o_pwr_drop),
+      .i_real_offset(0.0),
+      .i_real_inl('{default: 0.0}),
       .o_dig(o_adc_drop)
   );
 
-  tuner_pwr_detect_phy pwr_thru_detect (
+  tuner_pwr_detect_phy #(
+      .ADC_WIDTH(ADC_WIDTH),
+      .MAX_WAIT_CYCLE(MAX_WAIT_CYCLE),
+      .MAX_NUM_PWR_DETECT(MAX_NUM_PWR_DETECT)
+  ) pwr_thru_detect (
       .i_clk(i_clk),
       .i_rst(i_rst),
       .i_dig_ring_pwr(o_adc_thru),
@@ -1,11 +1,13 @@
 #include "Vsim.h"
 #include "testbench/verilator_tb.hpp"
+#include "utils/options.hpp"
 #include "utils/sweep.hpp"
 #include <csv2/writer.hpp>
 #include <fstream>
 #include <iostream>
 
 int main(int argc, char **argv) {
+  options::Options opts(argc, argv);
   VerilatorTb<Vsim> tb(argc, argv);
   auto *dut = tb.dut();
 
@@ -16,16 +18,29 @@ int main(int argc, char **argv) {
   const double wvl_end = 1305.0;
   const double wvl_count = 100;
 
+  // Power detect config: 0 = block average, 1 = moving-average stream
+  const int kDetectMode = opts.get<int>("detect_mode", 0);
+  const int kDetectWaitCycle = opts.get<int>("detect_wait_cycle", 4);
+  const int kDetectAvgShift = opts.get<int>("detect_avg_shift", 0);
+  const int kDetectSettleTol = opts.get<int>("detect_settle_tol", 0);
+  opts.check_unused();
+  opts.write_effective("tb_config.toml");
+
   // DUT initialization
   dut->i_pwr = 1.0;
   dut->i_wvl_ls = wvl_start;
   dut->i_wvl_ring = 1300.0;
+  dut->i_cfg_detect_mode = kDetectMode;
+  dut->i_cfg_detect_wait_cycle = kDetectWaitCycle;
+  dut->i_cfg_detect_avg_shift = kDetectAvgShift;
+  dut->i_cfg_detect_settle_tol = kDetectSettleTol;
 
   dut->i_clk = 0; // Clock starts low
   tb.reset(dut->i_clk, dut->i_rst);
 
   // initialize sweep result vector
   csv_t sweep_result;
+  long detect_cycles = 0;
 
   for (const auto pt :
        WavelengthSweep(dut->i_pwr, wvl_start, wvl_end, wvl_count)) {
@@ -36,6 +51,7 @@ int main(int argc, char **argv) {
      *tfp->dump(main_time);*/
     while (!dut->o_dig_pwr_thru_detect_fire) {
       advance_clk();
+      ++detect_cycles;
     }
 
     wvl_tf_t measure = pt;
@@ -50,8 +66,12 @@ int main(int argc, char **argv) {
               << std::endl;
 
     advance_clk();
+    ++detect_cycles;
   }
 
+  std::cout << "[PWR DETECT] Average cycles per detect: "
+            << (double)detect_cycles / wvl_count << std::endl;
+
   std::ofstream stream("sweep.csv");
   csv2::Writer<csv2::delimiter<','>> writer(stream);
 
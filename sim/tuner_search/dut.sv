@@ -22,7 +22,9 @@ module dut #(
     parameter int ADC_WIDTH   = 8,
     parameter int NUM_TARGET  = 4,
     parameter int NUM_WAVES   = 2,
-    parameter int MAX_SYNC_CYCLE = 16
+    parameter int MAX_SYNC_CYCLE = 16,
+    parameter int MAX_WAIT_CYCLE = 16,
+    parameter int MAX_NUM_PWR_DETECT = 16
   ) (
     input var logic i_clk,
     input var logic i_rst,
@@ -32,6 +34,12 @@ module dut #(
     input var real i_wvl_ls  [NUM_WAVES],
     input var real i_wvl_ring,
 
+    // AFE nonideality injection (lib/cpp/models/afe_noise.hpp), drop path
+    input var real i_pd_noise,
+    input var real i_adc_offset,
+    input var real i_adc_inl[2**ADC_WIDTH],
+    input var real i_dac_inl[2**DAC_WIDTH],
+
     // output signals
     output real o_pwr_thru,
     output real o_pwr_drop,
@@ -48,9 +56,14 @@ module dut #(
     input logic i_dig_search_peaks_rdy,
     output logic o_dig_search_peaks_val,
     input logic [$clog2(MAX_SYNC_CYCLE + 1)-1:0] i_cfg_sync_cycle,
+    input logic i_cfg_detect_mode,
+    input logic [$clog2(MAX_WAIT_CYCLE + 1)-1:0] i_cfg_detect_wait_cycle,
+    input logic [$clog2($clog2(MAX_NUM_PWR_DETECT) + 1)-1:0] i_cfg_detect_avg_shift,
+    input logic [3:0] i_cfg_detect_settle_tol,
     input logic [DAC_WIDTH-1:0] i_dig_ring_tune_start,
     input logic [DAC_WIDTH-1:0] i_dig_ring_tune_end,
     input logic [DAC_WIDTH-1:0] i_dig_ring_tune_stride,
+    input logic i_dig_search_fit_mode,
 
     // peak detect signal and collected tuner codes for codes
     output logic [DAC_WIDTH-1:0] o_dig_ring_tune_peaks[NUM_TARGET],
@@ -101,7 +114,9 @@ module dut #(
   /*assign o_dig_pwr_drop_detect_val = pwr_detect_val;*/
 
   tuner_pwr_detect_if #(
-      .ADC_WIDTH(ADC_WIDTH)
+      .ADC_WIDTH(ADC_WIDTH),
+      .MAX_WAIT_CYCLE(MAX_WAIT_CYCLE),
+      .MAX_NUM_PWR_DETECT(MAX_NUM_PWR_DETECT)
   ) pwr_detect_if (
       .i_clk(i_clk),
       .i_rst(i_rst)
@@ -142,6 +157,10 @@ module dut #(
       .*
   );
 
+  // Search is the only client: fixed priority
+  assign ctrl_arb_if.cfg_weight = '{default: '0};
+  assign ctrl_arb_if.cfg_lock_max_wait = '0;
+
   tuner_txn_if #(
       .DAC_WIDTH(DAC_WIDTH),
       .ADC_WIDTH(ADC_WIDTH)
@@ -149,6 +168,18 @@ module dut #(
       .i_clk(i_clk),
       .i_rst(i_rst)
   );
+
+  // No local search requester in this bench
+  tuner_local_search_if #(
+      .DAC_WIDTH(DAC_WIDTH),
+      .ADC_WIDTH(ADC_WIDTH)
+  ) local_search_if (
+      .i_clk(i_clk),
+      .i_rst(i_rst)
+  );
+  assign local_search_if.trig_val = 1'b0;
+  assign local_search_if.ring_tune_start = '0;
+  assign local_search_if.ring_tune_end = '0;
   // ----------------------------------------------------------------------
 
   // ----------------------------------------------------------------------
@@ -173,6 +204,8 @@ module dut #(
       .i_real_wvl_ring(i_wvl_ring),
       .i_real_tuning_dist(ana_tune),  // No tuning for now
       .i_real_temperature(0.0),  // No temperature sensitivity for now
+      .i_real_fwhm_scale (1.0),
+      .i_real_tune_scale (1.0),
       .o_phot_waves_drop(waves_drop),
       .o_phot_waves_thru(waves_thru)
   );
@@ -182,6 +215,7 @@ module dut #(
       .FullScaleRange(1.0)
   ) dac_tune_afe (
       .i_dig(dac_tune),
+      .i_real_inl(i_dac_inl),
       .o_ana(ana_tune)
   );
 
@@ -189,6 +223,7 @@ module dut #(
       .waves_t(WAVES_TYPE)
   ) pd_drop (
       .i_phot_waves  (waves_drop),
+      .i_real_noise  (i_pd_noise),
       .o_real_current(o_pwr_drop)
   );
 
@@ -196,6 +231,7 @@ module dut #(
       .waves_t(WAVES_TYPE)
   ) pd_thru (
       .i_phot_waves  (waves_thru),
+      .i_real_noise  (0.0),
       .o_real_current(o_pwr_thru)
   );
 
@@ -204,6 +240,8 @@ module dut #(
       .FullScaleRange(1.0)
   ) adc_thru (
       .i_ana(o_pwr_thru),
+      .i_real_offset(0.0),
+      .i_real_inl('{default: 0.0}),
       .o_dig(o_adc_thru)
   );
 
@@ -212,10 +250,16 @@ module dut #(
       .FullScaleRange(1.0)
   ) adc_drop (
       .i_ana(o_pwr_drop),
+      .i_real_offset(i_adc_offset),
+      .i_real_inl(i_adc_inl),
       .o_dig(o_adc_drop)
   );
 
-  tuner_pwr_detect_phy pwr_drop_detect (
+  tuner_pwr_detect_phy #(
+      .ADC_WIDTH(ADC_WIDTH),
+      .MAX_WAIT_CYCLE(MAX_WAIT_CYCLE),
+      .MAX_NUM_PWR_DETECT(MAX_NUM_PWR_DETECT)
+  ) pwr_drop_detect (
       .i_clk(i_clk),
       .i_rst(i_rst),
       .i_dig_ring_pwr(o_adc_drop),
@@ -223,11 +267,28 @@ module dut #(
   );
 
   tuner_ctrl_arb_phy #(
-      .MAX_SYNC_CYCLE(MAX_SYNC_CYCLE)
+      .MAX_SYNC_CYCLE(MAX_SYNC_CYCLE),
+      .MAX_WAIT_CYCLE(MAX_WAIT_CYCLE),
+      .MAX_NUM_PWR_DETECT(MAX_NUM_PWR_DETECT)
   ) ctrl_arb (
       .i_clk(i_clk),
       .i_rst(i_rst),
       .i_cfg_sync_cycle(i_cfg_sync_cycle),
+      .i_cfg_sync_cal_en(1'b0),
+      .i_cfg_sync_cal_step('0),
+      .i_cfg_sync_cal_tol('0),
+      .i_cfg_sync_cal_margin('0),
+      .i_cfg_sync_cal_period('0),
+      .o_dig_sync_cal_cycle(),
+      // Search-only bench: the lock channel never requests detects
+      .i_cfg_search_detect_mode(i_cfg_detect_mode),
+      .i_cfg_search_detect_wait_cycle(i_cfg_detect_wait_cycle),
+      .i_cfg_search_detect_avg_shift(i_cfg_detect_avg_shift),
+      .i_cfg_search_detect_settle_tol(i_cfg_detect_settle_tol),
+      .i_cfg_lock_detect_mode(i_cfg_detect_mode),
+      .i_cfg_lock_detect_wait_cycle(i_cfg_detect_wait_cycle),
+      .i_cfg_lock_detect_avg_shift(i_cfg_detect_avg_shift),
+      .i_cfg_lock_detect_settle_tol(i_cfg_detect_settle_tol),
       .pwr_detect_if(pwr_detect_if),
       .ctrl_arb_if(ctrl_arb_if),
       .o_dig_afe_ring_tune(dac_tune),
@@ -257,6 +318,7 @@ module dut #(
       .i_dig_ring_tune_start(i_dig_ring_tune_start),
       .i_dig_ring_tune_end(i_dig_ring_tune_end),
       .i_dig_ring_tune_stride(i_dig_ring_tune_stride),
+      .i_dig_search_fit_mode(i_dig_search_fit_mode),
 
       /*      .pwr_detect_if(pwr_detect_if),
  *
@@ -274,6 +336,7 @@ module dut #(
 
       .txn_if(search_txn_if.ctrl),
       .search_if(search_if),
+      .local_search_if(local_search_if.producer),
       .o_dig_ring_tune(search_ring_tune)
 
       /*.o_mon_peak_commit(o_mon_peak_commit),
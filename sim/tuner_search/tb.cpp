@@ -1,5 +1,8 @@
 #include "Vsim.h"
+#include "models/afe_noise.hpp"
 #include "testbench/verilator_tb.hpp"
+#include "utils/options.hpp"
+#include "utils/profiler.hpp"
 #include "utils/sweep.hpp"
 #include <csv2/writer.hpp>
 #include <fstream>
@@ -20,6 +23,8 @@ public:
       : dut_(dut), sample_interval_(interval){};
 
   void sample(vluint64_t time, bool force, bool print) {
+    static profiler::Phase phase("monitor.sample");
+    profiler::ScopedTimer timer(phase);
     bool do_sample = force || ((interval_count_ & sample_interval_) == 0);
 
     if (do_sample) {
@@ -33,6 +38,8 @@ public:
       records_.push_back(r);
 
       if (print) {
+        static profiler::Phase print_phase("monitor.print");
+        profiler::ScopedTimer print_timer(print_phase);
         std::cout << "[" << r.time << " ps] "
                   << "State=" << state_string(r.state_enum)
                   << " tune=" << r.tune_code << " i_pwr=" << r.i_pwr
@@ -99,15 +106,50 @@ private:
 };
 
 int main(int argc, char **argv) {
-  constexpr int kSyncCycle = 4;
+  options::Options opts(argc, argv);
+  const int kSyncCycle = opts.get<int>("sync_cycle", 4);
+  // Power detect: the defaults are the former fixed 4-cycle wait on one
+  // sample; a nonzero kDetectSettleTol opts in to the early exit
+  const int kDetectMode = opts.get<int>("detect_mode", 0);
+  const int kDetectWaitCycle = opts.get<int>("detect_wait_cycle", 4);
+  const int kDetectAvgShift = opts.get<int>("detect_avg_shift", 0);
+  const int kDetectSettleTol = opts.get<int>("detect_settle_tol", 0);
+  // AFE nonidealities (all zero is the ideal AFE). PD noise is given in ADC
+  // LSB and scaled to o_real_current units with the drop ADC full scale.
+  const uint64_t kNoiseSeed = opts.get<uint64_t>("noise_seed", 1);
+  constexpr double kAdcFullScale = 1.0;
+  const double kPdWhiteLsb = opts.get<double>("pd_white_lsb", 0.0);
+  const double kPdPinkLsb = opts.get<double>("pd_pink_lsb", 0.0);
+  const double kAdcOffsetLsb = opts.get<double>("adc_offset_lsb", 0.0);
+  const double kAdcDnlSigma = opts.get<double>("adc_dnl_sigma", 0.0);
+  const double kDacBowLsb = opts.get<double>("dac_bow_lsb", 0.0);
+  const double kDacDnlSigma = opts.get<double>("dac_dnl_sigma", 0.0);
+  const double kWvlRing = opts.get<double>("wvl_ring", 1295.0);
+  // Full-range sweep stride (log2 of the code step). Fit mode estimates
+  // each resonance from three samples, so it can sweep with a larger stride.
+  const int kSearchStride = opts.get<int>("search_stride", 2);
+  const int kSearchFitMode = opts.get<int>("search_fit_mode", 0);
+  opts.check_unused();
+  opts.write_effective("tb_config.toml");
   VerilatorTb<Vsim> tb(argc, argv);
   auto *dut = tb.dut();
 
   // Create a search monitor
   SearchPhyMonitor search_monitor(dut, 8);
 
+  afe_noise::AfeNoiseConfig noise_cfg;
+  noise_cfg.seed = kNoiseSeed;
+  noise_cfg.pd.white_sigma = kPdWhiteLsb * kAdcFullScale / 255.0;
+  noise_cfg.pd.pink_sigma = kPdPinkLsb * kAdcFullScale / 255.0;
+  noise_cfg.adc_offset_lsb = kAdcOffsetLsb;
+  noise_cfg.adc_dnl_sigma = kAdcDnlSigma;
+  noise_cfg.dac_bow_lsb = kDacBowLsb;
+  noise_cfg.dac_dnl_sigma = kDacDnlSigma;
+  afe_noise::AfeNoise<8, 8> afe(noise_cfg, 0);
+
   auto advance_clk = [&]() {
     auto search_phy_state_prev = dut->o_mon_state;
+    dut->i_pd_noise = afe.pd.next();
     tb.step_clk(dut->i_clk);
 
     auto search_phy_state = dut->o_mon_state;
@@ -159,15 +201,24 @@ int main(int argc, char **argv) {
   dut->i_pwr = 1.0;
   dut->i_wvl_ls[0] = 1300.0;
   dut->i_wvl_ls[1] = 1302.0;
-  dut->i_wvl_ring = 1295.0;
+  dut->i_wvl_ring = kWvlRing;
   dut->i_dig_search_trig_val = 0;
   dut->i_dig_search_peaks_rdy = 0;
   dut->i_cfg_sync_cycle = kSyncCycle;
+  dut->i_dig_search_fit_mode = kSearchFitMode;
+  dut->i_cfg_detect_mode = kDetectMode;
+  dut->i_cfg_detect_wait_cycle = kDetectWaitCycle;
+  dut->i_cfg_detect_avg_shift = kDetectAvgShift;
+  dut->i_cfg_detect_settle_tol = kDetectSettleTol;
+
+  dut->i_adc_offset = afe.adc.offset_lsb();
+  afe_noise::load_table(dut->i_adc_inl, afe.adc.inl_table());
+  afe_noise::load_table(dut->i_dac_inl, afe.dac.inl_table());
 
   dut->i_clk = 0; // Clock starts low
   tb.reset(dut->i_clk, dut->i_rst);
 
-  search_routine(0, 255, 2, true);
+  search_routine(0, 255, kSearchStride, true);
   search_routine(140, 255, 0, true);
 
   search_monitor.write_csv("search_waveform.csv");
@@ -13,7 +13,11 @@ module dut #(
     parameter int ADC_WIDTH    = 8,
     parameter int NUM_TARGET   = 8,
     parameter int LOCK_DELTA_WINDOW_SIZE = 2,
-    parameter int MAX_SYNC_CYCLE = 16
+    parameter int MAX_SYNC_CYCLE = 16,
+    parameter int MAX_WAIT_CYCLE = 16,
+    parameter int MAX_NUM_PWR_DETECT = 16,
+    // -GCTRL_ARB_TLM=1 (SVWDM_CTRL_ARB_TLM): transaction-level arbiter
+    parameter bit CTRL_ARB_TLM = 1'b0
 ) (
     input var logic i_clk,
     input var logic i_rst,
@@ -29,12 +33,33 @@ module dut #(
     input var logic [$clog2(DAC_WIDTH)-1:0] i_cfg_ring_tune_stride,
     input var logic [$clog2(DAC_WIDTH)-1:0] i_cfg_lock_tune_stride,
     input var logic [$clog2(MAX_SYNC_CYCLE + 1)-1:0] i_cfg_sync_cycle,
+    input var logic i_cfg_sync_cal_en,
+    input var logic [DAC_WIDTH-1:0] i_cfg_sync_cal_step,
+    input var logic [3:0] i_cfg_sync_cal_tol,
+    input var logic [1:0] i_cfg_sync_cal_margin,
+    input var logic [15:0] i_cfg_sync_cal_period,
     input var logic [$clog2(LOCK_DELTA_WINDOW_SIZE + 1)-1:0] i_cfg_lock_pwr_delta_thres,
+    input var logic i_cfg_lock_mode,
+    input var logic [$clog2(ADC_WIDTH)-1:0] i_cfg_lock_pi_kp_shift,
+    input var logic [$clog2(ADC_WIDTH)-1:0] i_cfg_lock_pi_ki_shift,
     input var logic [3:0] i_cfg_ring_pwr_peak_ratio,
+    input var logic [3:0] i_cfg_lock_loss_ratio,
+    input var logic [3:0] i_cfg_lock_loss_cnt,
+    input var logic [DAC_WIDTH-1:0] i_cfg_lock_research_halfwidth,
 
     input var logic [ADC_WIDTH-1:0] i_cfg_pwr_peak,
     input var logic [DAC_WIDTH-1:0] i_cfg_ring_tune_peak,
 
+    // Power Detect Config per requesting PHY
+    input var logic i_cfg_search_detect_mode,
+    input var logic [$clog2(MAX_WAIT_CYCLE + 1)-1:0] i_cfg_search_detect_wait_cycle,
+    input var logic [$clog2($clog2(MAX_NUM_PWR_DETECT) + 1)-1:0] i_cfg_search_detect_avg_shift,
+    input var logic [3:0] i_cfg_search_detect_settle_tol,
+    input var logic i_cfg_lock_detect_mode,
+    input var logic [$clog2(MAX_WAIT_CYCLE + 1)-1:0] i_cfg_lock_detect_wait_cycle,
+    input var logic [$clog2($clog2(MAX_NUM_PWR_DETECT) + 1)-1:0] i_cfg_lock_detect_avg_shift,
+    input var logic [3:0] i_cfg_lock_detect_settle_tol,
+
     // Search Interface
     input var logic i_search_trig_val,
     output var logic o_search_trig_rdy,
@@ -52,6 +77,15 @@ module dut #(
     input var  logic i_lock_resume_val,
     output var logic o_lock_resume_rdy,
 
+    // AFE nonideality injection (lib/cpp/models/afe_noise.hpp), drop path
+    input var real i_pd_noise,
+    input var real i_adc_offset,
+    input var real i_adc_inl[2**ADC_WIDTH],
+    input var real i_dac_inl[2**DAC_WIDTH],
+
+    // Heater thermal time constant in cycles (0 is instantaneous)
+    input var real i_heater_tau,
+
     // output signals
     output real o_pwr_thru,
     output real o_pwr_drop,
@@ -60,6 +94,7 @@ module dut #(
     output tuner_phy_lock_state_e o_lock_state,
     output logic o_search_err,
     output logic o_lock_err,
+    output logic [$clog2(MAX_SYNC_CYCLE + 1)-1:0] o_sync_cal_cycle,
     output logic [ADC_WIDTH-1:0] o_adc_thru,
     output logic [ADC_WIDTH-1:0] o_adc_drop
 );
@@ -94,6 +129,8 @@ module dut #(
   real pwrs[WAVES_WIDTH];
 
   real ana_tune;
+  real heater_drive[1];
+  real heater_tune[1];
 
   logic [ADC_WIDTH-1:0] adc_thru;
   logic [ADC_WIDTH-1:0] adc_drop;
@@ -125,8 +162,10 @@ module dut #(
   ) microring (
       .i_phot_waves(waves_in),
       .i_real_wvl_ring(i_wvl_ring),
-      .i_real_tuning_dist(ana_tune),
+      .i_real_tuning_dist(heater_tune[0]),
       .i_real_temperature(0.0),
+      .i_real_fwhm_scale (1.0),
+      .i_real_tune_scale (1.0),
       .o_phot_waves_drop(waves_drop),
       .o_phot_waves_thru(waves_thru)
   );
@@ -136,13 +175,28 @@ module dut #(
       .FullScaleRange(1.0)
   ) dac_tune (
       .i_dig(o_ring_tune),
+      .i_real_inl(i_dac_inl),
       .o_ana(ana_tune)
   );
 
+  always_comb heater_drive[0] = ana_tune;
+
+  heater #(
+      .NUM_CHANNEL(1)
+  ) heater_tune_inst (
+      .i_clk(i_clk),
+      .i_rst(i_rst),
+      .i_real_tau_cycles(i_heater_tau),
+      .i_real_coupling(0.0),
+      .i_real_drive(heater_drive),
+      .o_real_tuning_dist(heater_tune)
+  );
+
   photodetector #(
       .waves_t(WAVES_TYPE)
   ) pd_drop (
       .i_phot_waves  (waves_drop),
+      .i_real_noise  (i_pd_noise),
       .o_real_current(o_pwr_drop)
   );
 
@@ -150,6 +204,7 @@ module dut #(
       .waves_t(WAVES_TYPE)
   ) pd_thru (
       .i_phot_waves  (waves_thru),
+      .i_real_noise  (0.0),
       .o_real_current(o_pwr_thru)
   );
 
@@ -158,6 +213,8 @@ module dut #(
       .FullScaleRange(1.0)
   ) adc_thru_inst (
       .i_ana(o_pwr_thru),
+      .i_real_offset(0.0),
+      .i_real_inl('{default: 0.0}),
       .o_dig(adc_thru)
   );
 
@@ -166,6 +223,8 @@ module dut #(
       .FullScaleRange(1.0)
   ) adc_drop_inst (
       .i_ana(o_pwr_drop),
+      .i_real_offset(i_adc_offset),
+      .i_real_inl(i_adc_inl),
       .o_dig(adc_drop)
   );
 
@@ -176,7 +235,10 @@ module dut #(
       .SEARCH_PEAK_WINDOW_HALFSIZE(4),
       .SEARCH_PEAK_THRES(2),
       .LOCK_DELTA_WINDOW_SIZE(LOCK_DELTA_WINDOW_SIZE),
-      .MAX_SYNC_CYCLE(MAX_SYNC_CYCLE)
+      .MAX_SYNC_CYCLE(MAX_SYNC_CYCLE),
+      .MAX_WAIT_CYCLE(MAX_WAIT_CYCLE),
+      .MAX_NUM_PWR_DETECT(MAX_NUM_PWR_DETECT),
+      .CTRL_ARB_TLM(CTRL_ARB_TLM)
   ) tuner_phy_inst (
       .i_clk(i_clk),
       .i_rst(i_rst),
@@ -184,19 +246,45 @@ module dut #(
       .i_cfg_ring_tune_start(i_cfg_ring_tune_start),
       .i_cfg_ring_tune_end(i_cfg_ring_tune_end),
       .i_cfg_ring_tune_stride(i_cfg_ring_tune_stride),
+      .i_cfg_search_fit_mode(1'b0),
       .i_cfg_lock_tune_stride(i_cfg_lock_tune_stride),
       .i_cfg_sync_cycle(i_cfg_sync_cycle),
+      .i_cfg_sync_cal_en(i_cfg_sync_cal_en),
+      .i_cfg_sync_cal_step(i_cfg_sync_cal_step),
+      .i_cfg_sync_cal_tol(i_cfg_sync_cal_tol),
+      .i_cfg_sync_cal_margin(i_cfg_sync_cal_margin),
+      .i_cfg_sync_cal_period(i_cfg_sync_cal_period),
+      .i_cfg_arb_search_weight('0),
+      .i_cfg_arb_lock_weight('0),
+      .i_cfg_arb_lock_max_wait('0),
       .i_cfg_lock_pwr_delta_thres(i_cfg_lock_pwr_delta_thres),
+      .i_cfg_lock_mode(i_cfg_lock_mode),
+      .i_cfg_lock_pi_kp_shift(i_cfg_lock_pi_kp_shift),
+      .i_cfg_lock_pi_ki_shift(i_cfg_lock_pi_ki_shift),
       .i_cfg_ring_pwr_peak_ratio(i_cfg_ring_pwr_peak_ratio),
+      .i_cfg_lock_loss_ratio(i_cfg_lock_loss_ratio),
+      .i_cfg_lock_loss_cnt(i_cfg_lock_loss_cnt),
+      .i_cfg_lock_research_halfwidth(i_cfg_lock_research_halfwidth),
       .i_cfg_pwr_peak(i_cfg_pwr_peak),
       .i_cfg_ring_tune_peak(i_cfg_ring_tune_peak),
+      .i_cfg_search_detect_mode(i_cfg_search_detect_mode),
+      .i_cfg_search_detect_wait_cycle(i_cfg_search_detect_wait_cycle),
+      .i_cfg_search_detect_avg_shift(i_cfg_search_detect_avg_shift),
+      .i_cfg_search_detect_settle_tol(i_cfg_search_detect_settle_tol),
+      .i_cfg_lock_detect_mode(i_cfg_lock_detect_mode),
+      .i_cfg_lock_detect_wait_cycle(i_cfg_lock_detect_wait_cycle),
+      .i_cfg_lock_detect_avg_shift(i_cfg_lock_detect_avg_shift),
+      .i_cfg_lock_detect_settle_tol(i_cfg_lock_detect_settle_tol),
       .search_if(search_if.producer),
       .lock_if(lock_if.producer),
       .o_dig_ring_tune(o_ring_tune),
       .o_dig_search_state_mon(o_search_state),
       .o_dig_lock_state_mon(o_lock_state),
       .o_dig_search_err(o_search_err),
-      .o_dig_lock_err(o_lock_err)
+      .o_dig_lock_err(o_lock_err),
+      .o_dig_sync_cal_cycle(o_sync_cal_cycle),
+      .o_dig_arb_lock_req(),
+      .o_dig_arb_grant()
   );
   // ----------------------------------------------------------------------
 
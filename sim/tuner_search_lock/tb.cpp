@@ -1,9 +1,16 @@
 #include "Vdut.h"
+#include "models/afe_noise.hpp"
+#include "testbench/ctrl_arb_tlm.hpp"
 #include "testbench/verilator_tb.hpp"
+#include "utils/async_writer.hpp"
+#include "utils/monitor_bin.hpp"
+#include "utils/options.hpp"
+#include "utils/profiler.hpp"
 #include "utils/sweep.hpp"
 #include <csv2/writer.hpp>
 #include <fstream>
 #include <iostream>
+#include <memory>
 
 class SearchLockPhyMonitor {
 public:
@@ -18,12 +25,15 @@ public:
   } search_lock_record_t;
 
   typedef std::vector<int> peak_codes_t;
+  typedef async_writer::AsyncWriter<search_lock_record_t> bin_writer_t;
 
   SearchLockPhyMonitor(Vdut *dut) : dut_(dut) { sample_interval_ = 1; };
   SearchLockPhyMonitor(Vdut *dut, int interval)
       : dut_(dut), sample_interval_(interval){};
 
   void sample(vluint64_t time, bool force, bool print) {
+    static profiler::Phase phase("monitor.sample");
+    profiler::ScopedTimer timer(phase);
     bool do_sample = force || ((interval_count_ % sample_interval_) == 0);
 
     if (do_sample) {
@@ -36,8 +46,15 @@ public:
       r.search_state_enum = dut_->o_search_state;
       r.lock_state_enum = dut_->o_lock_state;
       records_.push_back(r);
+      if (writer_) {
+        writer_->push(r);
+      } else if (bin_) {
+        append_bin(r);
+      }
 
       if (print) {
+        static profiler::Phase print_phase("monitor.print");
+        profiler::ScopedTimer print_timer(print_phase);
         std::cout << "[" << r.time << " ps] "
                   << "Search State=" << search_state_string(r.search_state_enum)
                   << " Lock State=" << lock_state_string(r.lock_state_enum)
@@ -70,6 +87,50 @@ public:
     ofs.close();
   }
 
+  // Also stream every sample to a binary monitor for utils/plot_wave. With
+  // async, sample() only queues the record and a writer thread appends it.
+  void open_bin(const std::string &filename, bool async = false,
+                size_t queue_depth = size_t{1} << 16,
+                async_writer::backpressure_e policy =
+                    async_writer::backpressure_e::BLOCK) {
+    using monitor_bin::col_type_e;
+    std::vector<std::string> search_labels, lock_labels;
+    for (int s = 0; s <= 5; ++s)
+      search_labels.push_back(search_state_string(s));
+    for (int s = 0; s <= 4; ++s)
+      lock_labels.push_back(lock_state_string(s));
+    bin_ = std::make_unique<monitor_bin::MonitorBinWriter>();
+    bin_->add_column("time", col_type_e::F64);
+    bin_->add_column("tune_code", col_type_e::I32);
+    bin_->add_column("i_pwr", col_type_e::F64);
+    bin_->add_column("o_pwr_thru", col_type_e::F64);
+    bin_->add_column("o_pwr_drop", col_type_e::F64);
+    bin_->add_column("search_state", col_type_e::U8, search_labels);
+    bin_->add_column("lock_state", col_type_e::U8, lock_labels);
+    bin_->open(filename);
+    if (async) {
+      writer_ = std::make_unique<bin_writer_t>(
+          [this](const search_lock_record_t *r, size_t n) {
+            for (size_t i = 0; i < n; ++i)
+              append_bin(r[i]);
+          },
+          queue_depth, policy);
+    }
+  }
+
+  void close_bin() {
+    if (writer_) {
+      writer_->close();
+      bin_dropped_ = writer_->dropped();
+      writer_.reset();
+    }
+    if (bin_)
+      bin_->close();
+  }
+
+  // Samples the async writer discarded under drop backpressure
+  uint64_t bin_dropped() const { return bin_dropped_; }
+
   void change_sample_interval(int new_interval) {
     if (new_interval > 0) {
       sample_interval_ = new_interval;
@@ -96,6 +157,14 @@ private:
   int interval_count_ = 0;
   std::vector<search_lock_record_t> records_;
   peak_codes_t peak_codes_;
+  std::unique_ptr<monitor_bin::MonitorBinWriter> bin_;
+  std::unique_ptr<bin_writer_t> writer_;
+  uint64_t bin_dropped_ = 0;
+
+  void append_bin(const search_lock_record_t &r) {
+    bin_->append(r.time, r.tune_code, r.i_pwr, r.o_pwr_thru, r.o_pwr_drop,
+                 r.search_state_enum, r.lock_state_enum);
+  }
 
   static std::string state_string(int state_enum, bool is_search) {
     if (is_search) {
@@ -134,6 +203,8 @@ private:
       return "ACTIVE";
     case 3:
       return "INTR";
+    case 4:
+      return "SEARCH";
     default:
       return "UNKNOWN";
     }
@@ -141,22 +212,97 @@ private:
 };
 
 int main(int argc, char **argv) {
-  constexpr int kLockTuneStride = 1;
-  constexpr int kLockPwrDeltaThres = 2;
-  constexpr int kSyncCycle = 4;
+  options::Options opts(argc, argv);
+  const int kLockTuneStride = opts.get<int>("lock_tune_stride", 1);
+  const int kLockPwrDeltaThres = opts.get<int>("lock_pwr_delta_thres", 2);
+  const int kSyncCycle = opts.get<int>("sync_cycle", 4);
+  // Sync-cycle calibration: sync_cycle becomes the ceiling for a count
+  // measured by stepping the DAC sync_cal_step codes away and back
+  const bool kSyncCalEn = opts.get<bool>("sync_cal_en", false);
+  const int kSyncCalStep = opts.get<int>("sync_cal_step", 16);
+  const int kSyncCalTol = opts.get<int>("sync_cal_tol", 1);
+  const int kSyncCalMargin = opts.get<int>("sync_cal_margin", 0);
+  const int kSyncCalPeriod = opts.get<int>("sync_cal_period", 0);
+  // 0: LOCK_MODE_SLOPE, 1: LOCK_MODE_PI
+  const int kLockMode = opts.get<int>("lock_mode", 0);
+  const int kLockPiKpShift = opts.get<int>("lock_pi_kp_shift", 4);
+  const int kLockPiKiShift = opts.get<int>("lock_pi_ki_shift", 3);
+  // Lock loss below 4/16 of the peak for 4 windows, re-search +-32 codes
+  const int kLockLossRatio = opts.get<int>("lock_loss_ratio", 4);
+  const int kLockLossCnt = opts.get<int>("lock_loss_cnt", 4);
+  const int kLockResearchHalfwidth =
+      opts.get<int>("lock_research_halfwidth", 32);
+  const double kWvlRing = opts.get<double>("wvl_ring", 1295.0);
+  const double kThermalKick = opts.get<double>("thermal_kick", 1.0);
+  const int kMaxReacquireCycles = opts.get<int>("max_reacquire_cycles", 100000);
+  // Power detect per PHY: the defaults are the former fixed 4-cycle wait on
+  // one sample; settle_tol opts in to the early exit, avg_shift averages
+  // 2^shift samples per window
+  const int kSearchDetectMode = opts.get<int>("search_detect_mode", 0);
+  const int kSearchDetectWaitCycle =
+      opts.get<int>("search_detect_wait_cycle", 4);
+  const int kSearchDetectAvgShift = opts.get<int>("search_detect_avg_shift", 0);
+  const int kSearchDetectSettleTol =
+      opts.get<int>("search_detect_settle_tol", 0);
+  const int kLockDetectMode = opts.get<int>("lock_detect_mode", 0);
+  const int kLockDetectWaitCycle = opts.get<int>("lock_detect_wait_cycle", 4);
+  const int kLockDetectAvgShift = opts.get<int>("lock_detect_avg_shift", 0);
+  const int kLockDetectSettleTol = opts.get<int>("lock_detect_settle_tol", 0);
+  // AFE nonidealities (all zero is the ideal AFE). PD noise is given in ADC
+  // LSB and scaled to o_real_current units with the drop ADC full scale.
+  const uint64_t kNoiseSeed = opts.get<uint64_t>("noise_seed", 1);
+  constexpr double kAdcFullScale = 1.0;
+  const double kPdWhiteLsb = opts.get<double>("pd_white_lsb", 0.0);
+  const double kPdPinkLsb = opts.get<double>("pd_pink_lsb", 0.0);
+  const double kAdcOffsetLsb = opts.get<double>("adc_offset_lsb", 0.0);
+  const double kAdcDnlSigma = opts.get<double>("adc_dnl_sigma", 0.0);
+  const double kDacBowLsb = opts.get<double>("dac_bow_lsb", 0.0);
+  const double kDacDnlSigma = opts.get<double>("dac_dnl_sigma", 0.0);
+  // Heater thermal time constant in cycles (0 is the instantaneous DAC ->
+  // ring path, heater.sv)
+  const double kHeaterTauCycles = opts.get<double>("heater_tau_cycles", 0.0);
+  // Binary monitor appends on a background writer thread, with "block" or
+  // "drop" backpressure when its queue of monitor_queue_depth samples fills
+  const bool kMonitorAsync = opts.get<bool>("monitor_async", false);
+  const int kMonitorQueueDepth = opts.get<int>("monitor_queue_depth", 65536);
+  const auto kMonitorBackpressure = async_writer::parse_backpressure(
+      opts.get<std::string>("monitor_backpressure", "block"));
+  opts.check_unused();
+  opts.write_effective("tb_config.toml");
   VerilatorTb<Vdut> tb(argc, argv);
   auto *dut = tb.dut();
   int first_peak_code = 0;
+  int first_peak_pwr = 0;
 
   SearchLockPhyMonitor monitor(dut, 8);
+  monitor.open_bin("search_lock_waveform.swm", kMonitorAsync,
+                   kMonitorQueueDepth, kMonitorBackpressure);
+
+  afe_noise::AfeNoiseConfig noise_cfg;
+  noise_cfg.seed = kNoiseSeed;
+  noise_cfg.pd.white_sigma = kPdWhiteLsb * kAdcFullScale / 255.0;
+  noise_cfg.pd.pink_sigma = kPdPinkLsb * kAdcFullScale / 255.0;
+  noise_cfg.adc_offset_lsb = kAdcOffsetLsb;
+  noise_cfg.adc_dnl_sigma = kAdcDnlSigma;
+  noise_cfg.dac_bow_lsb = kDacBowLsb;
+  noise_cfg.dac_dnl_sigma = kDacDnlSigma;
+  afe_noise::AfeNoise<8, 8> afe(noise_cfg, 0);
+
+  // With the TLM arbiter (SVWDM_CTRL_ARB_TLM) the sync cycles are accounted,
+  // not simulated; report time as if they had been
+  const auto &tlm = ctrl_arb_tlm::Registry::instance();
+  auto time_ps = [&]() -> vluint64_t {
+    return tb.time_ps() + tlm.skipped_cycles() * tb.clk_period_ps();
+  };
 
   auto advance_clk = [&]() {
     auto search_state_prev = dut->o_search_state;
     auto lock_state_prev = dut->o_lock_state;
+    dut->i_pd_noise = afe.pd.next();
     tb.step_clk(dut->i_clk);
     bool force_sample = (dut->o_search_state != search_state_prev) ||
                         (dut->o_lock_state != lock_state_prev);
-    monitor.sample(tb.time_ps(), force_sample, true);
+    monitor.sample(time_ps(), force_sample, true);
   };
 
   auto search_routine = [&](int start, int end, int stride = 1,
@@ -175,7 +321,9 @@ int main(int argc, char **argv) {
 
     // save the first peak code
     first_peak_code = (int)dut->o_pwr_peak_tune_codes[0];
-    std::cout << "First peak tune code: " << first_peak_code << "\n";
+    first_peak_pwr = (int)dut->o_pwr_peak_codes[0];
+    std::cout << "First peak tune code: " << first_peak_code
+              << " pwr: " << first_peak_pwr << "\n";
     monitor.record_peak(first_peak_code);
 
     dut->i_search_done_rdy = 0;
@@ -184,6 +332,8 @@ int main(int argc, char **argv) {
   auto lock_routine = [&](bool print = true) {
     dut->i_lock_trig_val = 1;
     dut->i_cfg_ring_tune_start = monitor.get_peak(0) - 20; // offset by -20
+    dut->i_cfg_ring_tune_peak = monitor.get_peak(0);
+    dut->i_cfg_pwr_peak = first_peak_pwr;
     advance_clk();
     dut->i_lock_trig_val = 0;
 
@@ -196,6 +346,28 @@ int main(int argc, char **argv) {
       advance_clk();
     }
 
+    // Thermal kick: shift the resonance and let the hardware re-acquire
+    dut->i_wvl_ring = kWvlRing + kThermalKick;
+    const vluint64_t kick_time = time_ps();
+    int cycles = 0;
+    while (dut->o_lock_state != 4 /*SEARCH*/ && cycles < kMaxReacquireCycles) {
+      advance_clk();
+      ++cycles;
+    }
+    while (dut->o_lock_state != 2 /*ACTIVE*/ && cycles < kMaxReacquireCycles) {
+      advance_clk();
+      ++cycles;
+    }
+    if (cycles >= kMaxReacquireCycles) {
+      std::cerr << "Lock re-acquire did not complete" << std::endl;
+    } else {
+      std::cout << "Lock re-acquired " << (time_ps() - kick_time)
+                << " ps after thermal kick" << std::endl;
+    }
+    for (int i = 0; i < 1000; ++i) {
+      advance_clk();
+    }
+
     // Trigger interrupt by dropping intr_rdy
     dut->i_lock_intr_rdy = 0;
     advance_clk();
@@ -232,7 +404,7 @@ int main(int argc, char **argv) {
 
   dut->i_pwr = 1.0;
   dut->i_wvl_ls = 1300.0;
-  dut->i_wvl_ring = 1295.0;
+  dut->i_wvl_ring = kWvlRing;
   dut->i_search_trig_val = 0;
   dut->i_search_done_rdy = 0;
   dut->i_lock_trig_val = 0;
@@ -242,15 +414,62 @@ int main(int argc, char **argv) {
   dut->i_cfg_lock_tune_stride = kLockTuneStride;
   dut->i_cfg_lock_pwr_delta_thres = kLockPwrDeltaThres;
   dut->i_cfg_sync_cycle = kSyncCycle;
+  dut->i_cfg_sync_cal_en = kSyncCalEn;
+  dut->i_cfg_sync_cal_step = kSyncCalStep;
+  dut->i_cfg_sync_cal_tol = kSyncCalTol;
+  dut->i_cfg_sync_cal_margin = kSyncCalMargin;
+  dut->i_cfg_sync_cal_period = kSyncCalPeriod;
+  dut->i_cfg_lock_mode = kLockMode;
+  dut->i_cfg_lock_pi_kp_shift = kLockPiKpShift;
+  dut->i_cfg_lock_pi_ki_shift = kLockPiKiShift;
+  dut->i_cfg_lock_loss_ratio = kLockLossRatio;
+  dut->i_cfg_lock_loss_cnt = kLockLossCnt;
+  dut->i_cfg_lock_research_halfwidth = kLockResearchHalfwidth;
+  dut->i_cfg_search_detect_mode = kSearchDetectMode;
+  dut->i_cfg_search_detect_wait_cycle = kSearchDetectWaitCycle;
+  dut->i_cfg_search_detect_avg_shift = kSearchDetectAvgShift;
+  dut->i_cfg_search_detect_settle_tol = kSearchDetectSettleTol;
+  dut->i_cfg_lock_detect_mode = kLockDetectMode;
+  dut->i_cfg_lock_detect_wait_cycle = kLockDetectWaitCycle;
+  dut->i_cfg_lock_detect_avg_shift = kLockDetectAvgShift;
+  dut->i_cfg_lock_detect_settle_tol = kLockDetectSettleTol;
+
+  dut->i_adc_offset = afe.adc.offset_lsb();
+  afe_noise::load_table(dut->i_adc_inl, afe.adc.inl_table());
+  afe_noise::load_table(dut->i_dac_inl, afe.dac.inl_table());
+
+  dut->i_heater_tau = kHeaterTauCycles;
 
   dut->i_clk = 0;
   tb.reset(dut->i_clk, dut->i_rst);
+  if (!tlm.empty() && kHeaterTauCycles > 0.0) {
+    std::cerr << "Warning: the TLM ctrl arbiter samples the settled ring; "
+                 "heater_tau_cycles > 0 needs the RTL arbiter"
+              << std::endl;
+  }
 
   search_routine(0, 255, 2, true);
   lock_routine(true);
   search_routine(100, 200, 2, true);
 
   monitor.write_csv("search_lock_waveform.csv");
+  monitor.close_bin();
+  if (monitor.bin_dropped() > 0) {
+    std::cerr << "Monitor dropped " << monitor.bin_dropped() << " samples"
+              << std::endl;
+  }
+  if (kSyncCalEn) {
+    std::cout << "Calibrated sync cycle: "
+              << static_cast<int>(dut->o_sync_cal_cycle) << " (ceiling "
+              << kSyncCycle << ")" << std::endl;
+  }
+  if (!tlm.empty()) {
+    std::cout << "TLM ctrl arbiter: " << tlm.transactions()
+              << " transactions, " << tlm.skipped_cycles()
+              << " sync cycles accounted, "
+              << tb.time_ps() / tb.clk_period_ps() << " simulated"
+              << std::endl;
+  }
 
   return 0;
 }
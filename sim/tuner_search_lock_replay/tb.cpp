@@ -0,0 +1,250 @@
+#include "Vdut.h"
+#include "testbench/stimulus_replay.hpp"
+#include "testbench/verilator_tb.hpp"
+#include "utils/metrics.hpp"
+#include "utils/monitor_bin.hpp"
+#include "utils/options.hpp"
+#include "utils/profiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+// Streams the lock loop and the replayed stimulus to a binary monitor; long
+// replays are only practical to plot through utils/plot_wave's LOD reader
+class ReplayMonitor {
+public:
+  ReplayMonitor(Vdut *dut, int interval) : dut_(dut), interval_(interval) {
+    bin_.add_column("time", monitor_bin::col_type_e::F64);
+    bin_.add_column("tune_code", monitor_bin::col_type_e::I32);
+    bin_.add_column("i_pwr", monitor_bin::col_type_e::F64);
+    bin_.add_column("i_wvl_ring", monitor_bin::col_type_e::F64);
+    bin_.add_column("o_pwr_drop", monitor_bin::col_type_e::F64);
+    bin_.add_column("search_state", monitor_bin::col_type_e::U8,
+                    {"IDLE", "INIT", "ACTIVE", "DONE", "ERROR", "INTR"});
+    bin_.add_column("lock_state", monitor_bin::col_type_e::U8,
+                    {"IDLE", "INIT", "ACTIVE", "INTR", "SEARCH"});
+  }
+
+  void open(const std::string &filename) { bin_.open(filename); }
+  void close() { bin_.close(); }
+
+  void sample(vluint64_t time, bool force) {
+    static profiler::Phase phase("monitor.sample");
+    profiler::ScopedTimer timer(phase);
+    if (force || (count_ % interval_) == 0) {
+      bin_.append(static_cast<double>(time), dut_->o_ring_tune, dut_->i_pwr,
+                  dut_->i_wvl_ring, dut_->o_pwr_drop, dut_->o_search_state,
+                  dut_->o_lock_state);
+      if (force)
+        count_ = 0;
+    }
+    ++count_;
+  }
+
+private:
+  Vdut *dut_;
+  int interval_;
+  int count_ = 0;
+  monitor_bin::MonitorBinWriter bin_;
+};
+
+// Synthetic capture used when no STIMULUS_FILE is given: two hours at 1 Hz
+// of diurnal-like temperature swing plus laser power droop and ripple
+static void write_synthetic_stimulus(const std::string &filename) {
+  constexpr double kTwoPi = 6.283185307179586;
+  std::ofstream ofs(filename);
+  ofs << "time,pwr,temp\n";
+  for (int n = 0; n <= 7200; ++n) {
+    const double t = static_cast<double>(n);
+    const double temp = 25.0 + 1.5 * std::sin(kTwoPi * t / 5400.0) +
+                        0.05 * std::sin(kTwoPi * t / 37.0);
+    const double pwr = 1.0 - 0.05 * t / 7200.0 +
+                       0.01 * std::sin(kTwoPi * t / 600.0);
+    ofs << t << "," << pwr << "," << temp << "\n";
+  }
+}
+
+int main(int argc, char **argv) {
+  options::Options opts(argc, argv);
+  const int kLockTuneStride = opts.get<int>("lock_tune_stride", 1);
+  const int kLockPwrDeltaThres = opts.get<int>("lock_pwr_delta_thres", 2);
+  const int kSyncCycle = opts.get<int>("sync_cycle", 4);
+  // 0: LOCK_MODE_SLOPE, 1: LOCK_MODE_PI
+  const int kLockMode = opts.get<int>("lock_mode", 0);
+  const int kLockPiKpShift = opts.get<int>("lock_pi_kp_shift", 4);
+  const int kLockPiKiShift = opts.get<int>("lock_pi_ki_shift", 3);
+  const int kLockLossRatio = opts.get<int>("lock_loss_ratio", 4);
+  const int kLockLossCnt = opts.get<int>("lock_loss_cnt", 4);
+  const int kLockResearchHalfwidth =
+      opts.get<int>("lock_research_halfwidth", 32);
+  const int kSearchDetectMode = opts.get<int>("search_detect_mode", 0);
+  const int kSearchDetectWaitCycle =
+      opts.get<int>("search_detect_wait_cycle", 4);
+  const int kSearchDetectAvgShift = opts.get<int>("search_detect_avg_shift", 0);
+  const int kSearchDetectSettleTol =
+      opts.get<int>("search_detect_settle_tol", 0);
+  const int kLockDetectMode = opts.get<int>("lock_detect_mode", 0);
+  const int kLockDetectWaitCycle = opts.get<int>("lock_detect_wait_cycle", 4);
+  const int kLockDetectAvgShift = opts.get<int>("lock_detect_avg_shift", 0);
+  const int kLockDetectSettleTol = opts.get<int>("lock_detect_settle_tol", 0);
+  // Stimulus mapping. i_pwr = kPwrScale * pwr, and the ring resonance
+  // follows temperature at kWvlPerKelvin around kWvlRing at kTempRef.
+  const double kPwrScale = opts.get<double>("pwr_scale", 1.0);
+  const double kWvlRing = opts.get<double>("wvl_ring", 1295.0);
+  const double kTempRef = opts.get<double>("temp_ref", 25.0);
+  const double kWvlPerKelvin = opts.get<double>("wvl_per_kelvin", 0.08);
+  // Time compression: capture seconds per simulated clock cycle, so the
+  // synthetic two-hour capture replays in 3.6 M cycles
+  constexpr double kClkPeriodPs = 10.0;
+  const double kTraceSecPerCycle =
+      opts.get<double>("trace_sec_per_cycle", 2e-3);
+  const uint64_t kMaxReplayCycles =
+      opts.get<uint64_t>("max_replay_cycles", 50000000);
+  const int kMonitorInterval = opts.get<int>("monitor_interval", 256);
+
+  // Capture to replay; empty writes and replays a synthetic one
+  const char *stimulus_env = std::getenv("STIMULUS_FILE");
+  std::string stimulus_file = opts.get<std::string>(
+      "stimulus_file", stimulus_env != nullptr ? stimulus_env : "");
+  opts.check_unused();
+  opts.write_effective("tb_config.toml");
+  if (stimulus_file.empty()) {
+    stimulus_file = "stimulus_synthetic.csv";
+    write_synthetic_stimulus(stimulus_file);
+  }
+
+  VerilatorTb<Vdut> tb(argc, argv);
+  auto *dut = tb.dut();
+
+  stimulus_replay::StimulusReplay replay(stimulus_file,
+                                         kTraceSecPerCycle / kClkPeriodPs);
+  replay.bind("pwr", &dut->i_pwr, kPwrScale);
+  replay.bind("temp", &dut->i_wvl_ring, kWvlPerKelvin,
+              kWvlRing - kWvlPerKelvin * kTempRef);
+  if (replay.has_column("wvl_ls")) {
+    replay.bind("wvl_ls", &dut->i_wvl_ls);
+  }
+
+  ReplayMonitor monitor(dut, kMonitorInterval);
+  monitor.open("search_lock_replay.swm");
+
+  auto advance_clk = [&]() {
+    auto search_state_prev = dut->o_search_state;
+    auto lock_state_prev = dut->o_lock_state;
+    replay.update(tb.time_ps());
+    tb.step_clk(dut->i_clk);
+    bool force_sample = (dut->o_search_state != search_state_prev) ||
+                        (dut->o_lock_state != lock_state_prev);
+    monitor.sample(tb.time_ps(), force_sample);
+  };
+
+  dut->i_wvl_ls = 1300.0;
+  dut->i_search_trig_val = 0;
+  dut->i_search_done_rdy = 0;
+  dut->i_lock_trig_val = 0;
+  dut->i_lock_intr_rdy = 1;
+  dut->i_lock_resume_val = 0;
+  dut->i_cfg_ring_pwr_peak_ratio = 8;
+  dut->i_cfg_lock_tune_stride = kLockTuneStride;
+  dut->i_cfg_lock_pwr_delta_thres = kLockPwrDeltaThres;
+  dut->i_cfg_sync_cycle = kSyncCycle;
+  dut->i_cfg_lock_mode = kLockMode;
+  dut->i_cfg_lock_pi_kp_shift = kLockPiKpShift;
+  dut->i_cfg_lock_pi_ki_shift = kLockPiKiShift;
+  dut->i_cfg_lock_loss_ratio = kLockLossRatio;
+  dut->i_cfg_lock_loss_cnt = kLockLossCnt;
+  dut->i_cfg_lock_research_halfwidth = kLockResearchHalfwidth;
+  dut->i_cfg_search_detect_mode = kSearchDetectMode;
+  dut->i_cfg_search_detect_wait_cycle = kSearchDetectWaitCycle;
+  dut->i_cfg_search_detect_avg_shift = kSearchDetectAvgShift;
+  dut->i_cfg_search_detect_settle_tol = kSearchDetectSettleTol;
+  dut->i_cfg_lock_detect_mode = kLockDetectMode;
+  dut->i_cfg_lock_detect_wait_cycle = kLockDetectWaitCycle;
+  dut->i_cfg_lock_detect_avg_shift = kLockDetectAvgShift;
+  dut->i_cfg_lock_detect_settle_tol = kLockDetectSettleTol;
+  dut->i_pd_noise = 0.0;
+  dut->i_adc_offset = 0.0;
+  for (int k = 0; k < 256; ++k) {
+    dut->i_adc_inl[k] = 0.0;
+    dut->i_dac_inl[k] = 0.0;
+  }
+
+  // Stimulus at t = 0 during reset
+  replay.update(0);
+  dut->i_clk = 0;
+  tb.reset(dut->i_clk, dut->i_rst);
+
+  // Search under the replayed stimulus
+  dut->i_cfg_ring_tune_start = 0;
+  dut->i_cfg_ring_tune_end = 255;
+  dut->i_cfg_ring_tune_stride = 2;
+  dut->i_search_trig_val = 1;
+  advance_clk();
+  dut->i_search_trig_val = 0;
+  while (dut->o_search_state != 3 /*DONE*/) {
+    advance_clk();
+  }
+  dut->i_search_done_rdy = 1;
+  advance_clk();
+  const int peak_code = (int)dut->o_pwr_peak_tune_codes[0];
+  const int peak_pwr = (int)dut->o_pwr_peak_codes[0];
+  dut->i_search_done_rdy = 0;
+  std::cout << "Peak tune code: " << peak_code << " pwr: " << peak_pwr
+            << std::endl;
+
+  // Lock, then hold it for the rest of the capture
+  dut->i_cfg_ring_tune_start = peak_code;
+  dut->i_cfg_ring_tune_peak = peak_code;
+  dut->i_cfg_pwr_peak = peak_pwr;
+  dut->i_lock_trig_val = 1;
+  advance_clk();
+  dut->i_lock_trig_val = 0;
+  while (dut->o_lock_state != 2 /*ACTIVE*/) {
+    advance_clk();
+  }
+  std::cout << "Locked at " << tb.time_ps() << " ps" << std::endl;
+
+  // Keep the VCD to the bring-up; the replay itself goes to the monitor
+  tb.set_trace_enabled(false);
+  uint64_t cycles = 0;
+  uint64_t active_cycles = 0;
+  int reacquires = 0;
+  while (!replay.exhausted() && cycles < kMaxReplayCycles) {
+    const auto lock_state_prev = dut->o_lock_state;
+    advance_clk();
+    ++cycles;
+    active_cycles += (dut->o_lock_state == 2 /*ACTIVE*/);
+    if (dut->o_lock_state == 4 /*SEARCH*/ && lock_state_prev != 4) {
+      ++reacquires;
+      std::cout << "[" << replay.trace_time() << " s] lock lost, temp="
+                << replay.value("temp") << " pwr=" << replay.value("pwr")
+                << std::endl;
+    }
+  }
+  monitor.close();
+
+  std::cout << "Replayed " << replay.trace_time() << " s of "
+            << stimulus_file << " in " << cycles << " cycles ("
+            << replay.rows_read() << " rows read, " << replay.rows_skipped()
+            << " skipped)" << std::endl;
+  std::cout << "Lock held " << (100.0 * active_cycles / std::max<uint64_t>(
+                                                  cycles, 1))
+            << "% of cycles, " << reacquires << " re-acquires" << std::endl;
+
+  BenchMetrics metrics;
+  metrics.set("trace_time_s", replay.trace_time());
+  metrics.set("replay_cycles", cycles);
+  metrics.set("active_cycles", active_cycles);
+  metrics.set("lock_availability",
+              static_cast<double>(active_cycles) /
+                  std::max<uint64_t>(cycles, 1));
+  metrics.set("reacquires", reacquires);
+  metrics.set("exhausted", replay.exhausted());
+  metrics.write();
+
+  return replay.exhausted() ? 0 : 1;
+}
@@ -0,0 +1,801 @@
+#ifndef TUNER_SEARCH_LOCK_ROW_BENCH_HPP
+#define TUNER_SEARCH_LOCK_ROW_BENCH_HPP
+
+#include "Vsim.h"
+#include "models/afe_noise.hpp"
+#include "testbench/verilator_tb.hpp"
+#include "utils/async_writer.hpp"
+#include "utils/metrics.hpp"
+#include "utils/monitor_bin.hpp"
+#include "utils/options.hpp"
+#include "utils/profiler.hpp"
+#include "utils/scenario.hpp"
+#include "utils/sweep.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <csv2/writer.hpp>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+class SearchLockPhyMonitor {
+public:
+  typedef struct {
+    double time;
+    int tune_code;
+    double i_pwr;
+    double o_pwr_thru;
+    double o_pwr_drop;
+    int search_state_enum;
+    int lock_state_enum;
+  } search_lock_record_t;
+
+  typedef std::vector<int> peak_codes_t;
+  typedef async_writer::AsyncWriter<search_lock_record_t> bin_writer_t;
+
+  SearchLockPhyMonitor(Vsim *dut, int ring, int interval = 1)
+      : dut_(dut), ring_(ring), sample_interval_(interval) {}
+
+  void sample(vluint64_t time, bool force, bool print) {
+    static profiler::Phase phase("monitor.sample");
+    profiler::ScopedTimer timer(phase);
+    bool do_sample = force || ((interval_count_ % sample_interval_) == 0);
+
+    if (do_sample) {
+      search_lock_record_t r;
+      r.time = static_cast<double>(time);
+      r.tune_code = dut_->o_ring_tune[ring_];
+      r.i_pwr = dut_->i_pwr;
+      r.o_pwr_thru = dut_->o_pwr_thru;
+      r.o_pwr_drop = dut_->o_pwr_drop[ring_];
+      r.search_state_enum = dut_->o_search_state[ring_];
+      r.lock_state_enum = dut_->o_lock_state[ring_];
+      records_.push_back(r);
+      if (writer_) {
+        writer_->push(r);
+      } else if (bin_) {
+        append_bin(r);
+      }
+
+      if (print) {
+        static profiler::Phase print_phase("monitor.print");
+        profiler::ScopedTimer print_timer(print_phase);
+        std::cout << "[" << r.time << " ps] "
+                  << "Search State=" << search_state_string(r.search_state_enum)
+                  << " Lock State=" << lock_state_string(r.lock_state_enum)
+                  << " tune=" << r.tune_code << " i_pwr=" << r.i_pwr
+                  << " o_pwr_thru=" << r.o_pwr_thru
+                  << " o_pwr_drop=" << r.o_pwr_drop << "\n";
+      }
+
+      if (force) {
+        interval_count_ = 0;
+      }
+    }
+    interval_count_++;
+  }
+
+  void write_csv(const std::string &filename) const {
+    std::ofstream ofs(filename);
+    csv2::Writer<csv2::delimiter<','>> writer(ofs);
+
+    writer.write_row(csv_row_t{"time", "tune_code", "i_pwr", "o_pwr_thru",
+                               "o_pwr_drop", "search_state", "lock_state"});
+    for (auto &r : records_) {
+      writer.write_row(
+          csv_row_t{std::to_string(r.time), std::to_string(r.tune_code),
+                    std::to_string(r.i_pwr), std::to_string(r.o_pwr_thru),
+                    std::to_string(r.o_pwr_drop),
+                    search_state_string(r.search_state_enum),
+                    lock_state_string(r.lock_state_enum)});
+    }
+    ofs.close();
+  }
+
+  // Also stream every sample to a binary monitor for utils/plot_wave. With
+  // async, sample() only queues the record and a writer thread appends it.
+  void open_bin(const std::string &filename, bool async = false,
+                size_t queue_depth = size_t{1} << 16,
+                async_writer::backpressure_e policy =
+                    async_writer::backpressure_e::BLOCK) {
+    using monitor_bin::col_type_e;
+    std::vector<std::string> search_labels, lock_labels;
+    for (int s = 0; s <= 5; ++s)
+      search_labels.push_back(search_state_string(s));
+    for (int s = 0; s <= 4; ++s)
+      lock_labels.push_back(lock_state_string(s));
+    bin_ = std::make_unique<monitor_bin::MonitorBinWriter>();
+    bin_->add_column("time", col_type_e::F64);
+    bin_->add_column("tune_code", col_type_e::I32);
+    bin_->add_column("i_pwr", col_type_e::F64);
+    bin_->add_column("o_pwr_thru", col_type_e::F64);
+    bin_->add_column("o_pwr_drop", col_type_e::F64);
+    bin_->add_column("search_state", col_type_e::U8, search_labels);
+    bin_->add_column("lock_state", col_type_e::U8, lock_labels);
+    bin_->open(filename);
+    if (async) {
+      writer_ = std::make_unique<bin_writer_t>(
+          [this](const search_lock_record_t *r, size_t n) {
+            for (size_t i = 0; i < n; ++i)
+              append_bin(r[i]);
+          },
+          queue_depth, policy);
+    }
+  }
+
+  void close_bin() {
+    if (writer_) {
+      writer_->close();
+      bin_dropped_ = writer_->dropped();
+      writer_.reset();
+    }
+    if (bin_)
+      bin_->close();
+  }
+
+  // Samples the async writer discarded under drop backpressure
+  uint64_t bin_dropped() const { return bin_dropped_; }
+
+  void change_sample_interval(int new_interval) {
+    if (new_interval > 0) {
+      sample_interval_ = new_interval;
+      interval_count_ = 0;
+    } else {
+      std::cerr << "Invalid sample interval: " << new_interval
+                << ". Must be greater than 0." << std::endl;
+    }
+  }
+
+  const std::vector<search_lock_record_t> &records() const {
+    return records_;
+  }
+  std::vector<search_lock_record_t> take_records() {
+    return std::move(records_);
+  }
+
+  void record_peak(int peak_code) { peak_codes_.push_back(peak_code); }
+  int get_peak(int idx) {
+    if (idx < 0 || idx >= static_cast<int>(peak_codes_.size())) {
+      std::cerr << "Index out of bounds: " << idx
+                << ". Peak codes size: " << peak_codes_.size() << std::endl;
+      return -1; // or throw an exception
+    }
+    return peak_codes_[idx];
+  }
+
+private:
+  Vsim *dut_;
+  int ring_;
+  int sample_interval_;
+  int interval_count_ = 0;
+  std::vector<search_lock_record_t> records_;
+  peak_codes_t peak_codes_;
+  std::unique_ptr<monitor_bin::MonitorBinWriter> bin_;
+  std::unique_ptr<bin_writer_t> writer_;
+  uint64_t bin_dropped_ = 0;
+
+  void append_bin(const search_lock_record_t &r) {
+    bin_->append(r.time, r.tune_code, r.i_pwr, r.o_pwr_thru, r.o_pwr_drop,
+                 r.search_state_enum, r.lock_state_enum);
+  }
+
+  static std::string search_state_string(int state_enum) {
+    switch (state_enum) {
+    case 0:
+      return "IDLE";
+    case 1:
+      return "INIT";
+    case 2:
+      return "ACTIVE";
+    case 3:
+      return "DONE";
+    case 4:
+      return "ERROR";
+    case 5:
+      return "INTR";
+    default:
+      return "UNKNOWN";
+    }
+  }
+
+  static std::string lock_state_string(int state_enum) {
+    switch (state_enum) {
+    case 0:
+      return "IDLE";
+    case 1:
+      return "INIT";
+    case 2:
+      return "ACTIVE";
+    case 3:
+      return "INTR";
+    case 4:
+      return "SEARCH";
+    default:
+      return "UNKNOWN";
+    }
+  }
+};
+
+typedef SearchLockPhyMonitor::search_lock_record_t search_lock_record_t;
+
+// Result of one search + lock scenario on the two-ring row
+struct SearchLockRowRun {
+  static constexpr size_t kNumRings = 2;
+  // Every monitor sample per ring, as recorded by SearchLockPhyMonitor
+  std::array<std::vector<search_lock_record_t>, kNumRings> records;
+  BenchMetrics metrics;
+  int num_locked = 0;
+};
+
+// Read every knob from opts and run one scenario. Shared by tb.cpp and the
+// in-process Python module (py.cpp). With write_files off the run leaves no
+// files behind: no VCD, monitors, tb_config.toml, manifest or metrics.toml.
+inline SearchLockRowRun run_search_lock_row(options::Options &opts,
+                                            std::ostream &log,
+                                            bool write_files, int argc,
+                                            char **argv) {
+  constexpr size_t kNumRings = SearchLockRowRun::kNumRings;
+  SearchLockRowRun run;
+  const auto kLockTuneStride =
+      opts.get_array<int, kNumRings>("lock_tune_stride", {0, 0});
+  const auto kLockPwrDeltaThres =
+      opts.get_array<int, kNumRings>("lock_pwr_delta_thres", {2, 2});
+  const auto kSyncCycle = opts.get_array<int, kNumRings>("sync_cycle", {4, 4});
+  // Sync-cycle calibration: sync_cycle becomes the ceiling for a count
+  // measured by stepping the DAC sync_cal_step codes away and back
+  const auto kSyncCalEn = opts.get_array<int, kNumRings>("sync_cal_en", {0, 0});
+  const auto kSyncCalStep =
+      opts.get_array<int, kNumRings>("sync_cal_step", {16, 16});
+  const auto kSyncCalTol =
+      opts.get_array<int, kNumRings>("sync_cal_tol", {1, 1});
+  const auto kSyncCalMargin =
+      opts.get_array<int, kNumRings>("sync_cal_margin", {0, 0});
+  const auto kSyncCalPeriod =
+      opts.get_array<int, kNumRings>("sync_cal_period", {0, 0});
+  // 0: LOCK_MODE_SLOPE, 1: LOCK_MODE_PI
+  const auto kLockMode = opts.get_array<int, kNumRings>("lock_mode", {0, 0});
+  const auto kLockPiKpShift =
+      opts.get_array<int, kNumRings>("lock_pi_kp_shift", {5, 5});
+  const auto kLockPiKiShift =
+      opts.get_array<int, kNumRings>("lock_pi_ki_shift", {5, 5});
+  const auto kLockLossRatio =
+      opts.get_array<int, kNumRings>("lock_loss_ratio", {4, 4});
+  const auto kLockLossCnt =
+      opts.get_array<int, kNumRings>("lock_loss_cnt", {4, 4});
+  const auto kLockResearchHalfwidth =
+      opts.get_array<int, kNumRings>("lock_research_halfwidth", {16, 16});
+  const auto kSearchDetectMode =
+      opts.get_array<int, kNumRings>("search_detect_mode", {0, 0});
+  const auto kSearchDetectWaitCycle =
+      opts.get_array<int, kNumRings>("search_detect_wait_cycle", {4, 4});
+  const auto kSearchDetectAvgShift =
+      opts.get_array<int, kNumRings>("search_detect_avg_shift", {0, 0});
+  const auto kSearchDetectSettleTol =
+      opts.get_array<int, kNumRings>("search_detect_settle_tol", 0);
+  const auto kLockDetectMode =
+      opts.get_array<int, kNumRings>("lock_detect_mode", {0, 0});
+  const auto kLockDetectWaitCycle =
+      opts.get_array<int, kNumRings>("lock_detect_wait_cycle", {4, 4});
+  const auto kLockDetectAvgShift =
+      opts.get_array<int, kNumRings>("lock_detect_avg_shift", {0, 0});
+  const auto kLockDetectSettleTol =
+      opts.get_array<int, kNumRings>("lock_detect_settle_tol", {0, 0});
+  std::array<int, kNumRings> peak_pwr{};
+  std::array<int, kNumRings> num_peaks{};
+  std::array<bool, kNumRings> locked{};
+  std::array<int, kNumRings> lock_tune{};
+  std::array<double, kNumRings> lock_pwr_drop{};
+  std::array<vluint64_t, kNumRings> lock_time{};
+  std::array<int, kNumRings> lock_tune_ripple{};
+  std::array<double, kNumRings> lock_pwr_ripple{};
+  // Ripple is NaN unless the row re-locked inside row_track_cycles
+  bool row_locked = false;
+  bool row_relocked = false;
+  int row_relock_cycles = -1;
+  double row_tune_ripple = std::numeric_limits<double>::quiet_NaN();
+  double row_pwr_ripple = std::numeric_limits<double>::quiet_NaN();
+  // AFE nonidealities (all zero is the ideal AFE). PD noise is given in ADC
+  // LSB and scaled to o_real_current units with the drop ADC full scale.
+  const uint64_t kNoiseSeed = opts.get<uint64_t>("noise_seed", 1);
+  constexpr double kAdcFullScale = 1000.0;
+  const double kPdWhiteLsb = opts.get<double>("pd_white_lsb", 0.0);
+  const double kPdPinkLsb = opts.get<double>("pd_pink_lsb", 0.0);
+  const double kAdcOffsetLsb = opts.get<double>("adc_offset_lsb", 0.0);
+  const double kAdcDnlSigma = opts.get<double>("adc_dnl_sigma", 0.0);
+  const double kDacBowLsb = opts.get<double>("dac_bow_lsb", 0.0);
+  const double kDacDnlSigma = opts.get<double>("dac_dnl_sigma", 0.0);
+  // Heater thermal time constant in cycles (0 is the instantaneous DAC ->
+  // ring path) and neighbour drive coupling (heater.sv)
+  const double kHeaterTauCycles = opts.get<double>("heater_tau_cycles", 0.0);
+  const double kHeaterCoupling = opts.get<double>("heater_coupling", 0.0);
+  // Row feedforward (tuner_row_ff.sv): integrate the mean lock correction
+  // into a common offset at 2^-ff_cm_shift per cycle, and subtract
+  // ff_xtalk[i*N+j]/256 of ring j's code from ring i
+  const bool kFfCmEn = opts.get<bool>("ff_cm_en", false);
+  const int kFfCmShift = opts.get<int>("ff_cm_shift", 8);
+  const auto kFfXtalk =
+      opts.get_array<int, kNumRings * kNumRings>("ff_xtalk", 0);
+  // Lock start offset from the found peak, and the least cycles to run the
+  // lock after its trigger
+  const auto kLockOffset =
+      opts.get_array<int, kNumRings>("lock_offset", {-20, 20});
+  const int kLockDwellCycles = opts.get<int>("lock_dwell_cycles", 10000);
+  // A ring is locked once, in LOCK_ACTIVE, its tune code stays within
+  // lock_settle_tol codes of where it entered that band for
+  // lock_settle_cycles. The time to lock runs from the trigger to the band
+  // entry.
+  const int kLockSettleTol = opts.get<int>("lock_settle_tol", 2);
+  const int kLockSettleCycles = opts.get<int>("lock_settle_cycles", 2000);
+  // Give up when the time to lock exceeds this many cycles (a failed
+  // scenario)
+  const int kLockTimeoutCycles = opts.get<int>("lock_timeout_cycles", 1000000);
+  // Tracking window after LOCK_ACTIVE over which the tune code and drop
+  // power ripple are measured (0 skips it)
+  const int kLockTrackCycles = opts.get<int>("lock_track_cycles", 0);
+  // Row phase after the per-ring locks: lock every ring at once, shift all
+  // resonances by row_thermal_kick, and measure the re-lock time (drop power
+  // back within row_relock_tol of its pre-kick mean on every ring) and the
+  // ripple after it over row_track_cycles (0 skips the phase)
+  const int kRowTrackCycles = opts.get<int>("row_track_cycles", 0);
+  const double kRowThermalKick = opts.get<double>("row_thermal_kick", 0.2);
+  const double kRowRelockTol = opts.get<double>("row_relock_tol", 0.1);
+  const auto kRingPwrPeakRatio =
+      opts.get_array<int, kNumRings>("ring_pwr_peak_ratio", {8, 8});
+  // Binary monitor appends on a background writer thread, with "block" or
+  // "drop" backpressure when its queue of monitor_queue_depth samples fills
+  const bool kMonitorAsync = opts.get<bool>("monitor_async", false);
+  const int kMonitorQueueDepth = opts.get<int>("monitor_queue_depth", 65536);
+  const auto kMonitorBackpressure = async_writer::parse_backpressure(
+      opts.get<std::string>("monitor_backpressure", "block"));
+  // Full-range sweep stride (log2 of the code step). Fit mode estimates
+  // each resonance from three samples, so it can sweep with a larger stride.
+  const int kSearchStride = opts.get<int>("search_stride", 2);
+  const auto kSearchFitMode =
+      opts.get_array<int, kNumRings>("search_fit_mode", {0, 0});
+  // Scenario: laser grid, ring fabrication offsets and FWHM/tuning-range
+  // spread, drawn per scenario index (all zero spread is the nominal row).
+  // Distributions are "const(v)", "uniform(lo,hi)" or "normal(mean,sigma)".
+  const uint64_t scenario_seed = opts.get<uint64_t>("scenario_seed", 1);
+  const uint64_t scenario_index = opts.get<uint64_t>("scenario_index", 0);
+  scenario::ScenarioConfig scenario_cfg;
+  scenario_cfg.num_lasers = 2;
+  scenario_cfg.num_rings = kNumRings;
+  scenario_cfg.laser_wvl_start = opts.get<double>("laser_wvl_start", 1300.0);
+  scenario_cfg.laser_spacing = opts.get<double>("laser_spacing", 2.0);
+  scenario_cfg.laser_grid_offset = scenario::Dist::parse(
+      opts.get<std::string>("laser_grid_offset", "const(0)"));
+  scenario_cfg.laser_wvl_error = scenario::Dist::parse(
+      opts.get<std::string>("laser_wvl_error", "const(0)"));
+  scenario_cfg.laser_pwr =
+      scenario::Dist::parse(opts.get<std::string>("laser_pwr", "const(1000)"));
+  scenario_cfg.ring_wvl_start = opts.get<double>("ring_wvl_start", 1295.0);
+  scenario_cfg.ring_spacing = opts.get<double>("ring_spacing", 3.0);
+  scenario_cfg.ring_fab_offset = scenario::Dist::parse(
+      opts.get<std::string>("ring_fab_offset", "const(0)"));
+  scenario_cfg.fwhm_scale =
+      scenario::Dist::parse(opts.get<std::string>("fwhm_scale", "const(1)"));
+  scenario_cfg.tune_scale =
+      scenario::Dist::parse(opts.get<std::string>("tune_scale", "const(1)"));
+  opts.check_unused();
+  const scenario::ScenarioGenerator scenario_gen(scenario_cfg, scenario_seed);
+  const scenario::Scenario scn = scenario_gen.generate(scenario_index);
+  if (write_files) {
+    opts.write_effective("tb_config.toml");
+    scenario_gen.write_manifest("scenario_manifest.csv", scenario_index,
+                                scenario_index + 1);
+  }
+
+  VerilatorTb<Vsim> tb(argc, argv, write_files ? "waveform.vcd" : "");
+  auto *dut = tb.dut();
+
+  std::array<SearchLockPhyMonitor, kNumRings> monitor{
+      SearchLockPhyMonitor(dut, 0, 8), SearchLockPhyMonitor(dut, 1, 8)};
+  for (size_t r = 0; r < kNumRings && write_files; ++r) {
+    monitor[r].open_bin("search_lock_waveform_ring" + std::to_string(r) +
+                            ".swm",
+                        kMonitorAsync, kMonitorQueueDepth,
+                        kMonitorBackpressure);
+  }
+
+  /*auto advance_clk = [&](size_t ring) {
+   *  auto search_state_prev = dut->o_search_state[ring];
+   *  auto lock_state_prev = dut->o_lock_state[ring];
+   *  advance_half_clk();
+   *  advance_half_clk();
+   *  tfp->dump(main_time);
+   *  bool force_sample = (dut->o_search_state[ring] != search_state_prev) ||
+   *                      (dut->o_lock_state[ring] != lock_state_prev);
+   *  monitor[ring].sample(main_time, force_sample, true);
+   *};*/
+
+  afe_noise::AfeNoiseConfig noise_cfg;
+  noise_cfg.seed = kNoiseSeed;
+  noise_cfg.pd.white_sigma = kPdWhiteLsb * kAdcFullScale / 255.0;
+  noise_cfg.pd.pink_sigma = kPdPinkLsb * kAdcFullScale / 255.0;
+  noise_cfg.adc_offset_lsb = kAdcOffsetLsb;
+  noise_cfg.adc_dnl_sigma = kAdcDnlSigma;
+  noise_cfg.dac_bow_lsb = kDacBowLsb;
+  noise_cfg.dac_dnl_sigma = kDacDnlSigma;
+  // One independent stream per ring
+  std::vector<afe_noise::AfeNoise<8, 8>> afe;
+  for (size_t r = 0; r < kNumRings; ++r) {
+    afe.emplace_back(noise_cfg, static_cast<uint32_t>(r));
+  }
+
+  auto advance_clk = [&]() {
+    for (size_t r = 0; r < kNumRings; ++r) {
+      dut->i_pd_noise[r] = afe[r].pd.next();
+    }
+    tb.step_clk(dut->i_clk);
+    for (size_t ring = 0; ring < kNumRings; ++ring) {
+      monitor[ring].sample(tb.time_ps(), false, false);
+    }
+  };
+
+  auto search_routine = [&](size_t ring, int start, int end, int stride = 1,
+                            bool print = true) {
+    assert(end >= start &&
+           "search_routine: end must be greater than or equal to start");
+    dut->i_cfg_ring_tune_start[ring] = start;
+    dut->i_cfg_ring_tune_end[ring] = end;
+    dut->i_cfg_ring_tune_stride[ring] = stride;
+    dut->i_search_trig_val[ring] = 1;
+    advance_clk();
+    dut->i_search_trig_val[ring] = 0;
+
+    /*while (dut->o_search_state[ring] != 3) {
+     *  advance_clk();
+     *}
+     *dut->i_search_done_rdy[ring] = 1;
+     *advance_clk();*/
+
+    while (!dut->o_search_done_val[ring]) {
+      advance_clk();
+    }
+
+    monitor[ring].change_sample_interval(2);
+    advance_clk();
+    dut->i_search_done_rdy[ring] = 1;
+    advance_clk();
+
+    // save the first peak code
+    log << "First peak tune code: " << (int)dut->o_pwr_peak_tune_codes[ring][0]
+        << std::endl;
+    log << "Number of peaks: " << (int)dut->o_num_peaks[ring] << std::endl;
+    monitor[ring].record_peak((int)dut->o_pwr_peak_tune_codes[ring][0]);
+    peak_pwr[ring] = (int)dut->o_pwr_peak_codes[ring][0];
+    num_peaks[ring] = (int)dut->o_num_peaks[ring];
+
+    dut->i_search_done_rdy[ring] = 0;
+
+    if (print) {
+      log << "Ring " << ring
+          << " search complete, peaks: " << (int)dut->o_num_peaks[ring]
+          << std::endl;
+      for (int i = 0; i < (int)dut->o_num_peaks[ring]; ++i) {
+        log << "Peak[" << i
+            << "] Code: " << (int)dut->o_pwr_peak_tune_codes[ring][i]
+            << " Pwr: " << (int)dut->o_pwr_peak_codes[ring][i] << std::endl;
+      }
+    }
+  };
+
+  auto lock_routine = [&](size_t ring, bool print = true) {
+    dut->i_lock_trig_val[ring] = 1;
+
+    dut->i_cfg_ring_tune_start[ring] =
+        monitor[ring].get_peak(0) + kLockOffset[ring];
+    dut->i_cfg_ring_tune_peak[ring] = monitor[ring].get_peak(0);
+    dut->i_cfg_pwr_peak[ring] = peak_pwr[ring];
+    const vluint64_t trig_time = tb.time_ps();
+    advance_clk();
+    dut->i_lock_trig_val[ring] = 0;
+
+    // Convergence, not LOCK_ACTIVE entry (two cycles after the trigger)
+    /*while (dut->o_lock_state[ring] != LOCK_ACTIVE) {*/
+    int band = -1; // tune code at band entry, -1 outside LOCK_ACTIVE
+    int band_cycle = 0;
+    vluint64_t band_time = 0;
+    bool settled = false;
+    for (int i = 0; !settled || i < kLockDwellCycles; ++i) {
+      if (!settled) {
+        const int tune = dut->o_ring_tune[ring];
+        if (dut->o_lock_state[ring] != 2) {
+          band = -1;
+        } else if (band < 0 || std::abs(tune - band) > kLockSettleTol) {
+          band = tune;
+          band_cycle = i;
+          band_time = tb.time_ps();
+        }
+        if ((band < 0 ? i : band_cycle) > kLockTimeoutCycles) {
+          std::cerr << "Ring " << ring << " did not lock" << std::endl;
+          return;
+        }
+        settled = band >= 0 && i - band_cycle >= kLockSettleCycles;
+      }
+      advance_clk();
+    }
+    locked[ring] = true;
+    lock_tune[ring] = dut->o_ring_tune[ring];
+    lock_pwr_drop[ring] = dut->o_pwr_drop[ring];
+    lock_time[ring] = band_time - trig_time;
+
+    // Tune code peak-to-peak and RMS drop power deviation while tracking
+    int tune_min = dut->o_ring_tune[ring], tune_max = tune_min;
+    double pwr_sum = 0.0, pwr_sq_sum = 0.0;
+    for (int i = 0; i < kLockTrackCycles; ++i) {
+      advance_clk();
+      tune_min = std::min<int>(tune_min, dut->o_ring_tune[ring]);
+      tune_max = std::max<int>(tune_max, dut->o_ring_tune[ring]);
+      pwr_sum += dut->o_pwr_drop[ring];
+      pwr_sq_sum += dut->o_pwr_drop[ring] * dut->o_pwr_drop[ring];
+    }
+    if (kLockTrackCycles > 0) {
+      const double mean = pwr_sum / kLockTrackCycles;
+      lock_tune_ripple[ring] = tune_max - tune_min;
+      lock_pwr_ripple[ring] =
+          std::sqrt(std::max(0.0, pwr_sq_sum / kLockTrackCycles - mean * mean));
+    }
+
+    dut->i_lock_intr_rdy[ring] = 0;
+    advance_clk();
+    dut->i_lock_intr_rdy[ring] = 1;
+
+    /*while (dut->o_lock_state[ring] != LOCK_INTR) {*/
+    while (dut->o_lock_state[ring] != 3) {
+      advance_clk();
+    }
+
+    for (int i = 0; i < 10; ++i) {
+      advance_clk();
+    }
+    /*    dut->i_lock_resume_val[ring] = 1;
+     *    dut->i_cfg_ring_tune_start[ring] =
+     *        monitor[ring].get_peak(0) + 20; // offset by +20
+     *    advance_clk();
+     *    dut->i_lock_resume_val[ring] = 0;
+     *    dut->i_lock_trig_val[ring] = 1;
+     *    advance_clk();
+     *
+     *    for (int i = 0; i < 1000; ++i) {
+     *      advance_clk();
+     *    }
+     *
+     *    dut->i_lock_resume_val[ring] = 1;
+     *    dut->i_cfg_ring_tune_start[ring] = 100;*/
+    dut->i_lock_trig_val[ring] = 0;
+    advance_clk();
+    dut->i_lock_resume_val[ring] = 0;
+    advance_clk();
+  };
+
+  /*dut->i_pwr = 1.0;*/
+  /* Need to solve this problem -- 1.0 then 2nd ring fails. SV model ignores
+   * small numbers */
+  dut->i_pwr = scn.laser_pwr;
+  for (size_t i = 0; i < scn.laser_wvl.size(); ++i) {
+    dut->i_wvl_ls[i] = scn.laser_wvl[i];
+  }
+  dut->i_heater_tau = kHeaterTauCycles;
+  dut->i_heater_coupling = kHeaterCoupling;
+  dut->i_cfg_ff_cm_en = kFfCmEn;
+  dut->i_cfg_ff_cm_shift = kFfCmShift;
+  for (size_t i = 0; i < kNumRings; ++i) {
+    for (size_t j = 0; j < kNumRings; ++j) {
+      dut->i_cfg_ff_xtalk[i][j] = kFfXtalk[i * kNumRings + j];
+    }
+  }
+  for (size_t i = 0; i < kNumRings; ++i) {
+    dut->i_wvl_ring[i] = scn.ring_wvl[i];
+    dut->i_fwhm_scale[i] = scn.fwhm_scale[i];
+    dut->i_tune_scale[i] = scn.tune_scale[i];
+  }
+  log << "Scenario " << scenario_index << " (seed " << scenario_seed << ")"
+      << std::endl;
+
+  for (size_t r = 0; r < kNumRings; ++r) {
+    dut->i_search_trig_val[r] = 0;
+    dut->i_search_done_rdy[r] = 0;
+    dut->i_lock_trig_val[r] = 0;
+    dut->i_lock_intr_rdy[r] = 1;
+    dut->i_lock_resume_val[r] = 0;
+    dut->i_cfg_ring_pwr_peak_ratio[r] = kRingPwrPeakRatio[r];
+    dut->i_cfg_lock_tune_stride[r] = kLockTuneStride[r];
+    dut->i_cfg_lock_pwr_delta_thres[r] = kLockPwrDeltaThres[r];
+    dut->i_cfg_sync_cycle[r] = kSyncCycle[r];
+    dut->i_cfg_sync_cal_en[r] = kSyncCalEn[r];
+    dut->i_cfg_sync_cal_step[r] = kSyncCalStep[r];
+    dut->i_cfg_sync_cal_tol[r] = kSyncCalTol[r];
+    dut->i_cfg_sync_cal_margin[r] = kSyncCalMargin[r];
+    dut->i_cfg_sync_cal_period[r] = kSyncCalPeriod[r];
+    dut->i_cfg_search_fit_mode[r] = kSearchFitMode[r];
+    dut->i_cfg_lock_mode[r] = kLockMode[r];
+    dut->i_cfg_lock_pi_kp_shift[r] = kLockPiKpShift[r];
+    dut->i_cfg_lock_pi_ki_shift[r] = kLockPiKiShift[r];
+    dut->i_cfg_lock_loss_ratio[r] = kLockLossRatio[r];
+    dut->i_cfg_lock_loss_cnt[r] = kLockLossCnt[r];
+    dut->i_cfg_lock_research_halfwidth[r] = kLockResearchHalfwidth[r];
+    dut->i_cfg_search_detect_mode[r] = kSearchDetectMode[r];
+    dut->i_cfg_search_detect_wait_cycle[r] = kSearchDetectWaitCycle[r];
+    dut->i_cfg_search_detect_avg_shift[r] = kSearchDetectAvgShift[r];
+    dut->i_cfg_search_detect_settle_tol[r] = kSearchDetectSettleTol[r];
+    dut->i_cfg_lock_detect_mode[r] = kLockDetectMode[r];
+    dut->i_cfg_lock_detect_wait_cycle[r] = kLockDetectWaitCycle[r];
+    dut->i_cfg_lock_detect_avg_shift[r] = kLockDetectAvgShift[r];
+    dut->i_cfg_lock_detect_settle_tol[r] = kLockDetectSettleTol[r];
+  }
+
+  for (size_t r = 0; r < kNumRings; ++r) {
+    dut->i_adc_offset[r] = afe[r].adc.offset_lsb();
+    afe_noise::load_table(dut->i_adc_inl[r], afe[r].adc.inl_table());
+    afe_noise::load_table(dut->i_dac_inl[r], afe[r].dac.inl_table());
+  }
+
+  dut->i_clk = 0;
+  tb.reset(dut->i_clk, dut->i_rst);
+
+  for (size_t ring = 0; ring < kNumRings; ++ring) {
+    log << "--- Ring " << ring << " ---" << std::endl;
+    search_routine(ring, 0, 255, kSearchStride, false);
+    /*search_routine(ring, 100, 200, 2, true);*/
+  }
+
+  for (size_t ring = 0; ring < kNumRings; ++ring) {
+    log << "--- Ring " << ring << " ---" << std::endl;
+    lock_routine(ring, true);
+    /*search_routine(ring, 100, 200, 2, true);*/
+  }
+
+  // o_ff_cm is DAC_WIDTH + 1 bits, two's complement
+  auto ff_cm = [&]() {
+    const int v = dut->o_ff_cm & 0x1ff;
+    return v >= 0x100 ? v - 0x200 : v;
+  };
+
+  auto row_routine = [&]() {
+    // Release every ring from LOCK_INTR, then lock them all at once
+    for (size_t r = 0; r < kNumRings; ++r) {
+      dut->i_lock_resume_val[r] = 1;
+    }
+    advance_clk();
+    for (size_t r = 0; r < kNumRings; ++r) {
+      dut->i_lock_resume_val[r] = 0;
+      dut->i_lock_trig_val[r] = 1;
+      dut->i_cfg_ring_tune_start[r] = monitor[r].get_peak(0) + kLockOffset[r];
+      dut->i_cfg_ring_tune_peak[r] = monitor[r].get_peak(0);
+      dut->i_cfg_pwr_peak[r] = peak_pwr[r];
+    }
+    advance_clk();
+    for (size_t r = 0; r < kNumRings; ++r) {
+      dut->i_lock_trig_val[r] = 0;
+    }
+    auto all_active = [&]() {
+      for (size_t r = 0; r < kNumRings; ++r) {
+        if (dut->o_lock_state[r] != 2)
+          return false;
+      }
+      return true;
+    };
+    for (int i = 0; !all_active(); ++i) {
+      if (i == kLockTimeoutCycles) {
+        std::cerr << "Row did not lock" << std::endl;
+        return;
+      }
+      advance_clk();
+    }
+    row_locked = true;
+    for (int i = 0; i < kLockDwellCycles; ++i) {
+      advance_clk();
+    }
+
+    std::array<double, kNumRings> pwr_base{};
+    for (int i = 0; i < kRowTrackCycles; ++i) {
+      advance_clk();
+      for (size_t r = 0; r < kNumRings; ++r) {
+        pwr_base[r] += dut->o_pwr_drop[r] / kRowTrackCycles;
+      }
+    }
+
+    // Common-mode thermal step on every ring
+    for (size_t r = 0; r < kNumRings; ++r) {
+      dut->i_wvl_ring[r] = scn.ring_wvl[r] + kRowThermalKick;
+    }
+    std::vector<std::array<int, kNumRings>> tune(kRowTrackCycles);
+    std::vector<std::array<double, kNumRings>> pwr(kRowTrackCycles);
+    int last_out = -1;
+    for (int i = 0; i < kRowTrackCycles; ++i) {
+      advance_clk();
+      for (size_t r = 0; r < kNumRings; ++r) {
+        tune[i][r] = dut->o_ring_tune[r];
+        pwr[i][r] = dut->o_pwr_drop[r];
+        if (std::fabs(pwr[i][r] - pwr_base[r]) > kRowRelockTol * pwr_base[r])
+          last_out = i;
+      }
+    }
+    // Still outside the tolerance on the last cycle: no re-lock, and no
+    // window to measure the ripple over
+    if (last_out + 1 >= kRowTrackCycles) {
+      log << "Row did not re-lock after " << kRowThermalKick << " nm kick"
+          << std::endl;
+      return;
+    }
+    row_relocked = true;
+    row_relock_cycles = last_out + 1;
+
+    // Ripple over the tracking window after re-lock
+    const int n = kRowTrackCycles - row_relock_cycles;
+    row_tune_ripple = 0.0;
+    row_pwr_ripple = 0.0;
+    for (size_t r = 0; r < kNumRings; ++r) {
+      int tune_min = tune[row_relock_cycles][r], tune_max = tune_min;
+      double sq_sum = 0.0;
+      for (int i = row_relock_cycles; i < kRowTrackCycles; ++i) {
+        tune_min = std::min(tune_min, tune[i][r]);
+        tune_max = std::max(tune_max, tune[i][r]);
+        sq_sum += (pwr[i][r] - pwr_base[r]) * (pwr[i][r] - pwr_base[r]);
+      }
+      row_tune_ripple =
+          std::max(row_tune_ripple, static_cast<double>(tune_max - tune_min));
+      row_pwr_ripple += std::sqrt(sq_sum / n) / kNumRings;
+    }
+    log << "Row re-lock after " << kRowThermalKick << " nm kick: "
+        << row_relock_cycles << " cycles, ff_cm "
+        << ff_cm() << std::endl;
+  };
+
+  if (kRowTrackCycles > 0) {
+    log << "--- Row ---" << std::endl;
+    row_routine();
+  }
+
+  for (size_t r = 0; r < kNumRings; ++r) {
+    if (write_files) {
+      monitor[r].write_csv("search_lock_waveform_ring" + std::to_string(r) +
+                           ".csv");
+      monitor[r].close_bin();
+    }
+    run.records[r] = monitor[r].take_records();
+  }
+
+  // Per-ring results for utils/sweep_run
+  BenchMetrics &metrics = run.metrics;
+  metrics.set("scenario_index", scenario_index);
+  int num_locked = 0;
+  for (size_t r = 0; r < kNumRings; ++r) {
+    const std::string ring = "ring" + std::to_string(r) + ".";
+    metrics.set(ring + "num_peaks", num_peaks[r]);
+    metrics.set(ring + "peak_code", monitor[r].get_peak(0));
+    metrics.set(ring + "peak_pwr", peak_pwr[r]);
+    metrics.set(ring + "locked", locked[r]);
+    metrics.set(ring + "lock_tune", lock_tune[r]);
+    metrics.set(ring + "lock_pwr_drop", lock_pwr_drop[r]);
+    metrics.set(ring + "lock_time_ps", lock_time[r]);
+    metrics.set(ring + "lock_tune_ripple", lock_tune_ripple[r]);
+    metrics.set(ring + "lock_pwr_ripple", lock_pwr_ripple[r]);
+    metrics.set(ring + "monitor_dropped", monitor[r].bin_dropped());
+    metrics.set(ring + "sync_cal_cycle",
+                static_cast<int>(dut->o_sync_cal_cycle[r]));
+    num_locked += locked[r];
+  }
+  metrics.set("num_locked", num_locked);
+  if (kRowTrackCycles > 0) {
+    metrics.set("row.locked", row_locked);
+    metrics.set("row.relocked", row_relocked);
+    metrics.set("row.relock_cycles", row_relock_cycles);
+    metrics.set("row.tune_ripple", row_tune_ripple);
+    metrics.set("row.pwr_ripple", row_pwr_ripple);
+    metrics.set("row.ff_cm", ff_cm());
+  }
+  if (write_files)
+    metrics.write();
+  run.num_locked = num_locked;
+  return run;
+}
+
+#endif // TUNER_SEARCH_LOCK_ROW_BENCH_HPP
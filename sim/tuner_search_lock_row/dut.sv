@@ -18,7 +18,9 @@ module dut #(
     parameter int NUM_WAVES    = 2,
     parameter int NUM_CHANNEL  = 2,
     parameter int LOCK_DELTA_WINDOW_SIZE = 2,
-    parameter int MAX_SYNC_CYCLE = 16
+    parameter int MAX_SYNC_CYCLE = 16,
+    parameter int MAX_WAIT_CYCLE = 16,
+    parameter int MAX_NUM_PWR_DETECT = 16
 ) (
     input var logic i_clk,
     input var logic i_rst,
@@ -27,19 +29,44 @@ module dut #(
     input var real i_pwr,
     input var real i_wvl_ls  [NUM_WAVES],
     input var real i_wvl_ring[NUM_CHANNEL],
+    // Per-ring FWHM / TuningFullScale variation (nominal 1.0)
+    input var real i_fwhm_scale[NUM_CHANNEL],
+    input var real i_tune_scale[NUM_CHANNEL],
 
     // Config Inputs for Search/Lock
     input var logic [DAC_WIDTH-1:0] i_cfg_ring_tune_start[NUM_CHANNEL],
     input var logic [DAC_WIDTH-1:0] i_cfg_ring_tune_end[NUM_CHANNEL],
     input var logic [$clog2(DAC_WIDTH)-1:0] i_cfg_ring_tune_stride[NUM_CHANNEL],
+    input var logic i_cfg_search_fit_mode[NUM_CHANNEL],
     input var logic [$clog2(DAC_WIDTH)-1:0] i_cfg_lock_tune_stride[NUM_CHANNEL],
     input var logic [$clog2(MAX_SYNC_CYCLE + 1)-1:0] i_cfg_sync_cycle[NUM_CHANNEL],
+    input var logic i_cfg_sync_cal_en[NUM_CHANNEL],
+    input var logic [DAC_WIDTH-1:0] i_cfg_sync_cal_step[NUM_CHANNEL],
+    input var logic [3:0] i_cfg_sync_cal_tol[NUM_CHANNEL],
+    input var logic [1:0] i_cfg_sync_cal_margin[NUM_CHANNEL],
+    input var logic [15:0] i_cfg_sync_cal_period[NUM_CHANNEL],
     input var logic [$clog2(LOCK_DELTA_WINDOW_SIZE + 1)-1:0]
         i_cfg_lock_pwr_delta_thres[NUM_CHANNEL],
+    input var logic i_cfg_lock_mode[NUM_CHANNEL],
+    input var logic [$clog2(ADC_WIDTH)-1:0] i_cfg_lock_pi_kp_shift[NUM_CHANNEL],
+    input var logic [$clog2(ADC_WIDTH)-1:0] i_cfg_lock_pi_ki_shift[NUM_CHANNEL],
     input var logic [3:0] i_cfg_ring_pwr_peak_ratio[NUM_CHANNEL],
+    input var logic [3:0] i_cfg_lock_loss_ratio[NUM_CHANNEL],
+    input var logic [3:0] i_cfg_lock_loss_cnt[NUM_CHANNEL],
+    input var logic [DAC_WIDTH-1:0] i_cfg_lock_research_halfwidth[NUM_CHANNEL],
     input var logic [ADC_WIDTH-1:0] i_cfg_pwr_peak[NUM_CHANNEL],
     input var logic [DAC_WIDTH-1:0] i_cfg_ring_tune_peak[NUM_CHANNEL],
 
+    // Power Detect Config per requesting PHY
+    input var logic i_cfg_search_detect_mode[NUM_CHANNEL],
+    input var logic [$clog2(MAX_WAIT_CYCLE + 1)-1:0] i_cfg_search_detect_wait_cycle[NUM_CHANNEL],
+    input var logic [$clog2($clog2(MAX_NUM_PWR_DETECT) + 1)-1:0] i_cfg_search_detect_avg_shift[NUM_CHANNEL],
+    input var logic [3:0] i_cfg_search_detect_settle_tol[NUM_CHANNEL],
+    input var logic i_cfg_lock_detect_mode[NUM_CHANNEL],
+    input var logic [$clog2(MAX_WAIT_CYCLE + 1)-1:0] i_cfg_lock_detect_wait_cycle[NUM_CHANNEL],
+    input var logic [$clog2($clog2(MAX_NUM_PWR_DETECT) + 1)-1:0] i_cfg_lock_detect_avg_shift[NUM_CHANNEL],
+    input var logic [3:0] i_cfg_lock_detect_settle_tol[NUM_CHANNEL],
+
     // Search Interface
     input var logic i_search_trig_val[NUM_CHANNEL],
     output var logic o_search_trig_rdy[NUM_CHANNEL],
@@ -57,6 +84,23 @@ module dut #(
     input var  logic i_lock_resume_val[NUM_CHANNEL],
     output var logic o_lock_resume_rdy[NUM_CHANNEL],
 
+    // AFE nonideality injection (lib/cpp/models/afe_noise.hpp), drop path
+    input var real i_pd_noise[NUM_CHANNEL],
+    input var real i_adc_offset[NUM_CHANNEL],
+    input var real i_adc_inl[NUM_CHANNEL][2**ADC_WIDTH],
+    input var real i_dac_inl[NUM_CHANNEL][2**DAC_WIDTH],
+
+    // Heater thermal time constant in cycles (0 is instantaneous) and the
+    // fraction of each neighbour's drive coupled into a ring
+    input var real i_heater_tau,
+    input var real i_heater_coupling,
+
+    // Row feedforward (tuner_row_ff): common-mode drift offload and heater
+    // crosstalk compensation, all zero is pass-through
+    input var logic i_cfg_ff_cm_en,
+    input var logic [3:0] i_cfg_ff_cm_shift,
+    input var logic signed [7:0] i_cfg_ff_xtalk[NUM_CHANNEL][NUM_CHANNEL],
+
     // output signals
     output real o_pwr_thru,
     output real o_pwr_drop[NUM_CHANNEL],
@@ -65,6 +109,8 @@ module dut #(
     output tuner_phy_lock_state_e o_lock_state[NUM_CHANNEL],
     output logic o_search_err[NUM_CHANNEL],
     output logic o_lock_err[NUM_CHANNEL],
+    output logic [$clog2(MAX_SYNC_CYCLE + 1)-1:0] o_sync_cal_cycle[NUM_CHANNEL],
+    output logic signed [DAC_WIDTH:0] o_ff_cm,
     output logic [ADC_WIDTH-1:0] o_adc_thru,
     output logic [ADC_WIDTH-1:0] o_adc_drop[NUM_CHANNEL]
 );
@@ -117,7 +163,9 @@ module dut #(
 
   real ana_tune[NUM_CHANNEL];
   real real_tuning_dist[NUM_CHANNEL];
+  logic [DAC_WIDTH-1:0] ring_tune_phy[NUM_CHANNEL];
   logic [DAC_WIDTH-1:0] ring_tune_dig[NUM_CHANNEL];
+  logic lock_active[NUM_CHANNEL];
   logic [ADC_WIDTH-1:0] adc_thru;
   logic [ADC_WIDTH-1:0] adc_drop[NUM_CHANNEL];
 
@@ -126,9 +174,6 @@ module dut #(
       wvls[i] = i_wvl_ls[i];
       pwrs[i] = i_pwr;
     end
-    for (int j = 0; j < NUM_CHANNEL; j++) begin
-      real_tuning_dist[j] = ana_tune[j];
-    end
   end
   // ----------------------------------------------------------------------
 
@@ -144,6 +189,17 @@ module dut #(
       .o_phot_waves(waves_in)
   );
 
+  heater #(
+      .NUM_CHANNEL(NUM_CHANNEL)
+  ) heater_row (
+      .i_clk(i_clk),
+      .i_rst(i_rst),
+      .i_real_tau_cycles(i_heater_tau),
+      .i_real_coupling(i_heater_coupling),
+      .i_real_drive(ana_tune),
+      .o_real_tuning_dist(real_tuning_dist)
+  );
+
   microringrow #(
       .waves_t        (WAVES_TYPE),
       .NUM_CHANNEL    (NUM_CHANNEL),
@@ -154,6 +210,8 @@ module dut #(
       .i_real_wvl_ring   (i_wvl_ring),
       .i_real_tuning_dist(real_tuning_dist),
       .i_real_temperature('{default: 0.0}),
+      .i_real_fwhm_scale (i_fwhm_scale),
+      .i_real_tune_scale (i_tune_scale),
       .o_phot_waves_drop (waves_drop),
       .o_phot_waves_thru (waves_thru)
   );
@@ -165,6 +223,7 @@ module dut #(
           .FullScaleRange(1.0)
       ) dac_tune (
           .i_dig(ring_tune_dig[ch]),
+          .i_real_inl(i_dac_inl[ch]),
           .o_ana(ana_tune[ch])
       );
 
@@ -172,6 +231,7 @@ module dut #(
           .waves_t(WAVES_TYPE)
       ) pd_drop (
           .i_phot_waves  (waves_drop[ch]),
+          .i_real_noise  (i_pd_noise[ch]),
           .o_real_current(o_pwr_drop[ch])
       );
 
@@ -180,6 +240,8 @@ module dut #(
           .FullScaleRange(1000.0)
       ) adc_drop_inst (
           .i_ana(o_pwr_drop[ch]),
+          .i_real_offset(i_adc_offset[ch]),
+          .i_real_inl(i_adc_inl[ch]),
           .o_dig(adc_drop[ch])
       );
 
@@ -190,7 +252,9 @@ module dut #(
           .SEARCH_PEAK_WINDOW_HALFSIZE(4),
           .SEARCH_PEAK_THRES(2),
           .LOCK_DELTA_WINDOW_SIZE(LOCK_DELTA_WINDOW_SIZE),
-          .MAX_SYNC_CYCLE(MAX_SYNC_CYCLE)
+          .MAX_SYNC_CYCLE(MAX_SYNC_CYCLE),
+          .MAX_WAIT_CYCLE(MAX_WAIT_CYCLE),
+          .MAX_NUM_PWR_DETECT(MAX_NUM_PWR_DETECT)
       ) tuner_phy_inst (
           .i_clk(i_clk),
           .i_rst(i_rst),
@@ -198,19 +262,45 @@ module dut #(
           .i_cfg_ring_tune_start(i_cfg_ring_tune_start[ch]),
           .i_cfg_ring_tune_end(i_cfg_ring_tune_end[ch]),
           .i_cfg_ring_tune_stride(i_cfg_ring_tune_stride[ch]),
+          .i_cfg_search_fit_mode(i_cfg_search_fit_mode[ch]),
           .i_cfg_lock_tune_stride(i_cfg_lock_tune_stride[ch]),
           .i_cfg_sync_cycle(i_cfg_sync_cycle[ch]),
+          .i_cfg_sync_cal_en(i_cfg_sync_cal_en[ch]),
+          .i_cfg_sync_cal_step(i_cfg_sync_cal_step[ch]),
+          .i_cfg_sync_cal_tol(i_cfg_sync_cal_tol[ch]),
+          .i_cfg_sync_cal_margin(i_cfg_sync_cal_margin[ch]),
+          .i_cfg_sync_cal_period(i_cfg_sync_cal_period[ch]),
+          .i_cfg_arb_search_weight('0),
+          .i_cfg_arb_lock_weight('0),
+          .i_cfg_arb_lock_max_wait('0),
           .i_cfg_lock_pwr_delta_thres(i_cfg_lock_pwr_delta_thres[ch]),
+          .i_cfg_lock_mode(i_cfg_lock_mode[ch]),
+          .i_cfg_lock_pi_kp_shift(i_cfg_lock_pi_kp_shift[ch]),
+          .i_cfg_lock_pi_ki_shift(i_cfg_lock_pi_ki_shift[ch]),
           .i_cfg_ring_pwr_peak_ratio(i_cfg_ring_pwr_peak_ratio[ch]),
+          .i_cfg_lock_loss_ratio(i_cfg_lock_loss_ratio[ch]),
+          .i_cfg_lock_loss_cnt(i_cfg_lock_loss_cnt[ch]),
+          .i_cfg_lock_research_halfwidth(i_cfg_lock_research_halfwidth[ch]),
           .i_cfg_pwr_peak(i_cfg_pwr_peak[ch]),
           .i_cfg_ring_tune_peak(i_cfg_ring_tune_peak[ch]),
+          .i_cfg_search_detect_mode(i_cfg_search_detect_mode[ch]),
+          .i_cfg_search_detect_wait_cycle(i_cfg_search_detect_wait_cycle[ch]),
+          .i_cfg_search_detect_avg_shift(i_cfg_search_detect_avg_shift[ch]),
+          .i_cfg_search_detect_settle_tol(i_cfg_search_detect_settle_tol[ch]),
+          .i_cfg_lock_detect_mode(i_cfg_lock_detect_mode[ch]),
+          .i_cfg_lock_detect_wait_cycle(i_cfg_lock_detect_wait_cycle[ch]),
+          .i_cfg_lock_detect_avg_shift(i_cfg_lock_detect_avg_shift[ch]),
+          .i_cfg_lock_detect_settle_tol(i_cfg_lock_detect_settle_tol[ch]),
           .search_if(search_if[ch].producer),
           .lock_if(lock_if[ch].producer),
-          .o_dig_ring_tune(ring_tune_dig[ch]),
+          .o_dig_ring_tune(ring_tune_phy[ch]),
           .o_dig_search_state_mon(o_search_state[ch]),
           .o_dig_lock_state_mon(o_lock_state[ch]),
           .o_dig_search_err(o_search_err[ch]),
-          .o_dig_lock_err(o_lock_err[ch])
+          .o_dig_lock_err(o_lock_err[ch]),
+          .o_dig_sync_cal_cycle(o_sync_cal_cycle[ch]),
+          .o_dig_arb_lock_req(),
+          .o_dig_arb_grant()
       );
 
       // Search Interface Logic
@@ -230,15 +320,32 @@ module dut #(
       assign lock_if[ch].resume_val    = i_lock_resume_val[ch];
       assign o_lock_resume_rdy[ch]     = lock_if[ch].resume_rdy;
 
+      assign lock_active[ch]           = (o_lock_state[ch] == LOCK_ACTIVE);
       assign o_ring_tune[ch]           = ring_tune_dig[ch];
       assign o_adc_drop[ch]            = adc_drop[ch];
     end
   endgenerate
 
+  tuner_row_ff #(
+      .DAC_WIDTH  (DAC_WIDTH),
+      .NUM_CHANNEL(NUM_CHANNEL)
+  ) row_ff (
+      .i_clk(i_clk),
+      .i_rst(i_rst),
+      .i_cfg_ff_cm_en(i_cfg_ff_cm_en),
+      .i_cfg_ff_cm_shift(i_cfg_ff_cm_shift),
+      .i_cfg_ff_xtalk(i_cfg_ff_xtalk),
+      .i_dig_ring_tune(ring_tune_phy),
+      .i_dig_lock_active(lock_active),
+      .o_dig_ring_tune(ring_tune_dig),
+      .o_dig_ff_cm(o_ff_cm)
+  );
+
   photodetector #(
       .waves_t(WAVES_TYPE)
   ) pd_thru (
       .i_phot_waves  (waves_thru),
+      .i_real_noise  (0.0),
       .o_real_current(o_pwr_thru)
   );
 
@@ -247,6 +354,8 @@ module dut #(
       .FullScaleRange(1.0)
   ) adc_thru_inst (
       .i_ana(o_pwr_thru),
+      .i_real_offset(0.0),
+      .i_real_inl('{default: 0.0}),
       .o_dig(adc_thru)
   );
 
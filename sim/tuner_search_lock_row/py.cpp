@@ -0,0 +1,115 @@
+#include "Vsim.h"
+#include "bench.hpp"
+#include "utils/options.hpp"
+#include <iostream>
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// svwdm_search_lock_row: the tuner_search_lock_row bench in process. Each
+// run takes the same knobs as the executable (a dict instead of +key=value)
+// and returns the metrics plus every monitor sample as NumPy structured
+// arrays that own the bench's record buffers. No VCD, CSV or binary monitor
+// is written.
+namespace py = pybind11;
+
+// Knob values spelled the way the command line and config files spell them
+static std::string knob_value(py::handle v) {
+  if (py::isinstance<py::bool_>(v))
+    return v.cast<bool>() ? "true" : "false";
+  if (py::isinstance<py::list>(v) || py::isinstance<py::tuple>(v)) {
+    std::string s = "[";
+    for (py::handle item : v) {
+      s += (s.size() > 1 ? ", " : "") + knob_value(item);
+    }
+    return s + "]";
+  }
+  return py::str(v);
+}
+
+static options::Options make_options(const py::dict &knobs) {
+  options::Options opts;
+  for (auto kv : knobs)
+    opts.set(py::str(kv.first), knob_value(kv.second));
+  return opts;
+}
+
+// metrics.toml values back to Python scalars
+static py::object metric_value(const std::string &s) {
+  if (s == "true" || s == "false")
+    return py::bool_(s == "true");
+  if (!s.empty() && s.front() == '"')
+    return py::str(s.substr(1, s.size() - 2));
+  size_t n = 0;
+  try {
+    const long long v = std::stoll(s, &n);
+    if (n == s.size())
+      return py::int_(v);
+  } catch (const std::logic_error &) {
+  }
+  return py::float_(std::stod(s));
+}
+
+// Hand a record buffer to NumPy without copying
+template <typename T> static py::array_t<T> to_numpy(std::vector<T> &&v) {
+  auto *owned = new std::vector<T>(std::move(v));
+  py::capsule base(owned, [](void *p) {
+    delete static_cast<std::vector<T> *>(p);
+  });
+  return py::array_t<T>(static_cast<py::ssize_t>(owned->size()),
+                        owned->data(), base);
+}
+
+static py::dict run(const py::dict &knobs, bool verbose) {
+  options::Options opts = make_options(knobs);
+  SearchLockRowRun result;
+  {
+    py::gil_scoped_release release;
+    std::ostringstream quiet;
+    result = run_search_lock_row(opts, verbose ? std::cout : quiet, false, 0,
+                                 nullptr);
+  }
+  py::dict metrics;
+  for (const auto &kv : result.metrics.values())
+    metrics[py::str(kv.first)] = metric_value(kv.second);
+  py::list records;
+  for (auto &ring : result.records)
+    records.append(to_numpy(std::move(ring)));
+  py::dict out;
+  out["metrics"] = metrics;
+  out["records"] = records;
+  out["num_locked"] = result.num_locked;
+  return out;
+}
+
+PYBIND11_MODULE(svwdm_search_lock_row, m) {
+  m.doc() = "In-process tuner_search_lock_row bench";
+
+  PYBIND11_NUMPY_DTYPE(search_lock_record_t, time, tune_code, i_pwr,
+                       o_pwr_thru, o_pwr_drop, search_state_enum,
+                       lock_state_enum);
+
+  m.attr("num_rings") = SearchLockRowRun::kNumRings;
+  m.def("run", &run, py::arg("knobs") = py::dict(),
+        py::arg("verbose") = false,
+        "Run one scenario; returns {'metrics', 'records', 'num_locked'}");
+  m.def(
+      "run_scenarios",
+      [](const py::dict &knobs, uint64_t first, uint64_t last) {
+        py::list runs;
+        for (uint64_t idx = first; idx < last; ++idx) {
+          py::dict point;
+          for (auto kv : knobs)
+            point[kv.first] = kv.second;
+          point["scenario_index"] = idx;
+          runs.append(run(point, false));
+        }
+        return runs;
+      },
+      py::arg("knobs"), py::arg("first"), py::arg("last"),
+      "Run scenario_index in [first, last) with the other knobs fixed");
+}
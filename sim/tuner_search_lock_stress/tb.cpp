@@ -0,0 +1,266 @@
+#include "Vsim.h"
+#include "models/afe_noise.hpp"
+#include "testbench/verilator_tb.hpp"
+#include "utils/metrics.hpp"
+#include "utils/options.hpp"
+#include "utils/scenario.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <sys/resource.h>
+#include <unistd.h>
+
+// Built once per ring count (see CMakeLists.txt); must match -GNUM_CHANNEL
+#ifndef STRESS_NUM_RINGS
+#define STRESS_NUM_RINGS 16
+#endif
+
+namespace {
+
+// Current resident set size in KiB
+long rss_kib() {
+  std::ifstream statm("/proc/self/statm");
+  long pages = 0, resident = 0;
+  if (statm >> pages >> resident)
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+  return -1;
+}
+
+long peak_rss_kib() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  options::Options opts(argc, argv);
+  constexpr size_t kNumRings = STRESS_NUM_RINGS;
+  // Uniform tuner config; per-ring overrides through key.<ring>
+  const auto kSyncCycle = opts.get_array<int, kNumRings>("sync_cycle", 4);
+  const auto kLockMode = opts.get_array<int, kNumRings>("lock_mode", 0);
+  const auto kLockPwrDeltaThres =
+      opts.get_array<int, kNumRings>("lock_pwr_delta_thres", 2);
+  const auto kLockPiKpShift =
+      opts.get_array<int, kNumRings>("lock_pi_kp_shift", 5);
+  const auto kLockPiKiShift =
+      opts.get_array<int, kNumRings>("lock_pi_ki_shift", 5);
+  const auto kSearchDetectWaitCycle =
+      opts.get_array<int, kNumRings>("search_detect_wait_cycle", 4);
+  const auto kLockDetectWaitCycle =
+      opts.get_array<int, kNumRings>("lock_detect_wait_cycle", 4);
+  const auto kLockDetectAvgShift =
+      opts.get_array<int, kNumRings>("lock_detect_avg_shift", 0);
+  const auto kLockOffset = opts.get_array<int, kNumRings>("lock_offset", -20);
+  // Full-range sweep stride (log2 of the code step). Fit mode estimates
+  // each resonance from three samples, so it can sweep with a larger stride.
+  const int kSearchStride = opts.get<int>("search_stride", 1);
+  const auto kSearchFitMode =
+      opts.get_array<int, kNumRings>("search_fit_mode", 0);
+  const int kSearchTimeoutCycles =
+      opts.get<int>("search_timeout_cycles", 1000000);
+  const int kLockTimeoutCycles = opts.get<int>("lock_timeout_cycles", 1000000);
+  // Closed-loop cycles with every ring locked, the steady-state throughput
+  // measurement
+  const int kLockDwellCycles = opts.get<int>("lock_dwell_cycles", 100000);
+  // One laser line per ring. Each ring rests kRingOffset below its line so
+  // its own line is the first peak of an upward sweep.
+  const uint64_t scenario_seed = opts.get<uint64_t>("scenario_seed", 1);
+  const uint64_t scenario_index = opts.get<uint64_t>("scenario_index", 0);
+  const double kLaserSpacing = opts.get<double>("laser_spacing", 2.0);
+  const double kRingOffset = opts.get<double>("ring_offset", 1.0);
+  scenario::ScenarioConfig scenario_cfg;
+  scenario_cfg.num_lasers = kNumRings;
+  scenario_cfg.num_rings = kNumRings;
+  scenario_cfg.laser_wvl_start = opts.get<double>("laser_wvl_start", 1300.0);
+  scenario_cfg.laser_spacing = kLaserSpacing;
+  scenario_cfg.laser_wvl_error = scenario::Dist::parse(
+      opts.get<std::string>("laser_wvl_error", "const(0)"));
+  scenario_cfg.laser_pwr =
+      scenario::Dist::parse(opts.get<std::string>("laser_pwr", "const(1000)"));
+  scenario_cfg.ring_wvl_start = scenario_cfg.laser_wvl_start - kRingOffset;
+  scenario_cfg.ring_spacing = kLaserSpacing;
+  scenario_cfg.ring_fab_offset = scenario::Dist::parse(
+      opts.get<std::string>("ring_fab_offset", "const(0)"));
+  opts.check_unused();
+  opts.write_effective("tb_config.toml");
+  const scenario::Scenario scn =
+      scenario::ScenarioGenerator(scenario_cfg, scenario_seed)
+          .generate(scenario_index);
+
+  const long rss_before = rss_kib();
+  VerilatorTb<Vsim> tb(argc, argv);
+  auto *dut = tb.dut();
+  const long rss_model = rss_kib() - rss_before;
+
+  uint64_t cycles = 0;
+  auto advance_clk = [&]() {
+    tb.step_clk(dut->i_clk);
+    ++cycles;
+  };
+
+  // Advance until done(ring) holds for every ring; returns the cycle count,
+  // or -1 on timeout
+  auto run_until_all = [&](auto done, int timeout) -> long {
+    const uint64_t start = cycles;
+    for (;;) {
+      bool all = true;
+      for (size_t r = 0; r < kNumRings && all; ++r)
+        all = done(r);
+      if (all)
+        return static_cast<long>(cycles - start);
+      if (cycles - start >= static_cast<uint64_t>(timeout))
+        return -1;
+      advance_clk();
+    }
+  };
+
+  dut->i_pwr = scn.laser_pwr;
+  for (size_t r = 0; r < kNumRings; ++r) {
+    dut->i_wvl_ls[r] = scn.laser_wvl[r];
+    dut->i_wvl_ring[r] = scn.ring_wvl[r];
+    dut->i_fwhm_scale[r] = 1.0;
+    dut->i_tune_scale[r] = 1.0;
+
+    dut->i_search_trig_val[r] = 0;
+    dut->i_search_done_rdy[r] = 0;
+    dut->i_lock_trig_val[r] = 0;
+    dut->i_lock_intr_rdy[r] = 1;
+    dut->i_lock_resume_val[r] = 0;
+    dut->i_cfg_ring_tune_start[r] = 0;
+    dut->i_cfg_ring_tune_end[r] = 255;
+    dut->i_cfg_ring_tune_stride[r] = kSearchStride;
+    dut->i_cfg_ring_pwr_peak_ratio[r] = 8;
+    dut->i_cfg_lock_tune_stride[r] = 0;
+    dut->i_cfg_lock_pwr_delta_thres[r] = kLockPwrDeltaThres[r];
+    dut->i_cfg_sync_cycle[r] = kSyncCycle[r];
+    dut->i_cfg_search_fit_mode[r] = kSearchFitMode[r];
+    dut->i_cfg_lock_mode[r] = kLockMode[r];
+    dut->i_cfg_lock_pi_kp_shift[r] = kLockPiKpShift[r];
+    dut->i_cfg_lock_pi_ki_shift[r] = kLockPiKiShift[r];
+    dut->i_cfg_lock_loss_ratio[r] = 4;
+    dut->i_cfg_lock_loss_cnt[r] = 4;
+    dut->i_cfg_lock_research_halfwidth[r] = 16;
+    dut->i_cfg_search_detect_mode[r] = 0;
+    dut->i_cfg_search_detect_wait_cycle[r] = kSearchDetectWaitCycle[r];
+    dut->i_cfg_search_detect_avg_shift[r] = 0;
+    dut->i_cfg_search_detect_settle_tol[r] = 0;
+    dut->i_cfg_lock_detect_mode[r] = 0;
+    dut->i_cfg_lock_detect_wait_cycle[r] = kLockDetectWaitCycle[r];
+    dut->i_cfg_lock_detect_avg_shift[r] = kLockDetectAvgShift[r];
+    dut->i_cfg_lock_detect_settle_tol[r] = 0;
+
+    dut->i_pd_noise[r] = 0.0;
+    dut->i_adc_offset[r] = 0.0;
+    afe_noise::load_table(dut->i_adc_inl[r], std::array<double, 256>{});
+    afe_noise::load_table(dut->i_dac_inl[r], std::array<double, 256>{});
+  }
+
+  dut->i_clk = 0;
+  tb.reset(dut->i_clk, dut->i_rst);
+
+  using clock = std::chrono::steady_clock;
+  auto seconds_since = [](clock::time_point t0) {
+    return std::chrono::duration<double>(clock::now() - t0).count();
+  };
+
+  // All rings search concurrently
+  auto t0 = clock::now();
+  for (size_t r = 0; r < kNumRings; ++r)
+    dut->i_search_trig_val[r] = 1;
+  advance_clk();
+  for (size_t r = 0; r < kNumRings; ++r)
+    dut->i_search_trig_val[r] = 0;
+  const long search_cycles = run_until_all(
+      [&](size_t r) { return dut->o_search_done_val[r] != 0; },
+      kSearchTimeoutCycles);
+  const double search_s = seconds_since(t0);
+
+  std::array<int, kNumRings> peak_code{};
+  std::array<int, kNumRings> peak_pwr{};
+  int num_found = 0;
+  for (size_t r = 0; r < kNumRings; ++r) {
+    if (dut->o_search_done_val[r] && dut->o_num_peaks[r] > 0) {
+      peak_code[r] = dut->o_pwr_peak_tune_codes[r][0];
+      peak_pwr[r] = dut->o_pwr_peak_codes[r][0];
+      ++num_found;
+    }
+    dut->i_search_done_rdy[r] = 1;
+  }
+  advance_clk();
+  for (size_t r = 0; r < kNumRings; ++r)
+    dut->i_search_done_rdy[r] = 0;
+
+  // All rings lock concurrently from an offset of their first peak
+  t0 = clock::now();
+  for (size_t r = 0; r < kNumRings; ++r) {
+    dut->i_cfg_ring_tune_start[r] =
+        std::clamp(peak_code[r] + kLockOffset[r], 0, 255);
+    dut->i_cfg_ring_tune_peak[r] = peak_code[r];
+    dut->i_cfg_pwr_peak[r] = peak_pwr[r];
+    dut->i_lock_trig_val[r] = 1;
+  }
+  advance_clk();
+  for (size_t r = 0; r < kNumRings; ++r)
+    dut->i_lock_trig_val[r] = 0;
+  const long lock_cycles = run_until_all(
+      [&](size_t r) { return dut->o_lock_state[r] == 2; /*LOCK_ACTIVE*/ },
+      kLockTimeoutCycles);
+  const double lock_s = seconds_since(t0);
+
+  // Steady-state closed loop on every ring
+  t0 = clock::now();
+  uint64_t active_ring_cycles = 0;
+  for (int i = 0; i < kLockDwellCycles; ++i) {
+    advance_clk();
+    for (size_t r = 0; r < kNumRings; ++r)
+      active_ring_cycles += dut->o_lock_state[r] == 2;
+  }
+  const double dwell_s = seconds_since(t0);
+
+  int num_locked = 0;
+  for (size_t r = 0; r < kNumRings; ++r)
+    num_locked += dut->o_lock_state[r] == 2;
+
+  const double dwell_rate = kLockDwellCycles / std::max(dwell_s, 1e-9);
+  std::cout << kNumRings << " rings: " << num_found << " searched, "
+            << num_locked << " locked" << std::endl;
+  std::cout << "Search: " << search_cycles << " cycles, " << search_s
+            << " s" << std::endl;
+  std::cout << "Lock:   " << lock_cycles << " cycles, " << lock_s << " s"
+            << std::endl;
+  std::cout << "Dwell:  " << kLockDwellCycles << " cycles, " << dwell_s
+            << " s (" << dwell_rate << " cycles/s, "
+            << dwell_rate * kNumRings << " ring-cycles/s, "
+            << 1e9 / (dwell_rate * kNumRings) << " ns/ring-cycle)"
+            << std::endl;
+  std::cout << "Memory: model " << rss_model << " KiB, peak RSS "
+            << peak_rss_kib() << " KiB" << std::endl;
+
+  BenchMetrics metrics;
+  metrics.set("num_rings", kNumRings);
+  metrics.set("num_searched", num_found);
+  metrics.set("num_locked", num_locked);
+  metrics.set("search_cycles", search_cycles);
+  metrics.set("search_s", search_s);
+  metrics.set("lock_cycles", lock_cycles);
+  metrics.set("lock_s", lock_s);
+  metrics.set("dwell_cycles", kLockDwellCycles);
+  metrics.set("dwell_s", dwell_s);
+  metrics.set("dwell_active_fraction",
+              static_cast<double>(active_ring_cycles) /
+                  std::max<uint64_t>(
+                      static_cast<uint64_t>(kLockDwellCycles) * kNumRings, 1));
+  metrics.set("cycles_per_s", dwell_rate);
+  metrics.set("ring_cycles_per_s", dwell_rate * kNumRings);
+  metrics.set("total_cycles", cycles);
+  metrics.set("model_rss_kib", rss_model);
+  metrics.set("peak_rss_kib", peak_rss_kib());
+  metrics.write();
+
+  return num_locked == static_cast<int>(kNumRings) ? 0 : 1;
+}
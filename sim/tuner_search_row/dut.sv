@@ -23,7 +23,9 @@ module dut #(
     parameter int NUM_TARGET   = 4,
     parameter int NUM_WAVES    = 2,
     parameter int NUM_CHANNEL  = 2,
-    parameter int MAX_SYNC_CYCLE = 16
+    parameter int MAX_SYNC_CYCLE = 16,
+    parameter int MAX_WAIT_CYCLE = 16,
+    parameter int MAX_NUM_PWR_DETECT = 16
 ) (
     input var logic i_clk,
     input var logic i_rst,
@@ -33,6 +35,12 @@ module dut #(
     input var real i_wvl_ls  [NUM_WAVES],
     input var real i_wvl_ring[NUM_CHANNEL],
 
+    // AFE nonideality injection (lib/cpp/models/afe_noise.hpp), drop path
+    input var real i_pd_noise[NUM_CHANNEL],
+    input var real i_adc_offset[NUM_CHANNEL],
+    input var real i_adc_inl[NUM_CHANNEL][2**ADC_WIDTH],
+    input var real i_dac_inl[NUM_CHANNEL][2**DAC_WIDTH],
+
     // output signals
     output real o_pwr_thru,
     output real o_pwr_drop[NUM_CHANNEL],
@@ -49,9 +57,14 @@ module dut #(
     input logic i_dig_search_peaks_rdy[NUM_CHANNEL],
     output logic o_dig_search_peaks_val[NUM_CHANNEL],
     input logic [$clog2(MAX_SYNC_CYCLE + 1)-1:0] i_cfg_sync_cycle[NUM_CHANNEL],
+    input logic i_cfg_detect_mode[NUM_CHANNEL],
+    input logic [$clog2(MAX_WAIT_CYCLE + 1)-1:0] i_cfg_detect_wait_cycle[NUM_CHANNEL],
+    input logic [$clog2($clog2(MAX_NUM_PWR_DETECT) + 1)-1:0] i_cfg_detect_avg_shift[NUM_CHANNEL],
+    input logic [3:0] i_cfg_detect_settle_tol[NUM_CHANNEL],
     input logic [DAC_WIDTH-1:0] i_dig_ring_tune_start[NUM_CHANNEL],
     input logic [DAC_WIDTH-1:0] i_dig_ring_tune_end[NUM_CHANNEL],
     input logic [DAC_WIDTH-1:0] i_dig_ring_tune_stride[NUM_CHANNEL],
+    input logic i_dig_search_fit_mode[NUM_CHANNEL],
 
     // peak detect signal and collected tuner codes for codes
     output logic [DAC_WIDTH-1:0] o_dig_ring_tune_peaks[NUM_CHANNEL][NUM_TARGET],
@@ -106,7 +119,9 @@ module dut #(
   /*assign o_dig_pwr_drop_detect_val = pwr_detect_val;*/
 
   tuner_pwr_detect_if #(
-      .ADC_WIDTH(ADC_WIDTH)
+      .ADC_WIDTH(ADC_WIDTH),
+      .MAX_WAIT_CYCLE(MAX_WAIT_CYCLE),
+      .MAX_NUM_PWR_DETECT(MAX_NUM_PWR_DETECT)
   ) pwr_detect_if[NUM_CHANNEL] (
       .i_clk(i_clk),
       .i_rst(i_rst)
@@ -140,6 +155,15 @@ module dut #(
       .i_clk(i_clk),
       .i_rst(i_rst)
   );
+
+  // No local search requester in this bench
+  tuner_local_search_if #(
+      .DAC_WIDTH(DAC_WIDTH),
+      .ADC_WIDTH(ADC_WIDTH)
+  ) local_search_if[NUM_CHANNEL] (
+      .i_clk(i_clk),
+      .i_rst(i_rst)
+  );
   // ----------------------------------------------------------------------
 
   // ----------------------------------------------------------------------
@@ -178,6 +202,8 @@ module dut #(
       .i_real_wvl_ring   (i_wvl_ring),
       .i_real_tuning_dist(real_tuning_dist),
       .i_real_temperature('{default: 0.0}),   // No temperature sensitivity for now
+      .i_real_fwhm_scale ('{default: 1.0}),
+      .i_real_tune_scale ('{default: 1.0}),
       .o_phot_waves_drop (waves_drop),
       .o_phot_waves_thru (waves_thru)
   );
@@ -190,6 +216,7 @@ module dut #(
           .FullScaleRange(1.0)
       ) dac_tune_afe (
           .i_dig(dac_tune[ch]),
+          .i_real_inl(i_dac_inl[ch]),
           .o_ana(ana_tune[ch])
       );
 
@@ -197,6 +224,7 @@ module dut #(
           .waves_t(WAVES_TYPE)
       ) pd_drop (
           .i_phot_waves  (waves_drop[ch]),
+          .i_real_noise  (i_pd_noise[ch]),
           .o_real_current(o_pwr_drop[ch])
       );
 
@@ -205,22 +233,49 @@ module dut #(
           .FullScaleRange(1000.0)
       ) adc_drop (
           .i_ana(o_pwr_drop[ch]),
+          .i_real_offset(i_adc_offset[ch]),
+          .i_real_inl(i_adc_inl[ch]),
           .o_dig(o_adc_drop[ch])
       );
 
-      tuner_pwr_detect_phy pwr_drop_detect (
+      tuner_pwr_detect_phy #(
+          .ADC_WIDTH(ADC_WIDTH),
+          .MAX_WAIT_CYCLE(MAX_WAIT_CYCLE),
+          .MAX_NUM_PWR_DETECT(MAX_NUM_PWR_DETECT)
+      ) pwr_drop_detect (
           .i_clk(i_clk),
           .i_rst(i_rst),
           .i_dig_ring_pwr(o_adc_drop[ch]),
           .pwr_detect_if(pwr_detect_if[ch])
       );
 
+      // Search is the only client: fixed priority
+      assign ctrl_arb_if[ch].cfg_weight = '{default: '0};
+      assign ctrl_arb_if[ch].cfg_lock_max_wait = '0;
+
       tuner_ctrl_arb_phy #(
-          .MAX_SYNC_CYCLE(MAX_SYNC_CYCLE)
+          .MAX_SYNC_CYCLE(MAX_SYNC_CYCLE),
+          .MAX_WAIT_CYCLE(MAX_WAIT_CYCLE),
+          .MAX_NUM_PWR_DETECT(MAX_NUM_PWR_DETECT)
       ) ctrl_arb (
           .i_clk(i_clk),
           .i_rst(i_rst),
           .i_cfg_sync_cycle(i_cfg_sync_cycle[ch]),
+          .i_cfg_sync_cal_en(1'b0),
+          .i_cfg_sync_cal_step('0),
+          .i_cfg_sync_cal_tol('0),
+          .i_cfg_sync_cal_margin('0),
+          .i_cfg_sync_cal_period('0),
+          .o_dig_sync_cal_cycle(),
+          // Search-only bench: the lock channel never requests detects
+          .i_cfg_search_detect_mode(i_cfg_detect_mode[ch]),
+          .i_cfg_search_detect_wait_cycle(i_cfg_detect_wait_cycle[ch]),
+          .i_cfg_search_detect_avg_shift(i_cfg_detect_avg_shift[ch]),
+          .i_cfg_search_detect_settle_tol(i_cfg_detect_settle_tol[ch]),
+          .i_cfg_lock_detect_mode(i_cfg_detect_mode[ch]),
+          .i_cfg_lock_detect_wait_cycle(i_cfg_detect_wait_cycle[ch]),
+          .i_cfg_lock_detect_avg_shift(i_cfg_detect_avg_shift[ch]),
+          .i_cfg_lock_detect_settle_tol(i_cfg_detect_settle_tol[ch]),
           .pwr_detect_if(pwr_detect_if[ch]),
           .ctrl_arb_if(ctrl_arb_if[ch]),
           .o_dig_afe_ring_tune(dac_tune[ch]),
@@ -250,12 +305,18 @@ module dut #(
           .i_dig_ring_tune_start(i_dig_ring_tune_start[ch]),
           .i_dig_ring_tune_end(i_dig_ring_tune_end[ch]),
           .i_dig_ring_tune_stride(i_dig_ring_tune_stride[ch]),
+          .i_dig_search_fit_mode(i_dig_search_fit_mode[ch]),
 
           .txn_if(search_txn_if[ch].ctrl),
           .search_if  (search_if[ch]),
+          .local_search_if(local_search_if[ch].producer),
           .o_dig_ring_tune(search_ring_tune[ch])
       );
 
+      assign local_search_if[ch].trig_val        = 1'b0;
+      assign local_search_if[ch].ring_tune_start = '0;
+      assign local_search_if[ch].ring_tune_end   = '0;
+
       assign search_if[ch].trig_val         = i_dig_search_trig_val[ch];
       assign search_if[ch].peaks_rdy        = i_dig_search_peaks_rdy[ch];
       assign o_dig_search_peaks_val[ch]     = search_if[ch].peaks_val;
@@ -278,6 +339,7 @@ module dut #(
       .waves_t(WAVES_TYPE)
   ) pd_thru (
       .i_phot_waves  (waves_thru),
+      .i_real_noise  (0.0),
       .o_real_current(o_pwr_thru)
   );
 
@@ -286,6 +348,8 @@ module dut #(
       .FullScaleRange(1.0)
   ) adc_thru (
       .i_ana(o_pwr_thru),
+      .i_real_offset(0.0),
+      .i_real_inl('{default: 0.0}),
       .o_dig(o_adc_thru)
   );
 
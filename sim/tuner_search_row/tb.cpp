@@ -1,11 +1,15 @@
 #include "Vsim.h"
+#include "models/afe_noise.hpp"
 #include "testbench/verilator_tb.hpp"
+#include "utils/options.hpp"
+#include "utils/profiler.hpp"
 #include "utils/sweep.hpp"
 #include <array>
 #include <cassert>
 #include <csv2/writer.hpp>
 #include <fstream>
 #include <iostream>
+#include <vector>
 
 class SearchPhyMonitor {
 public:
@@ -21,6 +25,8 @@ public:
       : dut_(dut), ring_(ring), sample_interval_(interval) {}
 
   void sample(vluint64_t time, bool force, bool print) {
+    static profiler::Phase phase("monitor.sample");
+    profiler::ScopedTimer timer(phase);
     bool do_sample = force || ((interval_count_ % sample_interval_) == 0);
 
     if (do_sample) {
@@ -34,6 +40,8 @@ public:
       records_.push_back(r);
 
       if (print) {
+        static profiler::Phase print_phase("monitor.print");
+        profiler::ScopedTimer print_timer(print_phase);
         std::cout << "[" << r.time << " ps] "
                   << "State=" << state_string(r.state_enum)
                   << " tune=" << r.tune_code << " i_pwr=" << r.i_pwr
@@ -101,7 +109,32 @@ private:
 };
 
 int main(int argc, char **argv) {
-  constexpr int kSyncCycle = 4;
+  options::Options opts(argc, argv);
+  const int kSyncCycle = opts.get<int>("sync_cycle", 4);
+  // Power detect: the defaults are the former fixed 4-cycle wait on one
+  // sample; a nonzero kDetectSettleTol opts in to the early exit
+  const int kDetectMode = opts.get<int>("detect_mode", 0);
+  const int kDetectWaitCycle = opts.get<int>("detect_wait_cycle", 4);
+  const int kDetectAvgShift = opts.get<int>("detect_avg_shift", 0);
+  const int kDetectSettleTol = opts.get<int>("detect_settle_tol", 0);
+  // AFE nonidealities (all zero is the ideal AFE). PD noise is given in ADC
+  // LSB and scaled to o_real_current units with the drop ADC full scale.
+  const uint64_t kNoiseSeed = opts.get<uint64_t>("noise_seed", 1);
+  constexpr double kAdcFullScale = 1000.0;
+  const double kPdWhiteLsb = opts.get<double>("pd_white_lsb", 0.0);
+  const double kPdPinkLsb = opts.get<double>("pd_pink_lsb", 0.0);
+  const double kAdcOffsetLsb = opts.get<double>("adc_offset_lsb", 0.0);
+  const double kAdcDnlSigma = opts.get<double>("adc_dnl_sigma", 0.0);
+  const double kDacBowLsb = opts.get<double>("dac_bow_lsb", 0.0);
+  const double kDacDnlSigma = opts.get<double>("dac_dnl_sigma", 0.0);
+  const auto kWvlRing =
+      opts.get_array<double, 2>("wvl_ring", {1295.0, 1298.0});
+  // Full-range sweep stride (log2 of the code step). Fit mode estimates
+  // each resonance from three samples, so it can sweep with a larger stride.
+  const int kSearchStride = opts.get<int>("search_stride", 2);
+  const int kSearchFitMode = opts.get<int>("search_fit_mode", 0);
+  opts.check_unused();
+  opts.write_effective("tb_config.toml");
   VerilatorTb<Vsim> tb(argc, argv);
   auto *dut = tb.dut();
 
@@ -109,8 +142,25 @@ int main(int argc, char **argv) {
   std::array<SearchPhyMonitor, kNumRings> search_monitor{
       SearchPhyMonitor(dut, 0, 8), SearchPhyMonitor(dut, 1, 8)};
 
+  afe_noise::AfeNoiseConfig noise_cfg;
+  noise_cfg.seed = kNoiseSeed;
+  noise_cfg.pd.white_sigma = kPdWhiteLsb * kAdcFullScale / 255.0;
+  noise_cfg.pd.pink_sigma = kPdPinkLsb * kAdcFullScale / 255.0;
+  noise_cfg.adc_offset_lsb = kAdcOffsetLsb;
+  noise_cfg.adc_dnl_sigma = kAdcDnlSigma;
+  noise_cfg.dac_bow_lsb = kDacBowLsb;
+  noise_cfg.dac_dnl_sigma = kDacDnlSigma;
+  // One independent stream per ring
+  std::vector<afe_noise::AfeNoise<8, 8>> afe;
+  for (size_t r = 0; r < kNumRings; ++r) {
+    afe.emplace_back(noise_cfg, static_cast<uint32_t>(r));
+  }
+
   auto advance_clk = [&](size_t ring) {
     auto search_phy_state_prev = dut->o_mon_state[ring];
+    for (size_t r = 0; r < kNumRings; ++r) {
+      dut->i_pd_noise[r] = afe[r].pd.next();
+    }
     tb.step_clk(dut->i_clk);
 
     auto search_phy_state = dut->o_mon_state[ring];
@@ -165,23 +215,33 @@ int main(int argc, char **argv) {
   dut->i_wvl_ls[0] = 1300.0;
   dut->i_wvl_ls[1] = 1302.0;
 
-  const std::array<double, 2> wvl_ring = {1295.0, 1298.0};
-  for (size_t i = 0; i < wvl_ring.size(); ++i) {
-    dut->i_wvl_ring[i] = wvl_ring[i];
+  for (size_t i = 0; i < kWvlRing.size(); ++i) {
+    dut->i_wvl_ring[i] = kWvlRing[i];
   }
   for (size_t r = 0; r < kNumRings; ++r) {
     dut->i_dig_search_trig_val[r] = 0;
     dut->i_dig_search_peaks_rdy[r] = 0;
     dut->i_cfg_sync_cycle[r] = kSyncCycle;
+    dut->i_dig_search_fit_mode[r] = kSearchFitMode;
+    dut->i_cfg_detect_mode[r] = kDetectMode;
+    dut->i_cfg_detect_wait_cycle[r] = kDetectWaitCycle;
+    dut->i_cfg_detect_avg_shift[r] = kDetectAvgShift;
+    dut->i_cfg_detect_settle_tol[r] = kDetectSettleTol;
+  }
+
+  for (size_t r = 0; r < kNumRings; ++r) {
+    dut->i_adc_offset[r] = afe[r].adc.offset_lsb();
+    afe_noise::load_table(dut->i_adc_inl[r], afe[r].adc.inl_table());
+    afe_noise::load_table(dut->i_dac_inl[r], afe[r].dac.inl_table());
   }
 
   dut->i_clk = 0; // Clock starts low
 
-  for (size_t ring = 0; ring < wvl_ring.size(); ++ring) {
+  for (size_t ring = 0; ring < kWvlRing.size(); ++ring) {
     tb.reset(dut->i_clk, dut->i_rst);
 
     std::cout << "--- Running search on ring " << ring << " ---" << std::endl;
-    search_routine(ring, 0, 255, 2, true);
+    search_routine(ring, 0, 255, kSearchStride, true);
     search_routine(ring, 140, 255, 0, true);
   }
 
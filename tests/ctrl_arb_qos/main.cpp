@@ -0,0 +1,132 @@
+#include "models/ctrl_arb_qos.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <random>
+
+using namespace ctrl_arb_qos;
+
+// Random requests with CH_LOCK held until granted (tune_val stays up until
+// the tune fire); returns the most grants CH_LOCK waited behind
+static int max_lock_wait(QosArbiter &arb, uint64_t seed, int cycles) {
+  std::mt19937_64 rng(seed);
+  std::bernoulli_distribution req(0.7);
+  std::bernoulli_distribution rdy(0.8);
+  bool lock_req = false;
+  int wait = 0, wait_max = 0;
+  for (int i = 0; i < cycles; ++i) {
+    uint32_t mask = 0;
+    for (int c = 1; c <= arb.num_client(); ++c)
+      if (req(rng))
+        mask |= 1u << c;
+    lock_req = lock_req || ((mask >> CH_LOCK) & 1u);
+    mask = lock_req ? (mask | (1u << CH_LOCK)) : (mask & ~(1u << CH_LOCK));
+    if (!rdy(rng)) {
+      arb.idle(mask);
+      continue;
+    }
+    const ch_t g = arb.grant(mask);
+    assert(g == CH_NULL || ((mask >> g) & 1u));
+    if (g == CH_LOCK) {
+      lock_req = false;
+      wait = 0;
+    } else if (g != CH_NULL && lock_req) {
+      ++wait;
+      wait_max = std::max(wait_max, wait);
+    }
+  }
+  return wait_max;
+}
+
+int main() {
+  // All-zero config is the legacy search-first priority, and starves lock
+  {
+    QosArbiter arb;
+    const uint32_t both = (1u << CH_SEARCH) | (1u << CH_LOCK);
+    for (int i = 0; i < 100; ++i)
+      assert(arb.grant(both) == CH_SEARCH);
+    assert(arb.grant(1u << CH_LOCK) == CH_LOCK);
+    assert(arb.grant(0) == CH_NULL);
+    assert(arb.lock_wait_bound() < 0);
+  }
+
+  // Lowest channel first for N clients too
+  {
+    QosArbiter arb(4);
+    assert(arb.grant((1u << CH_MON) | (1u << CH_CAL)) == CH_CAL);
+    assert(arb.grant(1u << CH_MON) == CH_MON);
+  }
+
+  // WRR shares the grants in proportion to the weights
+  {
+    const std::array<int, 3> weights = {3, 1, 2};
+    QosArbiter arb(3);
+    for (int c = 1; c <= 3; ++c)
+      arb.set_weight(static_cast<ch_t>(c), weights[c - 1]);
+    std::array<int, 4> count = {};
+    const uint32_t all = (1u << CH_SEARCH) | (1u << CH_LOCK) | (1u << CH_CAL);
+    constexpr int kRounds = 100;
+    for (int i = 0; i < kRounds * 6; ++i)
+      ++count[arb.grant(all)];
+    for (int c = 1; c <= 3; ++c)
+      assert(count[c] == kRounds * weights[c - 1]);
+    assert(arb.lock_wait_bound() == 3 + 2);
+  }
+
+  // A zero weight still gets a burst of one under WRR
+  {
+    QosArbiter arb;
+    arb.set_weight(CH_SEARCH, 4);
+    const uint32_t both = (1u << CH_SEARCH) | (1u << CH_LOCK);
+    for (int r = 0; r < 10; ++r) {
+      for (int i = 0; i < 4; ++i)
+        assert(arb.grant(both) == CH_SEARCH);
+      assert(arb.grant(both) == CH_LOCK);
+    }
+    assert(arb.lock_wait_bound() == 4);
+  }
+
+  // Lock guard bounds the wait under fixed priority
+  {
+    QosArbiter arb;
+    arb.set_lock_max_wait(3);
+    const uint32_t both = (1u << CH_SEARCH) | (1u << CH_LOCK);
+    for (int r = 0; r < 10; ++r) {
+      for (int i = 0; i < 3; ++i)
+        assert(arb.grant(both) == CH_SEARCH);
+      assert(arb.grant(both) == CH_LOCK);
+    }
+    assert(arb.lock_wait_bound() == 3);
+  }
+
+  // Random contention never exceeds the bound
+  int checked = 0;
+  for (int n = 2; n <= 4; ++n)
+    for (int w = 0; w <= 15; w += 5)
+      for (int guard = 0; guard <= 6; guard += 3) {
+        QosArbiter arb(n);
+        // w = 0 leaves fixed priority, bounded by the guard alone
+        for (int c = 1; c <= n; ++c)
+          arb.set_weight(static_cast<ch_t>(c),
+                         c == CH_LOCK ? std::min(w, 1) : w);
+        arb.set_lock_max_wait(guard);
+        const int bound = arb.lock_wait_bound();
+        if (bound < 0)
+          continue;
+        for (uint64_t seed = 1; seed <= 8; ++seed) {
+          const int wait = max_lock_wait(arb, seed, 20000);
+          if (wait > bound) {
+            std::cerr << "Lock waited " << wait << " > bound " << bound
+                      << " (n=" << n << " w=" << w << " guard=" << guard
+                      << " seed=" << seed << ")\n";
+            return 1;
+          }
+          arb.reset();
+        }
+        ++checked;
+      }
+  std::cout << "Lock wait within bound for " << checked << " configs\n";
+  return 0;
+}
@@ -0,0 +1,256 @@
+#include "models/ctrl_arb_txn.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace ctrl_arb_txn;
+
+// Cycle-by-cycle transcription of tuner_ctrl_arb_phy, tuner_pwr_detect_if
+// and tuner_pwr_detect_phy, driven like tuner_ctrl_txn_adapter: the
+// controller fires a new code think cycles after each commit
+class RtlReference {
+public:
+  enum arb_e { INIT, TUNE, SYNC, COMMIT };
+  enum det_e { IDLE, WAIT, ACTIVE, DONE };
+
+  RtlReference(const DetectConfig &cfg, int sync_cycle)
+      : cfg_(cfg), sync_eff_(sync_cycle < 1    ? 1
+                             : sync_cycle > 16 ? 16
+                                               : sync_cycle) {
+    line_.fill(0);
+  }
+
+  // One clock; returns true on the commit fire
+  bool clock(bool tune_val, int code, const std::vector<int> &samples) {
+    const bool fire = arb_ == TUNE && tune_val;
+    const int x = samples[fire ? code : track_];
+
+    // Detector comb
+    const bool read_fire = if_read_ && (det_ == IDLE || det_ == DONE);
+    const bool detect_fire = !if_read_ && det_ == DONE;
+    const int wait_in = std::clamp(cfg_.wait_cycle, 1, 16);
+    const int shift_in = std::min(cfg_.avg_shift, 4);
+    const int num = 1 << shift_;
+    const bool keep = stream_ &&
+                      cfg_.mode == detect_mode_e::DETECT_MODE_STREAM &&
+                      shift_in == shift_;
+    const int diff = std::abs(x - line_[0]);
+    const bool settled =
+        det_ == WAIT && tol_ != 0 && wait_cnt_ != 0 && diff < tol_;
+    const int data = detect_fire ? (acc_ >> shift_) & 0xFF : 0;
+
+    // Arbiter comb
+    const bool sync_done = arb_ == SYNC && sync_cnt_ == sync_eff_ - 1;
+    const bool ctrl_sync = arb_ == SYNC && detect_fire;
+    const bool commit_fire = arb_ == COMMIT;
+
+    // Arbiter seq
+    if (ctrl_sync) {
+      pwr_commit_ = data;
+      tune_commit_ = track_;
+    }
+    if (fire)
+      track_ = code;
+    sync_cnt_ = arb_ == SYNC ? sync_cnt_ + ctrl_sync : 0;
+    switch (arb_) {
+    case INIT:
+      arb_ = TUNE;
+      break;
+    case TUNE:
+      arb_ = fire ? SYNC : TUNE;
+      break;
+    case SYNC:
+      arb_ = sync_done ? COMMIT : SYNC;
+      break;
+    case COMMIT:
+      arb_ = TUNE;
+      break;
+    }
+
+    // Detector seq
+    det_e next = det_;
+    int acc = 0;
+    if (det_ == IDLE && read_fire)
+      next = WAIT;
+    if (det_ == WAIT && (wait_cnt_ == wait_ - 1 || settled))
+      next = ACTIVE;
+    if (det_ == ACTIVE && detect_cnt_ == num - 1)
+      next = DONE;
+    if (det_ == DONE && read_fire)
+      next = keep ? DONE : WAIT;
+    if (det_ == ACTIVE)
+      acc = (acc_ + x) & 0xFFF;
+    if (det_ == DONE)
+      acc = stream_ ? (acc_ + x - line_[num - 1]) & 0xFFF : acc_;
+    wait_cnt_ = det_ == WAIT ? wait_cnt_ + 1 : 0;
+    detect_cnt_ = det_ == ACTIVE ? detect_cnt_ + 1 : 0;
+    acc_ = acc;
+    if (read_fire) {
+      stream_ = cfg_.mode == detect_mode_e::DETECT_MODE_STREAM;
+      wait_ = wait_in;
+      shift_ = shift_in;
+      tol_ = cfg_.settle_tol;
+    }
+    for (int i = 15; i > 0; --i)
+      line_[i] = line_[i - 1];
+    line_[0] = x;
+    if (read_fire)
+      if_read_ = false;
+    else if (detect_fire)
+      if_read_ = true;
+    det_ = next;
+    return commit_fire;
+  }
+
+  int pwr_commit() const { return pwr_commit_; }
+  int tune_commit() const { return tune_commit_; }
+
+private:
+  DetectConfig cfg_;
+  int sync_eff_;
+  arb_e arb_ = INIT;
+  int sync_cnt_ = 0;
+  int track_ = 0;
+  int pwr_commit_ = 0;
+  int tune_commit_ = 0;
+  det_e det_ = IDLE;
+  bool if_read_ = true;
+  int wait_cnt_ = 0, detect_cnt_ = 0, acc_ = 0;
+  bool stream_ = false;
+  int wait_ = 1, shift_ = 0, tol_ = 0;
+  std::array<int, 16> line_;
+};
+
+struct Commit {
+  int pwr;
+  int tune;
+  uint64_t cycle;
+};
+
+static std::vector<Commit> run_rtl(const DetectConfig &cfg, int sync_cycle,
+                                   int think, const std::vector<int> &codes,
+                                   const std::vector<int> &samples) {
+  RtlReference rtl(cfg, sync_cycle);
+  std::vector<Commit> out;
+  int wait = 0;
+  for (uint64_t cycle = 0; out.size() < codes.size(); ++cycle) {
+    const bool tune_val = wait == 0;
+    if (rtl.clock(tune_val, codes[out.size()], samples)) {
+      out.push_back({rtl.pwr_commit(), rtl.tune_commit(), cycle});
+      wait = think;
+    } else if (wait > 0) {
+      --wait;
+    }
+  }
+  return out;
+}
+
+// Same controller against the TLM arbiter: INIT -> TUNE -> COMMIT, with the
+// transactor called at the fire and commits stamped in accounted cycles
+static std::vector<Commit> run_tlm(const DetectConfig &cfg, int sync_cycle,
+                                   int think, const std::vector<int> &codes,
+                                   const std::vector<int> &samples,
+                                   uint64_t *sim_cycles) {
+  CtrlArbTransactor tlm;
+  tlm.set_inputs(0, true, cfg);
+  enum { INIT, TUNE, COMMIT } arb = INIT;
+  std::vector<Commit> out;
+  TxnResult r{};
+  int wait = 0;
+  uint64_t cycle = 0;
+  for (; out.size() < codes.size(); ++cycle) {
+    const int code = codes[out.size()];
+    if (arb == INIT) {
+      arb = TUNE;
+    } else if (arb == TUNE) {
+      if (wait == 0) {
+        r = tlm.transact(cycle, code, samples[code], sync_cycle);
+        arb = COMMIT;
+      }
+    } else {
+      out.push_back({r.pwr_commit, r.ring_tune_commit,
+                     tlm.accounted_cycle(cycle)});
+      wait = think;
+      arb = TUNE;
+      continue;
+    }
+    if (wait > 0)
+      --wait;
+  }
+  *sim_cycles = cycle;
+  return out;
+}
+
+int main() {
+  std::mt19937 rng(7);
+  std::vector<int> samples(256);
+  for (auto &s : samples)
+    s = static_cast<int>(rng() % 256);
+  std::vector<int> codes(200);
+  for (auto &c : codes)
+    c = static_cast<int>(rng() % 256);
+
+  // Every commit and its cycle match the RTL across modes, waits, windows,
+  // early settling, sync depths and controller think time
+  int configs = 0;
+  uint64_t rtl_total = 0;
+  uint64_t sim_total = 0;
+  for (int mode = 0; mode < 2; ++mode)
+    for (int wait : {0, 1, 4, 17})
+      for (int shift : {0, 2, 5})
+        for (int tol : {0, 3})
+          for (int sync : {0, 1, 2, 4, 20})
+            for (int think : {0, 1, 3}) {
+              DetectConfig cfg;
+              cfg.mode = static_cast<detect_mode_e>(mode);
+              cfg.wait_cycle = wait;
+              cfg.avg_shift = shift;
+              cfg.settle_tol = tol;
+              const auto rtl = run_rtl(cfg, sync, think, codes, samples);
+              uint64_t sim_cycles = 0;
+              const auto tlm =
+                  run_tlm(cfg, sync, think, codes, samples, &sim_cycles);
+              for (size_t i = 0; i < codes.size(); ++i) {
+                if (rtl[i].pwr != tlm[i].pwr || rtl[i].tune != tlm[i].tune ||
+                    rtl[i].cycle != tlm[i].cycle) {
+                  std::cerr << "Mismatch mode=" << mode << " wait=" << wait
+                            << " shift=" << shift << " tol=" << tol
+                            << " sync=" << sync << " think=" << think
+                            << " txn=" << i << ": rtl " << rtl[i].pwr << "@"
+                            << rtl[i].cycle << " tlm " << tlm[i].pwr << "@"
+                            << tlm[i].cycle << "\n";
+                  return 1;
+                }
+              }
+              rtl_total += rtl.back().cycle;
+              sim_total += sim_cycles;
+              ++configs;
+            }
+  std::cout << "Matched " << configs << " configs; simulated "
+            << sim_total << " of " << rtl_total << " cycles ("
+            << double(rtl_total) / sim_total << "x fewer)\n";
+
+  // Deep enough sync always commits the settled sample in block mode
+  DetectConfig block;
+  block.wait_cycle = 4;
+  block.avg_shift = 2;
+  uint64_t sim_cycles = 0;
+  for (const auto &c : run_tlm(block, 3, 1, codes, samples, &sim_cycles))
+    assert(c.pwr == samples[c.tune]);
+
+  // An inactive detector would hang the RTL arbiter
+  CtrlArbTransactor idle;
+  bool threw = false;
+  try {
+    idle.transact(0, 1, 1, 2);
+  } catch (const std::logic_error &) {
+    threw = true;
+  }
+  assert(threw);
+  return 0;
+}
@@ -0,0 +1,109 @@
+#include "models/ring_tf.hpp"
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace ring_tf;
+
+int main() {
+  // tau = 0 without coupling is the original combinational DAC -> ring path
+  {
+    HeaterRow heater(3);
+    const double zero[3] = {0.0, 0.0, 0.0};
+    heater.reset(zero);
+    double tune[3];
+    for (int n = 0; n < 10; ++n) {
+      const double drive[3] = {0.1 * n, 0.5, 1.0 - 0.05 * n};
+      heater.step(drive, tune);
+      for (int i = 0; i < 3; ++i)
+        assert(tune[i] == drive[i]);
+    }
+  }
+
+  // Step response of a single heater: 1 - (1 - a)^n after n cycles
+  for (double tau : {0.5, 1.0, 3.0, 20.0}) {
+    const double a = HeaterRow::alpha(tau);
+    HeaterRow heater(1, tau);
+    const double zero = 0.0;
+    const double one = 1.0;
+    heater.reset(&zero);
+    double tune = 0.0;
+    for (int n = 1; n <= 100; ++n) {
+      heater.step(&one, &tune);
+      assert(std::fabs(tune - (1.0 - std::pow(1.0 - a, n))) < 1e-12);
+    }
+  }
+
+  // Coupled row settles at d[i] + k * (d[i-1] + d[i+1]); reset starts there
+  {
+    const double k = 0.1;
+    const double drive[4] = {0.2, 0.8, 0.0, 0.4};
+    const double settled[4] = {0.2 + k * 0.8, 0.8 + k * 0.2,
+                               k * (0.8 + 0.4), 0.4};
+    HeaterRow heater(4, 5.0, k);
+    const double zero[4] = {0.0, 0.0, 0.0, 0.0};
+    heater.reset(zero);
+    double tune[4];
+    for (int n = 0; n < 400; ++n)
+      heater.step(drive, tune);
+    for (int i = 0; i < 4; ++i)
+      assert(std::fabs(tune[i] - settled[i]) < 1e-12);
+    heater.reset(drive);
+    heater.step(drive, tune);
+    for (int i = 0; i < 4; ++i)
+      assert(std::fabs(tune[i] - settled[i]) < 1e-12);
+  }
+
+  // settle_cycles is the first n with step * (1 - a)^n below tol
+  for (double tau : {0.3, 2.0, 8.0, 50.0}) {
+    const double a = HeaterRow::alpha(tau);
+    for (double tol : {1e-1, 1e-2, 1e-4}) {
+      const uint64_t n = HeaterRow::settle_cycles(tau, 1.0, tol);
+      assert(std::pow(1.0 - a, double(n)) <= tol);
+      assert(n == 1 || std::pow(1.0 - a, double(n - 1)) > tol);
+    }
+  }
+  assert(HeaterRow::settle_cycles(0.0, 1.0, 1e-6) == 1);
+
+  // Slowed ring (tuner_search_lock geometry): after a code step the drop
+  // ADC is within one code of its settled value from settle_cycles on, with
+  // tol the drive error worth one ADC LSB at the steepest Lorentzian slope.
+  // That is the wait_cycle the power detector needs.
+  ChainConfig cfg;
+  const std::vector<Wave> waves = {{1300.0, 1.0}};
+  const RingDropDouble ring(cfg, waves, 1295.0);
+  const double lsb = cfg.dac_full_scale / cfg.dac_max();
+  const double max_slope = 3.0 * std::sqrt(3.0) / 8.0; // max |L'(u)|
+  const double tol = 1.0 / (cfg.adc_gain() * max_slope / (cfg.fwhm / 2.0) *
+                            cfg.tuning_full_scale);
+  for (double tau : {1.0, 4.0, 16.0}) {
+    uint64_t worst = 0;
+    for (code_t from = 0; from < 256; from += 15) {
+      for (code_t to = 100; to < 180; to += 3) {
+        const double d0 = from * lsb;
+        const double d1 = to * lsb;
+        const uint64_t wait = HeaterRow::settle_cycles(tau, d1 - d0, tol);
+        const code_t target = ring.adc(to);
+        HeaterRow heater(1, tau);
+        heater.reset(&d0);
+        double tune = d0;
+        uint64_t settled_at = 0;
+        for (uint64_t n = 1; n <= wait + 200; ++n) {
+          heater.step(&d1, &tune);
+          const code_t code =
+              adc_code(cfg, ring.current_at(tune * cfg.tuning_full_scale));
+          if (std::abs(code - target) > 1)
+            settled_at = n + 1;
+        }
+        assert(settled_at <= wait);
+        worst = std::max(worst, wait);
+      }
+    }
+    std::cout << "tau " << tau << " cycles: worst-case wait " << worst
+              << " cycles\n";
+  }
+  return 0;
+}
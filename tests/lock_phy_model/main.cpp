@@ -0,0 +1,163 @@
+#include "models/lock_phy.hpp"
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+using namespace lock_phy;
+
+// Lorentzian drop power seen through an 8-bit ADC, FWHM in tune codes
+static int power_func(double tune, double peak, double fwhm = 25.0) {
+  double x = (tune - peak) / (fwhm / 2);
+  return static_cast<int>(std::floor(255.0 / (1.0 + x * x)));
+}
+
+// Number of windows until the ring stays within tol codes of target_code
+static int run(LockPhyModel &model, double peak, int target_code, int tol,
+               int windows) {
+  int settled = -1;
+  for (int w = 0; w < windows; ++w) {
+    model.step(power_func(model.ring_tune(), peak));
+    bool inside = std::abs(model.ring_tune() - target_code) <= tol;
+    if (!inside)
+      settled = -1;
+    else if (settled < 0)
+      settled = w;
+  }
+  return settled;
+}
+
+int main() {
+  constexpr int kPeak = 120;
+  const int peak_pwr = power_func(kPeak, kPeak);
+
+  // Both modes start kPullIn codes below their own lock point and settle
+  // to the same tolerance, so the pull-in windows compare like for like
+  constexpr int kPullIn = 20;
+  constexpr int kTol = 3;
+
+  // Slope detection climbs toward the peak one stride per round
+  LockPhyModel slope;
+  slope.configure(lock_mode_e::LOCK_MODE_SLOPE, 0, 2, 8, 4, 3);
+  slope.start(kPeak - kPullIn, kPeak, peak_pwr);
+  int slope_settled = run(slope, kPeak, kPeak, kTol, 400);
+
+  // PI locks to the half-power point on the low flank (ratio 8/16)
+  LockPhyModel pi;
+  pi.configure(lock_mode_e::LOCK_MODE_PI, 0, 2, 8, 4, 3);
+  const int half_code = kPeak - 12; // floor(255 / 2) at -FWHM/2
+  pi.start(half_code - kPullIn, kPeak, peak_pwr);
+  int pi_settled = run(pi, kPeak, half_code, kTol, 400);
+
+  std::cout << "Slope pull-in windows over " << kPullIn
+            << " codes: " << slope_settled << "\n";
+  std::cout << "PI pull-in windows over " << kPullIn
+            << " codes: " << pi_settled << " gear=" << pi.pi_gear()
+            << " tune=" << pi.ring_tune() << " tgt=" << pi.pwr_tgt() << "\n";
+  assert(slope_settled > 0);
+  assert(pi_settled >= 0);
+  assert(pi_settled < slope_settled);
+
+  // Upper flank start flips the tune direction
+  LockPhyModel pi_red;
+  pi_red.configure(lock_mode_e::LOCK_MODE_PI, 0, 2, 8, 4, 3);
+  pi_red.start(kPeak + 20, kPeak, peak_pwr);
+  assert(run(pi_red, kPeak, kPeak + 12, 2, 400) >= 0);
+
+  // Track a slow drift of the resonance: one code every 16 windows
+  double drift_peak = kPeak;
+  double err_sq = 0.0;
+  int n = 0;
+  for (int w = 0; w < 1024; ++w) {
+    if (w % 16 == 0)
+      drift_peak += 1.0;
+    pi.step(power_func(pi.ring_tune(), drift_peak));
+    if (w >= 64) {
+      double err = pi.pwr_tgt() - power_func(pi.ring_tune(), drift_peak);
+      err_sq += err * err;
+      ++n;
+    }
+  }
+  double rms = std::sqrt(err_sq / n);
+  std::cout << "PI drift tracking rms error: " << rms << "\n";
+  assert(rms < 16.0);
+
+  // Resonance jump: the loss counter fires, the local sweep around the last
+  // good code finds the new peak, and the lock re-enters at the original
+  // start-to-peak offset from it
+  {
+    constexpr int kJump = 30;
+    LockPhyModel relock;
+    relock.configure(lock_mode_e::LOCK_MODE_SLOPE, 0, 2, 8, 4, 3);
+    relock.configure_loss(4, 4, 40);
+    relock.start(kPeak - kPullIn, kPeak, peak_pwr);
+    assert(run(relock, kPeak, kPeak, kTol, 400) >= 0);
+    assert(relock.state() == lock_state_e::LOCK_ACTIVE);
+    assert(!relock.lock_lost());
+
+    const double new_peak = kPeak + kJump;
+    int windows = 0;
+    while (relock.state() == lock_state_e::LOCK_ACTIVE && windows < 100) {
+      relock.step(power_func(relock.ring_tune(), new_peak));
+      ++windows;
+    }
+    assert(relock.state() == lock_state_e::LOCK_SEARCH);
+    assert(relock.lock_lost());
+    assert(windows == 4);
+
+    const code_t lo = relock.local_search_start();
+    const code_t hi = relock.local_search_end();
+    assert(lo <= new_peak && new_peak <= hi);
+    code_t peak_code = lo;
+    for (code_t c = lo; c <= hi; ++c)
+      if (power_func(c, new_peak) > power_func(peak_code, new_peak))
+        peak_code = c;
+    relock.local_search_done(peak_code, power_func(peak_code, new_peak));
+    assert(relock.state() == lock_state_e::LOCK_ACTIVE);
+    assert(relock.ring_tune_peak() == kPeak + kJump);
+    assert(relock.ring_tune_offset() == -kPullIn);
+    assert(relock.ring_tune() == kPeak + kJump - kPullIn);
+    const int relock_settled = run(relock, new_peak, kPeak + kJump, kTol, 400);
+    assert(relock_settled >= 0);
+    assert(relock.state() == lock_state_e::LOCK_ACTIVE);
+    assert(!relock.lock_lost());
+    std::cout << "Re-acquire after " << kJump << " code jump: loss in "
+              << windows << " windows, re-lock in " << relock_settled
+              << " windows\n";
+  }
+
+  // A host interrupt during LOCK_SEARCH is held and served once the lock
+  // re-enters LOCK_ACTIVE
+  {
+    LockPhyModel intr;
+    intr.configure(lock_mode_e::LOCK_MODE_SLOPE, 0, 2, 8, 4, 3);
+    intr.configure_loss(4, 4, 40);
+    intr.start(kPeak - kPullIn, kPeak, peak_pwr);
+    run(intr, kPeak, kPeak, kTol, 400);
+    while (intr.state() == lock_state_e::LOCK_ACTIVE)
+      intr.step(power_func(intr.ring_tune(), kPeak + 30));
+    assert(intr.state() == lock_state_e::LOCK_SEARCH);
+    intr.interrupt();
+    assert(intr.state() == lock_state_e::LOCK_SEARCH);
+    assert(intr.intr_pending());
+    intr.local_search_done(kPeak + 30, peak_pwr);
+    assert(intr.state() == lock_state_e::LOCK_INTR);
+    assert(!intr.intr_pending());
+    intr.resume();
+    assert(intr.state() == lock_state_e::LOCK_IDLE);
+  }
+
+  // Zero half width only flags the loss and keeps tracking
+  {
+    LockPhyModel flag;
+    flag.configure(lock_mode_e::LOCK_MODE_SLOPE, 0, 2, 8, 4, 3);
+    flag.configure_loss(4, 4, 0);
+    flag.start(kPeak - kPullIn, kPeak, peak_pwr);
+    run(flag, kPeak, kPeak, kTol, 400);
+    for (int w = 0; w < 8; ++w)
+      flag.step(power_func(flag.ring_tune(), kPeak + 60));
+    assert(flag.state() == lock_state_e::LOCK_ACTIVE);
+    assert(flag.lock_lost());
+  }
+  return 0;
+}
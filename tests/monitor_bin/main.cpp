@@ -0,0 +1,68 @@
+#include "utils/monitor_bin.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace monitor_bin;
+
+int main() {
+  constexpr uint32_t kChunkRows = 4096;
+  constexpr uint64_t kRows = 100000;
+  const std::string kFile = "monitor_bin_test.swm";
+
+  auto tune = [](uint64_t n) { return static_cast<int>((n / 7) % 256); };
+  auto pwr = [](uint64_t n) { return std::sin(1e-3 * double(n)); };
+  auto state = [](uint64_t n) { return static_cast<int>((n / 30000) % 3); };
+
+  {
+    MonitorBinWriter w(kChunkRows);
+    w.add_column("time", col_type_e::F64);
+    w.add_column("tune_code", col_type_e::I32);
+    w.add_column("o_pwr_drop", col_type_e::F64);
+    w.add_column("lock_state", col_type_e::U8, {"IDLE", "INIT", "ACTIVE"});
+    w.open(kFile);
+    for (uint64_t n = 0; n < kRows; ++n) {
+      w.append(10.0 * double(n), tune(n), pwr(n), state(n));
+    }
+    assert(w.num_rows() == kRows);
+  }
+
+  MonitorBinReader r(kFile);
+  assert(r.num_rows() == kRows);
+  assert(r.chunk_rows() == kChunkRows);
+  assert(r.columns().size() == 4);
+  assert(r.columns()[3].name == "lock_state");
+  assert(r.columns()[3].labels.size() == 3);
+  assert(r.columns()[3].labels[2] == "ACTIVE");
+  assert(r.chunks().size() == (kRows + kChunkRows - 1) / kChunkRows);
+  assert(r.chunks().back().rows == kRows % kChunkRows);
+
+  // Samples round-trip and summaries bound them
+  uint64_t base = 0;
+  for (size_t k = 0; k < r.chunks().size(); ++k) {
+    const auto &ch = r.chunks()[k];
+    const auto t = r.read_column(k, 0);
+    const auto code = r.read_column(k, 1);
+    const auto p = r.read_column(k, 2);
+    const auto s = r.read_column(k, 3);
+    assert(ch.min[0] == t.front() && ch.max[0] == t.back());
+    for (uint64_t i = 0; i < ch.rows; ++i) {
+      const uint64_t n = base + i;
+      assert(t[i] == 10.0 * double(n));
+      assert(code[i] == tune(n));
+      assert(p[i] == pwr(n));
+      assert(s[i] == state(n));
+      for (size_t c = 0; c < 4; ++c) {
+        const double v = c == 0 ? t[i] : c == 1 ? code[i] : c == 2 ? p[i] : s[i];
+        assert(v >= ch.min[c] && v <= ch.max[c]);
+      }
+    }
+    base += ch.rows;
+  }
+  assert(base == kRows);
+
+  std::cout << "Rows: " << r.num_rows() << " in " << r.chunks().size()
+            << " chunks" << std::endl;
+  return 0;
+}
@@ -0,0 +1,109 @@
+#include "utils/options.hpp"
+#include <array>
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace options;
+
+namespace {
+
+bool throws(void (*fn)()) {
+  try {
+    fn();
+  } catch (const std::runtime_error &) {
+    return true;
+  }
+  return false;
+}
+
+} // namespace
+
+int main() {
+  {
+    std::ofstream ofs("options_test.toml");
+    ofs << "# lock loop\n"
+        << "sync_cycle = 8\n"
+        << "lock_offset = [-10, 10]  # per ring\n"
+        << "stimulus_file = \"drift # 1.csv\"\n"
+        << "[noise]\n"
+        << "pd_white_lsb = 0.5\n";
+  }
+  {
+    std::ofstream ofs("options_test.json");
+    ofs << "{\n  \"sync_cycle\": 6,\n  \"lock_mode\": true,\n"
+        << "  \"lock_pi_kp_shift\": [3, 4],\n"
+        << "  \"noise\": {\"seed\": 7}\n}\n";
+  }
+
+  // TOML file, then command line overrides (including per-ring elements)
+  {
+    const char *argv[] = {"tb", "+verilator+seed+5", "--config=options_test.toml",
+                          "+sync_cycle=12", "+lock_offset.1=25", "positional"};
+    Options opts(6, const_cast<char **>(argv));
+    assert(opts.get<int>("sync_cycle", 4) == 12);
+    const auto offset = opts.get_array<int, 2>("lock_offset", {-20, 20});
+    assert(offset[0] == -10 && offset[1] == 25);
+    assert(opts.get<std::string>("stimulus_file", "") == "drift # 1.csv");
+    assert(opts.get<double>("noise.pd_white_lsb", 0.0) == 0.5);
+    assert(opts.get<int>("lock_mode", 0) == 0); // default
+    assert(opts.unused().empty());
+    opts.check_unused();
+    opts.write_effective("options_effective.toml");
+  }
+
+  // The effective config reproduces the run
+  {
+    Options opts;
+    opts.load_file("options_effective.toml");
+    assert(opts.get<int>("sync_cycle", 0) == 12);
+    const auto offset = opts.get_array<int, 2>("lock_offset", {0, 0});
+    assert(offset[0] == -10 && offset[1] == 25);
+    assert(opts.get<std::string>("stimulus_file", "") == "drift # 1.csv");
+  }
+
+  // JSON with nesting; scalar broadcast to every ring
+  {
+    Options opts;
+    opts.load_file("options_test.json");
+    assert(opts.get<int>("sync_cycle", 4) == 6);
+    assert(opts.get<bool>("lock_mode", false));
+    const auto kp = opts.get_array<int, 2>("lock_pi_kp_shift", {5, 5});
+    assert(kp[0] == 3 && kp[1] == 4);
+    assert(opts.get<uint64_t>("noise.seed", 1) == 7);
+    opts.set("lock_loss_cnt", "3");
+    const auto cnt = opts.get_array<int, 2>("lock_loss_cnt", {4, 4});
+    assert(cnt[0] == 3 && cnt[1] == 3);
+  }
+
+  // Typos and bad values are errors, not silent defaults
+  assert(throws([] {
+    Options opts;
+    opts.set("sync_cylce", "8");
+    opts.get<int>("sync_cycle", 4);
+    opts.check_unused();
+  }));
+  assert(throws([] {
+    Options opts;
+    opts.set("sync_cycle", "8x");
+    opts.get<int>("sync_cycle", 4);
+  }));
+  assert(throws([] {
+    Options opts;
+    opts.set("lock_offset", "[1, 2, 3]");
+    opts.get_array<int, 2>("lock_offset", {0, 0});
+  }));
+  assert(throws([] {
+    Options opts;
+    opts.set("scenario_index", "-1");
+    opts.get<uint64_t>("scenario_index", 0);
+  }));
+
+  std::remove("options_test.toml");
+  std::remove("options_test.json");
+  std::remove("options_effective.toml");
+  std::cout << "options: all checks passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,67 @@
+#include "utils/profiler.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+using namespace profiler;
+
+namespace {
+
+volatile double sink = 0.0;
+
+void work(int n) {
+  for (int i = 0; i < n; ++i)
+    sink = sink + std::sqrt(static_cast<double>(i));
+}
+
+} // namespace
+
+int main() {
+  global().set_enabled(true);
+  const Phase outer("outer");
+  const Phase inner("inner");
+  assert(Phase("outer").stats() == outer.stats());
+
+  for (int i = 0; i < 100; ++i) {
+    ScopedTimer t(outer);
+    work(1000);
+    {
+      ScopedTimer t2(inner);
+      work(1000);
+    }
+  }
+  const PhaseStats &o = *outer.stats();
+  const PhaseStats &in = *inner.stats();
+  assert(o.calls == 100 && in.calls == 100);
+  assert(o.depth == 0 && in.depth == 1);
+  assert(o.child_ticks == in.ticks);
+  assert(o.ticks > in.ticks);
+  assert(current_timer == nullptr);
+
+  // Disabled timers record nothing
+  global().set_enabled(false);
+  {
+    ScopedTimer t(outer);
+    work(10);
+  }
+  assert(o.calls == 100);
+  global().set_enabled(true);
+
+  // Per-timer overhead with an empty body
+  const Phase empty("empty");
+  constexpr int kIters = 1000000;
+  const uint64_t t0 = ticks();
+  for (int i = 0; i < kIters; ++i) {
+    ScopedTimer t(empty);
+  }
+  const uint64_t t1 = ticks();
+  const double ns = (t1 - t0) / global().ticks_per_ns() / kIters;
+
+  std::ostringstream os;
+  global().report(os);
+  assert(os.str().find("inner") != std::string::npos);
+  assert(os.str().find("(untimed)") != std::string::npos);
+  std::cout << os.str() << "Timer overhead: " << ns << " ns" << std::endl;
+  return 0;
+}
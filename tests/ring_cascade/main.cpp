@@ -0,0 +1,106 @@
+#include "models/ring_tf.hpp"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace ring_tf;
+
+constexpr size_t kNumRings = 32;
+constexpr size_t kNumWaves = 32;
+
+static bool same_q48(const RingRowLut &full, RingRowCascade &inc,
+                     const std::vector<code_t> &codes) {
+  std::vector<uint64_t> a(kNumRings), b(kNumRings);
+  full.evaluate_q48(codes.data(), a.data());
+  inc.evaluate_q48(codes.data(), b.data());
+  return a == b;
+}
+
+int main() {
+  // Dense row: 1 nm grid, rings interleaved with the waves
+  ChainConfig cfg;
+  cfg.fwhm = 0.25;
+  cfg.adc_full_scale = 1000.0;
+  std::vector<Wave> waves;
+  std::vector<double> rings;
+  for (size_t i = 0; i < kNumWaves; ++i)
+    waves.push_back({1300.0 + i, 1000.0});
+  for (size_t r = 0; r < kNumRings; ++r)
+    rings.push_back(1295.3 + r);
+  RingRowLut full(cfg, waves, rings);
+  RingRowCascade inc(cfg, waves, rings);
+
+  std::mt19937_64 rng(1);
+  std::uniform_int_distribution<code_t> any_code(0, cfg.dac_max());
+  std::uniform_int_distribution<size_t> any_ring(0, kNumRings - 1);
+  std::vector<code_t> codes(kNumRings);
+
+  // Bit-exact under arbitrary code changes
+  for (int n = 0; n < 200; ++n) {
+    for (auto &c : codes)
+      c = any_code(rng);
+    assert(same_q48(full, inc, codes));
+  }
+
+  // Lock dither: one ring moves by one code per evaluation
+  size_t updates = 0;
+  constexpr int kDither = 5000;
+  for (int n = 0; n < kDither; ++n) {
+    const size_t r = any_ring(rng);
+    codes[r] = std::clamp<code_t>(codes[r] + (n & 1 ? 1 : -1), 0,
+                                  cfg.dac_max());
+    for (size_t k = 0; k < kNumRings; ++k)
+      inc.set_code(k, codes[k]);
+    updates += inc.update();
+    if (n % 50 == 0)
+      assert(same_q48(full, inc, codes));
+  }
+  const double per_eval = double(updates) / kDither;
+  std::cout << "Dither: " << per_eval << " of " << kNumRings * kNumWaves
+            << " (ring, wave) pairs per evaluation\n";
+  assert(per_eval < 0.5 * kNumRings * kNumWaves);
+
+  // Resonance moves invalidate the cached factors
+  for (int n = 0; n < 20; ++n) {
+    const size_t r = any_ring(rng);
+    const double wvl = 1295.0 + 0.37 * n;
+    full.set_ring(r, wvl);
+    inc.set_ring(r, wvl);
+    codes[any_ring(rng)] = any_code(rng);
+    assert(same_q48(full, inc, codes));
+  }
+  std::vector<code_t> a_full(kNumRings), a_inc(kNumRings);
+  full.evaluate_adc(codes.data(), a_full.data());
+  inc.evaluate_adc(codes.data(), a_inc.data());
+  assert(a_full == a_inc);
+
+  // Per-evaluation cost under dither
+  constexpr int kIters = 20000;
+  std::vector<uint64_t> acc(kNumRings);
+  volatile uint64_t sink = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int n = 0; n < kIters; ++n) {
+    codes[n % kNumRings] ^= 1;
+    full.evaluate_q48(codes.data(), acc.data());
+    sink = sink + acc[0];
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  for (int n = 0; n < kIters; ++n) {
+    codes[n % kNumRings] ^= 1;
+    inc.evaluate_q48(codes.data(), acc.data());
+    sink = sink + acc[0];
+  }
+  auto t2 = std::chrono::steady_clock::now();
+  std::cout << "full: "
+            << std::chrono::duration<double, std::micro>(t1 - t0).count() /
+                   kIters
+            << " us/eval, incremental: "
+            << std::chrono::duration<double, std::micro>(t2 - t1).count() /
+                   kIters
+            << " us/eval\n";
+  return 0;
+}
@@ -0,0 +1,135 @@
+#include "models/ring_tf.hpp"
+#include "models/search_phy.hpp"
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace ring_tf;
+
+template <typename Plant>
+static search_phy::SearchPhyModel run_search(const Plant &plant) {
+  search_phy::SearchPhyModel model;
+  model.configure(0, 255, 0);
+  model.start();
+  while (model.state() == search_phy::search_state_e::SEARCH_ACTIVE) {
+    model.step(static_cast<uint8_t>(plant.adc(model.ring_tune())));
+  }
+  return model;
+}
+
+int main() {
+  // Table vs exact Lorentzian
+  const auto &lut = LorentzianLut::instance();
+  const double bound = LorentzianLut::max_abs_error();
+  double max_err = 0.0;
+  for (double u = -80.0; u <= 80.0; u += 1.0 / 4096.0 + 1e-7) {
+    max_err = std::max(max_err, std::abs(lut.eval(u) - lorentzian(u)));
+  }
+  assert(max_err <= bound);
+  // Below half an 8-bit LSB of a full-scale drop, guaranteed and measured
+  constexpr double kLsb8 = 1.0 / 255.0;
+  assert(bound < 0.5 * kLsb8);
+  assert(max_err < 0.5 * kLsb8);
+  std::cout << "LUT max error " << max_err << " (bound " << bound << ", "
+            << max_err / kLsb8 << " LSB at 8 bits)\n";
+
+  // Single ring drop chain, tuner_search geometry (two waves)
+  ChainConfig cfg;
+  cfg.fwhm = 0.2;
+  const std::vector<Wave> waves = {{1300.0, 1.0}, {1302.0, 1.0}};
+  RingDropDouble ref(cfg, waves, 1295.0);
+  RingDropLut fast(cfg, waves, 1295.0);
+  const double bound_lsb = fast.error_bound_lsb();
+  assert(bound_lsb < 0.5);
+
+  double max_lsb = 0.0;
+  int mismatch = 0;
+  int total = 0;
+  for (double wvl_ring = 1293.0; wvl_ring <= 1297.0; wvl_ring += 0.0371) {
+    ref.set_ring(wvl_ring);
+    fast.set_ring(wvl_ring);
+    for (code_t code = 0; code <= cfg.dac_max(); ++code) {
+      const double err =
+          std::abs(fast.current(code) - ref.current(code)) * cfg.adc_gain();
+      max_lsb = std::max(max_lsb, err);
+      const int diff = std::abs(fast.adc(code) - ref.adc(code));
+      assert(diff <= 1);
+      mismatch += diff != 0;
+      ++total;
+    }
+  }
+  assert(max_lsb <= bound_lsb);
+  assert(max_lsb < 0.5);
+  std::cout << "Drop chain max error " << max_lsb << " LSB (bound "
+            << bound_lsb << "), ADC mismatch " << mismatch << "/" << total
+            << "\n";
+
+  // Same peaks out of the search model with either plant (headroom so the
+  // resonances do not saturate the ADC)
+  ChainConfig search_cfg = cfg;
+  search_cfg.adc_full_scale = 2.0;
+  const auto s_ref = run_search(RingDropDouble(search_cfg, waves, 1295.01));
+  const auto s_fast = run_search(RingDropLut(search_cfg, waves, 1295.01));
+  assert(s_ref.peaks_cnt() == 2);
+  assert(s_fast.peaks_cnt() == s_ref.peaks_cnt());
+  for (int i = 0; i < int(s_ref.peaks_cnt()); ++i) {
+    const int d = int(s_fast.ring_tune_peaks()[i]) -
+                  int(s_ref.ring_tune_peaks()[i]);
+    assert(std::abs(d) <= 1);
+    std::cout << "Peak " << i << " code=" << s_ref.ring_tune_peaks()[i]
+              << " pwr=" << s_ref.pwr_peaks()[i] << "\n";
+  }
+
+  // Row cascade, tuner_search_row geometry
+  ChainConfig row_cfg;
+  row_cfg.fwhm = 0.25;
+  row_cfg.adc_full_scale = 1000.0;
+  const std::vector<Wave> row_waves = {{1300.0, 1000.0}, {1302.0, 1000.0}};
+  const std::vector<double> rings = {1295.0, 1296.0};
+  RingRowDouble row_ref(row_cfg, row_waves, rings);
+  RingRowLut row_fast(row_cfg, row_waves, rings);
+  double row_max[2] = {0.0, 0.0};
+  for (code_t c0 = 0; c0 <= row_cfg.dac_max(); c0 += 3) {
+    for (code_t c1 = 0; c1 <= row_cfg.dac_max(); c1 += 5) {
+      const code_t codes[2] = {c0, c1};
+      double i_ref[2], i_fast[2];
+      code_t a_ref[2], a_fast[2];
+      row_ref.evaluate(codes, i_ref);
+      row_fast.evaluate(codes, i_fast);
+      row_ref.evaluate_adc(codes, a_ref);
+      row_fast.evaluate_adc(codes, a_fast);
+      for (int r = 0; r < 2; ++r) {
+        row_max[r] = std::max(row_max[r], std::abs(i_fast[r] - i_ref[r]) *
+                                              row_cfg.adc_gain());
+        assert(std::abs(a_fast[r] - a_ref[r]) <= 1);
+      }
+    }
+  }
+  for (int r = 0; r < 2; ++r) {
+    assert(row_max[r] <= row_fast.error_bound_lsb(r));
+    std::cout << "Row ring " << r << " max error " << row_max[r]
+              << " LSB (bound " << row_fast.error_bound_lsb(r) << ")\n";
+  }
+
+  // Per-evaluation cost
+  constexpr int kIters = 2000;
+  volatile code_t sink = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int n = 0; n < kIters; ++n)
+    for (code_t code = 0; code <= cfg.dac_max(); ++code)
+      sink = sink + ref.adc(code);
+  auto t1 = std::chrono::steady_clock::now();
+  for (int n = 0; n < kIters; ++n)
+    for (code_t code = 0; code <= cfg.dac_max(); ++code)
+      sink = sink + fast.adc(code);
+  auto t2 = std::chrono::steady_clock::now();
+  const double evals = double(kIters) * (cfg.dac_max() + 1);
+  std::cout << "double: "
+            << std::chrono::duration<double, std::nano>(t1 - t0).count() / evals
+            << " ns/eval, lut: "
+            << std::chrono::duration<double, std::nano>(t2 - t1).count() / evals
+            << " ns/eval\n";
+  return 0;
+}
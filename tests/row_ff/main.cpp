@@ -0,0 +1,135 @@
+#include "models/ring_tf.hpp"
+#include "models/row_ff.hpp"
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace row_ff;
+
+constexpr size_t kNumRings = 4;
+constexpr int kWindow = 64; // cycles per lock update
+
+// Row of bang-bang locks (one code per window toward the resonance) behind
+// the feedforward. The resonances sit at base + drift in DAC codes, and a
+// common drift step is applied once every ring is locked. Returns the
+// cycles until every ring is within one code of its resonance for good.
+static int relock_cycles(RowFeedforward &ff, int drift, int cycles,
+                         code_t *ff_cm_end, code_t *corr_end) {
+  const code_t base[kNumRings] = {60, 100, 140, 180};
+  code_t tune[kNumRings], out[kNumRings];
+  bool active[kNumRings];
+  for (size_t i = 0; i < kNumRings; ++i) {
+    tune[i] = base[i];
+    active[i] = true;
+  }
+  ff.reset();
+  int last_out = -1;
+  for (int n = 0; n < cycles; ++n) {
+    ff.apply(tune, out);
+    bool settled = true;
+    for (size_t i = 0; i < kNumRings; ++i) {
+      const code_t res = base[i] + drift;
+      settled = settled && std::abs(out[i] - res) <= 1;
+      if (n % kWindow == kWindow - 1)
+        tune[i] += (res > out[i]) - (res < out[i]);
+    }
+    if (!settled)
+      last_out = n;
+    ff.step(tune, active);
+  }
+  *ff_cm_end = ff.ff_cm();
+  *corr_end = 0;
+  for (size_t i = 0; i < kNumRings; ++i)
+    *corr_end = std::max<code_t>(*corr_end, std::abs(tune[i] - base[i]));
+  return last_out + 1;
+}
+
+int main() {
+  // All zero config is pass-through
+  {
+    RowFeedforward ff(kNumRings);
+    const bool active[kNumRings] = {true, true, false, true};
+    for (code_t c = 0; c <= RowFeedforward::CODE_MAX; c += 5) {
+      const code_t tune[kNumRings] = {c, RowFeedforward::CODE_MAX - c, 7, c};
+      code_t out[kNumRings];
+      ff.apply(tune, out);
+      for (size_t i = 0; i < kNumRings; ++i)
+        assert(out[i] == tune[i]);
+      ff.step(tune, active);
+      assert(ff.ff_cm() == 0);
+    }
+  }
+
+  // Common-mode offload: the row follows a drift step faster, and the
+  // offset ends up carrying it while each lock returns to its entry code
+  {
+    constexpr int kDrift = 12;
+    constexpr int kCycles = 40000;
+    RowFeedforward off(kNumRings), on(kNumRings);
+    on.configure(true, 10);
+    code_t cm_off, corr_off, cm_on, corr_on;
+    const int t_off = relock_cycles(off, kDrift, kCycles, &cm_off, &corr_off);
+    const int t_on = relock_cycles(on, kDrift, kCycles, &cm_on, &corr_on);
+    std::cout << "Re-lock after " << kDrift << " code drift: " << t_off
+              << " cycles without, " << t_on << " with feedforward\n";
+    assert(cm_off == 0 && corr_off == kDrift);
+    assert(t_on < t_off);
+    assert(std::abs(cm_on - kDrift) <= 1);
+    assert(corr_on <= 1);
+  }
+
+  // Crosstalk compensation: a neighbour's tune step leaves a ring's heater
+  // tuning (heater.sv coupling, in DAC codes) unchanged to first order
+  {
+    constexpr double kCoupling = 0.08;
+    const int coef = static_cast<int>(std::lround(kCoupling * 256));
+    for (bool comp : {false, true}) {
+      RowFeedforward ff(kNumRings);
+      for (size_t i = 0; i + 1 < kNumRings; ++i) {
+        ff.set_xtalk(i, i + 1, comp ? coef : 0);
+        ff.set_xtalk(i + 1, i, comp ? coef : 0);
+      }
+      ring_tf::HeaterRow heater(kNumRings, 0.0, kCoupling);
+      auto ring1_tuning = [&](code_t neighbour) {
+        const code_t tune[kNumRings] = {neighbour, 128, 128, 128};
+        code_t out[kNumRings];
+        ff.apply(tune, out);
+        double drive[kNumRings], tuning[kNumRings];
+        for (size_t i = 0; i < kNumRings; ++i)
+          drive[i] = out[i];
+        heater.step(drive, tuning);
+        return tuning[1];
+      };
+      const double shift = ring1_tuning(200) - ring1_tuning(40);
+      std::cout << "Ring 1 shift for a 160 code neighbour step: " << shift
+                << (comp ? " compensated\n" : "\n");
+      if (comp)
+        assert(std::fabs(shift) < 0.1 * kCoupling * 160);
+      else
+        assert(std::fabs(shift - kCoupling * 160) < 1e-9);
+    }
+  }
+
+  // Offset and compensation saturate at the DAC range
+  {
+    RowFeedforward ff(2);
+    ff.configure(true, 0);
+    ff.set_xtalk(0, 1, -128);
+    const bool active[2] = {true, true};
+    code_t tune[2] = {250, 250};
+    ff.step(tune, active);
+    tune[0] = 255;
+    tune[1] = 255;
+    for (int n = 0; n < 100; ++n)
+      ff.step(tune, active);
+    assert(ff.ff_cm() == RowFeedforward::CODE_MAX);
+    code_t out[2];
+    ff.apply(tune, out);
+    assert(out[0] == RowFeedforward::CODE_MAX);
+    assert(out[1] == RowFeedforward::CODE_MAX);
+  }
+  return 0;
+}
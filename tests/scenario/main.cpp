@@ -0,0 +1,92 @@
+#include "utils/scenario.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+using namespace scenario;
+
+int main() {
+  ScenarioConfig cfg;
+  cfg.num_lasers = 4;
+  cfg.num_rings = 4;
+  cfg.laser_grid_offset = Dist::uniform(-0.2, 0.2);
+  cfg.laser_wvl_error = Dist::normal(0.0, 0.02);
+  cfg.laser_pwr = Dist::uniform(900.0, 1100.0);
+  cfg.ring_fab_offset = Dist::normal(0.0, 0.5);
+  cfg.fwhm_scale = Dist::normal(1.0, 0.1);
+  cfg.tune_scale = Dist::uniform(0.9, 1.1);
+  ScenarioGenerator gen(cfg, 42);
+
+  // Index-addressed: scenario k does not depend on what was drawn before
+  const Scenario s7 = gen.generate(7);
+  for (uint64_t i = 0; i < 100; ++i) {
+    gen.generate(i);
+  }
+  const Scenario s7b = gen.generate(7);
+  assert(s7.ring_wvl == s7b.ring_wvl);
+  assert(s7.fwhm_scale == s7b.fwhm_scale);
+  assert(s7.laser_wvl == s7b.laser_wvl);
+  assert(s7.laser_pwr == s7b.laser_pwr);
+
+  // Different seeds and indices give different draws
+  assert(ScenarioGenerator(cfg, 43).generate(7).ring_wvl != s7.ring_wvl);
+  assert(gen.generate(8).ring_wvl != s7.ring_wvl);
+  // 64-bit indices are distinct from their low 32 bits
+  assert(gen.generate(7 + (uint64_t{1} << 32)).ring_wvl != s7.ring_wvl);
+
+  // Moments over many scenarios
+  constexpr int kN = 20000;
+  double sum = 0.0, sum2 = 0.0, tmin = 2.0, tmax = 0.0;
+  for (int i = 0; i < kN; ++i) {
+    const Scenario s = gen.generate(i);
+    const double off = s.ring_wvl[1] - (cfg.ring_wvl_start + cfg.ring_spacing);
+    sum += off;
+    sum2 += off * off;
+    tmin = std::min(tmin, s.tune_scale[2]);
+    tmax = std::max(tmax, s.tune_scale[2]);
+    assert(s.laser_pwr >= 900.0 && s.laser_pwr <= 1100.0);
+  }
+  const double mean = sum / kN;
+  const double sigma = std::sqrt(sum2 / kN - mean * mean);
+  std::cout << "ring_fab_offset mean=" << mean << " sigma=" << sigma
+            << std::endl;
+  assert(std::fabs(mean) < 0.02);
+  assert(std::fabs(sigma - 0.5) < 0.02);
+  assert(tmin >= 0.9 && tmax <= 1.1 && tmax - tmin > 0.19);
+
+  // Constant distributions reproduce the nominal design
+  const Scenario nominal = ScenarioGenerator(ScenarioConfig{}, 1).generate(3);
+  assert(nominal.ring_wvl[0] == 1295.0 && nominal.ring_wvl[1] == 1298.0);
+  assert(nominal.laser_wvl[1] == 1302.0 && nominal.laser_pwr == 1000.0);
+  assert(nominal.fwhm_scale[0] == 1.0 && nominal.tune_scale[1] == 1.0);
+
+  // Manifest round trip rebuilds an identical generator
+  gen.write_manifest("scenario_test_manifest.csv", 0, 16);
+  const ScenarioGenerator regen =
+      ScenarioGenerator::from_manifest("scenario_test_manifest.csv");
+  assert(regen.seed() == 42);
+  assert(regen.config().num_rings == 4);
+  for (uint64_t i : {0, 5, 15, 12345}) {
+    const Scenario a = gen.generate(i);
+    const Scenario b = regen.generate(i);
+    assert(a.ring_wvl == b.ring_wvl && a.fwhm_scale == b.fwhm_scale);
+    assert(a.tune_scale == b.tune_scale && a.laser_wvl == b.laser_wvl);
+  }
+
+  // Shards tile the sweep exactly
+  uint64_t next = 0;
+  for (uint64_t k = 0; k < 7; ++k) {
+    const auto [first, last] = shard_range(100, k, 7);
+    assert(first == next);
+    assert(last - first == 14 || last - first == 15);
+    next = last;
+  }
+  assert(next == 100);
+
+  std::remove("scenario_test_manifest.csv");
+  std::cout << "scenario: all checks passed" << std::endl;
+  return 0;
+}
@@ -1,5 +1,7 @@
 #include "models/search_phy.hpp"
 #include <cassert>
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
 
 using namespace search_phy;
@@ -15,6 +17,31 @@ static int power_func(int tune) {
   return pwr & 0xFF;
 }
 
+// Drop-port resonance at a fractional code, 8-bit ADC
+static int lorentzian(int tune, double center, double fwhm) {
+  const double d = 2.0 * (tune - center) / fwhm;
+  return static_cast<int>(std::lround(240.0 / (1.0 + d * d)));
+}
+
+// Sweep 0..255 and return the peak's error against the true center, or
+// kMissed when the strict three-sample detector misses a flat top
+static constexpr double kMissed = -1.0;
+
+static double fit_error(double center, int stride, bool fit_mode,
+                        code_t *samples) {
+  SearchPhyModel model;
+  model.configure(0, 255, stride, fit_mode);
+  model.start();
+  while (model.state() == search_state_e::SEARCH_ACTIVE) {
+    model.step(lorentzian(model.ring_tune(), center, 6.4));
+  }
+  assert(model.peaks_cnt() <= 1);
+  *samples = model.samples();
+  if (model.peaks_cnt() == 0)
+    return kMissed;
+  return std::abs(double(model.ring_tune_peaks()[0]) - center);
+}
+
 int main() {
   SearchPhyModel model;
   model.configure(0, 20, 0); // sweep 0..20 step 1
@@ -34,9 +61,36 @@ int main() {
   assert(peaks[1] == 15);
 
   std::cout << "Peaks detected: " << (int)model.peaks_cnt() << "\n";
-  for (int i = 0; i < model.peaks_cnt(); ++i) {
+  for (int i = 0; i < int(model.peaks_cnt()); ++i) {
     std::cout << "Peak " << i << " code=" << (int)peaks[i]
               << " pwr=" << (int)pwrs[i] << "\n";
   }
+
+  // Sparse sweep with the Lorentzian fit: a quarter of the transactions of
+  // a dense sweep, with the peak always found and within one code. A miss
+  // counts as a failure of the max-pick detectors.
+  double max_dense = 0.0, max_fit = 0.0, max_sparse = 0.0;
+  int dense_missed = 0, sparse_failed = 0;
+  code_t dense_samples = 0, fit_samples = 0;
+  for (double center = 60.0; center < 200.0; center += 0.37) {
+    const double dense = fit_error(center, 0, false, &dense_samples);
+    const double fit = fit_error(center, 2, true, &fit_samples);
+    code_t unused;
+    const double sparse = fit_error(center, 2, false, &unused);
+    assert(fit != kMissed);
+    max_fit = std::max(max_fit, fit);
+    max_dense = std::max(max_dense, dense);
+    max_sparse = std::max(max_sparse, sparse);
+    dense_missed += dense == kMissed;
+    sparse_failed += sparse == kMissed || sparse > 1.0;
+  }
+  assert(int(fit_samples) * 4 <= int(dense_samples) + 4);
+  assert(max_fit <= 1.0);
+  assert(sparse_failed > 0);
+  std::cout << "Lorentzian fit: " << fit_samples << " samples, max error "
+            << max_fit << " codes (sparse max-pick " << max_sparse << ", "
+            << sparse_failed << " failed; dense " << dense_samples
+            << " samples " << max_dense << ", " << dense_missed
+            << " missed)\n";
   return 0;
 }
@@ -0,0 +1,118 @@
+#include "testbench/stimulus_replay.hpp"
+#include <cassert>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+using namespace stimulus_replay;
+
+namespace {
+
+bool near(double a, double b, double tol = 1e-9) {
+  return std::fabs(a - b) <= tol;
+}
+
+} // namespace
+
+int main() {
+  const std::string kFile = "stimulus_replay_test.csv";
+  // 10 Hz capture: pwr ramps 1.0 -> 0.9 over 1000 s, temp = 25 + 0.01 * t
+  constexpr int kRows = 10001;
+  {
+    std::ofstream ofs(kFile);
+    ofs << "time,pwr,temp\r\n";
+    for (int n = 0; n < kRows; ++n) {
+      const double t = 0.1 * n;
+      ofs << t << "," << 1.0 - 1e-4 * t << "," << 25.0 + 0.01 * t << "\r\n";
+    }
+  }
+
+  StimulusFile f(kFile);
+  assert(f.columns().size() == 3);
+  assert(f.column("temp") == 2);
+  assert(f.column("missing") == -1);
+
+  // 1 ps of simulation = 1 ms of capture
+  constexpr double kTracePerPs = 1e-3;
+  double pwr = 0.0;
+  double wvl = 0.0;
+  {
+    StimulusReplay replay(kFile, kTracePerPs);
+    replay.bind("pwr", &pwr);
+    // 0.08 nm/K around 1295 nm at 25 C
+    replay.bind("temp", &wvl, 0.08, 1295.0 - 0.08 * 25.0);
+
+    // Every 10 ps of simulation (10 ms) lands between capture rows
+    for (uint64_t t_ps = 0; t_ps <= 20000; t_ps += 10) {
+      replay.update(t_ps);
+      const double t = kTracePerPs * double(t_ps);
+      assert(near(pwr, 1.0 - 1e-4 * t, 1e-9));
+      assert(near(wvl, 1295.0 + 0.08 * 0.01 * t, 1e-9));
+    }
+    assert(near(replay.value("temp"), 25.0 + 0.01 * 20.0, 1e-9));
+    assert(replay.rows_skipped() == 0);
+    assert(!replay.exhausted());
+  }
+
+  {
+    // Decimation: 1 ps = 10 s of capture, so 99 of every 100 rows are
+    // stepped over without being parsed
+    StimulusReplay replay(kFile, 10.0);
+    replay.bind("pwr", &pwr);
+    for (uint64_t t_ps = 0; t_ps <= 100; ++t_ps) {
+      replay.update(t_ps);
+      const double t = std::min(10.0 * double(t_ps), 1000.0);
+      assert(near(pwr, 1.0 - 1e-4 * t, 1e-9));
+    }
+    assert(replay.exhausted());
+    assert(replay.rows_skipped() > 9 * replay.rows_read());
+    // Held at the last row past the end of the capture
+    replay.update(1000);
+    assert(near(pwr, 0.9, 1e-9));
+  }
+
+  {
+    // Interval-gated updates hold the port between refreshes
+    StimulusReplay replay(kFile, kTracePerPs, 0.0, 1000);
+    replay.bind("pwr", &pwr);
+    replay.update(0);
+    const double p0 = pwr;
+    replay.update(500);
+    assert(pwr == p0);
+    replay.update(1000);
+    assert(near(pwr, 1.0 - 1e-4 * 1.0, 1e-9));
+  }
+
+  bool threw = false;
+  try {
+    StimulusReplay replay(kFile, kTracePerPs);
+    replay.bind("missing", &pwr);
+  } catch (const std::runtime_error &) {
+    threw = true;
+  }
+  assert(threw);
+
+  // Per-cycle overhead: 10 M updates at 10 ps per cycle
+  {
+    StimulusReplay replay(kFile, 1e-5);
+    replay.bind("pwr", &pwr);
+    replay.bind("temp", &wvl, 0.08);
+    const auto t0 = std::chrono::steady_clock::now();
+    for (uint64_t c = 0; c < 10000000; ++c) {
+      replay.update(10 * c);
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    const double ns =
+        std::chrono::duration<double, std::nano>(t1 - t0).count() / 1e7;
+    std::cout << "update: " << ns << " ns/cycle, " << replay.rows_read()
+              << " rows read, " << replay.rows_skipped() << " skipped"
+              << std::endl;
+  }
+
+  std::remove(kFile.c_str());
+  std::cout << "stimulus_replay: all checks passed" << std::endl;
+  return 0;
+}